@@ -15,6 +15,7 @@ set(SDKLIB_HEADERS
     include/mega/traits.h
     include/mega/scoped_timer.h
     include/mega/canceller.h
+    include/mega/code_counter.h
     include/mega/command.h
     include/mega/thread.h
     include/mega/json.h
@@ -37,6 +38,8 @@ set(SDKLIB_HEADERS
     include/mega/autocomplete.h
     include/mega/serialize64.h
     include/mega/nodemanager.h
+    include/mega/node_skeleton.h
+    include/mega/node_handle_map.h
     include/mega/setandelement.h
     include/mega/testhooks.h
     include/mega/share.h
@@ -55,6 +58,7 @@ set(SDKLIB_HEADERS
     include/mega/filesystem.h
     include/mega/backofftimer.h
     include/mega/raid.h
+    include/mega/raid_kernels.h
     include/mega/raidproxy.h
     include/mega/logging.h
     include/mega/file.h
@@ -119,6 +123,7 @@ set(SDKLIB_SOURCES
     src/backofftimer.cpp
     src/base64.cpp
     src/canceller.cpp
+    src/code_counter.cpp
     src/command.cpp
     src/commands.cpp
     src/db.cpp
@@ -146,10 +151,12 @@ set(SDKLIB_SOURCES
     src/proxy.cpp
     src/pubkeyaction.cpp
     src/raid.cpp
+    src/raid_kernels.cpp
     src/raidproxy.cpp
     src/request.cpp
     src/serialize64.cpp
     src/nodemanager.cpp
+    src/node_skeleton.cpp
     src/setandelement.cpp
     src/share.cpp
     src/sharenodekeys.cpp
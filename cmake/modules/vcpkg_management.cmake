@@ -119,6 +119,10 @@ macro(process_vcpkg_libraries overlays_path)
         list(APPEND VCPKG_MANIFEST_FEATURES "sdk-tests")
     endif()
 
+    if (ENABLE_SDKLIB_BENCHMARKS)
+        list(APPEND VCPKG_MANIFEST_FEATURES "sdk-benchmarks")
+    endif()
+
     if (ENABLE_C_ARES_BACKEND)
         list(APPEND VCPKG_MANIFEST_FEATURES "c-ares-backend-curl")
     endif()
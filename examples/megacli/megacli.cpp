@@ -4378,10 +4378,12 @@ static void exec_fuseflags(autocomplete::ACState& state)
     std::string flushDelay;
     std::string logLevel;
     std::string fileExplorerView;
+    std::string writebackCache;
 
     state.extractflagparam("-flush-delay", flushDelay);
     state.extractflagparam("-log-level", logLevel);
     state.extractflagparam("-file-explorer-view", fileExplorerView);
+    state.extractflagparam("-writeback-cache", writebackCache);
 
     auto flags = client->mFuseService.serviceFlags();
 
@@ -4394,6 +4396,9 @@ static void exec_fuseflags(autocomplete::ACState& state)
     if (!fileExplorerView.empty())
         flags.mFileExplorerView = fuse::toFileExplorerView(fileExplorerView);
 
+    if (!writebackCache.empty())
+        flags.mWritebackCache = writebackCache == "on";
+
     parseCacheFlags(flags.mInodeCacheFlags);
     parseExecutorFlags(flags.mMountExecutorFlags, "mount");
     parseExecutorFlags(flags.mServiceExecutorFlags, "service");
@@ -4416,8 +4421,8 @@ static void exec_fuseflags(autocomplete::ACState& state)
               << "Service Max Thread Count: " << flags.mServiceExecutorFlags.mMaxWorkers << "\n"
               << "Service Max Thread Idle Time: " << flags.mServiceExecutorFlags.mIdleTime.count()
               << "s\n"
-              << "Service Min Thread Count: " << flags.mServiceExecutorFlags.mMinWorkers
-              << std::endl;
+              << "Service Min Thread Count: " << flags.mServiceExecutorFlags.mMinWorkers << "\n"
+              << "Writeback Cache: " << (flags.mWritebackCache ? "on" : "off") << std::endl;
 }
 
 static void exec_fusemountadd(autocomplete::ACState& state)
@@ -5626,7 +5631,8 @@ autocomplete::ACN autocompleteSyntax()
                      sequence(flag("-mount-min-thread-count"), wholenumber("count", 0)),
                      sequence(flag("-service-max-thread-count"), wholenumber("count", 16)),
                      sequence(flag("-service-max-thread-idle-time"), wholenumber("seconds", 16)),
-                     sequence(flag("-service-min-thread-count"), wholenumber("count", 0))))));
+                     sequence(flag("-service-min-thread-count"), wholenumber("count", 0)),
+                     sequence(flag("-writeback-cache"), either(text("on"), text("off")))))));
 
     p->Add(exec_fusemountadd,
            sequence(text("fuse"),
@@ -311,7 +311,7 @@ public:
                              map<LocalPath, FSNode>& known,
                              std::vector<FSNode>& results,
                              bool followSymLinks,
-                             unsigned& nFingerprinted) override;
+                             std::vector<PendingFingerprint>& pendingFingerprints) override;
 
     /* Not implemented yet */
     bool hardLink(const LocalPath& source, const LocalPath& target) override;
@@ -0,0 +1,203 @@
+/**
+ * @file mega/code_counter.h
+ * @brief Runtime counters and latency histograms for the SDK's major code paths
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#ifndef MEGA_CODE_COUNTER_H
+#define MEGA_CODE_COUNTER_H 1
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// uncomment this to also log the counters every 2 minutes, time a few very hot functions, and
+// get extra control from megacli
+// #define MEGA_MEASURE_CODE
+
+namespace mega {
+
+namespace CodeCounter
+{
+// Some classes that allow us to easily measure the number of times a block of code is called,
+// and how long it takes. Scopes are always measured: every ScopeStats registers itself with the
+// Registry, which can snapshot all of them at any time, from any thread.
+
+using namespace std::chrono;
+
+// Upper bounds of the latency histogram buckets, in microseconds.
+// A last, unbounded bucket counts anything slower.
+constexpr std::array<uint64_t, 7> LATENCY_BUCKETS_US =
+    {10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000};
+
+struct ScopeStats
+{
+    struct Snapshot
+    {
+        // Times the scope was entered and left.
+        uint64_t starts = 0;
+        uint64_t count = 0;
+
+        uint64_t timeSpentNs = 0;
+        uint64_t longestNs = 0;
+
+        std::array<uint64_t, LATENCY_BUCKETS_US.size() + 1> buckets{};
+
+        // Times the scope is being executed right now.
+        uint64_t active() const
+        {
+            // Counters are read one at a time, so a scope may be seen finishing but not starting.
+            return starts > count ? starts - count : 0;
+        }
+
+        void add(const Snapshot& other);
+    };
+
+    ScopeStats(std::string name);
+    ~ScopeStats();
+
+    ScopeStats(const ScopeStats&) = delete;
+    ScopeStats& operator=(const ScopeStats&) = delete;
+
+    const std::string& name() const
+    {
+        return mName;
+    }
+
+    void started();
+    void finished(high_resolution_clock::duration timeSpent);
+
+    Snapshot snapshot() const;
+
+    // Log line for the performance report: counts since the last reset, and the longest time
+    // ever spent.
+    std::string report(bool reset = false);
+
+private:
+    // Threads update their own shard, so concurrent scopes don't fight over a cache line.
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> starts{0};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> timeSpentNs{0};
+        std::atomic<uint64_t> longestNs{0};
+        std::array<std::atomic<uint64_t>, LATENCY_BUCKETS_US.size() + 1> buckets{};
+    };
+
+    static constexpr size_t NUM_SHARDS = 8;
+
+    Shard& shard();
+
+    std::string mName;
+    std::array<Shard, NUM_SHARDS> mShards;
+
+    // What report() last reset to.
+    Snapshot mReported;
+};
+
+struct DurationSum
+{
+#ifdef MEGA_MEASURE_CODE
+    high_resolution_clock::duration sum{ 0 };
+    high_resolution_clock::time_point deltaStart;
+    bool started = false;
+    inline void start(bool b = true) { if (b && !started) { deltaStart = high_resolution_clock::now(); started = true; }  }
+    inline void stop(bool b = true) { if (b && started) { sum += high_resolution_clock::now() - deltaStart; started = false; } }
+    inline bool inprogress() { return started; }
+    inline std::string report(bool reset = false)
+    {
+        std::string s = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(sum).count());
+        if (reset) sum = high_resolution_clock::duration{ 0 };
+        return s;
+    }
+#else
+    inline void start(bool = true) {  }
+    inline void stop(bool = true) {  }
+#endif
+};
+
+struct ScopeTimer
+{
+    ScopeStats& scope;
+    high_resolution_clock::time_point blockStart;
+    high_resolution_clock::duration diff{};
+    bool done = false;
+
+    ScopeTimer(ScopeStats& sm):
+        scope(sm),
+        blockStart(high_resolution_clock::now())
+    {
+        scope.started();
+    }
+
+    ~ScopeTimer()
+    {
+        complete();
+    }
+
+    high_resolution_clock::duration timeSpent()
+    {
+        return high_resolution_clock::now() - blockStart;
+    }
+
+    void complete()
+    {
+        // can be called early in which case the destructor's call is ignored
+        if (!done)
+        {
+            diff = high_resolution_clock::now() - blockStart;
+            scope.finished(diff);
+            done = true;
+        }
+    }
+};
+
+// Every live ScopeStats, process-wide.
+class Registry
+{
+public:
+    static Registry& instance();
+
+    void add(ScopeStats& scope);
+    void remove(ScopeStats& scope);
+
+    // Scopes sharing a name (say, one per MegaClient) are reported as one.
+    std::map<std::string, ScopeStats::Snapshot> snapshot() const;
+
+    std::string toJson() const;
+
+    // Prometheus text exposition format.
+    std::string toPrometheus() const;
+
+private:
+    Registry() = default;
+
+    mutable std::mutex mMutex;
+    std::vector<ScopeStats*> mScopes;
+};
+}
+
+} // namespace mega
+
+#endif // MEGA_CODE_COUNTER_H
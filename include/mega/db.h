@@ -25,6 +25,7 @@
 #include "filesystem.h"
 #include "logging.h"
 #include "node.h"
+#include "node_skeleton.h"
 
 #include <filesystem>
 #include <optional>
@@ -98,6 +99,9 @@ public:
     virtual bool next(uint32_t*, string*) = 0;
     bool next(uint32_t*, string*, SymmCipher*);
 
+    // get next record in sequence, still encrypted, so it can be decrypted elsewhere
+    bool nextEncrypted(uint32_t*, string*);
+
     // get specific record by key
     virtual bool get(uint32_t, string*) = 0;
 
@@ -137,6 +141,18 @@ public:
 class NodeSearchFilter;
 class NodeSearchPage;
 
+// Properties of a node passed to the visitor of DBTableNodes::visitNodesDepthFirst()
+struct NodeTreeVisit
+{
+    NodeHandle mHandle;
+    m_off_t mSize = 0;
+    uint64_t mFlags = 0;
+    nodetype_t mType = TYPE_UNKNOWN;
+
+    // 1 for nodes whose parent isn't in the table (root nodes, inshares...), 2 for their children...
+    size_t mDepth = 0;
+};
+
 class MEGA_API DBTableNodes
 {
 public:
@@ -205,6 +221,14 @@ public:
     // count of items in 'nodes' table. Returns 0 if error
     virtual uint64_t getNumberOfNodes() = 0;
 
+    // handle, parent handle and type of every node in the 'nodes' table
+    virtual bool getNodeSkeleton(std::vector<NodeSkeleton::Entry>& entries) = 0;
+
+    // visit every node in the 'nodes' table, each one before the nodes below it. Nodes are read in
+    // pages, so memory doesn't depend on the number of nodes and 'visitor' may update their
+    // counters and flags. Returns false on error
+    virtual bool visitNodesDepthFirst(const std::function<void(const NodeTreeVisit&)>& visitor) = 0;
+
     // count of children nodes of by type
     virtual uint64_t getNumberOfChildrenByType(NodeHandle parentHandle, nodetype_t nodeType) = 0;
 
@@ -314,7 +338,9 @@ enum DbOpenFlag
     // Recycle legacy database, if present.
     DB_OPEN_FLAG_RECYCLE = 0x1,
     // Operations should always be transacted.
-    DB_OPEN_FLAG_TRANSACTED = 0x2
+    DB_OPEN_FLAG_TRANSACTED = 0x2,
+    // Keep the database in memory, nothing is written to disk. Meant for tests and benchmarks.
+    DB_OPEN_FLAG_IN_MEMORY = 0x4
 }; // DbOpenFlag
 
 struct MEGA_API DbAccess
@@ -29,6 +29,7 @@
 
 #include <filesystem>
 #include <optional>
+#include <unordered_set>
 #include <sqlite3.h>
 
 namespace mega {
@@ -124,6 +125,8 @@ public:
     bool getNodeSizeTypeAndFlags(NodeHandle node, m_off_t& size, nodetype_t& nodeType, uint64_t &oldFlags) override;
     bool isAncestor(mega::NodeHandle node, mega::NodeHandle ancestor, CancelToken cancelFlag) override;
     uint64_t getNumberOfNodes() override;
+    bool getNodeSkeleton(std::vector<NodeSkeleton::Entry>& entries) override;
+    bool visitNodesDepthFirst(const std::function<void(const NodeTreeVisit&)>& visitor) override;
     uint64_t getNumberOfChildrenByType(NodeHandle parentHandle, nodetype_t nodeType) override;
 
     bool put(Node* node) override;
@@ -131,6 +134,8 @@ public:
     bool remove(mega::NodeHandle nodehandle) override;
     bool removeNodes() override;
 
+    void abort() override;
+
     void updateCounter(NodeHandle nodeHandle, const std::string& nodeCounterBlob) override;
     void updateCounterAndFlags(NodeHandle nodeHandle, uint64_t flags, const std::string& nodeCounterBlob) override;
     void createIndexes(bool enableIndexesForSearching) override;
@@ -160,6 +165,10 @@ public:
     // Gets the node size from node counter (blob)
     static void getSizeFromNodeCounter(sqlite3_context* context, int argc, sqlite3_value** argv);
 
+    // Method called when query uses 'foldCaseAccent'
+    // Gets the text with case folded and accents stripped, as compared by likeCompare()
+    static void userFoldCaseAccent(sqlite3_context* context, int argc, sqlite3_value** argv);
+
     /**
      * @brief This method is designed to apply all the filtering options in various methods that
      * perform a query to the database and use a NodeSearchFilter object.
@@ -168,11 +177,39 @@ public:
      */
     static void userMatchFilter(sqlite3_context* context, int argc, sqlite3_value** argv);
 
+    // Whether the full-text index of nodes (table 'nodesearch') exists
+    bool hasNodeSearchIndex();
+
 private:
     // Iterate over a SQL query row by row and fill the map
     // Allow at least the following containers:
     bool processSqlQueryNodes(sqlite3_stmt *stmt, std::vector<std::pair<mega::NodeHandle, mega::NodeSerialized>>& nodes);
 
+    // Full-text index (FTS5) of node names, descriptions and tags, used by searchNodes() to look
+    // up candidates instead of traversing every node below the ancestors. It's a search index, so
+    // it's created by createIndexes() and removed by dropSearchDBIndexes()
+    bool createNodeSearchIndex();
+    bool putInNodeSearchIndex(NodeHandle nodeHandle);
+    bool searchNodesUsingIndex(const NodeSearchFilter& filter,
+                               const std::string& indexQuery,
+                               int order,
+                               std::vector<std::pair<NodeHandle, NodeSerialized>>& nodes,
+                               const NodeSearchPage& page);
+    bool mHasNodeSearchIndex = false;
+
+    // Ancestry of the nodes (column 'path'), so that the nodes below another one are a range scan
+    bool getNodePaths(NodeHandle nodeHandle,
+                      NodeHandle parentHandle,
+                      std::string& oldPath,
+                      std::string& path);
+    bool updateNodePaths(const std::string& oldPath, const std::string& path);
+    bool adoptOrphanNodes(NodeHandle nodeHandle, const std::string& path);
+
+    // Parents of the nodes that are stored before them, so that put() only looks for orphans to
+    // adopt when there are some. Loaded from the table on first use.
+    bool mayHaveOrphans(NodeHandle nodeHandle);
+    std::optional<std::unordered_set<handle>> mOrphanParents;
+
     // if add a new sqlite3_stmt update finalise()
     sqlite3_stmt* mStmtPutNode = nullptr;
     sqlite3_stmt* mStmtUpdateNode = nullptr;
@@ -186,6 +223,11 @@ private:
     sqlite3_stmt* mStmtNumChildren = nullptr;
     std::map<size_t, sqlite3_stmt*> mStmtGetChildren;
     std::map<size_t, sqlite3_stmt*> mStmtSearchNodes;
+    std::map<size_t, sqlite3_stmt*> mStmtSearchNodesUsingIndex;
+    sqlite3_stmt* mStmtPutNodeSearch = nullptr;
+    sqlite3_stmt* mStmtGetNodePaths = nullptr;
+    sqlite3_stmt* mStmtUpdateNodePaths = nullptr;
+    sqlite3_stmt* mStmtOrphanNodes = nullptr;
     sqlite3_stmt* mStmtNodeTagsBelow = nullptr;
     sqlite3_stmt* mStmtNodesByFpNoMtime = nullptr;
     sqlite3_stmt* mStmtNodeByFp = nullptr;
@@ -329,6 +371,9 @@ private:
     bool stripExistingColumns(sqlite3* db, vector<NewColumn>& cols);
     bool addColumn(sqlite3* db, const string& name, const string& type);
     bool migrateDataToColumns(sqlite3* db, vector<NewColumn>&& cols);
+
+    // Calculate the ancestry ('path' column) of the nodes stored before it existed
+    bool populateNodePaths(sqlite3* db);
 };
 
 class OrderByClause
@@ -347,6 +392,10 @@ public:
     };
 };
 
+// FTS5 query that searchNodes() looks up in the node search index for the filter, if it has one.
+// Empty if the index can't be used for this filter.
+std::string getNodeSearchIndexQuery(const NodeSearchFilter& filter);
+
 } // namespace
 
 #endif
@@ -77,6 +77,12 @@ public:
     // When was this file last modified?
     std::int64_t modified() const;
 
+    // How many reads were satisfied by data that was present or already being downloaded?
+    std::uint64_t readHits() const;
+
+    // How many reads had to wait for data to be downloaded?
+    std::uint64_t readMisses() const;
+
     // Remove a previously added observer.
     void removeObserver(FileEventObserverID id);
 
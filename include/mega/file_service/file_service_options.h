@@ -17,6 +17,11 @@ struct FileServiceOptions
     // How many times will we try to download a range before we give up.
     std::uint64_t mMaximumRangeRetries = 5u;
 
+    // How much data can we read ahead of a file that's being read sequentially?
+    //
+    // Read-ahead is disabled if this is zero.
+    std::uint64_t mMaximumReadAheadSize = 1u << 24;
+
     // Specifies the minimum distance between ranges before they are merged.
     std::uint64_t mMinimumRangeDistance = 1u << 17;
 
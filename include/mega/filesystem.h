@@ -144,7 +144,9 @@ struct MEGA_API FileSystemAccess;
 class MEGA_API Sync;
 struct MEGA_API FSNode;
 
+#ifdef MEGA_MEASURE_CODE
 extern CodeCounter::ScopeStats g_compareUtfTimings;
+#endif // MEGA_MEASURE_CODE
 
 inline std::ostream& operator<<(std::ostream& os, const LocalPath& p)
 {
@@ -675,6 +677,16 @@ public:
 // For directoryScan(...).
 struct MEGA_API FSNode;
 
+// A file that directoryScan(...) leaves for its caller to fingerprint, possibly in parallel.
+struct MEGA_API PendingFingerprint
+{
+    // Index of the file in the scan results.
+    size_t index;
+
+    // Computes the fingerprint of that file, false if it couldn't be read.
+    std::function<bool(FSNode&)> compute;
+};
+
 // generic host filesystem access interface
 struct MEGA_API FileSystemAccess : public EventTrigger
 {
@@ -810,7 +822,7 @@ struct MEGA_API FileSystemAccess : public EventTrigger
                                      map<LocalPath, FSNode>& known,
                                      std::vector<FSNode>& results,
                                      bool followSymLinks,
-                                     unsigned& nFingerprinted) = 0;
+                                     std::vector<PendingFingerprint>& pendingFingerprints) = 0;
 
     // Retrieve the FSID of the item at the specified path.
     // UNDEF is returned if we cannot determine the item's FSID.
@@ -1003,6 +1015,33 @@ public:
             return mExpectedFsid;
         }
 
+        // Entries found, files fingerprinted and how long it took.
+        struct Stats
+        {
+            size_t numEntries = 0;
+            size_t numFingerprinted = 0;
+            m_off_t bytesFingerprinted = 0;
+
+            // Wall-clock time with at least one of the scans running: scans that overlap in
+            // different threads are only counted once.
+            std::chrono::steady_clock::duration elapsed{};
+
+            // When the latest run of overlapping scans started, and when the last scan finished.
+            std::chrono::steady_clock::time_point started{};
+            std::chrono::steady_clock::time_point finished{};
+
+            Stats& operator+=(const Stats& other);
+
+            double entriesPerSecond() const;
+            double bytesFingerprintedPerSecond() const;
+        };
+
+        // Only meaningful once the request has completed.
+        const Stats& stats() const
+        {
+            return mStats;
+        }
+
     private:
         friend class ScanService;
 
@@ -1027,6 +1066,9 @@ public:
         // fsid that the target path should still referene
         handle mExpectedFsid;
 
+        // How the scan went.
+        Stats mStats;
+
     }; // ScanRequest
 
     // For convenience.
@@ -1038,6 +1080,11 @@ public:
     // Track performance (debug only)
     static CodeCounter::ScopeStats syncScanTime;
 
+    // Number of threads scanning directories and fingerprinting their files, shared by all the
+    // services. Changes apply to the running worker, if any.
+    static void setNumThreads(size_t numThreads);
+    static size_t numThreads();
+
 private:
        // Convenience.
     using ScanRequestPtr = std::shared_ptr<ScanRequest>;
@@ -1055,12 +1102,39 @@ private:
         // Queues a scan request for processing.
         void queue(ScanRequestPtr request);
 
+        // Starts or stops threads so that there are numThreads of them.
+        void resize(size_t numThreads);
+
     private:
+        // Files of a scan request being fingerprinted by the threads.
+        struct FingerprintBatch
+        {
+            ScanRequestPtr request;
+            std::atomic<size_t> numPending{0};
+            std::atomic<size_t> numFingerprinted{0};
+            std::atomic<m_off_t> bytesFingerprinted{0};
+        };
+
+        struct FingerprintJob
+        {
+            std::shared_ptr<FingerprintBatch> batch;
+            PendingFingerprint fingerprint;
+        };
+
         // Thread entry point.
-        void loop();
+        void loop(size_t threadIndex);
 
         // Processes a scan request.
-        ScanResult scan(ScanRequestPtr request, unsigned& nFingerprinted);
+        ScanResult scan(ScanRequestPtr request);
+
+        // Fingerprints the files left by directoryScan(...), with the help of any idle thread.
+        void fingerprint(ScanRequestPtr request, std::vector<PendingFingerprint>&& pending);
+
+        // Computes one fingerprint of a batch.
+        void fingerprint(FingerprintJob& job);
+
+        // Starts the thread with the given index.
+        void startThread(size_t threadIndex);
 
         // Filesystem access.
         std::unique_ptr<FileSystemAccess> mFsAccess;
@@ -1068,23 +1142,39 @@ private:
         // Pending scan requests.
         std::deque<ScanRequestPtr> mPending;
 
+        // Pending fingerprints of the requests being scanned.
+        std::deque<FingerprintJob> mFingerprints;
+
+        // Threads with an index from this one on must exit.
+        size_t mNumActiveThreads = 0;
+
         // Guards access to the above.
         std::mutex mPendingLock;
         std::condition_variable mPendingNotifier;
 
         // Worker threads.
         std::vector<std::thread> mThreads;
+
+        // Serializes resize() calls.
+        std::mutex mResizeLock;
     }; // Worker
 
     // How many services are currently active.
     static std::atomic<size_t> mNumServices;
 
-    // Worker shared by all services.
-    static std::unique_ptr<Worker> mWorker;
+    // Worker shared by all services. Shared so that setNumThreads() can wait for surplus threads
+    // without holding mWorkerLock.
+    static std::shared_ptr<Worker> mWorker;
+
+    // Number of threads of the worker.
+    static size_t mNumThreads;
 
     // Synchronizes access to the above.
     static std::mutex mWorkerLock;
 
+    // Serializes setNumThreads() calls, so that their resizes apply in the same order.
+    static std::mutex mSetNumThreadsLock;
+
 }; // ScanService
 
 // True if type denotes a network filesystem.
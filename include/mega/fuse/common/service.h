@@ -10,6 +10,7 @@
 #include <mega/common/node_event_queue_forward.h>
 #include <mega/common/normalized_path_forward.h>
 #include <mega/common/task_queue_forward.h>
+#include <mega/file_service/file_service_forward.h>
 #include <mega/fuse/common/inode_info_forward.h>
 #include <mega/fuse/common/mount_flags_forward.h>
 #include <mega/fuse/common/mount_info_forward.h>
@@ -18,6 +19,7 @@
 #include <mega/fuse/common/service_context_forward.h>
 #include <mega/fuse/common/service_flags.h>
 #include <mega/fuse/common/service_forward.h>
+#include <mega/fuse/common/service_statistics.h>
 
 #include <mega/types.h>
 
@@ -33,6 +35,8 @@ public:
 
     explicit Service(common::Client& mClient);
 
+    Service(common::Client& client, file_service::FileService& fileService);
+
     ~Service();
 
     // Abort (and unmount) any mounts matching predicate.
@@ -110,6 +114,9 @@ public:
     // Is FUSE supported on this platform?
     bool supported() const;
 
+    // Query the service's statistics.
+    ServiceStatistics statistics() const;
+
     // Check whether the specified path is "syncable."
     //
     // A path is syncable if:
@@ -126,6 +133,9 @@ public:
     // Who we call to learn about the cloud and transfer files.
     common::Client& mClient;
 
+    // Who we call to read files that aren't cached locally, if anyone.
+    file_service::FileService* mFileService;
+
 private:
     // Platform-specific behavior and state.
     ServiceContextPtr mContext;
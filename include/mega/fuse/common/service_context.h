@@ -7,6 +7,7 @@
 #include <mega/common/node_event_queue_forward.h>
 #include <mega/common/normalized_path_forward.h>
 #include <mega/common/task_queue_forward.h>
+#include <mega/file_service/file_service_forward.h>
 #include <mega/fuse/common/inode_info_forward.h>
 #include <mega/fuse/common/mount_flags_forward.h>
 #include <mega/fuse/common/mount_info_forward.h>
@@ -15,6 +16,7 @@
 #include <mega/fuse/common/service_context_forward.h>
 #include <mega/fuse/common/service_flags.h>
 #include <mega/fuse/common/service_forward.h>
+#include <mega/fuse/common/service_statistics.h>
 
 #include <mega/types.h>
 
@@ -65,6 +67,9 @@ public:
     // Query whether a specified mount is enabled.
     virtual bool enabled(const std::string& name) const = 0;
 
+    // Retrieve the file service used to read files that aren't cached locally, if any.
+    file_service::FileService* fileService() const;
+
     // Execute a function on some thread.
     virtual common::Task execute(std::function<void(const common::Task&)> function) = 0;
 
@@ -93,6 +98,9 @@ public:
     // Query the service's flags.
     ServiceFlags serviceFlags() const;
 
+    // Query the service's statistics.
+    virtual ServiceStatistics statistics() const = 0;
+
     // Check whether the specified path is "syncable."
     virtual bool syncable(const common::NormalizedPath& path) const = 0;
 
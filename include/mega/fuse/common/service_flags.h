@@ -33,6 +33,11 @@ struct ServiceFlags
 
     // Specifies how the service should manage its worker threads.
     common::TaskExecutorFlags mServiceExecutorFlags;
+
+    // Should mounts let the kernel cache writes and send us larger writes?
+    //
+    // Only affects mounts enabled after the flag has been changed.
+    bool mWritebackCache = false;
 }; // ServiceFlags
 
 } // fuse
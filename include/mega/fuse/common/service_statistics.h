@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include <mega/fuse/common/service_statistics_forward.h>
+
+namespace mega
+{
+namespace fuse
+{
+
+struct ServiceStatistics
+{
+    // What fraction of directory listings were served from the cache?
+    double listingHitRatio() const
+    {
+        auto total = mListingHits + mListingMisses;
+
+        if (!total)
+            return 0.0;
+
+        return static_cast<double>(mListingHits) / static_cast<double>(total);
+    }
+
+    // How many directory listings were served from the cache?
+    std::uint64_t mListingHits = 0u;
+
+    // How many directory listings had to be rebuilt from the client?
+    std::uint64_t mListingMisses = 0u;
+
+    // How long have we spent rebuilding directory listings?
+    std::chrono::microseconds mListingRebuildTime{0};
+}; // ServiceStatistics
+
+} // fuse
+} // mega
+
@@ -367,6 +367,12 @@ struct MEGA_API HttpReq
     byte* buf;
     m_off_t buflen, bufpos, notifiedbufpos;
 
+    // allocated size of buf, which can be larger than buflen when it comes from a HttpBufferPool
+    size_t bufcapacity;
+
+    // if set, incremented with the bytes copied into buf as they are received
+    m_off_t* mCopiedBytes = nullptr;
+
     // When did a post() start
     std::chrono::steady_clock::time_point postStartTime;
 
@@ -426,13 +432,18 @@ struct MEGA_API HttpReq
         size_t start;
         size_t end;
 
-        http_buf_t(byte* b, size_t s, size_t e);  // takes ownership of the byte*, which must have been allocated with new[]
+        http_buf_t(byte* b, size_t s, size_t e, size_t capacity = 0);  // takes ownership of the byte*, which must have been allocated with new[]
         ~http_buf_t();
         void swap(http_buf_t& other);
         bool isNull() const;
 
+        // give up ownership of the buffer, so it can be reused. Its allocated size is stored in
+        // 'capacity' (0 if unknown)
+        byte* release(size_t& capacity);
+
     private:
         byte* buf;
+        size_t capacity;
     };
 
     // give up ownership of the buffer for client to use.  The caller is the new owner of the http_buf_t, and the HttpReq no longer has the buffer or any info about it.
@@ -574,6 +585,13 @@ struct MEGA_API HttpReqUL : public HttpReqXfer
 {
     chunkmac_map mChunkmacs;
 
+    // Start of the current stage of the chunk in the upload pipeline (read, encrypt, send) and
+    // time (ms) spent in the ones already finished
+    std::chrono::steady_clock::time_point mStageStart;
+    double mReadTime{};
+    double mEncryptQueueTime{};
+    double mEncryptTime{};
+
     void prepare(const char*, SymmCipher*, uint64_t, m_off_t, m_off_t);
 
     m_off_t transferred(MegaClient*);
@@ -581,12 +599,42 @@ struct MEGA_API HttpReqUL : public HttpReqXfer
     ~HttpReqUL() { }
 };
 
+// Buffers to receive downloaded data, reused once their content has been written to the file so
+// every request doesn't allocate (and page in) a new buffer of several MB. Their sizes are
+// multiples of SymmCipher::BLOCKSIZE, as required to decrypt them in place.
+// It's only used from the client thread.
+class MEGA_API HttpBufferPool
+{
+public:
+    // get a buffer of 'size' bytes at least. Its allocated size is stored in 'capacity'
+    byte* get(size_t size, size_t& capacity);
+
+    // take back a buffer for reuse. Buffers of unknown capacity (0) are deleted
+    void put(byte* buffer, size_t capacity);
+
+    HttpBufferPool() = default;
+    HttpBufferPool(const HttpBufferPool&) = delete;
+    HttpBufferPool& operator=(const HttpBufferPool&) = delete;
+    ~HttpBufferPool();
+
+private:
+    // buffers ready for reuse, and their capacity
+    std::vector<std::pair<byte*, size_t>> mFree;
+
+    // buffers allocated by get(). The pool doesn't keep more than that, so it never holds more
+    // memory than the peak used by the transfer.
+    size_t mNumAllocated = 0;
+};
+
 // file chunk download
 struct MEGA_API HttpReqDL : public HttpReqXfer
 {
     m_off_t dlpos;
     bool buffer_released;
 
+    // if set, buf is taken from (and returned to) this pool
+    HttpBufferPool* mBufferPool = nullptr;
+
     void prepare(const char*, SymmCipher*, uint64_t, m_off_t, m_off_t);
 
     HttpReqDL();
@@ -84,6 +84,9 @@ public:
     void init();
     void toJsonArray(string *json);
 
+    // Compute nodesPerSecond and sample peakMemory, once the cached filesystem is ready
+    void measureCached();
+
     //////////////////
     // General info //
     //////////////////
@@ -194,6 +197,33 @@ public:
      * The resumption of transfers is done after the filesystem is current
      */
     dstime timeToTransfersResumed;
+
+    /**
+     * @brief Time (ms) spent decrypting and unserializing the records of the local cache
+     *
+     * Only from DB. Records are decoded in parallel by the worker threads.
+     */
+    long long cacheDecodeTime;
+
+    /**
+     * @brief Time (ms) spent applying the decoded records of the local cache to the client
+     *
+     * Only from DB
+     */
+    long long cacheApplyTime;
+
+    /**
+     * @brief Nodes loaded per second, from the first byte read until the cached filesystem is
+     * ready
+     */
+    long long nodesPerSecond;
+
+    /**
+     * @brief Peak resident memory of the process (bytes) when the cached filesystem is ready
+     *
+     * 0 if it's not available on this platform
+     */
+    long long peakMemory;
 };
 
 /**
@@ -509,6 +539,25 @@ struct DynamicMessageNotification
     std::map<std::string, std::map<std::string, std::string>> renderModes;
 };
 
+// A record of the statecache, decrypted and (if that doesn't need the client) unserialized by a
+// worker thread, to be applied by MegaClient::fetchsc() in record order
+struct MEGA_API StateCacheRecord
+{
+    uint32_t id = 0;
+    string data;
+    bool decrypted = false;
+    unique_ptr<PendingContactRequest> pcr;
+    unique_ptr<Set> set;
+    unique_ptr<SetElement> setElement;
+
+    // Decode the records in the worker threads of queue, and wait until all of them are done.
+    // Returns how many records can be applied: as DbTable::next(), loading stops at the first
+    // record that can't be decrypted.
+    static size_t decode(MegaClientAsyncQueue& queue,
+                         const SymmCipher& key,
+                         std::vector<StateCacheRecord>& records);
+};
+
 class MEGA_API MegaClient
 {
 public:
@@ -1802,6 +1851,9 @@ public:
 
     std::atomic<bool> mEnableSearchDBIndexes{true};
 
+    // Write a node skeleton snapshot next to the state cache and map it on resume
+    std::atomic<bool> mEnableNodeSkeletonSnapshot{false};
+
     struct FolderLink {
         // public handle of the folder link ('&n=' param in the POST)
         handle mPublicHandle = UNDEF;
@@ -2055,6 +2107,11 @@ public:
     bool fetchingnodes;
     int fetchnodestag;
 
+    // nodes received from fetchnodes are committed to sctable in transactions of this size,
+    // rather than in a single one for the whole account
+    static const unsigned FETCHNODES_NODES_PER_TRANSACTION = 100000;
+    unsigned mFetchedNodesSinceCommit = 0;
+
     // set true after fetchnodes and catching up on actionpackets, stays true after that.
     std::atomic<bool> statecurrent;
 
@@ -2115,6 +2172,15 @@ public:
     void updatesc();
     void finalizesc(bool);
 
+    // node changes (see NodeManager::getNodeChanges()) reflected by the last commit of sctable
+    uint64_t mCommittedNodeChanges = 0;
+
+    // location of the node skeleton snapshot, next to the state cache
+    LocalPath nodeSkeletonPath();
+
+    // write the node skeleton snapshot if enabled and nodes match the committed state cache
+    void saveNodeSkeleton();
+
     // truncates status table
     void initStatusTable();
 
@@ -2698,6 +2764,10 @@ public:
     // It should be call just after open the DB
     void dropSearchDBIndexes();
 
+    // Enable the node skeleton snapshot, used to warm start session resumption
+    // By default is false
+    void enableNodeSkeletonSnapshot(bool enable);
+
     // create a new folder with given name and stores its node's handle into the user's attribute ^!bak
     error setbackupfolder(const char* foldername, int tag, std::function<void(Error)> addua_completion);
 
@@ -2866,6 +2936,10 @@ public:
         CodeCounter::ScopeStats scProcessingTime = { "sc processing" };
 #ifdef ENABLE_SYNC
         CodeCounter::ScopeStats recursiveSyncTime = { "recursiveSync" };
+        CodeCounter::ScopeStats clientThreadActions = { "clientThreadActions" };
+#ifdef MEGA_MEASURE_CODE
+        // Run for every folder or row of every sync pass: too hot to time outside of measurement
+        // builds.
         CodeCounter::ScopeStats computeSyncTripletsTime = { "computeSyncTriplets" };
         CodeCounter::ScopeStats inferSyncTripletsTime = { "inferSyncTriplets" };
         CodeCounter::ScopeStats syncItem = { "syncItem" };
@@ -2878,7 +2952,7 @@ public:
         CodeCounter::ScopeStats syncItemCXF = { "syncItemCXF" };
         CodeCounter::ScopeStats syncItemCSX = { "syncItemCSX" };
         CodeCounter::ScopeStats syncItemCSF = { "syncItemCSF" };
-        CodeCounter::ScopeStats clientThreadActions = { "clientThreadActions" };
+#endif // MEGA_MEASURE_CODE
 #endif
         uint64_t transferStarts = 0, transferFinishes = 0;
         uint64_t transferTempErrors = 0, transferFails = 0;
@@ -3129,7 +3203,7 @@ private:
     void sc_ass(JSON& json); // AP after exported set update
 
     bool initscsets();
-    bool fetchscset(string* data, uint32_t id);
+    bool fetchscset(unique_ptr<Set> s, uint32_t id);
     bool updatescsets();
     void notifypurgesets();
     void notifyset(Set*);
@@ -3137,7 +3211,7 @@ private:
     map<handle, Set> mSets; // indexed by Set id
 
     bool initscsetelements();
-    bool fetchscsetelement(string* data, uint32_t id);
+    bool fetchscsetelement(unique_ptr<SetElement> el, uint32_t id);
     bool updatescsetelements();
     void notifypurgesetelements();
     void notifysetelement(SetElement*);
@@ -27,6 +27,7 @@
 #include "backofftimer.h"
 #include "file.h"
 #include "filefingerprint.h"
+#include "node_handle_map.h"
 #include "syncfilter.h"
 #include "syncinternals/mac_computation_state.h"
 #include "syncinternals/syncuploadthrottlingfile.h"
@@ -155,7 +156,7 @@ private:
     NodeManager& mNodeManager;
     weak_ptr<Node> mNode;
 };
-typedef std::map<NodeHandle, NodeManagerNode>::iterator NodePosition;
+typedef NodeHandleMap<NodeManagerNode>::iterator NodePosition;
 
 struct CommandChain
 {
@@ -638,6 +639,45 @@ struct SyncPath;
 
 struct MEGA_API LocalNode;
 
+// LocalNodes by name, as a LocalNode keeps its children.
+// Most LocalNodes are files, which never have children, so the map itself is only allocated
+// once the first entry is added. That saves an empty map in every file's LocalNode.
+class MEGA_API LocalNodeChildMap
+{
+public:
+    using iterator = localnode_map::iterator;
+    using const_iterator = localnode_map::const_iterator;
+    using value_type = localnode_map::value_type;
+
+    iterator begin() { return map().begin(); }
+    iterator end() { return map().end(); }
+    const_iterator begin() const { return map().begin(); }
+    const_iterator end() const { return map().end(); }
+
+    bool empty() const { return !mMap || mMap->empty(); }
+    size_t size() const { return mMap ? mMap->size() : 0; }
+
+    iterator find(const LocalPath& name) { return map().find(name); }
+    const_iterator find(const LocalPath& name) const { return map().find(name); }
+
+    LocalNode*& operator[](const LocalPath& name) { return allocated()[name]; }
+
+    iterator erase(const_iterator position) { return mMap ? mMap->erase(position) : end(); }
+    size_t erase(const LocalPath& name) { return mMap ? mMap->erase(name) : 0; }
+
+    // Releases the map, not just its entries.
+    void clear() { mMap.reset(); }
+
+private:
+    localnode_map& map() const { return mMap ? *mMap : emptyMap(); }
+    localnode_map& allocated();
+
+    // Shared by every LocalNodeChildMap without entries. Never modified.
+    static localnode_map& emptyMap();
+
+    std::unique_ptr<localnode_map> mMap;
+};
+
 struct MEGA_API LocalNodeCore
   : public Cacheable
 {
@@ -661,9 +701,6 @@ struct MEGA_API LocalNodeCore
     // null means either the entry has no shortname or it's the same as the (normal) longname
     std::unique_ptr<LocalPath> slocalname = nullptr;
 
-    // whether this node knew its shortname (otherwise it was loaded from an old db)
-    bool slocalname_in_db = false;
-
     // related cloud node, if any
     NodeHandle syncedCloudNodeHandle;
 
@@ -681,6 +718,10 @@ struct MEGA_API LocalNodeCore
     // This is so users can, for example, change uppercase/lowercase and have that synchronized.
     bool namesSynchronized = false;
 
+    // whether this node knew its shortname (otherwise it was loaded from an old db)
+    // (kept next to the other small fields so the struct has no padding holes)
+    bool slocalname_in_db = false;
+
 }; // LocalNodeCore
 
 struct MEGA_API LocalNode
@@ -699,10 +740,10 @@ struct MEGA_API LocalNode
     LocalNode* parent = nullptr;
 
     // children by name
-    localnode_map children;
+    LocalNodeChildMap children;
 
     unique_ptr<LocalPath> cloneShortname() const;
-    localnode_map schildren;
+    LocalNodeChildMap schildren;
 
     // The last scan of the folder (for folders).
     // Removed again when the folder is fully synced.
@@ -905,16 +946,18 @@ struct MEGA_API LocalNode
          * for large files, so it runs incrementally across sync iterations using worker threads.
          *
          * Architecture:
-         * - Sync thread reads file in large chunks (10-20MB) with FILE_SHARE_DELETE
-         * - Worker thread (mAsyncQueue) computes MACs for chunks
-         * - Progress tracked across sync iterations
-         * - File opened/closed per chunk to minimize lock duration
+         * - File split in ranges of up to 10MB on chunk boundaries
+         * - Sync thread keeps up to MacComputationState::MAX_RANGES_IN_FLIGHT ranges queued
+         *   on mAsyncQueue, topping them up on each sync iteration
+         * - Each worker opens the file with FILE_SHARE_DELETE, reads its range with blocking
+         *   I/O, closes it and computes the range's chunk MACs
+         * - The worker that completes the last range computes the file MAC
          *
          * Thread safety:
          * - Context fields are immutable after construction
-         * - chunkInProgress flag: sync thread sets true before queueing, worker clears when done
-         * - completed flag: worker sets when all chunks processed
-         * - partialMacs protected by mutex (worker writes, sync reads only when !chunkInProgress)
+         * - rangesInFlight: sync thread increments before queueing, worker decrements when done
+         * - completed/failed flags: set by workers, checked by the sync thread
+         * - partialMacs and bytesProcessed protected by mutex (written by workers)
          *
          * Lifetime:
          * - Sync thread holds shared_ptr in RareFields
@@ -0,0 +1,530 @@
+/**
+ * @file mega/node_handle_map.h
+ * @brief Flat hash index keyed by node handle, with stable element addresses
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#ifndef MEGA_NODE_HANDLE_MAP_H
+#define MEGA_NODE_HANDLE_MAP_H 1
+
+#include "types.h"
+
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace mega {
+
+/**
+ * @brief Associative container keyed by NodeHandle, replacing std::map for large node sets.
+ *
+ * Lookups go through an open-addressing index (linear probing, backward-shift deletion)
+ * that only stores the 48-bit handle and the number of the slot holding the element, so a
+ * probe sequence touches a single cache line in the common case.
+ *
+ * Elements live in fixed-size blocks that are never moved or reallocated: pointers,
+ * references and iterators to an element stay valid until that element is erased, exactly
+ * like std::map. This is required by NodeManager, which keeps NodePosition iterators in
+ * every Node and raw NodeManagerNode pointers in NodeManagerNode::mChildren.
+ *
+ * Iteration order is unspecified (slot order, not handle order).
+ */
+template<typename T>
+class NodeHandleMap
+{
+public:
+    using key_type = NodeHandle;
+    using mapped_type = T;
+    using value_type = std::pair<const NodeHandle, T>;
+    using size_type = std::size_t;
+
+private:
+    template<bool IsConst>
+    class Iterator
+    {
+        using Map = std::conditional_t<IsConst, const NodeHandleMap, NodeHandleMap>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = NodeHandleMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+        using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+
+        Iterator() = default;
+
+        // Allow iterator -> const_iterator conversion.
+        template<bool WasConst, typename = std::enable_if_t<IsConst && !WasConst>>
+        Iterator(const Iterator<WasConst>& other):
+            mMap(other.mMap),
+            mSlot(other.mSlot)
+        {}
+
+        reference operator*() const
+        {
+            return mMap->valueAt(mSlot);
+        }
+
+        pointer operator->() const
+        {
+            return &mMap->valueAt(mSlot);
+        }
+
+        Iterator& operator++()
+        {
+            mSlot = mMap->nextUsedSlot(mSlot + 1);
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        // Only the slot is compared: a default-constructed iterator compares equal to end(),
+        // which is what Node::mNodePosition relies on before the node is indexed.
+        bool operator==(const Iterator& other) const
+        {
+            return mSlot == other.mSlot;
+        }
+
+        bool operator!=(const Iterator& other) const
+        {
+            return mSlot != other.mSlot;
+        }
+
+    private:
+        friend class NodeHandleMap;
+        friend class Iterator<!IsConst>;
+
+        Iterator(Map* map, uint32_t slot):
+            mMap(map),
+            mSlot(slot)
+        {}
+
+        Map* mMap = nullptr;
+        uint32_t mSlot = NO_SLOT;
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    NodeHandleMap() = default;
+
+    NodeHandleMap(const NodeHandleMap&) = delete;
+    NodeHandleMap& operator=(const NodeHandleMap&) = delete;
+
+    ~NodeHandleMap()
+    {
+        destroyAll();
+    }
+
+    iterator begin()
+    {
+        return iterator(this, nextUsedSlot(0));
+    }
+
+    iterator end()
+    {
+        return iterator(this, NO_SLOT);
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, nextUsedSlot(0));
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, NO_SLOT);
+    }
+
+    bool empty() const
+    {
+        return mSize == 0;
+    }
+
+    size_type size() const
+    {
+        return mSize;
+    }
+
+    iterator find(NodeHandle handle)
+    {
+        return iterator(this, findSlot(handle.as8byte()));
+    }
+
+    const_iterator find(NodeHandle handle) const
+    {
+        return const_iterator(this, findSlot(handle.as8byte()));
+    }
+
+    size_type count(NodeHandle handle) const
+    {
+        return findSlot(handle.as8byte()) == NO_SLOT ? 0 : 1;
+    }
+
+    /**
+     * @brief Inserts an element constructed from args if no element exists for handle.
+     *
+     * Unlike std::map::emplace, the mapped value is not constructed when the handle is
+     * already present.
+     *
+     * @return the iterator to the element for handle, and whether it was inserted.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(NodeHandle handle, Args&&... args)
+    {
+        const uint64_t key = handle.as8byte();
+
+        if (uint32_t slot = findSlot(key); slot != NO_SLOT)
+        {
+            return {iterator(this, slot), false};
+        }
+
+        reserveIndex(mSize + 1);
+
+        const uint32_t slot = allocateSlot();
+
+        try
+        {
+            ::new (static_cast<void*>(&valueAt(slot)))
+                value_type(std::piecewise_construct,
+                           std::forward_as_tuple(handle),
+                           std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        catch (...)
+        {
+            releaseSlot(slot);
+            throw;
+        }
+
+        insertBucket(key, slot);
+        ++mSize;
+
+        return {iterator(this, slot), true};
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(NodeHandle handle, Args&&... args)
+    {
+        return try_emplace(handle, std::forward<Args>(args)...);
+    }
+
+    void erase(iterator position)
+    {
+        assert(position.mMap == this && position.mSlot != NO_SLOT);
+
+        eraseBucket(valueAt(position.mSlot).first.as8byte());
+        valueAt(position.mSlot).~value_type();
+        releaseSlot(position.mSlot);
+        --mSize;
+    }
+
+    size_type erase(NodeHandle handle)
+    {
+        uint32_t slot = findSlot(handle.as8byte());
+
+        if (slot == NO_SLOT)
+        {
+            return 0;
+        }
+
+        erase(iterator(this, slot));
+        return 1;
+    }
+
+    // Destroys all elements and releases the memory used by them and by the index.
+    void clear()
+    {
+        destroyAll();
+
+        mBlocks.clear();
+        mBlocks.shrink_to_fit();
+        mBuckets.clear();
+        mBuckets.shrink_to_fit();
+        mFreeSlots.clear();
+        mFreeSlots.shrink_to_fit();
+        mSlotCount = 0;
+        mSize = 0;
+        mMask = 0;
+    }
+
+    // Sizes the index so that count elements can be inserted without rehashing.
+    void reserve(size_type count)
+    {
+        reserveIndex(count);
+    }
+
+private:
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    // Elements per block. Blocks are never reallocated so element addresses are stable.
+    static constexpr uint32_t BLOCK_SHIFT = 10;
+    static constexpr uint32_t BLOCK_SIZE = 1u << BLOCK_SHIFT;
+    static constexpr uint32_t BLOCK_MASK = BLOCK_SIZE - 1;
+
+    static constexpr size_type MIN_BUCKETS = 16;
+
+    // Maximum load factor of the index is MAX_LOAD_NUMERATOR / MAX_LOAD_DENOMINATOR.
+    static constexpr size_type MAX_LOAD_NUMERATOR = 3;
+    static constexpr size_type MAX_LOAD_DENOMINATOR = 4;
+
+    struct Bucket
+    {
+        // 48-bit node handle (or UNDEF), as returned by NodeHandle::as8byte().
+        uint64_t mKey = 0;
+        // Slot holding the element, NO_SLOT when the bucket is empty.
+        uint32_t mSlot = NO_SLOT;
+    };
+
+    union Slot
+    {
+        Slot() {}
+        ~Slot() {}
+
+        value_type mValue;
+    };
+
+    struct Block
+    {
+        // One bit per slot, set when the slot holds a constructed element.
+        uint64_t mUsed[BLOCK_SIZE / 64] = {};
+        Slot mSlots[BLOCK_SIZE];
+    };
+
+    static uint64_t hash(uint64_t key)
+    {
+        // Fibonacci hashing. Node handles are random already, but the multiplication spreads
+        // sequential test handles and any bias in the low bits across the whole index.
+        key *= 0x9E3779B97F4A7C15ull;
+        return key ^ (key >> 32);
+    }
+
+    value_type& valueAt(uint32_t slot)
+    {
+        return mBlocks[slot >> BLOCK_SHIFT]->mSlots[slot & BLOCK_MASK].mValue;
+    }
+
+    const value_type& valueAt(uint32_t slot) const
+    {
+        return mBlocks[slot >> BLOCK_SHIFT]->mSlots[slot & BLOCK_MASK].mValue;
+    }
+
+    bool isUsed(uint32_t slot) const
+    {
+        const Block& block = *mBlocks[slot >> BLOCK_SHIFT];
+        uint32_t offset = slot & BLOCK_MASK;
+        return (block.mUsed[offset >> 6] >> (offset & 63)) & 1;
+    }
+
+    void setUsed(uint32_t slot, bool used)
+    {
+        Block& block = *mBlocks[slot >> BLOCK_SHIFT];
+        uint32_t offset = slot & BLOCK_MASK;
+        uint64_t bit = uint64_t(1) << (offset & 63);
+
+        if (used)
+        {
+            block.mUsed[offset >> 6] |= bit;
+        }
+        else
+        {
+            block.mUsed[offset >> 6] &= ~bit;
+        }
+    }
+
+    // Returns the first slot >= from holding an element, or NO_SLOT.
+    uint32_t nextUsedSlot(uint32_t from) const
+    {
+        while (from < mSlotCount)
+        {
+            const Block& block = *mBlocks[from >> BLOCK_SHIFT];
+            uint32_t offset = from & BLOCK_MASK;
+            uint64_t word = block.mUsed[offset >> 6] >> (offset & 63);
+
+            if (word)
+            {
+                for (; !(word & 1); word >>= 1)
+                {
+                    ++from;
+                }
+
+                return from < mSlotCount ? from : NO_SLOT;
+            }
+
+            // Skip to the beginning of the next word.
+            from = (from | 63) + 1;
+        }
+
+        return NO_SLOT;
+    }
+
+    uint32_t findSlot(uint64_t key) const
+    {
+        if (mBuckets.empty())
+        {
+            return NO_SLOT;
+        }
+
+        for (size_type i = hash(key) & mMask;; i = (i + 1) & mMask)
+        {
+            const Bucket& bucket = mBuckets[i];
+
+            if (bucket.mSlot == NO_SLOT)
+            {
+                return NO_SLOT;
+            }
+
+            if (bucket.mKey == key)
+            {
+                return bucket.mSlot;
+            }
+        }
+    }
+
+    uint32_t allocateSlot()
+    {
+        uint32_t slot;
+
+        if (!mFreeSlots.empty())
+        {
+            slot = mFreeSlots.back();
+            mFreeSlots.pop_back();
+        }
+        else
+        {
+            assert(mSlotCount < NO_SLOT);
+
+            slot = mSlotCount++;
+
+            if ((slot >> BLOCK_SHIFT) == mBlocks.size())
+            {
+                mBlocks.emplace_back(new Block);
+            }
+        }
+
+        setUsed(slot, true);
+        return slot;
+    }
+
+    void releaseSlot(uint32_t slot)
+    {
+        setUsed(slot, false);
+        mFreeSlots.push_back(slot);
+    }
+
+    void insertBucket(uint64_t key, uint32_t slot)
+    {
+        size_type i = hash(key) & mMask;
+
+        while (mBuckets[i].mSlot != NO_SLOT)
+        {
+            i = (i + 1) & mMask;
+        }
+
+        mBuckets[i].mKey = key;
+        mBuckets[i].mSlot = slot;
+    }
+
+    void eraseBucket(uint64_t key)
+    {
+        size_type i = hash(key) & mMask;
+
+        while (mBuckets[i].mKey != key || mBuckets[i].mSlot == NO_SLOT)
+        {
+            assert(mBuckets[i].mSlot != NO_SLOT);
+            i = (i + 1) & mMask;
+        }
+
+        // Backward-shift deletion: move later members of the probe sequence into the hole so
+        // that lookups never need tombstones.
+        for (size_type j = (i + 1) & mMask; mBuckets[j].mSlot != NO_SLOT; j = (j + 1) & mMask)
+        {
+            size_type home = hash(mBuckets[j].mKey) & mMask;
+
+            // Move j into the hole at i unless its home bucket lies cyclically in (i, j].
+            if (((j - home) & mMask) >= ((j - i) & mMask))
+            {
+                mBuckets[i] = mBuckets[j];
+                i = j;
+            }
+        }
+
+        mBuckets[i] = Bucket();
+    }
+
+    void reserveIndex(size_type count)
+    {
+        size_type buckets = mBuckets.empty() ? MIN_BUCKETS : mBuckets.size();
+
+        while (count * MAX_LOAD_DENOMINATOR > buckets * MAX_LOAD_NUMERATOR)
+        {
+            buckets <<= 1;
+        }
+
+        if (buckets == mBuckets.size())
+        {
+            return;
+        }
+
+        std::vector<Bucket> previous(buckets);
+        previous.swap(mBuckets);
+        mMask = buckets - 1;
+
+        for (const Bucket& bucket: previous)
+        {
+            if (bucket.mSlot != NO_SLOT)
+            {
+                insertBucket(bucket.mKey, bucket.mSlot);
+            }
+        }
+    }
+
+    void destroyAll()
+    {
+        for (uint32_t slot = nextUsedSlot(0); slot != NO_SLOT; slot = nextUsedSlot(slot + 1))
+        {
+            valueAt(slot).~value_type();
+            setUsed(slot, false);
+        }
+    }
+
+    // Open-addressing index: size is a power of two, mMask == size - 1.
+    std::vector<Bucket> mBuckets;
+    size_type mMask = 0;
+
+    // Element storage.
+    std::vector<std::unique_ptr<Block>> mBlocks;
+    std::vector<uint32_t> mFreeSlots;
+    uint32_t mSlotCount = 0;
+
+    size_type mSize = 0;
+};
+
+} // namespace mega
+
+#endif // MEGA_NODE_HANDLE_MAP_H
@@ -0,0 +1,126 @@
+/**
+ * @file mega/node_skeleton.h
+ * @brief Memory-mapped snapshot of the node tree's structure
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#ifndef MEGA_NODE_SKELETON_H
+#define MEGA_NODE_SKELETON_H 1
+
+#include "types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace mega {
+
+class FileSystemAccess;
+class LocalPath;
+
+/**
+ * @brief Read-only snapshot of which node lives under which parent, and with what type.
+ *
+ * The snapshot is written next to the state cache once its contents are known to match a
+ * committed scsn. On the next session resume it is memory-mapped rather than read, so
+ * NodeManager can answer structural queries (children counts, ancestry) without touching the
+ * database and without holding the whole tree in RAM.
+ *
+ * A snapshot is only usable while it describes exactly what is in the database: it is
+ * rejected when its scsn differs from the cached one, and NodeManager drops it as soon as
+ * any node is written or removed.
+ *
+ * File layout (native byte order):
+ *   Header
+ *   Entry[count]        sorted by handle
+ *   uint32_t[count]     positions into the entries, sorted by (parent, handle)
+ */
+class MEGA_API NodeSkeleton
+{
+public:
+    struct Entry
+    {
+        uint64_t mHandle;
+        uint64_t mParentHandle;
+        int32_t mType;
+        uint32_t mReserved;
+    };
+
+    // Bump whenever the layout of Header or Entry changes.
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    ~NodeSkeleton();
+
+    NodeSkeleton(const NodeSkeleton&) = delete;
+    NodeSkeleton& operator=(const NodeSkeleton&) = delete;
+
+    // Map the snapshot at path. Returns nullptr if it is missing, malformed, corrupt or not for
+    // scsn.
+    static std::unique_ptr<NodeSkeleton> map(const LocalPath& path, handle scsn);
+
+    // Write a snapshot of entries, taken at scsn, to path. The write is atomic: the snapshot is
+    // written to a temporary file which then replaces path.
+    static bool write(FileSystemAccess& fsAccess,
+                      const LocalPath& path,
+                      handle scsn,
+                      std::vector<Entry> entries);
+
+    bool contains(NodeHandle node) const;
+
+    // Is ancestor a (strict) ancestor of node? nullopt if node is unknown.
+    std::optional<bool> isAncestor(NodeHandle node,
+                                   NodeHandle ancestor,
+                                   CancelToken cancelToken) const;
+
+    size_t numChildren(NodeHandle parent) const;
+
+    size_t numChildrenByType(NodeHandle parent, nodetype_t type) const;
+
+    std::optional<NodeHandle> parent(NodeHandle node) const;
+
+    handle scsn() const;
+
+    size_t size() const;
+
+private:
+    struct Header;
+
+    NodeSkeleton() = default;
+
+    // Are the entries ordered as documented, and mChildIndex in bounds and ordered too?
+    bool valid() const;
+
+    const Entry* find(NodeHandle node) const;
+
+    // Range of mChildIndex holding the children of parent.
+    std::pair<const uint32_t*, const uint32_t*> children(NodeHandle parent) const;
+
+    const unsigned char* mData = nullptr;
+    size_t mLength = 0;
+
+    const Header* mHeader = nullptr;
+    const Entry* mEntries = nullptr;
+    const uint32_t* mChildIndex = nullptr;
+};
+
+} // namespace mega
+
+#endif // MEGA_NODE_SKELETON_H
@@ -26,8 +26,10 @@
 #include <map>
 #include <limits>
 #include <set>
+#include <shared_mutex>
 #include <vector>
 #include "node.h"
+#include "node_skeleton.h"
 #include "types.h"
 
 namespace mega {
@@ -405,6 +407,16 @@ public:
     // and root of incoming shares. Return true if success, false if error
     bool loadNodes();
 
+    // Map the node skeleton snapshot at 'path' if it was taken at 'scsn', so structural queries
+    // can be answered without the DB until the first node changes. Return true if mapped
+    bool mapSkeleton(const LocalPath& path, handle scsn);
+
+    // Write a node skeleton snapshot of the 'nodes' table, taken at 'scsn', to 'path'
+    bool saveSkeleton(FileSystemAccess& fsAccess, const LocalPath& path, handle scsn);
+
+    // Returns how many times nodes have been written to or removed from the DB
+    uint64_t getNodeChanges() const;
+
     // Returns total of nodes in the account (cloud+inbox+rubbish AND inshares), including versions
     uint64_t getNodeCount();
 
@@ -499,19 +511,25 @@ private:
 
     MegaClient& mClient;
 
-#if defined(DEBUG)
-    using MutexType = CheckableMutex<std::recursive_mutex>;
-#else // DEBUG
-    using MutexType = std::recursive_mutex;
-#endif // ! DEBUG
+    // Writers (and reads that need the DB) take exclusive ownership of mMutex.
+    // Reads that can be served from RAM (lookups, children enumeration, counters)
+    // take shared ownership, so they don't serialize against each other.
+    using MutexType = RecursiveSharedMutex;
 
     using LockGuard = std::lock_guard<MutexType>;
+    using SharedLockGuard = std::shared_lock<MutexType>;
 
     mutable MutexType mMutex;
 
     // interface to handle accesses to "nodes" table
     DBTableNodes* mTable = nullptr;
 
+    // structural snapshot of the "nodes" table, mapped on resume and dropped upon the first change
+    std::unique_ptr<NodeSkeleton> mSkeleton;
+
+    // count of nodes written to or removed from the DB
+    uint64_t mNodeChanges = 0;
+
     // logger with rate limitting for no key
     static NoKeyLogger mNoKeyLogger;
 
@@ -547,7 +565,8 @@ private:
     };
 
     // Stores nodes that have been loaded in RAM from DB (not necessarily all of them)
-    std::map<NodeHandle, NodeManagerNode> mNodes;
+    // Element addresses are stable: Node::mNodePosition and NodeManagerNode::mChildren point into it
+    NodeHandleMap<NodeManagerNode> mNodes;
 
     uint64_t mCacheLRUMaxSize = std::numeric_limits<uint64_t>::max();
     std::list<std::shared_ptr<Node> > mCacheLRU;
@@ -564,6 +583,21 @@ private:
     std::atomic<long long> mAppliedKeyNodeCount{0};
 
     shared_ptr<Node> getNodeInRAM(NodeHandle handle);
+
+    // Read-only fast paths, called with shared ownership of mMutex. They never touch the DB
+    // nor modify the containers: when the data isn't fully available in RAM they fail and the
+    // caller retries through the exclusive (_internal) path.
+    shared_ptr<Node> getNodeInRAM_shared(NodeHandle handle);
+    bool getChildrenInRAM_shared(const Node* parent,
+                                 CancelToken cancelToken,
+                                 sharedNode_list& children);
+
+    // Readers can't reorder mCacheLRU, so they record accessed nodes here and the LRU order
+    // is updated before the next eviction.
+    void touchNodeCacheLRU_shared(NodeHandle handle);
+    void applyPendingCacheLRUTouches();
+    std::mutex mPendingCacheLRUTouchesMutex;
+    std::vector<NodeHandle> mPendingCacheLRUTouches;
     void saveNodeInRAM(std::shared_ptr<Node> node, bool isRootnode, MissingParentNodes& missingParentNodes);    // takes ownership
 
     sharedNode_vector getNodesWithSharesOrLink_internal(ShareType_t shareType);
@@ -584,8 +618,8 @@ private:
     // reads from DB and loads the node in memory
     shared_ptr<Node> unserializeNode(const string*, bool fromOldCache);
 
-    // returns the counter for the specified node, calculating it recursively and accessing to DB if it's neccesary
-    NodeCounter calculateNodeCounter(const NodeHandle &nodehandle, nodetype_t parentType, std::shared_ptr<Node> node, bool isInRubbish);
+    // calculates the counters and flags of every node in DB, in a single depth-first pass
+    void calculateNodeCounters();
 
     // Container storing FileFingerprint* (Node* in practice) ordered by fingerprint
     FingerprintContainer mFingerPrintsNoMtime;
@@ -611,7 +645,11 @@ private:
     std::shared_ptr<Node> mNodeToWriteInDb;
 
     // Stores (or updates) the node in the DB. It also tries to decrypt it for the last time before storing it.
-    void putNodeInDb(Node* node) const;
+    void putNodeInDb(Node* node);
+
+    // Called whenever nodes are written to or removed from the DB ('node' is null for removals).
+    // Drops the skeleton snapshot unless 'node' keeps its place in the tree
+    void nodesChanged_internal(const Node* node = nullptr);
 
     // true when the NodeManager has been inicialized and contains a valid filesystem
     bool mInitialized = false;
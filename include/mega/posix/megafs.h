@@ -123,7 +123,7 @@ public:
                              map<LocalPath, FSNode>& known,
                              std::vector<FSNode>& results,
                              bool followSymLinks,
-                             unsigned& nFingerprinted) override;
+                             std::vector<PendingFingerprint>& pendingFingerprints) override;
 
 #ifdef ENABLE_SYNC
     bool fsStableIDs(const LocalPath& path) const override;
@@ -235,6 +235,20 @@ public:
                             const LocalPath& rootPath,
                             Waiter* waiter) override;
 
+#ifdef USE_FANOTIFY
+    // Whether syncs added from now on try to monitor their filesystem with fanotify. Off by
+    // default, as marking a whole filesystem reports every change made on it.
+    void useFanotify(bool enable)
+    {
+        mUseFanotify = enable;
+    }
+
+    bool usingFanotify() const
+    {
+        return mUseFanotify;
+    }
+#endif // USE_FANOTIFY
+
 private:
     // Tracks which notifiers were created by this instance.
     list<DirNotify*> mNotifiers;
@@ -245,6 +259,32 @@ private:
     // Tracks which nodes are associated with what inotify handle.
     WatchMap mWatches;
 
+#ifdef USE_FANOTIFY
+    std::atomic<bool> mUseFanotify{false};
+
+    // Fanotify descriptor, for syncs on filesystems we are permitted to mark as a whole.
+    // Only opened once a sync wants to use it.
+    int mFanotifyFd = -EINVAL;
+
+    // How many notifiers have marked each filesystem, by fsid.
+    map<string, unsigned> mFanotifyMarks;
+
+    // Paths of the directories events referred to, by filesystem and handle, so that the
+    // directory of every event needn't be opened to learn its path.
+    std::unordered_map<string, string> mFanotifyDirectories;
+
+    bool openFanotify();
+
+    // Path of the directory identified by handle on the filesystem of mountFd, empty if gone.
+    string fanotifyDirectory(int mountFd,
+                             const __kernel_fsid_t& fsid,
+                             file_handle& handle,
+                             bool& failed);
+
+    // read all pending fanotify events and queue them for processing
+    int checkFanotifyEvents(PosixWaiter& waiter);
+#endif // USE_FANOTIFY
+
 #endif // ENABLE_SYNC
 }; // LinuxFileSystemAccess
 
@@ -267,12 +307,54 @@ public:
 
     void removeWatch(WatchMapIterator entry);
 
+#ifdef USE_FANOTIFY
+    // Whether a fanotify mark on the whole filesystem covers this sync, so that its directories
+    // don't need an inotify watch each.
+    bool usesFanotify() const
+    {
+        return mRootFd >= 0;
+    }
+
+    // Queue a notification if directory (an absolute path) is within this sync.
+    bool notifyFanotifyEvent(const string& directory, const char* name, uint64_t mask);
+
+    // Path of name in directory relative to root, if directory is root or below it.
+    static std::optional<string>
+        fanotifyRelativePath(const string& root, const string& directory, const char* name);
+
+    // Whether this sync's root is on the filesystem identified by fsid.
+    bool onFilesystem(const __kernel_fsid_t& fsid) const;
+
+    // Descriptor of the sync's root, also used to open the directories that events refer to.
+    int rootDescriptor() const
+    {
+        return mRootFd;
+    }
+#endif // USE_FANOTIFY
+
 private:
     // The LFSA that we are associated with.
     LinuxFileSystemAccess& mOwner;
 
     // Our position in our owner's mNotifiers list.
     list<DirNotify*>::iterator mNotifiersIt;
+
+#ifdef USE_FANOTIFY
+    // Try to monitor the filesystem of rootPath with fanotify.
+    bool addFanotifyMark(const LocalPath& rootPath);
+
+    // Identifies our filesystem's mark in our owner's mFanotifyMarks.
+    string fanotifyMarkKey() const;
+
+    // The sync's root node, which notifications are relative to.
+    LocalNode* mRoot = nullptr;
+
+    int mRootFd = -1;
+    fsid_t mRootFsid{};
+
+    // The root's canonical path, as the kernel reports directories.
+    string mRootPath;
+#endif // USE_FANOTIFY
 }; // LinuxDirNotify
 
 #endif // ENABLE_SYNC
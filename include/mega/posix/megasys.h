@@ -110,6 +110,16 @@
 
 #ifdef USE_INOTIFY
     #include <sys/inotify.h>
+
+    // fanotify can monitor a whole filesystem at once, but apps can't use it on Android
+    #ifndef __ANDROID__
+        #include <sys/fanotify.h>
+
+        // Directory and name reporting needs Linux 5.9+ headers
+        #ifdef FAN_REPORT_DFID_NAME
+            #define USE_FANOTIFY 1
+        #endif
+    #endif
 #endif
 
 #include <sys/select.h>
@@ -163,6 +163,12 @@ public:
         // returns how far we are through the file on average, including uncombined data
         m_off_t progress() const;
 
+        // buffers for the download requests and the combined output, recycled once written
+        HttpBufferPool& bufferPool();
+
+        // bytes copied to combine the raid parts (and hold over the data past a chunk boundary)
+        m_off_t copiedBytes() const;
+
         RaidBufferManager();
         ~RaidBufferManager();
 
@@ -227,12 +233,15 @@ public:
         // For test hooks, disable avoid small requests when we need a lower speed and trigger 404/403/timeout errors
         bool mDisableAvoidSmallLastRequest;
 
+        HttpBufferPool mBufferPool;
+        m_off_t mCopiedBytes = 0;
+
         // take raid input part buffers and combine to form the asyncoutputbuffers
         void combineRaidParts(unsigned connectionNum);
         FilePiece* combineRaidParts(size_t partslen, size_t bufflen, m_off_t filepos, FilePiece& prevleftoverchunk);
-        void recoverSectorFromParity(byte* dest, byte* inputbufs[], unsigned offset);
         void combineLastRaidLine(byte* dest, size_t nbytes);
         void rollInputBuffers(size_t dataToDiscard);
+        void recycle(FilePiece& piece);
         virtual void bufferWriteCompletedAction(FilePiece& r);
 
         // decrypt and mac downloaded chunk.  virtual so Transfer and DirectNode derivations can be different
@@ -327,6 +336,7 @@ private:
         uint8_t getUnusedRaidConnection() const;
         m_off_t transferred(const std::shared_ptr<HttpReqXfer>& req) const;
         bool processRequestLatency(const std::shared_ptr<HttpReqXfer>& req);
+        bool addCopiedBytes(m_off_t bytes);
 
         /* RaidProxy functionality for TransferSlot */
         bool init(TransferSlot* tslot, MegaClient* client, int connections);
@@ -0,0 +1,67 @@
+/**
+ * @file mega/raid_kernels.h
+ * @brief Vectorized routines to combine the parts of cloudraid files
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#ifndef MEGA_RAID_KERNELS_H
+#define MEGA_RAID_KERNELS_H 1
+
+#include "raid.h"
+
+#include <vector>
+
+namespace mega {
+
+/**
+ * @brief Set of routines that move and XOR the RAIDSECTORs of cloudraid files.
+ *
+ * A raid file is stored as EFFECTIVE_RAIDPARTS data parts plus a parity part. Each RAIDLINE of
+ * the file takes one RAIDSECTOR from each data part, and the parity part holds the XOR of them.
+ *
+ * There is one implementation per instruction set (AVX2, SSE2, NEON) plus a portable one, and the
+ * best one supported by the CPU is chosen at runtime. None of them require aligned buffers.
+ */
+struct MEGA_API RaidKernels
+{
+    const char* name;
+
+    // dest = sources[0] ^ sources[1] ^ ... ^ sources[numSources - 1], 'len' bytes
+    void (*xorParts)(byte* dest, const byte* const sources[], unsigned numSources, size_t len);
+
+    // Builds 'numLines' RAIDLINEs in 'dest' taking their n-th sector from parts[n]
+    void (*interleaveLines)(byte* dest,
+                            const byte* const parts[EFFECTIVE_RAIDPARTS],
+                            size_t numLines);
+
+    // Copies 'numSectors' consecutive sectors of 'part' to one RAIDLINE each, starting at 'lines'
+    void (*scatterPart)(byte* lines, const byte* part, size_t numSectors);
+
+    // Rebuilds sector 'missing' of 'numLines' RAIDLINEs from the others and their 'parity' sectors
+    void (*recoverLines)(byte* lines, const byte* parity, unsigned missing, size_t numLines);
+
+    // Implementations supported by this CPU, the best first. The last one is the portable one.
+    static const std::vector<const RaidKernels*>& supported();
+
+    // Best implementation for this CPU
+    static const RaidKernels& get();
+};
+
+} // namespace
+
+#endif
@@ -85,6 +85,7 @@ class PartFetcher
     void setposrem();                                         // sets the next read position (pos) and the remaining read length (rem/remfeed)
     bool setremfeed(m_off_t);                                 // sets the remfeed depending on the number of bytes param and the remaining (rem) part data
     int64_t onFailure(); // Handle request failures
+    void recycleInbuf(); // give the processed input buffer back to the HttpReq, to receive the next piece
     m_off_t getSocketSpeed() const;                           // Get part throughput in bytes per millisec
 
 public:
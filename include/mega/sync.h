@@ -263,6 +263,15 @@ struct PerSyncStats
     int32_t numUploads = 0;
     int32_t numDownloads = 0;
 
+    // Scan throughput so far. Not compared, so the app is only notified of changes in the above.
+    double scannedEntriesPerSecond = 0;
+    double fingerprintedBytesPerSecond = 0;
+
+    // Milliseconds from detecting a change to having acted on it, for the latest change and the
+    // worst one so far. Not compared either.
+    int64_t lastChangeLatencyMs = 0;
+    int64_t maxChangeLatencyMs = 0;
+
     bool operator==(const PerSyncStats&);
     bool operator!=(const PerSyncStats&);
 };
@@ -530,6 +539,99 @@ public:
     }
 };
 
+// A LocalNode's row in a sync's state cache, as loaded by Sync::readstatecache.
+struct SyncStateCacheRow
+{
+    uint32_t id = 0;
+    uint32_t parentID = 0;
+
+    // Encrypted until decoded.
+    string data;
+
+    bool decrypted = false;
+    bool unserialized = false;
+
+    // Moved into the LocalNode created for the row, which is what gets serialized.
+    struct Core: LocalNodeCore
+    {
+        bool serialize(string*) const override
+        {
+            return false;
+        }
+    } core;
+};
+
+// Decrypt and unserialize rows in the worker threads of queue, and wait until all are done.
+// Only LocalNodeCore is built there: LocalNodes must be created on the sync thread.
+// Returns how many rows can be loaded: as DbTable::next(), loading stops at the first row that
+// can't be decrypted.
+size_t decodeSyncStateCacheRows(MegaClientAsyncQueue& queue,
+                              const SymmCipher& key,
+                              std::vector<SyncStateCacheRow>& rows);
+
+// Order (parent dbid, node) pairs so that stateCacheChildren() can find a parent's children.
+// Rows come in dbid order. The sort is stable to keep it among siblings, so duplicates from
+// prior versions of the SDK still resolve to the later entry.
+template<class Node>
+void sortStateCacheNodes(std::vector<std::pair<uint32_t, Node>>& nodes)
+{
+    std::stable_sort(nodes.begin(),
+                     nodes.end(),
+                     [](const std::pair<uint32_t, Node>& lhs, const std::pair<uint32_t, Node>& rhs)
+                     {
+                         return lhs.first < rhs.first;
+                     });
+}
+
+// The children of parentID in nodes sorted by sortStateCacheNodes().
+template<class Node>
+auto stateCacheChildren(std::vector<std::pair<uint32_t, Node>>& nodes, uint32_t parentID)
+{
+    return std::equal_range(nodes.begin(),
+                            nodes.end(),
+                            std::pair<uint32_t, Node>(parentID, Node{}),
+                            [](const std::pair<uint32_t, Node>& lhs,
+                               const std::pair<uint32_t, Node>& rhs)
+                            {
+                                return lhs.first < rhs.first;
+                            });
+}
+
+// Attach the children of parentID in nodes, sorted by sortStateCacheNodes(), depth first and down
+// to maxdepth levels, as Sync::readstatecache builds the LocalNode tree. Each node is attached at
+// most once and is nulled in nodes when it is: whatever isn't null afterwards is an orphan.
+//
+// tree.duplicate(parent, node) returns a child of parent already attached with node's name, if
+// prior versions of the SDK left one. It's removed with tree.remove(): the later entry is the one
+// they used. tree.attach(parent, node) returns the context in which node's children are attached,
+// and tree.id(node) is the id node's children have as their parentID.
+template<class Node, class Context, class Tree>
+void attachStateCacheChildren(std::vector<std::pair<uint32_t, Node*>>& nodes,
+                              uint32_t parentID,
+                              const Context& parent,
+                              int maxdepth,
+                              Tree& tree)
+{
+    auto range = stateCacheChildren(nodes, parentID);
+
+    for (auto i = range.first; i != range.second; ++i)
+    {
+        auto* node = std::exchange(i->second, nullptr);
+
+        // already attached further up the recursion
+        if (!node)
+            continue;
+
+        if (auto* duplicate = tree.duplicate(parent, *node))
+            tree.remove(*duplicate);
+
+        auto children = tree.attach(parent, *node);
+
+        if (maxdepth)
+            attachStateCacheChildren(nodes, tree.id(*node), children, maxdepth - 1, tree);
+    }
+}
+
 class MEGA_API Sync
 {
 public:
@@ -574,8 +676,9 @@ public:
     // adds an entry to the insert queue - removes it from deleteq
     void statecacheadd(LocalNode*);
 
-    // recursively add children
-    void addstatecachechildren(uint32_t, idlocalnode_map*, LocalPath&, LocalNode*, int);
+    // recursively add children, from nodes sorted by parent dbid
+    using StateCacheNodes = vector<std::pair<uint32_t, LocalNode*>>;
+    void addstatecachechildren(uint32_t, StateCacheNodes&, const LocalPath&, LocalNode*, int);
 
     // Caches all synchronized LocalNode
     void cachenodes();
@@ -759,6 +862,30 @@ public:
     // triggering rescans of their target folder
     std::shared_ptr<ScanService::ScanRequest> mActiveScanRequestUnscanned;
 
+    // Totals of the scans completed by this sync, to report its scan throughput.
+    ScanService::ScanRequest::Stats mScanStats;
+
+    // When the oldest change not yet acted upon was detected, if there is one.
+    std::optional<std::chrono::steady_clock::time_point> mFirstPendingChange;
+
+    // How long it took from detecting changes to acting on them: last time, and at worst.
+    std::chrono::milliseconds mLastChangeLatency{0};
+    std::chrono::milliseconds mMaxChangeLatency{0};
+
+    // Record that a change was detected at detectedDs (0 for now).
+    void changeDetected(dstime detectedDs);
+
+    // Record that a pass has acted on every change detected so far.
+    void changesHandled();
+
+    // When recursiveSync must yield to the other syncs, if the passes are time sliced.
+    std::optional<std::chrono::steady_clock::time_point> mRecurseTimeSliceEnd;
+
+    // Whether the last recursiveSync pass yielded because its time slice ran out.
+    bool mRecurseYielded = false;
+
+    bool recurseTimeSliceExpired();
+
     static const int SCANNING_DELAY_DS;
     static const int EXTRA_SCANNING_DELAY_DS;
     static const int FILE_UPDATE_DELAY_DS;
@@ -1805,6 +1932,15 @@ public:
     shared_ptr<Waiter> waiter;
     std::atomic<bool> skipWait = false;
 
+    // Limit how long one sync's recursiveSync pass can run before the other syncs get theirs.
+    // Zero (the default) lets every pass run to completion.
+    void setRecurseTimeSlice(unsigned milliseconds);
+    unsigned recurseTimeSlice() const;
+
+    // Whether syncs added from now on may be monitored with fanotify filesystem marks (Linux).
+    void useFanotify(bool enable);
+    bool usingFanotify() const;
+
     // These rules are used to generate ignore files for newly added syncs.
     DefaultFilterChain mNewSyncFilterChain;
 
@@ -2101,6 +2237,12 @@ private:
     // Track some state during and between recursiveSync runs
     unique_ptr<SyncFlags> mSyncFlags;
 
+    // Maximum milliseconds per recursiveSync pass of a sync, 0 for unlimited.
+    std::atomic<unsigned> mRecurseTimeSliceMs{0};
+
+    // Which sync gets its recursiveSync pass first, when passes are time sliced.
+    size_t mFirstSyncToRecurse = 0;
+
     // This user's internal sync configuration store.
     unique_ptr<SyncConfigStore> mSyncConfigStore;
 
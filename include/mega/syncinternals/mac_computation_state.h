@@ -25,6 +25,7 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <optional>
 #include <string>
@@ -63,7 +64,11 @@ struct MacComputationContext
  * @brief State for asynchronous local file MAC computation.
  *
  * Tracks progress of incremental MAC computation across sync iterations.
- * Thread-safe: sync thread reads/writes, worker thread (mAsyncQueue) computes.
+ * Thread-safe: sync thread reads/writes, worker threads (mAsyncQueue) read and compute.
+ *
+ * The file is split in ranges of BUFFER_SIZE bytes on chunk boundaries. Their chunk MACs are
+ * independent until macsmac, so up to MAX_RANGES_IN_FLIGHT ranges are queued at once: while a
+ * worker computes the MACs of one range, others are reading the next ones.
  *
  * Lifetime management:
  * - Owner (LocalNode::RareFields or SyncUpload_inClient) holds shared_ptr
@@ -83,18 +88,25 @@ struct MacComputationState
     std::array<byte, SymmCipher::KEYLENGTH> transferkey{};
     int64_t ctriv = 0;
 
-    // Progress tracking
-    m_off_t currentPosition = 0;
+    // Start of the next range to queue (sync thread only)
+    m_off_t nextRangeStart = 0;
+
+    // When the first range was queued (sync thread only)
+    std::chrono::steady_clock::time_point startTime;
 
-    // Accumulated chunk MACs - protected by mutex
+    // Accumulated chunk MACs and bytes processed - protected by mutex
     mutable std::mutex macsMutex;
     chunkmac_map partialMacs;
+    m_off_t bytesProcessed = 0;
 
-    // Buffer size for reading chunks (10MB)
+    // Buffer size for reading ranges (10MB)
     static constexpr m_off_t BUFFER_SIZE = 10 * 1024 * 1024;
 
+    // Ranges queued at once per file
+    static constexpr unsigned MAX_RANGES_IN_FLIGHT = 4;
+
     // State flags (atomic for thread safety)
-    std::atomic<bool> chunkInProgress{false}; // True while worker processing
+    std::atomic<unsigned> rangesInFlight{0}; // Ranges queued or being processed by workers
     std::atomic<bool> completed{false}; // True when local MAC computed
     std::atomic<bool> failed{false}; // True if read/compute error
 
@@ -109,6 +121,9 @@ struct MacComputationState
     // Result - the computed local file MAC (valid after completed=true)
     int64_t localMac{INVALID_META_MAC};
 
+    // Time taken to compute localMac (valid after completed=true)
+    std::chrono::steady_clock::duration elapsed{};
+
     // Optional context for CSF case validation
     // Not used for clone candidates (they use upload object lifetime)
     std::optional<MacComputationContext> context;
@@ -128,13 +143,16 @@ struct MacComputationState
     ~MacComputationState();
 
     /**
-     * @brief Thread-safe: called by worker thread when chunk MAC is computed.
+     * @brief Thread-safe: called by worker thread when the chunk MACs of a range are computed.
+     *
+     * @return true if that range was the last one, so all the file has been processed.
      */
-    void addChunkMacs(chunkmac_map&& chunkMacs, m_off_t newPosition)
+    bool addChunkMacs(chunkmac_map&& chunkMacs, m_off_t rangeSize)
     {
         std::lock_guard<std::mutex> g(macsMutex);
         chunkMacs.copyEntriesTo(partialMacs);
-        currentPosition = newPosition;
+        bytesProcessed += rangeSize;
+        return bytesProcessed == totalSize;
     }
 
     /**
@@ -143,7 +161,7 @@ struct MacComputationState
     void setComplete(const int64_t computedLocalMac)
     {
         localMac = computedLocalMac;
-        chunkInProgress.store(false, std::memory_order_release);
+        elapsed = std::chrono::steady_clock::now() - startTime;
         completed.store(true, std::memory_order_release);
     }
 
@@ -152,16 +170,16 @@ struct MacComputationState
      */
     void setFailed()
     {
-        chunkInProgress.store(false, std::memory_order_release);
         failed.store(true, std::memory_order_release);
     }
 
     /**
-     * @brief Thread-safe: check if a chunk is currently being processed.
+     * @brief Thread-safe: check if another range can be queued.
      */
-    bool isChunkInProgress() const
+    bool canQueueRange() const
     {
-        return chunkInProgress.load(std::memory_order_acquire);
+        return nextRangeStart < totalSize &&
+               rangesInFlight.load(std::memory_order_acquire) < MAX_RANGES_IN_FLIGHT;
     }
 
     /**
@@ -516,7 +516,10 @@ constexpr uint32_t kDefaultMaxConcurrentMacComputations = 8;
  * Prevents the sync engine from overwhelming the system with too many
  * simultaneous MAC calculations.
  *
- * We track FILES only (one chunk at a time per file).
+ * We track FILES only. Each of them has up to MacComputationState::MAX_RANGES_IN_FLIGHT
+ * ranges of 10MB in flight, read with blocking I/O by the threads of the client's shared
+ * mAsyncQueue: the limit bounds both the memory buffered and how much of that queue MAC
+ * computations can take from other work.
  *
  * Usage:
  * - Call tryAcquireFile() before starting MAC computation for a new file
@@ -627,6 +630,34 @@ FsCloudComparisonResult syncEqualFsCloudExcludingMtimeAsync(MegaClient& mc,
                                                             const LocalPath& fsNodeFullPath,
                                                             LocalNode& syncNode);
 
+/**
+ * @brief Result of advanceMacComputation.
+ */
+enum class MacAdvanceResult
+{
+    Pending, // Ranges queued or in progress
+    Ready, // Local MAC is computed (check state->localMac)
+    Failed // Error occurred
+};
+
+/**
+ * @brief Advance local file MAC computation, keeping its pipeline of ranges full.
+ *
+ * This is the shared core for both CSF and clone candidate MAC computation.
+ * It queues the next ranges of the file to the worker threads, which read them and compute
+ * their MACs, until MacComputationState::MAX_RANGES_IN_FLIGHT are in progress.
+ *
+ * @param mc MegaClient for file access and async queue.
+ * @param state The MAC computation state (must have cipher params initialized).
+ *              Passed by value to ensure the state stays alive during the function,
+ *              even if another thread resets the original shared_ptr.
+ * @param logPrefix Prefix for log messages.
+ * @return MacAdvanceResult indicating current state.
+ */
+MacAdvanceResult advanceMacComputation(MegaClient& mc,
+                                       std::shared_ptr<MacComputationState> state,
+                                       const std::string& logPrefix);
+
 /***********************************\
 *  CLONE CANDIDATE MAC COMPUTATION  *
 \***********************************/
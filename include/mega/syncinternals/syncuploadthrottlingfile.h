@@ -32,17 +32,20 @@ private:
      */
     unsigned mUploadCounter{};
 
-    /**
-     * @brief Timestamp of the last time the upload counter was processed.
-     */
-    std::chrono::steady_clock::time_point mUploadCounterLastTime{std::chrono::steady_clock::now()};
-
     /**
      * @brief Flag to bypass throttling logic.
      * This is meant for uncomplete uploads that were cancelled due to a change or failure.
+     *
+     * Declared next to mUploadCounter so both share one word: there is one of these per
+     * LocalNode.
      */
     bool mBypassThrottlingNextTime{};
 
+    /**
+     * @brief Timestamp of the last time the upload counter was processed.
+     */
+    std::chrono::steady_clock::time_point mUploadCounterLastTime{std::chrono::steady_clock::now()};
+
 public:
     /**
      * @brief Gets the mUploadCounter.
@@ -55,6 +55,15 @@ struct TransferSlotStats
     double mTotalStartTransferTime{};
     double mTotalConnectTime{};
     m_off_t mNumRequestsWithCalculatedLatency{};
+    // Bytes of downloaded data copied from one buffer to another (from the network included)
+    m_off_t mNumBytesCopied{};
+    // Upload pipeline: time (ms) the chunks spent being read from the file, waiting for a worker
+    // thread, being encrypted and being sent
+    m_off_t mNumUploadedChunks{};
+    double mTotalReadTime{};
+    double mTotalEncryptQueueTime{};
+    double mTotalEncryptTime{};
+    double mTotalSendTime{};
 
     // Ratio between failed requests and total requests.
     double failedRequestRatio() const;
@@ -65,6 +74,14 @@ struct TransferSlotStats
     // Includes DNS resolution, TCP handshake,
     // SSL handshake, server-side processing.
     double averageStartTransferTime() const;
+    // Average time (ms) an uploaded chunk spent in a stage of the pipeline, given its total
+    double averageUploadStageTime(double totalStageTime) const;
+    // Add the time (ms) an uploaded chunk spent in each stage of the pipeline, also published to
+    // the CodeCounter registry for MegaApi::getMetrics
+    void addUploadedChunk(double readTime,
+                          double encryptQueueTime,
+                          double encryptTime,
+                          double sendTime);
 };
 } // namespace stats
 
@@ -149,6 +166,13 @@ struct MEGA_API TransferSlot
     // Prepare an HTTP request
     void prepareRequest(const std::shared_ptr<HttpReqXfer>&, const string& tempURL, m_off_t pos, m_off_t npos);
 
+    // Encrypt and mac the chunk read for an upload request in a worker thread. The request
+    // becomes REQ_PREPARED once it's done.
+    void encryptUploadChunk(unsigned connection, m_off_t pos, m_off_t npos);
+
+    // Add the time spent by an uploaded chunk in each stage of the pipeline to tsStats
+    void processUploadStagesTime(HttpReqUL& req);
+
     // Process HTTP POST
     void processRequestPost(MegaClient* client, const std::shared_ptr<HttpReqXfer>&);
 
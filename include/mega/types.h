@@ -63,10 +63,12 @@ namespace mega {
 #include "megacrypto.h"
 #endif
 
+#include "mega/code_counter.h"
 #include "mega/crypto/sodium.h"
 #include "mega/user_attribute_types.h"
 
 #include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -928,109 +930,6 @@ enum NetworkActivityType : int
     REQUEST_ERROR,
 };
 
-//#define MEGA_MEASURE_CODE   // uncomment this to track time spent in major subsystems, and log it every 2 minutes, with extra control from megacli
-
-namespace CodeCounter
-{
-    // Some classes that allow us to easily measure the number of times a block of code is called, and the sum of the time it takes.
-    // Only enabled if MEGA_MEASURE_CODE is turned on.
-    // Usage generally doesn't need to be protected by the macro as the classes and methods will be empty when not enabled.
-
-    using namespace std::chrono;
-
-    struct ScopeStats
-    {
-#ifdef MEGA_MEASURE_CODE
-        uint64_t count = 0;
-        uint64_t starts = 0;
-        uint64_t finishes = 0;
-        high_resolution_clock::duration timeSpent{};
-        high_resolution_clock::duration longest{};
-        std::string name;
-        ScopeStats(std::string s) : name(std::move(s)) {}
-
-        inline string report(bool reset = false)
-        {
-            string s = " " + name + ": " + std::to_string(count) + " " +
-                    std::to_string(duration_cast<milliseconds>(timeSpent).count()) + " " +
-                    std::to_string(duration_cast<milliseconds>(longest).count());
-            if (reset)
-            {
-                count = 0;
-                starts -= finishes;
-                finishes = 0;
-                timeSpent = high_resolution_clock::duration{};
-                longest = high_resolution_clock::duration{};
-            }
-            return s;
-        }
-#else
-        ScopeStats(std::string) {}
-#endif
-    };
-
-    struct DurationSum
-    {
-#ifdef MEGA_MEASURE_CODE
-        high_resolution_clock::duration sum{ 0 };
-        high_resolution_clock::time_point deltaStart;
-        bool started = false;
-        inline void start(bool b = true) { if (b && !started) { deltaStart = high_resolution_clock::now(); started = true; }  }
-        inline void stop(bool b = true) { if (b && started) { sum += high_resolution_clock::now() - deltaStart; started = false; } }
-        inline bool inprogress() { return started; }
-        inline string report(bool reset = false)
-        {
-            string s = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(sum).count());
-            if (reset) sum = high_resolution_clock::duration{ 0 };
-            return s;
-        }
-#else
-        inline void start(bool = true) {  }
-        inline void stop(bool = true) {  }
-#endif
-    };
-
-    struct ScopeTimer
-    {
-#ifdef MEGA_MEASURE_CODE
-        ScopeStats& scope;
-        high_resolution_clock::time_point blockStart;
-        high_resolution_clock::duration diff{};
-        bool done = false;
-
-        ScopeTimer(ScopeStats& sm) : scope(sm), blockStart(high_resolution_clock::now())
-        {
-            ++scope.starts;
-        }
-        ~ScopeTimer()
-        {
-            complete();
-        }
-        high_resolution_clock::duration timeSpent()
-        {
-            return high_resolution_clock::now() - blockStart;
-        }
-        void complete()
-        {
-            // can be called early in which case the destructor's call is ignored
-            if (!done)
-            {
-                ++scope.count;
-                ++scope.finishes;
-                diff = high_resolution_clock::now() - blockStart;
-                scope.timeSpent += diff;
-                if (diff > scope.longest) scope.longest = diff;
-                done = true;
-            }
-        }
-#else
-        ScopeTimer(ScopeStats&) {}
-        void complete() {}
-#endif
-    };
-}
-
-
 // Hold the status of a status variable
 class CacheableStatus : public Cacheable
 {
@@ -1561,6 +1460,208 @@ static constexpr size_t MAX_FILE_ATTRIBUTE_SIZE = 16 * 1024 * 1024; // 16MB
 
 using detail::CheckableMutex;
 
+// Reader/writer mutex where both kinds of ownership are recursive.
+//
+// - A thread holding exclusive ownership may lock it again, exclusively or shared.
+//   Nested shared locks taken by the writer count as exclusive recursion.
+// - A thread holding shared ownership may lock it shared again without blocking,
+//   even if a writer is waiting.
+// - Upgrading shared ownership to exclusive is not supported (it would deadlock).
+//
+// New readers wait while a writer is waiting, so writers are not starved.
+class RecursiveSharedMutex
+{
+    // Serializes access to instance members.
+    mutable std::mutex mLock;
+
+    // Signalled when the mutex may have become available.
+    std::condition_variable mCV;
+
+    // Thread owning exclusive ownership and how many times it has locked the mutex.
+    std::thread::id mWriter;
+    std::uint32_t mWriterCount = 0;
+
+    // How many writers are waiting to acquire the mutex.
+    std::uint32_t mWritersWaiting = 0;
+
+    // Threads holding shared ownership and their recursion count.
+    // Usually very few threads, so a vector beats any associative container.
+    std::vector<std::pair<std::thread::id, std::uint32_t>> mReaders;
+
+    std::vector<std::pair<std::thread::id, std::uint32_t>>::iterator findReader(std::thread::id id)
+    {
+        auto i = mReaders.begin();
+        while (i != mReaders.end() && i->first != id)
+            ++i;
+        return i;
+    }
+
+public:
+    RecursiveSharedMutex() = default;
+
+    RecursiveSharedMutex(const RecursiveSharedMutex& other) = delete;
+
+    RecursiveSharedMutex& operator=(const RecursiveSharedMutex& rhs) = delete;
+
+    void lock()
+    {
+        auto id = std::this_thread::get_id();
+
+        std::unique_lock<std::mutex> guard(mLock);
+
+        if (mWriter == id)
+        {
+            ++mWriterCount;
+            return;
+        }
+
+        assert(findReader(id) == mReaders.end() && "Shared to exclusive upgrade would deadlock");
+
+        ++mWritersWaiting;
+        mCV.wait(guard, [this]() { return !mWriterCount && mReaders.empty(); });
+        --mWritersWaiting;
+
+        mWriter = id;
+        mWriterCount = 1;
+    }
+
+    bool try_lock()
+    {
+        auto id = std::this_thread::get_id();
+
+        std::lock_guard<std::mutex> guard(mLock);
+
+        if (mWriter != id && (mWriterCount || !mReaders.empty()))
+            return false;
+
+        mWriter = id;
+        ++mWriterCount;
+
+        return true;
+    }
+
+    void unlock()
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+
+        assert(mWriterCount);
+        assert(mWriter == std::this_thread::get_id());
+
+        if (--mWriterCount)
+            return;
+
+        mWriter = std::thread::id();
+        mCV.notify_all();
+    }
+
+    void lock_shared()
+    {
+        auto id = std::this_thread::get_id();
+
+        std::unique_lock<std::mutex> guard(mLock);
+
+        if (mWriter == id)
+        {
+            ++mWriterCount;
+            return;
+        }
+
+        if (auto i = findReader(id); i != mReaders.end())
+        {
+            ++i->second;
+            return;
+        }
+
+        mCV.wait(guard, [this]() { return !mWriterCount && !mWritersWaiting; });
+
+        mReaders.emplace_back(id, 1);
+    }
+
+    bool try_lock_shared()
+    {
+        auto id = std::this_thread::get_id();
+
+        std::lock_guard<std::mutex> guard(mLock);
+
+        if (mWriter == id)
+        {
+            ++mWriterCount;
+            return true;
+        }
+
+        if (auto i = findReader(id); i != mReaders.end())
+        {
+            ++i->second;
+            return true;
+        }
+
+        if (mWriterCount || mWritersWaiting)
+            return false;
+
+        mReaders.emplace_back(id, 1);
+
+        return true;
+    }
+
+    void unlock_shared()
+    {
+        auto id = std::this_thread::get_id();
+
+        std::lock_guard<std::mutex> guard(mLock);
+
+        if (mWriter == id)
+        {
+            assert(mWriterCount);
+
+            if (--mWriterCount)
+                return;
+
+            mWriter = std::thread::id();
+            mCV.notify_all();
+            return;
+        }
+
+        auto i = findReader(id);
+
+        assert(i != mReaders.end());
+
+        if (--i->second)
+            return;
+
+        mReaders.erase(i);
+
+        if (mReaders.empty())
+            mCV.notify_all();
+    }
+
+    // True if this thread has exclusive ownership.
+    bool owns_lock() const
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+
+        return mWriterCount && mWriter == std::this_thread::get_id();
+    }
+
+    // True if this thread has shared or exclusive ownership.
+    bool owns_shared_lock() const
+    {
+        auto id = std::this_thread::get_id();
+
+        std::lock_guard<std::mutex> guard(mLock);
+
+        if (mWriterCount && mWriter == id)
+            return true;
+
+        for (auto& reader: mReaders)
+        {
+            if (reader.first == id)
+                return true;
+        }
+
+        return false;
+    }
+}; // RecursiveSharedMutex
+
 // For convenience.
 #ifdef USE_IOS
 
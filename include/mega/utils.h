@@ -27,10 +27,12 @@
 #include <algorithm>
 #include <charconv>
 #include <condition_variable>
+#include <limits>
 #include <mutex>
 #include <shared_mutex>
 #include <thread>
 #include <type_traits>
+#include <vector>
 #undef SSIZE_MAX
 #include "mega/mega_utf8proc.h"
 #undef SSIZE_MAX
@@ -489,7 +491,94 @@ class chunkmac_map
         bool isMacsmacSoFar() { return finished && offset == unsigned(-1); }
     };
 
-    map<m_off_t, ChunkMAC> mMacMap;
+    // Chunk boundaries only depend on the position (see ChunkedHash), so the entries are stored by
+    // chunk number instead of in a tree keyed by position: slot i is chunk mFirstChunk + i, and
+    // mPresent tells which slots hold an entry. Slots before mBegin are unused, so that collapsing
+    // the leading entries doesn't move the others every time.
+    // Every slot between the lowest and the highest entry is allocated, even without an entry: a
+    // sparse map costs one ChunkMAC per MB of the range it spans (about 24 MB for a 1 TB range).
+    // Transfers add entries mostly in order and collapse the leading ones, so the range stays
+    // close to the chunks in progress.
+    std::vector<ChunkMAC> mMacs;
+    std::vector<bool> mPresent;
+    size_t mFirstChunk = 0;
+    size_t mBegin = 0;
+    size_t mCount = 0;
+
+    static constexpr size_t NOT_A_CHUNK = std::numeric_limits<size_t>::max();
+
+    // Chunk number of the chunk starting at 'pos', or NOT_A_CHUNK if no chunk starts there
+    static size_t chunkNumber(m_off_t pos);
+    static m_off_t chunkPos(size_t chunk);
+
+    // First slot holding an entry from 'slot' on, or mMacs.size() if none
+    size_t nextSlot(size_t slot) const;
+
+    ChunkMAC* find(m_off_t pos);
+
+    // Entry of the chunk starting at 'pos', added if it doesn't exist.
+    // If no chunk starts at 'pos', the error is logged and a scratch entry, not kept in the map,
+    // is returned.
+    ChunkMAC& get(m_off_t pos);
+
+    void eraseFirst();
+
+    // Iterates the entries in order of position, as pairs (position, ChunkMAC)
+    template<typename Map, typename Mac>
+    class Iterator
+    {
+    public:
+        struct Entry
+        {
+            m_off_t first;
+            Mac& second;
+        };
+
+        Iterator(Map& map, size_t slot):
+            mMap(map),
+            mSlot(map.nextSlot(slot))
+        {}
+
+        Entry operator*() const
+        {
+            return {chunkPos(mMap.mFirstChunk + mSlot), mMap.mMacs[mSlot]};
+        }
+
+        Iterator& operator++()
+        {
+            mSlot = mMap.nextSlot(mSlot + 1);
+            return *this;
+        }
+
+        bool operator!=(const Iterator& other) const
+        {
+            return mSlot != other.mSlot;
+        }
+
+    private:
+        Map& mMap;
+        size_t mSlot;
+    };
+
+    Iterator<chunkmac_map, ChunkMAC> begin()
+    {
+        return {*this, mBegin};
+    }
+
+    Iterator<chunkmac_map, ChunkMAC> end()
+    {
+        return {*this, mMacs.size()};
+    }
+
+    Iterator<const chunkmac_map, const ChunkMAC> begin() const
+    {
+        return {*this, mBegin};
+    }
+
+    Iterator<const chunkmac_map, const ChunkMAC> end() const
+    {
+        return {*this, mMacs.size()};
+    }
 
     // we collapse the leading consecutive entries, for large files.
     // this is the map key for how far that collapsing has progressed
@@ -522,11 +611,15 @@ public:
 
     size_t size() const
     {
-        return mMacMap.size();
+        return mCount;
     }
     void clear()
     {
-        mMacMap.clear();
+        mMacs.clear();
+        mPresent.clear();
+        mFirstChunk = 0;
+        mBegin = 0;
+        mCount = 0;
         macsmacSoFarPos = -1;
         setProgressContiguous(0);
     }
@@ -754,6 +847,12 @@ struct MegaClientAsyncQueue
     void push(std::function<void(SymmCipher&)> f, bool discardable);
     void clearDiscardable();
 
+    // Run f over [0, count) in ranges of at most rangeSize indexes, spread over the threads, and
+    // wait until all of them are done.  The ranges run on the caller's thread if there are none.
+    void forEachRange(size_t count,
+                      size_t rangeSize,
+                      const std::function<void(size_t first, size_t last, SymmCipher&)>& f);
+
     MegaClientAsyncQueue(Waiter& w, unsigned threadCount);
     ~MegaClientAsyncQueue();
 
@@ -1111,6 +1210,9 @@ bool platformSetRLimitNumFile(int newNumFileLimit = -1);
 
 void debugLogHeapUsage();
 
+// peak resident memory of the process in bytes, or 0 if it's not available on this platform
+uint64_t platformGetPeakMemoryUsage();
+
 bool haveDuplicatedValues(const string_map& readableVals, const string_map& b64Vals);
 
 struct SyncTransferCount
@@ -1296,6 +1398,20 @@ bool likeCompare(const char* pattern,
                  const UChar32 esc = static_cast<UChar32>(ESCAPE_CHARACTER),
                  const bool stripAccents = true);
 
+/*
+ * Fold case (and optionally strip accents) of every code point of a UTF-8 string.
+ *
+ * Code points are folded one by one, exactly as likeCompare compares them, so if a
+ * pattern without wild cards matches part of a string, the folded pattern is a
+ * substring of the folded string.
+ *
+ * @param str the UTF-8 string to fold
+ * @param stripAccents True if accents should be stripped.
+ *
+ * @return the folded string
+ */
+std::string foldCaseAccent(const char* str, const bool stripAccents = true);
+
 // Get the current process ID
 unsigned long getCurrentPid();
 
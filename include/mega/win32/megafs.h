@@ -94,7 +94,8 @@ public:
     static void emptydirlocal(const LocalPath&, dev_t = 0);
 
     ScanResult directoryScan(const LocalPath& path, handle expectedFsid,
-        map<LocalPath, FSNode>& known, std::vector<FSNode>& results, bool followSymlinks, unsigned& nFingerprinted) override;
+        map<LocalPath, FSNode>& known, std::vector<FSNode>& results, bool followSymlinks,
+        std::vector<PendingFingerprint>& pendingFingerprints) override;
 
     WinFileSystemAccess();
     ~WinFileSystemAccess();
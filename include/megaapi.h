@@ -7885,6 +7885,40 @@ public:
     */
     virtual int getDownloadCount() const = 0;
 
+  /** @brief Indicates how many folder entries per second the sync has scanned so far
+    *
+    * Measured over the time spent scanning. Its changes alone don't trigger
+    * MegaListener::onSyncStatsUpdated.
+    *
+    * @see MegaApi::setSyncScanThreads
+    */
+    virtual double getScannedEntriesPerSecond() const = 0;
+
+  /** @brief Indicates how many bytes per second the sync has read to fingerprint files so far
+    *
+    * Measured over the time spent scanning. Its changes alone don't trigger
+    * MegaListener::onSyncStatsUpdated.
+    *
+    * @see MegaApi::setSyncScanThreads
+    */
+    virtual double getFingerprintedBytesPerSecond() const = 0;
+
+  /** @brief Indicates how many milliseconds the sync took to act on its latest changes
+    *
+    * Measured from the first change being detected, either locally or in the cloud, until
+    * the sync completed a pass with nothing left to scan. Its changes alone don't trigger
+    * MegaListener::onSyncStatsUpdated.
+    *
+    * @see MegaApi::setSyncTimeSlice
+    */
+    virtual long long getLastChangeLatency() const = 0;
+
+  /** @brief Indicates the most milliseconds the sync has taken to act on changes
+    *
+    * @see MegaSyncStats::getLastChangeLatency
+    */
+    virtual long long getMaxChangeLatency() const = 0;
+
   /** @brief Make a copy of this object
     * You take ownership of the result.
     */
@@ -10718,6 +10752,12 @@ class MegaApi
             LOG_LEVEL_MAX = LOG_LEVEL_VERBOSE
         };
 
+        enum
+        {
+            METRICS_FORMAT_JSON = 0,
+            METRICS_FORMAT_PROMETHEUS = 1,
+        };
+
         enum {
             ATTR_TYPE_THUMBNAIL = 0,
             ATTR_TYPE_PREVIEW = 1
@@ -11226,6 +11266,32 @@ class MegaApi
          */
         long long getSDKtime();
 
+        /**
+         * @brief Get a snapshot of the SDK's runtime metrics
+         *
+         * The SDK keeps track of how often its main code paths run (the client's exec loop,
+         * transfer I/O, action packet processing, sync passes, network event processing...)
+         * and how long they take, as a latency histogram per code path.
+         *
+         * Metrics are process-wide: code paths of every MegaApi instance are counted together.
+         * Counts and times are cumulative since the process started.
+         *
+         * In MegaApi::METRICS_FORMAT_JSON, the result is an object with:
+         * - "bucketsUs": upper bounds of the latency buckets, in microseconds
+         * - "scopes": one object per code path, with its "name", "count" of completed runs,
+         *   runs currently "active", "totalUs" and "longestUs" spent, and the number of runs
+         *   per latency bucket in "buckets", the last one counting runs slower than every bound
+         *
+         * In MegaApi::METRICS_FORMAT_PROMETHEUS, the result is in Prometheus' text exposition
+         * format, ready to be served to a scraper.
+         *
+         * You take ownership of the returned value. Use delete[] to release the memory.
+         *
+         * @param format MegaApi::METRICS_FORMAT_JSON or MegaApi::METRICS_FORMAT_PROMETHEUS
+         * @return Snapshot of the metrics, or NULL if the format is invalid
+         */
+        char* getMetrics(int format = METRICS_FORMAT_JSON);
+
         /**
          * @brief Get an URL to transfer the current session to the webclient
          *
@@ -18270,6 +18336,89 @@ class MegaApi
          */
         void checkSyncUploadsThrottled(MegaRequestListener* const listener);
 
+        /**
+         * @brief Set the number of threads that scan the folders of the syncs
+         *
+         * The threads are shared by all the syncs of all the MegaApi instances of the process.
+         * Besides scanning different folders, they fingerprint the files of a folder in parallel,
+         * which speeds up the initial scan of large syncs on storage with parallel access.
+         *
+         * By default there is one thread. The change applies immediately, also to running syncs.
+         *
+         * @param numThreads Number of threads. Values lower than 1 are taken as 1.
+         *
+         * @see MegaSyncStats::getScannedEntriesPerSecond
+         * @see MegaSyncStats::getFingerprintedBytesPerSecond
+         */
+        void setSyncScanThreads(int numThreads);
+
+        /**
+         * @brief Get the number of threads that scan the folders of the syncs
+         *
+         * @return Number of threads
+         *
+         * @see MegaApi::setSyncScanThreads
+         */
+        int getSyncScanThreads();
+
+        /**
+         * @brief Limit how long each sync can work on its changes before the other syncs do
+         *
+         * The changes of all the syncs are acted upon by the same thread, one sync after
+         * another. A sync with a large backlog, like a big initial scan, can keep the changes
+         * in the other syncs waiting for a long time. With a time slice, a sync that uses up its
+         * slice yields to the others, and resumes where it left off after they had their turn.
+         *
+         * Smaller slices make the syncs more responsive to changes at the cost of some
+         * throughput in the busy sync. By default there is no limit. The change applies
+         * immediately, also to running syncs. This value is not reset upon logout.
+         *
+         * @param milliseconds Time slice in milliseconds. Zero or lower means no limit.
+         *
+         * @see MegaSyncStats::getLastChangeLatency
+         * @see MegaSyncStats::getMaxChangeLatency
+         */
+        void setSyncTimeSlice(int milliseconds);
+
+        /**
+         * @brief Get how long each sync can work on its changes before the other syncs do
+         *
+         * @return Time slice in milliseconds, or zero if there is no limit
+         *
+         * @see MegaApi::setSyncTimeSlice
+         */
+        int getSyncTimeSlice();
+
+        /**
+         * @brief Monitor syncs with fanotify, where permitted
+         *
+         * Only available on Linux. By default, syncs are monitored with an inotify watch per
+         * folder, which takes a while to set up for large syncs and is limited by
+         * fs.inotify.max_user_watches. When enabled, a sync is monitored instead with a single
+         * fanotify mark on its whole filesystem. Every change on that filesystem is then
+         * reported to the SDK, and only those within syncs are acted upon.
+         *
+         * Marking a filesystem requires the CAP_SYS_ADMIN and CAP_DAC_READ_SEARCH capabilities.
+         * Without them, or where fanotify isn't supported, syncs keep using inotify.
+         *
+         * Only affects syncs started after the change. This value is not reset upon logout.
+         *
+         * @param enable True to monitor syncs with fanotify where permitted
+         *
+         * @see MegaApi::usingSyncFanotify
+         */
+        void useSyncFanotify(bool enable);
+
+        /**
+         * @brief Check whether syncs are monitored with fanotify, where permitted
+         *
+         * @return True if MegaApi::useSyncFanotify enabled it, false otherwise and on platforms
+         * without fanotify
+         *
+         * @see MegaApi::useSyncFanotify
+         */
+        bool usingSyncFanotify();
+
 #endif // ENABLE_SYNC
 
         /**
@@ -20125,6 +20274,32 @@ class MegaApi
          */
         int enableSearchDBIndexes(bool enable);
 
+        /**
+         * @brief Enables or disables the node skeleton snapshot.
+         *
+         * When enabled, the SDK writes a compact snapshot of the node tree's structure (which
+         * node lives under which parent, and its type) next to the local cache once fetchnodes
+         * completes and when the session is closed without removing the cache. When the session
+         * is resumed from that cache, the snapshot is memory-mapped and used to answer queries
+         * about the number of children and ancestry without reading the database, until the
+         * first change to the node tree arrives.
+         *
+         * The snapshot is only used if it matches the state of the local cache exactly.
+         * Otherwise it is ignored and the database is used as usual.
+         *
+         * @note By default, this option is disabled (`false`).
+         *
+         * @note This method must be called before login and fetchnodes and its value is not reset
+         * upon logout.
+         *
+         * @param enable Set to `true` to write and use the snapshot, or `false` otherwise.
+         * @return
+         * - `API_OK`      - Operation completed successfully.
+         * - `API_EACCESS` - The operation could not be performed because the user is already logged
+         * in.
+         */
+        int enableNodeSkeletonSnapshot(bool enable);
+
         /**
          * @brief Generate an unique ViewID
          *
@@ -26641,6 +26816,15 @@ public:
      */
     virtual MegaFuseExecutorFlags* getSubsystemExecutorFlags() = 0;
 
+    /**
+     * @brief
+     * Query whether mounts let the kernel cache writes.
+     *
+     * @return
+     * True if mounts let the kernel cache writes.
+     */
+    virtual bool getWritebackCache() const = 0;
+
     /**
      * @brief
      * Specify how long we should wait before uploading a modified file.
@@ -26667,6 +26851,22 @@ public:
      * The service's new file explorer view.
      */
     virtual void setFileExplorerView(int view) = 0;
+
+    /**
+     * @brief
+     * Specify whether mounts should let the kernel cache writes.
+     *
+     * When enabled, the kernel buffers writes in its page cache and sends
+     * them to the mount in larger batches which greatly improves the
+     * throughput of sequential writes such as bulk copies.
+     *
+     * This is only supported by libfuse3 mounts and only affects mounts
+     * that are enabled after this flag has been changed.
+     *
+     * @param enable
+     * True if mounts should let the kernel cache writes.
+     */
+    virtual void setWritebackCache(bool enable) = 0;
 }; // MegaFuseFlags
 
 class MegaFuseInodeCacheFlags
@@ -2061,6 +2061,10 @@ public:
     int getFileCount() const override { return stats.numFiles; }
     int getUploadCount() const override { return stats.numUploads; }
     int getDownloadCount() const override { return stats.numDownloads; }
+    double getScannedEntriesPerSecond() const override { return stats.scannedEntriesPerSecond; }
+    double getFingerprintedBytesPerSecond() const override { return stats.fingerprintedBytesPerSecond; }
+    long long getLastChangeLatency() const override { return stats.lastChangeLatencyMs; }
+    long long getMaxChangeLatency() const override { return stats.maxChangeLatencyMs; }
     MegaSyncStatsPrivate *copy() const override { return new MegaSyncStatsPrivate(*this); }
 };
 
@@ -3710,6 +3714,7 @@ class MegaApiImpl : public MegaApp
 
         //Utils
         long long getSDKtime();
+        char* getMetrics(int format);
         void getSessionTransferURL(const char *path, MegaRequestListener *listener);
         static MegaHandle base32ToHandle(const char* base32Handle);
         static handle base64ToHandle(const char* base64Handle);
@@ -4247,6 +4252,12 @@ class MegaApiImpl : public MegaApp
                                          MegaRequestListener* const listener);
 
         void checkSyncUploadsThrottled(MegaRequestListener* const listener);
+        void setSyncScanThreads(int numThreads);
+        int getSyncScanThreads();
+        void setSyncTimeSlice(int milliseconds);
+        int getSyncTimeSlice();
+        void useSyncFanotify(bool enable);
+        bool usingSyncFanotify();
 
         AddressedStallFilter mAddressedStallFilter;
 
@@ -4416,6 +4427,7 @@ public:
 
         bool setLanguage(const char* languageCode);
         int enableSearchDBIndexes(bool enable);
+        int enableNodeSkeletonSnapshot(bool enable);
         string generateViewId();
         void setLanguagePreference(const char* languageCode, MegaRequestListener *listener = NULL);
         void getLanguagePreference(MegaRequestListener *listener = NULL);
@@ -6481,11 +6493,15 @@ public:
 
     MegaFuseExecutorFlags* getSubsystemExecutorFlags() override;
 
+    bool getWritebackCache() const override;
+
     void setFlushDelay(size_t seconds) override;
 
     void setLogLevel(int level) override;
 
     void setFileExplorerView(int view) override;
+
+    void setWritebackCache(bool enable) override;
 }; // MegaFuseFlagsPrivate
 
 using MegaMountFlagsPtr = std::unique_ptr<MegaMountFlags>;
@@ -1500,7 +1500,7 @@ ScanResult AndroidFileSystemAccess::directoryScan(const LocalPath& targetPath,
                                                   std::map<LocalPath, FSNode>& known,
                                                   std::vector<FSNode>& results,
                                                   bool followSymLinks,
-                                                  unsigned& nFingerprinted)
+                                                  std::vector<PendingFingerprint>& pendingFingerprints)
 {
     // Whether we can reuse an existing fingerprint.
     // I.e. Can we avoid computing the CRC?
@@ -1622,23 +1622,28 @@ ScanResult AndroidFileSystemAccess::directoryScan(const LocalPath& targetPath,
             continue;
         }
 
-        AndroidFileAccess fAccess(nullptr);
-        fAccess.updatelocalname(newpath, true);
-        bool validOpen = fAccess.fopen(newpath, false, false, FSLogging::logOnError);
-
-        // Only fingerprint the file if we could actually open it.
-        if (!validOpen)
-        {
-            LOG_warn << "directoryScan: "
-                     << "Unable to open file for fingerprinting: " << newpath
-                     << ". Error was: " << errno;
-            continue;
-        }
-
-        // Fingerprint the file.
-        result.fingerprint.genfingerprint(&fAccess);
-
-        ++nFingerprinted;
+        // Leave the fingerprint to our caller, so files can be read in parallel.
+        pendingFingerprints.push_back(
+            {results.size() - 1,
+             [newpath](FSNode& node)
+             {
+                 AndroidFileAccess fAccess(nullptr);
+                 fAccess.updatelocalname(newpath, true);
+                 bool validOpen = fAccess.fopen(newpath, false, false, FSLogging::logOnError);
+
+                 // Only fingerprint the file if we could actually open it.
+                 if (!validOpen)
+                 {
+                     LOG_warn << "directoryScan: "
+                              << "Unable to open file for fingerprinting: " << newpath
+                              << ". Error was: " << errno;
+                     return false;
+                 }
+
+                 // Fingerprint the file.
+                 node.fingerprint.genfingerprint(&fAccess);
+                 return true;
+             }});
     }
 
     return SCAN_SUCCESS;
@@ -0,0 +1,293 @@
+/**
+ * @file code_counter.cpp
+ * @brief Runtime counters and latency histograms for the SDK's major code paths
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/code_counter.h"
+
+#include "mega/json.h"
+
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+
+namespace mega {
+namespace CodeCounter
+{
+
+namespace
+{
+
+size_t bucketFor(uint64_t timeSpentNs)
+{
+    auto microseconds = timeSpentNs / 1000;
+
+    return static_cast<size_t>(std::lower_bound(LATENCY_BUCKETS_US.begin(),
+                                                LATENCY_BUCKETS_US.end(),
+                                                microseconds) -
+                               LATENCY_BUCKETS_US.begin());
+}
+
+// Prometheus label values are quoted: escape what would end or break them.
+std::string escapeLabel(const std::string& value)
+{
+    std::string escaped;
+
+    for (auto character: value)
+    {
+        if (character == '\\' || character == '"')
+            escaped.push_back('\\');
+
+        if (character == '\n')
+            escaped.append("\\n");
+        else
+            escaped.push_back(character);
+    }
+
+    return escaped;
+}
+
+} // namespace
+
+void ScopeStats::Snapshot::add(const Snapshot& other)
+{
+    starts += other.starts;
+    count += other.count;
+    timeSpentNs += other.timeSpentNs;
+    longestNs = std::max(longestNs, other.longestNs);
+
+    for (size_t i = 0; i < buckets.size(); ++i)
+        buckets[i] += other.buckets[i];
+}
+
+ScopeStats::ScopeStats(std::string name):
+    mName(std::move(name))
+{
+    Registry::instance().add(*this);
+}
+
+ScopeStats::~ScopeStats()
+{
+    Registry::instance().remove(*this);
+}
+
+void ScopeStats::started()
+{
+    shard().starts.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ScopeStats::finished(high_resolution_clock::duration timeSpent)
+{
+    auto& stats = shard();
+    auto nanoseconds = static_cast<uint64_t>(std::max<int64_t>(
+        duration_cast<std::chrono::nanoseconds>(timeSpent).count(), 0));
+
+    stats.count.fetch_add(1, std::memory_order_relaxed);
+    stats.timeSpentNs.fetch_add(nanoseconds, std::memory_order_relaxed);
+    stats.buckets[bucketFor(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+
+    auto longest = stats.longestNs.load(std::memory_order_relaxed);
+
+    while (nanoseconds > longest &&
+           !stats.longestNs.compare_exchange_weak(longest, nanoseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+auto ScopeStats::snapshot() const -> Snapshot
+{
+    Snapshot result;
+
+    for (auto& stats: mShards)
+    {
+        Snapshot shard;
+
+        shard.starts = stats.starts.load(std::memory_order_relaxed);
+        shard.count = stats.count.load(std::memory_order_relaxed);
+        shard.timeSpentNs = stats.timeSpentNs.load(std::memory_order_relaxed);
+        shard.longestNs = stats.longestNs.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < shard.buckets.size(); ++i)
+            shard.buckets[i] = stats.buckets[i].load(std::memory_order_relaxed);
+
+        result.add(shard);
+    }
+
+    return result;
+}
+
+std::string ScopeStats::report(bool reset)
+{
+    auto current = snapshot();
+
+    std::string s = " " + mName + ": " + std::to_string(current.count - mReported.count) + " " +
+                    std::to_string((current.timeSpentNs - mReported.timeSpentNs) / 1000000) +
+                    " " + std::to_string(current.longestNs / 1000000);
+
+    if (reset)
+        mReported = current;
+
+    return s;
+}
+
+auto ScopeStats::shard() -> Shard&
+{
+    // Spread threads over the shards as they first touch any scope.
+    static std::atomic<size_t> nextShard{0};
+    thread_local size_t index = nextShard.fetch_add(1, std::memory_order_relaxed) % NUM_SHARDS;
+
+    return mShards[index];
+}
+
+Registry& Registry::instance()
+{
+    static Registry registry;
+
+    return registry;
+}
+
+void Registry::add(ScopeStats& scope)
+{
+    std::lock_guard<std::mutex> guard(mMutex);
+
+    mScopes.emplace_back(&scope);
+}
+
+void Registry::remove(ScopeStats& scope)
+{
+    std::lock_guard<std::mutex> guard(mMutex);
+
+    auto i = std::find(mScopes.begin(), mScopes.end(), &scope);
+
+    assert(i != mScopes.end());
+
+    if (i != mScopes.end())
+        mScopes.erase(i);
+}
+
+std::map<std::string, ScopeStats::Snapshot> Registry::snapshot() const
+{
+    std::map<std::string, ScopeStats::Snapshot> result;
+    std::lock_guard<std::mutex> guard(mMutex);
+
+    for (auto* scope: mScopes)
+        result[scope->name()].add(scope->snapshot());
+
+    return result;
+}
+
+std::string Registry::toJson() const
+{
+    JSONWriter writer;
+
+    writer.beginobject();
+    writer.beginarray("bucketsUs");
+
+    for (auto bound: LATENCY_BUCKETS_US)
+    {
+        writer.addcomma();
+        writer.appendraw(std::to_string(bound).c_str());
+    }
+
+    writer.endarray();
+    writer.beginarray("scopes");
+
+    for (auto& [name, stats]: snapshot())
+    {
+        writer.beginobject();
+        writer.arg_stringWithEscapes("name", name);
+        writer.arg("count", static_cast<m_off_t>(stats.count));
+        writer.arg("active", static_cast<m_off_t>(stats.active()));
+        writer.arg("totalUs", static_cast<m_off_t>(stats.timeSpentNs / 1000));
+        writer.arg("longestUs", static_cast<m_off_t>(stats.longestNs / 1000));
+        writer.beginarray("buckets");
+
+        for (auto count: stats.buckets)
+        {
+            writer.addcomma();
+            writer.appendraw(std::to_string(count).c_str());
+        }
+
+        writer.endarray();
+        writer.endobject();
+    }
+
+    writer.endarray();
+    writer.endobject();
+
+    return writer.getstring();
+}
+
+std::string Registry::toPrometheus() const
+{
+    auto scopes = snapshot();
+    std::ostringstream s;
+
+    s.precision(12);
+
+    s << "# HELP mega_scope_duration_seconds Time spent in instrumented SDK code paths.\n"
+      << "# TYPE mega_scope_duration_seconds histogram\n";
+
+    for (auto& [name, stats]: scopes)
+    {
+        auto label = "scope=\"" + escapeLabel(name) + "\"";
+        uint64_t cumulative = 0;
+
+        for (size_t i = 0; i < LATENCY_BUCKETS_US.size(); ++i)
+        {
+            cumulative += stats.buckets[i];
+
+            s << "mega_scope_duration_seconds_bucket{" << label
+              << ",le=\"" << static_cast<double>(LATENCY_BUCKETS_US[i]) / 1e6 << "\"} "
+              << cumulative << "\n";
+        }
+
+        // Counted from the buckets so that the histogram stays consistent while scopes finish.
+        cumulative += stats.buckets.back();
+
+        s << "mega_scope_duration_seconds_bucket{" << label << ",le=\"+Inf\"} " << cumulative
+          << "\n"
+          << "mega_scope_duration_seconds_sum{" << label << "} "
+          << static_cast<double>(stats.timeSpentNs) / 1e9 << "\n"
+          << "mega_scope_duration_seconds_count{" << label << "} " << cumulative << "\n";
+    }
+
+    s << "# HELP mega_scope_longest_seconds Longest time spent in a code path.\n"
+      << "# TYPE mega_scope_longest_seconds gauge\n";
+
+    for (auto& [name, stats]: scopes)
+    {
+        s << "mega_scope_longest_seconds{scope=\"" << escapeLabel(name) << "\"} "
+          << static_cast<double>(stats.longestNs) / 1e9 << "\n";
+    }
+
+    s << "# HELP mega_scope_active Code paths currently being executed.\n"
+      << "# TYPE mega_scope_active gauge\n";
+
+    for (auto& [name, stats]: scopes)
+    {
+        s << "mega_scope_active{scope=\"" << escapeLabel(name) << "\"} "
+          << stats.active() << "\n";
+    }
+
+    return s.str();
+}
+
+}
+} // namespace mega
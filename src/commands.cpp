@@ -7436,6 +7436,7 @@ bool CommandFetchNodes::parsingFinished()
     WAIT_CLASS::bumpds();
     client->fnstats.timeToCached = Waiter::ds - client->fnstats.startTime;
     client->fnstats.nodesCached = static_cast<long long>(client->mNodeManager.getNodeCount());
+    client->fnstats.measureCached();
 #ifdef ENABLE_SYNC
     if (mLoadSyncs)
         client->syncs.loadSyncConfigsOnFetchnodesComplete(true);
@@ -76,24 +76,35 @@ bool DbTable::put(uint32_t type, Cacheable* record, SymmCipher* key)
 // get next record, decrypt and unpad
 bool DbTable::next(uint32_t* type, string* data, SymmCipher* key)
 {
-    if (next(type, data))
+    if (nextEncrypted(type, data))
     {
         if (!*type)
         {
             return true;
         }
 
-        if (*type > nextid)
-        {
-            nextid = *type & ~(static_cast<unsigned>(IDSPACING) - 1);
-        }
-
         return PaddedCBC::decrypt(data, key);
     }
 
     return false;
 }
 
+// get next record, keeping track of the ids in use
+bool DbTable::nextEncrypted(uint32_t* type, string* data)
+{
+    if (!next(type, data))
+    {
+        return false;
+    }
+
+    if (*type > nextid)
+    {
+        nextid = *type & ~(static_cast<unsigned>(IDSPACING) - 1);
+    }
+
+    return true;
+}
+
 DBTableTransactionCommitter *DbTable::getTransactionCommitter() const
 {
     return mTransactionCommitter;
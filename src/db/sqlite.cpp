@@ -28,6 +28,23 @@ namespace mega {
 
 static const char* NodeSearchFilterPtrStr = "NodeSearchFilterPtrStr";
 
+// Column 'path' of the nodes table stores the handles of all the ancestors of a node, from the
+// topmost one down to the node itself, as 8-byte big-endian keys. Node handles only use the lower
+// 6 bytes, so the first byte of every key is 0 and (path || x'FF') is greater than the path of
+// any descendant: the nodes below a node are a single range scan in 'pathindex'.
+// Concatenation always yields TEXT, which sorts before any BLOB, so results are cast to BLOB.
+static const size_t NODE_PATH_KEY_SIZE = 8;
+
+static std::string getNodePathKey(handle nodeHandle)
+{
+    std::string key(NODE_PATH_KEY_SIZE, '\0');
+    for (size_t i = NODE_PATH_KEY_SIZE; i--; nodeHandle >>= 8)
+    {
+        key[i] = static_cast<char>(nodeHandle & 0xFF);
+    }
+    return key;
+}
+
 SqliteDbAccess::SqliteDbAccess(const LocalPath& rootPath)
   : mRootPath(rootPath)
 {
@@ -199,6 +216,21 @@ DbTable *SqliteDbAccess::openTableWithNodes(PrnGen &rng, FileSystemAccess &fsAcc
         return nullptr;
     }
 
+    if (sqlite3_create_function(db,
+                                u8"foldCaseAccent",
+                                1,
+                                SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+                                0,
+                                &SqliteAccountState::userFoldCaseAccent,
+                                0,
+                                0) != SQLITE_OK)
+    {
+        LOG_err << "Data base error(sqlite3_create_function userFoldCaseAccent): "
+                << sqlite3_errmsg(db);
+        sqlite3_close(db);
+        return nullptr;
+    }
+
     if (sqlite3_create_collation(db,
                                  "NATURALNOCASE",
                                  SQLITE_UTF8,
@@ -220,7 +252,7 @@ DbTable *SqliteDbAccess::openTableWithNodes(PrnGen &rng, FileSystemAccess &fsAcc
         "sizeVirtual int64 AS (getSizeFromNodeCounter(counter)) VIRTUAL,"
         "share tinyint, fav tinyint, ctime int64, mtime int64 DEFAULT 0, "
         "flags int64, counter BLOB NOT NULL, "
-        "node BLOB NOT NULL, label tinyint DEFAULT 0, description text, tags text)";
+        "node BLOB NOT NULL, label tinyint DEFAULT 0, description text, tags text, path BLOB)";
 
     int result = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
     if (result)
@@ -258,6 +290,7 @@ DbTable *SqliteDbAccess::openTableWithNodes(PrnGen &rng, FileSystemAccess &fsAcc
          "int64 AS (getSizeFromNodeCounter(counter)) VIRTUAL",
          NodeData::COMPONENT_NONE,
          nullptr},
+        {"path", "BLOB", NodeData::COMPONENT_NONE, nullptr},
     };
 
     if (!addAndPopulateColumns(db, std::move(newCols)))
@@ -266,6 +299,26 @@ DbTable *SqliteDbAccess::openTableWithNodes(PrnGen &rng, FileSystemAccess &fsAcc
         return nullptr;
     }
 
+    // Indexes for the ancestry encoded in 'path'. They are required to keep it up to date when nodes
+    // are moved, or when a node arrives after its children (orphanindex only has the nodes stored
+    // without their parent, which are few), so they are created here instead of in createIndexes()
+    sql = "CREATE INDEX IF NOT EXISTS pathindex on nodes (path); "
+          "CREATE INDEX IF NOT EXISTS orphanindex on nodes (parenthandle) WHERE length(path) = " +
+          std::to_string(NODE_PATH_KEY_SIZE);
+    result = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
+    if (result)
+    {
+        LOG_err << "Data base error while creating path indexes: " << sqlite3_errmsg(db);
+        sqlite3_close(db);
+        return nullptr;
+    }
+
+    if (!populateNodePaths(db))
+    {
+        sqlite3_close(db);
+        return nullptr;
+    }
+
 #if __ANDROID__
     // Android doesn't provide a temporal directory -> change default policy for temp
     // store (FILE=1) to avoid failures on large queries, so it relies on MEMORY=2
@@ -348,8 +401,13 @@ const LocalPath& SqliteDbAccess::rootPath() const
 
 bool SqliteDbAccess::openDBAndCreateStatecache(sqlite3 **db, FileSystemAccess &fsAccess, const string &name, LocalPath &dbPath, const int flags)
 {
-    checkDbFileAndAdjustLegacy(fsAccess, name, flags, dbPath);
-    int result = sqlite3_open_v2(dbPath.toPath(false).c_str(), db,
+    const bool inMemory = (flags & DB_OPEN_FLAG_IN_MEMORY) > 0;
+    if (!inMemory)
+    {
+        checkDbFileAndAdjustLegacy(fsAccess, name, flags, dbPath);
+    }
+
+    int result = sqlite3_open_v2(inMemory ? ":memory:" : dbPath.toPath(false).c_str(), db,
         SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE // The database is opened for reading and writing, and is created if it does not already exist. This is the behavior that is always used for sqlite3_open() and sqlite3_open16().
         | SQLITE_OPEN_FULLMUTEX // The new database connection will use the "Serialized" threading mode. This means that multiple threads can be used withou restriction.
         , nullptr);
@@ -365,7 +423,8 @@ bool SqliteDbAccess::openDBAndCreateStatecache(sqlite3 **db, FileSystemAccess &f
     }
 
 #if !(TARGET_OS_IPHONE)
-    result = sqlite3_exec(*db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+    result = inMemory ? SQLITE_OK :
+                        sqlite3_exec(*db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
     if (result)
     {
         sqlite3_close(*db);
@@ -533,6 +592,120 @@ bool SqliteDbAccess::addColumn(sqlite3* db, const string& name, const string& ty
     return true;
 }
 
+bool SqliteDbAccess::populateNodePaths(sqlite3* db)
+{
+    // Paths are only missing right after adding the column (NULL is the first entry of pathindex)
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT 1 FROM nodes WHERE path IS NULL LIMIT 1", -1, &stmt, nullptr) !=
+        SQLITE_OK)
+    {
+        LOG_err << "Db error while preparing to search for missing paths: " << sqlite3_errmsg(db);
+        return false;
+    }
+
+    const bool missingPaths = sqlite3_step(stmt) == SQLITE_ROW;
+    sqlite3_finalize(stmt);
+
+    if (!missingPaths)
+    {
+        return true;
+    }
+
+    LOG_info << "Migrating Data base - populating node paths";
+
+    if (sqlite3_prepare_v2(db, "SELECT nodehandle, parenthandle FROM nodes", -1, &stmt, nullptr) !=
+        SQLITE_OK)
+    {
+        LOG_err << "Db error while preparing to extract node parents: " << sqlite3_errmsg(db);
+        return false;
+    }
+
+    std::unordered_map<handle, handle> parents;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        parents.emplace(static_cast<handle>(sqlite3_column_int64(stmt, 0)),
+                        static_cast<handle>(sqlite3_column_int64(stmt, 1)));
+    }
+
+    sqlite3_finalize(stmt);
+
+    // Nodes whose parent isn't in the table (root nodes, inshares...) are the top of their path.
+    // Iterative, as trees can be deeper than the stack: walks up to the first ancestor whose path
+    // is known, then extends it down to the node.
+    std::unordered_map<handle, std::string> paths;
+    auto getPath = [&parents, &paths](handle nodeHandle) -> const std::string&
+    {
+        std::vector<handle> missing;
+        std::string path;
+
+        for (auto it = parents.find(nodeHandle); it != parents.end(); it = parents.find(it->second))
+        {
+            auto [pathIt, inserted] = paths.try_emplace(it->first);
+            if (!inserted)
+            {
+                // Already calculated (or being calculated, if the table had a cycle)
+                path = pathIt->second;
+                break;
+            }
+
+            missing.push_back(it->first);
+        }
+
+        for (auto it = missing.rbegin(); it != missing.rend(); ++it)
+        {
+            path += getNodePathKey(*it);
+            paths[*it] = path;
+        }
+
+        return paths.at(nodeHandle);
+    };
+
+    if (sqlite3_exec(db, "BEGIN", nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+        LOG_debug << "Db error during migration for " << "BEGIN: " << sqlite3_errmsg(db);
+        return false;
+    }
+
+    if (sqlite3_prepare_v2(db, "UPDATE nodes SET path = ? WHERE nodehandle = ?", -1, &stmt, nullptr) !=
+        SQLITE_OK)
+    {
+        LOG_err << "Db error while preparing to populate node paths: " << sqlite3_errmsg(db);
+        sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        return false;
+    }
+
+    for (const auto& parent: parents)
+    {
+        const std::string& path = getPath(parent.first);
+
+        int stepResult;
+        if (sqlite3_bind_blob(stmt, 1, path.data(), static_cast<int>(path.size()), SQLITE_STATIC) !=
+                SQLITE_OK ||
+            sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(parent.first)) != SQLITE_OK ||
+            ((stepResult = sqlite3_step(stmt)) != SQLITE_DONE && stepResult != SQLITE_ROW) ||
+            sqlite3_reset(stmt) != SQLITE_OK)
+        {
+            LOG_err << "Db error during migration while updating node paths: " << sqlite3_errmsg(db);
+            sqlite3_finalize(stmt);
+            sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+        LOG_debug << "Db error during migration for " << "COMMIT: " << sqlite3_errmsg(db);
+        sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        return false;
+    }
+
+    LOG_info << "Migrating Data base - node paths populated: " << parents.size();
+
+    return true;
+}
+
 bool SqliteDbAccess::migrateDataToColumns(sqlite3* db, vector<NewColumn>&& cols)
 {
     if (cols.empty()) return true;
@@ -1057,6 +1230,7 @@ void SqliteDbTable::errorHandler(int sqliteError, const string& operation, bool
 SqliteAccountState::SqliteAccountState(PrnGen &rng, sqlite3 *pdb, FileSystemAccess &fsAccess, const LocalPath &path, const bool checkAlwaysTransacted, DBErrorCallback dBErrorCallBack)
     : SqliteDbTable(rng, pdb, fsAccess, path, checkAlwaysTransacted, dBErrorCallBack)
 {
+    mHasNodeSearchIndex = hasNodeSearchIndex();
 }
 
 SqliteAccountState::~SqliteAccountState()
@@ -1121,9 +1295,28 @@ bool SqliteAccountState::remove(NodeHandle nodehandle)
     int sqlResult = sqlite3_exec(db, buf, 0, 0, NULL);
     errorHandler(sqlResult, "Delete node", false);
 
+    if (sqlResult == SQLITE_OK && mHasNodeSearchIndex)
+    {
+        snprintf(buf,
+                 sizeof(buf),
+                 "DELETE FROM nodesearch WHERE rowid = %" PRId64,
+                 nodehandle.as8byte());
+
+        sqlResult = sqlite3_exec(db, buf, 0, 0, NULL);
+        errorHandler(sqlResult, "Delete node from search index", false);
+    }
+
     return sqlResult == SQLITE_OK;
 }
 
+void SqliteAccountState::abort()
+{
+    SqliteDbTable::abort();
+
+    // Adoptions may have been rolled back
+    mOrphanParents.reset();
+}
+
 bool SqliteAccountState::removeNodes()
 {
     if (!db)
@@ -1136,6 +1329,17 @@ bool SqliteAccountState::removeNodes()
     int sqlResult = sqlite3_exec(db, "DELETE FROM nodes", 0, 0, NULL);
     errorHandler(sqlResult, "Delete nodes", false);
 
+    if (sqlResult == SQLITE_OK && mOrphanParents)
+    {
+        mOrphanParents->clear();
+    }
+
+    if (sqlResult == SQLITE_OK && mHasNodeSearchIndex)
+    {
+        sqlResult = sqlite3_exec(db, "DELETE FROM nodesearch", 0, 0, NULL);
+        errorHandler(sqlResult, "Delete nodes from search index", false);
+    }
+
     return sqlResult == SQLITE_OK;
 }
 
@@ -1275,9 +1479,88 @@ void SqliteAccountState::createIndexes(bool enableIndexesForSearching)
         {
             LOG_err << "Data base error while creating index (ctimeindex): " << sqlite3_errmsg(db);
         }
+
+        if (!mHasNodeSearchIndex)
+        {
+            mHasNodeSearchIndex = createNodeSearchIndex();
+        }
     }
 }
 
+bool SqliteAccountState::hasNodeSearchIndex()
+{
+    // Preparing the statement fails if the table doesn't exist or if SQLite was built without FTS5
+    sqlite3_stmt* stmt = nullptr;
+    const bool exists =
+        sqlite3_prepare_v2(db, "SELECT rowid FROM nodesearch LIMIT 0", -1, &stmt, nullptr) ==
+        SQLITE_OK;
+    sqlite3_finalize(stmt);
+
+    return exists;
+}
+
+bool SqliteAccountState::createNodeSearchIndex()
+{
+    // Text is folded (case and accents) before being indexed, in the same way that likeCompare()
+    // compares it. The trigram tokenizer allows to look up any substring of 3 or more characters,
+    // which are the literals between the wild cards of the NodeSearchFilter patterns
+    // A savepoint is used because this method can be called with a transaction already started
+    const std::string sql =
+        "SAVEPOINT nodesearch; "
+        "CREATE VIRTUAL TABLE nodesearch USING fts5(name, description, tags, "
+        "tokenize = 'trigram case_sensitive 1'); "
+        "INSERT INTO nodesearch (rowid, name, description, tags) "
+        "SELECT nodehandle, foldCaseAccent(name), foldCaseAccent(description), "
+        "foldCaseAccent(tags) FROM nodes; "
+        "RELEASE nodesearch;";
+
+    const int result = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
+    if (result)
+    {
+        // Search works without the index, only slower
+        LOG_warn << "Data base error while creating full-text index (nodesearch): "
+                 << sqlite3_errmsg(db);
+        sqlite3_exec(db, "ROLLBACK TO nodesearch; RELEASE nodesearch;", nullptr, nullptr, nullptr);
+        return false;
+    }
+
+    return true;
+}
+
+bool SqliteAccountState::putInNodeSearchIndex(NodeHandle nodeHandle)
+{
+    int sqlResult = SQLITE_OK;
+    if (!mStmtPutNodeSearch)
+    {
+        sqlResult = sqlite3_prepare_v2(db,
+                                       "INSERT OR REPLACE INTO nodesearch (rowid, name, "
+                                       "description, tags) "
+                                       "SELECT nodehandle, foldCaseAccent(name), "
+                                       "foldCaseAccent(description), foldCaseAccent(tags) "
+                                       "FROM nodes WHERE nodehandle = ?",
+                                       -1,
+                                       &mStmtPutNodeSearch,
+                                       NULL);
+    }
+
+    if (sqlResult == SQLITE_OK)
+    {
+        if ((sqlResult = sqlite3_bind_int64(
+                 mStmtPutNodeSearch,
+                 1,
+                 static_cast<sqlite3_int64>(nodeHandle.as8byte()))) == SQLITE_OK)
+        {
+            sqlResult = sqlite3_step(mStmtPutNodeSearch);
+        }
+    }
+
+    errorHandler(sqlResult, "Put node in search index", false);
+
+    sqlite3_reset(mStmtPutNodeSearch);
+
+    return sqlResult == SQLITE_DONE;
+}
+
 void SqliteAccountState::dropSearchDBIndexes()
 {
     if (!db)
@@ -1319,6 +1602,19 @@ void SqliteAccountState::dropSearchDBIndexes()
         }
     }
 
+    if (mHasNodeSearchIndex)
+    {
+        if (int sqlResult = sqlite3_exec(db, "DROP TABLE nodesearch;", nullptr, nullptr, nullptr);
+            sqlResult != SQLITE_OK)
+        {
+            errorHandler(sqlResult, "Error while dropping full-text index (nodesearch)", false);
+        }
+        else
+        {
+            mHasNodeSearchIndex = false;
+        }
+    }
+
     commit();
 }
 
@@ -1334,6 +1630,15 @@ void SqliteAccountState::finalise()
     sqlite3_finalize(mStmtPutNode);
     mStmtPutNode = nullptr;
 
+    sqlite3_finalize(mStmtGetNodePaths);
+    mStmtGetNodePaths = nullptr;
+
+    sqlite3_finalize(mStmtUpdateNodePaths);
+    mStmtUpdateNodePaths = nullptr;
+
+    sqlite3_finalize(mStmtOrphanNodes);
+    mStmtOrphanNodes = nullptr;
+
     sqlite3_finalize(mStmtUpdateNode);
     mStmtUpdateNode = nullptr;
 
@@ -1364,6 +1669,15 @@ void SqliteAccountState::finalise()
     }
     mStmtSearchNodes.clear();
 
+    for (auto& s: mStmtSearchNodesUsingIndex)
+    {
+        sqlite3_finalize(s.second);
+    }
+    mStmtSearchNodesUsingIndex.clear();
+
+    sqlite3_finalize(mStmtPutNodeSearch);
+    mStmtPutNodeSearch = nullptr;
+
     sqlite3_finalize(mStmtNodeTagsBelow);
     mStmtNodeTagsBelow = nullptr;
 
@@ -1392,6 +1706,199 @@ void SqliteAccountState::finalise()
     mStmtFavourites = nullptr;
 }
 
+bool SqliteAccountState::getNodePaths(NodeHandle nodeHandle,
+                                      NodeHandle parentHandle,
+                                      std::string& oldPath,
+                                      std::string& path)
+{
+    int sqlResult = SQLITE_OK;
+    if (!mStmtGetNodePaths)
+    {
+        sqlResult = sqlite3_prepare_v2(db,
+                                       "SELECT (SELECT path FROM nodes WHERE nodehandle = ?1), "
+                                       "(SELECT path FROM nodes WHERE nodehandle = ?2)",
+                                       -1,
+                                       &mStmtGetNodePaths,
+                                       NULL);
+    }
+
+    std::string parentPath;
+    if (sqlResult == SQLITE_OK)
+    {
+        if ((sqlResult = sqlite3_bind_int64(mStmtGetNodePaths,
+                                            1,
+                                            static_cast<sqlite3_int64>(nodeHandle.as8byte()))) ==
+                SQLITE_OK &&
+            (sqlResult = sqlite3_bind_int64(mStmtGetNodePaths,
+                                            2,
+                                            static_cast<sqlite3_int64>(parentHandle.as8byte()))) ==
+                SQLITE_OK &&
+            (sqlResult = sqlite3_step(mStmtGetNodePaths)) == SQLITE_ROW)
+        {
+            auto getBlob = [this](int column) -> std::string
+            {
+                const char* data =
+                    static_cast<const char*>(sqlite3_column_blob(mStmtGetNodePaths, column));
+                int size = sqlite3_column_bytes(mStmtGetNodePaths, column);
+                return data ? std::string(data, static_cast<size_t>(size)) : std::string();
+            };
+
+            oldPath = getBlob(0);
+            parentPath = getBlob(1);
+            sqlResult = SQLITE_OK;
+        }
+    }
+
+    errorHandler(sqlResult, "Get node paths", false);
+
+    sqlite3_reset(mStmtGetNodePaths);
+
+    // If the parent isn't stored (yet), the node is the top of its path
+    path = parentPath + getNodePathKey(nodeHandle.as8byte());
+
+    return sqlResult == SQLITE_OK;
+}
+
+bool SqliteAccountState::updateNodePaths(const std::string& oldPath, const std::string& path)
+{
+    int sqlResult = SQLITE_OK;
+    if (!mStmtUpdateNodePaths)
+    {
+        // Replace the prefix 'oldPath' by 'path' for the node at 'oldPath' and all nodes below it
+        sqlResult = sqlite3_prepare_v2(db,
+                                       "UPDATE nodes SET path = CAST(?1 || substr(path, ?2) AS BLOB) "
+                                       "WHERE path >= ?3 AND path < CAST(?3 || x'FF' AS BLOB)",
+                                       -1,
+                                       &mStmtUpdateNodePaths,
+                                       NULL);
+    }
+
+    if (sqlResult == SQLITE_OK)
+    {
+        if ((sqlResult = sqlite3_bind_blob(mStmtUpdateNodePaths,
+                                           1,
+                                           path.data(),
+                                           static_cast<int>(path.size()),
+                                           SQLITE_STATIC)) == SQLITE_OK &&
+            (sqlResult = sqlite3_bind_int(mStmtUpdateNodePaths,
+                                          2,
+                                          static_cast<int>(oldPath.size()) + 1)) == SQLITE_OK &&
+            (sqlResult = sqlite3_bind_blob(mStmtUpdateNodePaths,
+                                           3,
+                                           oldPath.data(),
+                                           static_cast<int>(oldPath.size()),
+                                           SQLITE_STATIC)) == SQLITE_OK)
+        {
+            sqlResult = sqlite3_step(mStmtUpdateNodePaths);
+        }
+    }
+
+    errorHandler(sqlResult, "Update node paths", false);
+
+    sqlite3_reset(mStmtUpdateNodePaths);
+
+    return sqlResult == SQLITE_DONE;
+}
+
+bool SqliteAccountState::mayHaveOrphans(NodeHandle nodeHandle)
+{
+    if (!mOrphanParents)
+    {
+        sqlite3_stmt* stmt = nullptr;
+
+        // Uses orphanindex
+        const std::string query =
+            "SELECT DISTINCT parenthandle FROM nodes WHERE length(path) = " +
+            std::to_string(NODE_PATH_KEY_SIZE);
+
+        int sqlResult = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, NULL);
+
+        std::unordered_set<handle> parents;
+        if (sqlResult == SQLITE_OK)
+        {
+            while ((sqlResult = sqlite3_step(stmt)) == SQLITE_ROW)
+            {
+                parents.insert(static_cast<handle>(sqlite3_column_int64(stmt, 0)));
+            }
+        }
+
+        errorHandler(sqlResult, "Get parents of orphan nodes", false);
+
+        sqlite3_finalize(stmt);
+
+        if (sqlResult != SQLITE_DONE)
+        {
+            // Can't tell: look for them
+            return true;
+        }
+
+        mOrphanParents = std::move(parents);
+    }
+
+    return mOrphanParents->count(nodeHandle.as8byte()) > 0;
+}
+
+bool SqliteAccountState::adoptOrphanNodes(NodeHandle nodeHandle, const std::string& path)
+{
+    if (!mayHaveOrphans(nodeHandle))
+    {
+        return true;
+    }
+
+    int sqlResult = SQLITE_OK;
+    if (!mStmtOrphanNodes)
+    {
+        // Uses orphanindex
+        const std::string query =
+            "SELECT path FROM nodes WHERE parenthandle = ? AND length(path) = " +
+            std::to_string(NODE_PATH_KEY_SIZE);
+        sqlResult = sqlite3_prepare_v2(db, query.c_str(), -1, &mStmtOrphanNodes, NULL);
+    }
+
+    std::vector<std::string> orphanPaths;
+    if (sqlResult == SQLITE_OK)
+    {
+        if ((sqlResult = sqlite3_bind_int64(mStmtOrphanNodes,
+                                            1,
+                                            static_cast<sqlite3_int64>(nodeHandle.as8byte()))) ==
+            SQLITE_OK)
+        {
+            while ((sqlResult = sqlite3_step(mStmtOrphanNodes)) == SQLITE_ROW)
+            {
+                const char* data = static_cast<const char*>(sqlite3_column_blob(mStmtOrphanNodes, 0));
+                int size = sqlite3_column_bytes(mStmtOrphanNodes, 0);
+                orphanPaths.emplace_back(data, static_cast<size_t>(size));
+            }
+        }
+    }
+
+    errorHandler(sqlResult, "Get orphan nodes", false);
+
+    sqlite3_reset(mStmtOrphanNodes);
+
+    if (sqlResult != SQLITE_DONE)
+    {
+        return false;
+    }
+
+    if (!std::all_of(std::begin(orphanPaths),
+                     std::end(orphanPaths),
+                     [this, &path](const std::string& orphanPath)
+                     {
+                         return updateNodePaths(orphanPath, path + orphanPath);
+                     }))
+    {
+        return false;
+    }
+
+    if (mOrphanParents)
+    {
+        mOrphanParents->erase(nodeHandle.as8byte());
+    }
+
+    return true;
+}
+
 bool SqliteAccountState::put(Node *node)
 {
     if (!db)
@@ -1408,13 +1915,21 @@ bool SqliteAccountState::put(Node *node)
             sqlite3_prepare_v2(db,
                                "INSERT OR REPLACE INTO nodes (nodehandle, parenthandle, "
                                "name, fingerprint, origFingerprint, type, share, fav, ctime, "
-                               "mtime, flags, counter, node, label, description, tags) "
-                               "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
+                               "mtime, flags, counter, node, label, description, tags, path) "
+                               "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
                                -1,
                                &mStmtPutNode,
                                NULL);
     }
 
+    std::string oldPath;
+    std::string path;
+    if (sqlResult == SQLITE_OK &&
+        !getNodePaths(node->nodeHandle(), node->parentHandle(), oldPath, path))
+    {
+        return false;
+    }
+
     if (sqlResult == SQLITE_OK)
     {
         string nodeSerialized;
@@ -1500,6 +2015,12 @@ bool SqliteAccountState::put(Node *node)
             sqlite3_bind_null(mStmtPutNode, 16);
         }
 
+        sqlite3_bind_blob(mStmtPutNode,
+                          17,
+                          path.data(),
+                          static_cast<int>(path.size()),
+                          SQLITE_STATIC);
+
         sqlResult = sqlite3_step(mStmtPutNode);
     }
 
@@ -1507,7 +2028,40 @@ bool SqliteAccountState::put(Node *node)
 
     sqlite3_reset(mStmtPutNode);
 
-    return sqlResult == SQLITE_DONE;
+    if (sqlResult != SQLITE_DONE)
+    {
+        return false;
+    }
+
+    // Stored before its parent: the parent will have to adopt it
+    if (path.size() == NODE_PATH_KEY_SIZE && !node->parentHandle().isUndef() && mOrphanParents)
+    {
+        mOrphanParents->insert(node->parentHandle().as8byte());
+    }
+
+    if (oldPath.empty())
+    {
+        // New node: its children could have been stored before it (e.g. during fetchnodes)
+        if (!adoptOrphanNodes(node->nodeHandle(), path))
+        {
+            return false;
+        }
+    }
+    else if (oldPath != path)
+    {
+        // Moved node: so are all its descendants
+        if (!updateNodePaths(oldPath, path))
+        {
+            return false;
+        }
+    }
+
+    if (mHasNodeSearchIndex)
+    {
+        return putInNodeSearchIndex(node->nodeHandle());
+    }
+
+    return true;
 }
 
 bool SqliteAccountState::getNode(NodeHandle nodehandle, NodeSerialized &nodeSerialized)
@@ -1775,6 +2329,99 @@ int bindPointer(int& sqlResult, sqlite3_stmt* stmt, int index, void* ptr, const
     }
     return sqlResult;
 }
+
+// The trigram tokenizer of the node search index can't look up shorter strings
+constexpr size_t NODE_SEARCH_MIN_LITERAL_LENGTH = 3;
+
+// Adds an FTS5 phrase, restricted to 'column', for every literal of the pattern (text between
+// wild cards) that is long enough to be looked up in the node search index
+void addNodeSearchPhrases(const std::string& column,
+                          const std::string& pattern,
+                          std::vector<std::string>& phrases)
+{
+    std::string literal;
+    auto addPhrase = [&column, &literal, &phrases]()
+    {
+        const std::string folded = foldCaseAccent(literal.c_str());
+        literal.clear();
+
+        // Length in characters (skip UTF-8 continuation bytes)
+        const auto length = std::count_if(std::begin(folded),
+                                          std::end(folded),
+                                          [](char c) -> bool
+                                          {
+                                              return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+                                          });
+        if (static_cast<size_t>(length) < NODE_SEARCH_MIN_LITERAL_LENGTH)
+            return;
+
+        std::string phrase = column + " : \"";
+        for (const char c: folded)
+        {
+            if (c == '"')
+                phrase.push_back('"');
+            phrase.push_back(c);
+        }
+        phrase.push_back('"');
+        phrases.push_back(std::move(phrase));
+    };
+
+    bool isEscaped = false;
+    for (const char c: pattern)
+    {
+        if (!isEscaped && c == ESCAPE_CHARACTER)
+        {
+            isEscaped = true;
+            continue;
+        }
+
+        if (!isEscaped && (c == WILDCARD_MATCH_ALL || c == WILDCARD_MATCH_ONE))
+            addPhrase();
+        else
+            literal.push_back(c);
+
+        isEscaped = false;
+    }
+    addPhrase();
+}
+}
+
+// The query looks up the candidates for the text conditions of the filter (name, description and
+// tags). Every candidate still has to pass the filter, the query only needs to be a superset of the
+// actual matches.
+std::string getNodeSearchIndexQuery(const NodeSearchFilter& filter)
+{
+    std::vector<std::string> conditions;
+    bool hasConditionWithoutPhrases = false;
+
+    auto addCondition = [&conditions, &hasConditionWithoutPhrases](const std::string& column,
+                                                                   const std::string& text)
+    {
+        std::vector<std::string> phrases;
+        addNodeSearchPhrases(column, text, phrases);
+        if (phrases.empty())
+        {
+            hasConditionWithoutPhrases = true;
+            return;
+        }
+        conditions.push_back("(" + joinStrings(std::cbegin(phrases), std::cend(phrases), " AND ") +
+                             ")");
+    };
+
+    if (filter.hasName())
+        addCondition("name", filter.byName());
+    if (filter.hasDescription())
+        addCondition("description", filter.byDescription());
+    if (filter.hasTag())
+        addCondition("tags", filter.byTag());
+
+    // With OR, a condition that can't be looked up could match any node
+    if (conditions.empty() || (hasConditionWithoutPhrases && !filter.useAndForTextQuery()))
+        return {};
+
+    return joinStrings(std::cbegin(conditions),
+                       std::cend(conditions),
+                       filter.useAndForTextQuery() ? " AND " : " OR ");
 }
 
 bool SqliteAccountState::getChildren(const mega::NodeSearchFilter& filter,
@@ -2054,6 +2701,18 @@ bool SqliteAccountState::searchNodes(const NodeSearchFilter& filter,
                                  SqliteAccountState::progressHandler,
                                  static_cast<void*>(&cancelFlag));
 
+    if (const std::string indexQuery =
+            mHasNodeSearchIndex ? getNodeSearchIndexQuery(filter) : std::string{};
+        !indexQuery.empty())
+    {
+        const bool result = searchNodesUsingIndex(filter, indexQuery, order, nodes, page);
+
+        // unregister the handler (no-op if not registered)
+        sqlite3_progress_handler(db, -1, nullptr, nullptr);
+
+        return result;
+    }
+
     // There are multiple criteria used in ORDER BY clause.
     // For every order type a new statement is created
     size_t cacheId = OrderByClause::getId(order);
@@ -2123,13 +2782,35 @@ bool SqliteAccountState::searchNodes(const NodeSearchFilter& filter,
         // Disabling format for query readability
         // clang-format off
         static const std::string ancestors =
-            "ancestors(nodehandle) \n"s
-            "AS (SELECT nodehandle FROM nodes \n"
+            "ancestors(nodehandle, path) \n"s
+            "AS (SELECT nodehandle, path FROM nodes \n"
                 "WHERE (" + idAncestor1 + " != " + undefStr + " AND nodehandle = " + idAncestor1 + ") "
                 "OR (" + idAncestor2 + " != " + undefStr + " AND nodehandle = " + idAncestor2 + ") "
                 "OR (" + idAncestor3 + " != " + undefStr + " AND nodehandle = " + idAncestor3 + ") "
                 "OR (" + idIncShares + " != " + noShareStr + " AND type != " + filenodeStr + " AND share & " + idIncShares + " != 0))";
 
+        // Nodes below an ancestor are the range (A.path, A.path || x'FF') of 'pathindex'
+        static const std::string belowAncestor =
+            "(N.path > A.path AND N.path < CAST(A.path || x'FF' AS BLOB))"s;
+
+        // Sensitive nodes below each ancestor, only when filtering them out
+        static const std::string sensitives =
+            "sensitives(ancestor, path) \n"
+            "AS (SELECT A.nodehandle, N.path \n"
+                "FROM ancestors AS A \n"
+                "INNER JOIN nodes AS N \n"
+                "ON " + belowAncestor + " \n"
+                "WHERE " + idSens + " = " + onlyTrueStr + " AND (N.flags & " + idSensFlag + ") != 0)";
+
+        // Nodes below those sensitive nodes: one range scan of 'pathindex' per sensitive node,
+        // so that nodesCTE can anti-join against them rather than test every sensitive path
+        static const std::string hidden =
+            "hidden(ancestor, nodehandle) \n"
+            "AS (SELECT S.ancestor, N.nodehandle \n"
+                "FROM sensitives AS S \n"
+                "INNER JOIN nodes AS N \n"
+                "ON N.path > S.path AND N.path < CAST(S.path || x'FF' AS BLOB))";
+
         static const std::string nodesOfShares =
             "nodesOfShares(" + columnsForNodeAndFilters + ") \n"
             "AS (SELECT " + columnsForNodeAndFilters + " \n"
@@ -2137,21 +2818,18 @@ bool SqliteAccountState::searchNodes(const NodeSearchFilter& filter,
                 "WHERE parenthandle NOT IN (SELECT nodehandle FROM ancestors) AND "
                 + idIncShares + " != " + noShareStr + " AND share & " + idIncShares + " != 0)";
 
+        // Nodes below the ancestors, not below a file (only versions are, and they are flagged
+        // as such) unless it's the ancestor itself, nor below a sensitive node if filtering them
         static const std::string nodesCTE =
             "nodesCTE(" + columnsForNodeAndFilters + ") \n"
-            "AS (SELECT " + columnsForNodeAndFilters + " \n"
-                "FROM nodes \n"
-                "WHERE parenthandle IN (SELECT nodehandle FROM ancestors) \n"
-                "UNION ALL \n"
-                "SELECT " + columnsForNodeAndFiltersPrefixN + " \n"
-                "FROM nodes AS N \n"
-                "INNER JOIN nodesCTE AS P \n"
-                "ON (N.parenthandle = P.nodehandle \n"
-                "AND (P.flags & " + idVerFlag + " = 0) \n" // Versions aren't taken in consideration
-                "AND (" + idSens + " != " + onlyTrueStr + // Sensitive nodes
-                " OR " + idSens + " = " + onlyTrueStr +
-                " AND (P.flags & " + idSensFlag + ") = 0) "
-                "AND P.type != " + filenodeStr + "))";
+            "AS (SELECT " + columnsForNodeAndFiltersPrefixN + " \n"
+                "FROM ancestors AS A \n"
+                "INNER JOIN nodes AS N \n"
+                "ON " + belowAncestor + " \n"
+                "LEFT JOIN hidden AS H \n" // Sensitive nodes
+                "ON H.ancestor = A.nodehandle AND H.nodehandle = N.nodehandle \n"
+                "WHERE (N.parenthandle = A.nodehandle OR (N.flags & " + idVerFlag + ") = 0) \n" // Versions aren't taken in consideration
+                "AND H.nodehandle IS NULL)";
 
         static const std::string whereClause =
             "matchFilter("s + idFilter +
@@ -2169,10 +2847,12 @@ bool SqliteAccountState::searchNodes(const NodeSearchFilter& filter,
                 // avoid duplicates (should be faster than SELECT DISTINCT, but possibly require more memory)
                 "GROUP BY nodehandle)";
 
-        /// recursive query considering ancestors
+        /// query considering ancestors
         const std::string query =
             "WITH \n\n" +
             ancestors + ", \n\n" +
+            sensitives + ", \n\n" +
+            hidden + ", \n\n" +
             nodesOfShares + ", \n\n" +
             nodesCTE + ", \n\n" +
             nodesAfterFilters + "\n\n" +
@@ -2218,6 +2898,131 @@ bool SqliteAccountState::searchNodes(const NodeSearchFilter& filter,
     return result;
 }
 
+bool SqliteAccountState::searchNodesUsingIndex(const NodeSearchFilter& filter,
+                                               const std::string& indexQuery,
+                                               int order,
+                                               vector<pair<NodeHandle, NodeSerialized>>& nodes,
+                                               const NodeSearchPage& page)
+{
+    // There are multiple criteria used in ORDER BY clause.
+    // For every order type a new statement is created
+    size_t cacheId = OrderByClause::getId(order);
+    sqlite3_stmt*& stmt = mStmtSearchNodesUsingIndex[cacheId];
+
+    static const QueryTagId idVerFlag{1};
+    static const QueryTagId idIndexQuery{2};
+    static const QueryTagId idAncestor1{3};
+    static const QueryTagId idAncestor2{4};
+    static const QueryTagId idAncestor3{5};
+    static const QueryTagId idPageSize{6};
+    static const QueryTagId idPageOff{7};
+    static const QueryTagId idSens{8};
+    static const QueryTagId idSensFlag{9};
+    static const QueryTagId idIncShares{10};
+    static const QueryTagId idFilter{11};
+
+    int sqlResult = SQLITE_OK;
+    if (!stmt)
+    {
+        // Handful string conversions
+        static const std::string undefStr{std::to_string(static_cast<sqlite3_int64>(UNDEF))};
+        static const std::string noShareStr{std::to_string(NO_SHARES)};
+        static const std::string onlyTrueStr =
+            std::to_string(static_cast<int>(NodeSearchFilter::BoolFilter::onlyTrue));
+        static const std::string filenodeStr = std::to_string(FILENODE);
+
+        using namespace std::string_literals;
+
+        // Instead of walking down from the ancestors through every node (see searchNodes()), the
+        // candidates are looked up in the full-text index and then their parents are walked up
+        // until reaching an ancestor, checking the same conditions on the way.
+
+        // Disabling format for query readability
+        // clang-format off
+        static const std::string ancestors =
+            "ancestors(nodehandle) \n"s
+            "AS (SELECT nodehandle FROM nodes \n"
+                "WHERE (" + idAncestor1 + " != " + undefStr + " AND nodehandle = " + idAncestor1 + ") "
+                "OR (" + idAncestor2 + " != " + undefStr + " AND nodehandle = " + idAncestor2 + ") "
+                "OR (" + idAncestor3 + " != " + undefStr + " AND nodehandle = " + idAncestor3 + ") "
+                "OR (" + idIncShares + " != " + noShareStr + " AND type != " + filenodeStr + " AND share & " + idIncShares + " != 0))";
+
+        static const std::string candidates =
+            "candidates(nodehandle, parenthandle, share) \n"s
+            "AS (SELECT nodehandle, parenthandle, share \n"
+                "FROM nodes \n"
+                "WHERE nodehandle IN (SELECT rowid FROM nodesearch WHERE nodesearch MATCH " + idIndexQuery + ") \n"
+                "AND matchFilter(" + idFilter + ", flags, type, ctime, mtime, mimetypeVirtual, name, description, tags, fav))";
+
+        static const std::string candidatePaths =
+            "candidatePaths(nodehandle, parenthandle) \n"s
+            "AS (SELECT nodehandle, parenthandle \n"
+                "FROM candidates \n"
+                "UNION ALL \n"
+                "SELECT C.nodehandle, P.parenthandle \n"
+                "FROM candidatePaths AS C \n"
+                "INNER JOIN nodes AS P \n"
+                "ON (P.nodehandle = C.parenthandle \n"
+                "AND C.parenthandle NOT IN (SELECT nodehandle FROM ancestors) \n"
+                "AND (P.flags & " + idVerFlag + " = 0) \n" // Versions aren't taken in consideration
+                "AND (" + idSens + " != " + onlyTrueStr + // Sensitive nodes
+                " OR " + idSens + " = " + onlyTrueStr +
+                " AND (P.flags & " + idSensFlag + ") = 0) "
+                "AND P.type != " + filenodeStr + "))";
+
+        static const std::string matches =
+            "matches(nodehandle) \n"s
+            "AS (SELECT nodehandle FROM candidatePaths \n"
+                "WHERE parenthandle IN (SELECT nodehandle FROM ancestors) \n"
+                "UNION \n"
+                "SELECT nodehandle FROM candidates \n"
+                "WHERE " + idIncShares + " != " + noShareStr + " AND share & " + idIncShares + " != 0)";
+
+        const std::string query =
+            "WITH \n\n" +
+            ancestors + ", \n\n" +
+            candidates + ", \n\n" +
+            candidatePaths + ", \n\n" +
+            matches + "\n\n" +
+            "SELECT nodehandle, counter, node \n"
+            "FROM nodes WHERE nodehandle IN (SELECT nodehandle FROM matches) \n"
+            "ORDER BY \n" +
+            OrderByClause::get(order) + " \n" +
+            "LIMIT " + idPageSize + " OFFSET " + idPageOff;
+        // clang-format on
+
+        sqlResult = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, NULL);
+    }
+
+    constexpr uint64_t versionFlag = (1 << Node::FLAGS_IS_VERSION); // exclude file versions
+    constexpr uint64_t senstivityFlag = 1 << Node::FLAGS_IS_MARKED_SENSTIVE; // by sensitivity
+
+    const auto& ancestors = filter.byAncestorHandles();
+    const sqlite3_int64 pageSize = page.size() ? static_cast<sqlite3_int64>(page.size()) : -1;
+    assert(ancestors.size() >= 3); // support at least 3 ancestors
+    NodeSearchFilter filterCopy = filter;
+
+    bindValue(sqlResult, stmt, idVerFlag, versionFlag, sqlite3_bind_int64);
+    bindValue(sqlResult, stmt, idIncShares, filter.includedShares(), sqlite3_bind_int);
+    bindText(sqlResult, stmt, idIndexQuery, indexQuery);
+    bindValue(sqlResult, stmt, idAncestor1, ancestors[0], sqlite3_bind_int64);
+    bindValue(sqlResult, stmt, idAncestor2, ancestors[1], sqlite3_bind_int64);
+    bindValue(sqlResult, stmt, idAncestor3, ancestors[2], sqlite3_bind_int64);
+    bindValue(sqlResult, stmt, idPageSize, pageSize, sqlite3_bind_int64);
+    bindValue(sqlResult, stmt, idPageOff, page.startingOffset(), sqlite3_bind_int64);
+    bindPointer(sqlResult, stmt, idFilter, &filterCopy, NodeSearchFilterPtrStr);
+    bindValue(sqlResult, stmt, idSens, filter.bySensitivity(), sqlite3_bind_int);
+    bindValue(sqlResult, stmt, idSensFlag, senstivityFlag, sqlite3_bind_int64);
+
+    const bool result = (sqlResult == SQLITE_OK) && processSqlQueryNodes(stmt, nodes);
+
+    errorHandler(sqlResult, "Search nodes with filter using index", true);
+
+    sqlite3_reset(stmt);
+
+    return result;
+}
+
 bool SqliteAccountState::getNodesByFingerprintNoMtime(
     const std::string& fingerprint,
     std::vector<std::pair<NodeHandle, NodeSerialized>>& nodes)
@@ -2492,11 +3297,14 @@ bool SqliteAccountState::isAncestor(NodeHandle node, NodeHandle ancestor, Cancel
         return result;
     }
 
-    std::string sqlQuery = "WITH nodesCTE(nodehandle, parenthandle) "
-            "AS (SELECT nodehandle, parenthandle FROM nodes WHERE nodehandle = ? "
-            "UNION ALL SELECT A.nodehandle, A.parenthandle FROM nodes AS A INNER JOIN nodesCTE "
-            "AS E ON (A.nodehandle = E.parenthandle)) "
-            "SELECT * FROM nodesCTE WHERE parenthandle = ?";
+    // Either 'node' is in the range of 'pathindex' below 'ancestor', or 'ancestor' isn't stored
+    // but it's the parent of the top of the path of 'node' (e.g. the parent of an inshare)
+    std::string sqlQuery =
+        "SELECT 1 FROM nodes AS N WHERE N.nodehandle = ?1 "
+        "AND (EXISTS (SELECT 1 FROM nodes AS A WHERE A.nodehandle = ?2 "
+        "AND N.path > A.path AND N.path < CAST(A.path || x'FF' AS BLOB)) "
+        "OR EXISTS (SELECT 1 FROM nodes AS T WHERE T.path = substr(N.path, 1, " +
+        std::to_string(NODE_PATH_KEY_SIZE) + ") AND T.parenthandle = ?2))";
 
     if (cancelFlag.exists())
     {
@@ -2570,6 +3378,120 @@ uint64_t SqliteAccountState::getNumberOfNodes()
     return count;
 }
 
+bool SqliteAccountState::getNodeSkeleton(std::vector<NodeSkeleton::Entry>& entries)
+{
+    if (!db)
+    {
+        return false;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    int sqlResult =
+        sqlite3_prepare_v2(db, "SELECT nodehandle, parenthandle, type FROM nodes", -1, &stmt, NULL);
+    if (sqlResult == SQLITE_OK)
+    {
+        while ((sqlResult = sqlite3_step(stmt)) == SQLITE_ROW)
+        {
+            NodeSkeleton::Entry entry;
+            entry.mHandle = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+            entry.mParentHandle = static_cast<uint64_t>(sqlite3_column_int64(stmt, 1));
+            entry.mType = sqlite3_column_int(stmt, 2);
+            entry.mReserved = 0;
+            entries.push_back(entry);
+        }
+    }
+
+    if (sqlResult != SQLITE_DONE)
+    {
+        errorHandler(sqlResult, "Get node skeleton", false);
+    }
+
+    sqlite3_finalize(stmt);
+
+    return sqlResult == SQLITE_DONE;
+}
+
+bool SqliteAccountState::visitNodesDepthFirst(
+    const std::function<void(const NodeTreeVisit&)>& visitor)
+{
+    if (!db)
+    {
+        return false;
+    }
+
+    // Number of nodes read at a time. The statement is reset before visiting them, so the visitor
+    // can write to the table.
+    static const int NODES_PER_PAGE = 10000;
+
+    // Every node follows its ancestors in 'pathindex', and the next page starts after the path of
+    // the last node visited. The empty blob precedes every path.
+    sqlite3_stmt* stmt = nullptr;
+    int sqlResult = sqlite3_prepare_v2(db,
+                                       "SELECT nodehandle, type, sizeVirtual, flags, path "
+                                       "FROM nodes WHERE path > ? ORDER BY path LIMIT ?",
+                                       -1,
+                                       &stmt,
+                                       NULL);
+
+    std::string lastPath;
+    std::vector<NodeTreeVisit> page;
+
+    while (sqlResult == SQLITE_OK)
+    {
+        page.clear();
+
+        if ((sqlResult = sqlite3_bind_blob(stmt,
+                                           1,
+                                           lastPath.data(),
+                                           static_cast<int>(lastPath.size()),
+                                           SQLITE_TRANSIENT)) == SQLITE_OK &&
+            (sqlResult = sqlite3_bind_int(stmt, 2, NODES_PER_PAGE)) == SQLITE_OK)
+        {
+            while ((sqlResult = sqlite3_step(stmt)) == SQLITE_ROW)
+            {
+                NodeTreeVisit node;
+                node.mHandle.set6byte(static_cast<handle>(sqlite3_column_int64(stmt, 0)));
+                node.mType = static_cast<nodetype_t>(sqlite3_column_int(stmt, 1));
+                node.mSize = sqlite3_column_int64(stmt, 2);
+                node.mFlags = static_cast<uint64_t>(sqlite3_column_int64(stmt, 3));
+
+                auto path = static_cast<const char*>(sqlite3_column_blob(stmt, 4));
+                auto pathSize = static_cast<size_t>(sqlite3_column_bytes(stmt, 4));
+                node.mDepth = pathSize / NODE_PATH_KEY_SIZE;
+                lastPath.assign(path, pathSize);
+
+                page.push_back(node);
+            }
+        }
+
+        sqlite3_reset(stmt);
+
+        if (sqlResult != SQLITE_DONE)
+        {
+            break;
+        }
+
+        for (const auto& node: page)
+        {
+            visitor(node);
+        }
+
+        if (page.size() == static_cast<size_t>(NODES_PER_PAGE))
+        {
+            sqlResult = SQLITE_OK;
+        }
+    }
+
+    if (sqlResult != SQLITE_DONE)
+    {
+        errorHandler(sqlResult, "Visit nodes depth first", false);
+    }
+
+    sqlite3_finalize(stmt);
+
+    return sqlResult == SQLITE_DONE;
+}
+
 uint64_t SqliteAccountState::getNumberOfChildrenByType(NodeHandle parentHandle, nodetype_t nodeType)
 {
     uint64_t count = 0;
@@ -2672,6 +3594,32 @@ void SqliteAccountState::userGetMimetype(sqlite3_context* context, int argc, sql
     sqlite3_result_int(context, result);
 }
 
+void SqliteAccountState::userFoldCaseAccent(sqlite3_context* context,
+                                            int argc,
+                                            sqlite3_value** argv)
+{
+    if (argc != 1)
+    {
+        LOG_err << "Invalid parameters for userFoldCaseAccent (argc=" << argc << ")";
+        assert(argc == 1);
+        sqlite3_result_null(context);
+        return;
+    }
+
+    const char* text = reinterpret_cast<const char*>(sqlite3_value_text(argv[0]));
+    if (!text)
+    {
+        sqlite3_result_null(context);
+        return;
+    }
+
+    const std::string folded = foldCaseAccent(text);
+    sqlite3_result_text(context,
+                        folded.c_str(),
+                        static_cast<int>(folded.size()),
+                        SQLITE_TRANSIENT);
+}
+
 void SqliteAccountState::getFingerprintExcludingMtime(sqlite3_context* context,
                                                       int argc,
                                                       sqlite3_value** argv)
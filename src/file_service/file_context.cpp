@@ -729,6 +729,11 @@ void FileContext::execute(FileFlushRequest request)
                                      std::placeholders::_1)});
 }
 
+void FileContext::execute(FileReadRequest& request)
+{
+    execute(request, true);
+}
+
 // This function is pretty complex as it handles a lot of cases.
 //
 // The basic idea is that we want to get the most value out of any download
@@ -780,7 +785,11 @@ void FileContext::execute(FileFlushRequest request)
 //   - This case is handled pretty much the same as the case above.
 //   - It differs in that the user's request will be executed when the
 //     first hole is downloaded.
-void FileContext::execute(FileReadRequest& request)
+//
+// Separately, if the user seems to be reading the file sequentially, we'll
+// try and anticipate their next read by downloading the data that follows
+// it. See readAhead(...) below for details.
+void FileContext::execute(FileReadRequest& request, bool readAhead)
 {
     // The service's current options.
     auto options = mService.options();
@@ -813,6 +822,10 @@ void FileContext::execute(FileReadRequest& request)
     // Make sure we have exclusive access to mRanges.
     std::unique_lock lock(mRangesLock);
 
+    // Anticipate the user's next read if they're reading sequentially.
+    if (readAhead)
+        this->readAhead(range, options);
+
     // Try and locate the range that either:
     // - Contains the beginning of our read.
     // - Contains the read completely.
@@ -1429,6 +1442,121 @@ FileServiceOptions FileContext::options() const
     return mService.options();
 }
 
+void FileContext::prefetch(FileRange range)
+{
+    // The service's current options.
+    auto options = mService.options();
+
+    // Make sure we have exclusive access to mRanges.
+    std::unique_lock lock(mRangesLock);
+
+    // The user's stopped reading sequentially since we were queued.
+    if (!mReadAheadSize)
+        return;
+
+    // The file's current size.
+    auto size = mInfo->size();
+
+    // Make sure we don't read past the end of the file.
+    range.mEnd = std::min(range.mEnd, size);
+
+    // There's nothing to read ahead.
+    if (range.mBegin >= range.mEnd)
+        return;
+
+    // Add a range to our map and return a reference to its context.
+    auto add = [this](const FileRange& range)
+    {
+        // Add the range to the map.
+        auto [iterator, added] = mRanges.tryAdd(range, nullptr);
+
+        // Adding should always succeed as we're filling holes.
+        assert(added);
+
+        // Convenience.
+        auto& context = iterator->second;
+
+        // Instantiate a context to track the range's download.
+        context.reset(new FileRangeContext(mActivities.begin(), iterator, *this));
+
+        // Return a reference to the context to our caller.
+        return context.get();
+    }; // add
+
+    // Where does the first range after our read-ahead begin?
+    auto bound = [&]()
+    {
+        // Try and find the first range that begins after our read-ahead ends.
+        auto i = mRanges.beginsAfter(range.mEnd);
+
+        // No range follows our read-ahead.
+        if (i == mRanges.end())
+            return size;
+
+        // Return the range's beginning to our caller.
+        return i->first.mBegin;
+    }();
+
+    // Tracks the ranges that we need to download.
+    std::vector<FileRangeContext*> ranges;
+
+    // Where does the current hole begin?
+    auto scratch = range.mBegin;
+
+    // Iterate over the holes, creating ranges as needed.
+    for (auto [i, j] = mRanges.find(range); i != j; ++i)
+    {
+        // The range begins after scratch.
+        if (i->first.mBegin > scratch)
+            ranges.emplace_back(add(FileRange(scratch, i->first.mBegin)));
+
+        // Bump scratch's beginning.
+        scratch = std::max(scratch, i->first.mEnd);
+    }
+
+    // A final hole still remains.
+    //
+    // Make sure its download is worthwhile.
+    if (scratch < range.mEnd)
+    {
+        auto end = std::max(range.mEnd, scratch + options.mMinimumRangeSize);
+
+        ranges.emplace_back(add(FileRange(scratch, std::min(end, bound))));
+    }
+
+    // We already have (or are downloading) all of the data.
+    if (ranges.empty())
+        return;
+
+    FSDebugF("Reading ahead %s of %s", toString(range).c_str(), toString(mInfo->id()).c_str());
+
+    // Keep track of the downloads we need to begin.
+    std::vector<PartialDownloadPtr> downloads;
+
+    // We know how many downloads we need to begin.
+    downloads.reserve(ranges.size());
+
+    // Convenience.
+    auto& client = mService.client();
+
+    // The handle of the node we're downloading.
+    auto handle = mInfo->handle();
+
+    // Try and create downloads for our ranges.
+    for (auto* range_: ranges)
+    {
+        if (auto download = range_->download(client, mBuffer, handle, mKeyData))
+            downloads.emplace_back(std::move(download));
+    }
+
+    // Release our mRanges lock so we can safely begin the downloads.
+    lock.unlock();
+
+    // Begin the downloads.
+    for (auto& download: downloads)
+        download->begin();
+}
+
 template<typename Request>
 auto FileContext::queue(std::unique_lock<std::mutex> lock, Request&& request)
     -> std::enable_if_t<IsFileRequestV<Request>>
@@ -1464,6 +1592,95 @@ void FileContext::queued([[maybe_unused]] std::unique_lock<std::mutex> lock, Fil
     ++mNumPendingWriteRequests;
 }
 
+// Read-ahead is driven by the offsets of the reads we receive.
+//
+// A read is considered sequential if it begins where the previous read
+// ended. Each sequential read doubles how much data we read ahead of the
+// user, up to mMaximumReadAheadSize, and any data in that window we don't
+// already have is downloaded asynchronously.
+//
+// When a read isn't sequential, the window is reset and any read-ahead
+// downloads that no one's waiting for are cancelled.
+void FileContext::readAhead(const FileRange& range, const FileServiceOptions& options)
+{
+    // Sanity.
+    assert(range.mBegin < range.mEnd);
+
+    // Convenience.
+    auto [begin, end] = range;
+
+    // Let the user know whether their read could be satisfied by data we
+    // have or are already downloading.
+    {
+        auto [i, j] = mRanges.find(FileRange(begin, begin + 1));
+        mInfo->read(i != j);
+    }
+
+    // Is the user reading the file sequentially?
+    auto sequential = mReadAheadOffset && begin == *mReadAheadOffset;
+
+    // The user's next read is sequential if it begins where this one ends.
+    mReadAheadOffset = end;
+
+    // User's reading sequentially and read-ahead is enabled.
+    if (sequential && options.mMaximumReadAheadSize)
+    {
+        // Our window should be at least as large as a normal download.
+        auto minimumSize = std::max(end - begin, options.mMinimumRangeSize);
+
+        // Grow our read-ahead window.
+        mReadAheadSize = std::max(mReadAheadSize * 2, minimumSize);
+        mReadAheadSize = std::min(mReadAheadSize, options.mMaximumReadAheadSize);
+
+        // We're still far enough ahead of the user.
+        if (mReadAheadRange.mEnd > end && mReadAheadRange.mEnd - end >= mReadAheadSize / 2)
+            return;
+
+        // What data should we read ahead?
+        mReadAheadRange = FileRange(end, end + mReadAheadSize);
+
+        // Downloads the data on the service's thread pool.
+        auto prefetch = [cookie = weak_from_this(), range = mReadAheadRange]()
+        {
+            if (auto context = cookie.lock())
+                context->prefetch(range);
+        }; // prefetch
+
+        // Read ahead of the user.
+        return execute(std::move(prefetch));
+    }
+
+    // We weren't reading ahead of the user.
+    if (!mReadAheadSize)
+        return;
+
+    // Reset our read-ahead window.
+    mReadAheadSize = 0u;
+
+    // Tracks the read-ahead downloads that are still in progress.
+    std::vector<FileRangeContextPtr> contexts;
+
+    for (auto [i, j] = mRanges.find(mReadAheadRange); i != j; ++i)
+    {
+        // Range has already been downloaded.
+        if (!i->second)
+            continue;
+
+        // Range contains some of the user's read.
+        if (i->first.mBegin < end && i->first.mEnd > begin)
+            continue;
+
+        // Latch the context so we can cancel its download.
+        contexts.emplace_back(i->second);
+    }
+
+    mReadAheadRange = FileRange(0u, 0u);
+
+    // Cancel any downloads that no one's waiting for.
+    for (auto& context: contexts)
+        context->abandon();
+}
+
 template<typename Request>
 auto FileContext::reject([[maybe_unused]] const Request& request)
     -> std::enable_if_t<IsFileRequestV<Request>, FileResult>
@@ -1494,6 +1711,29 @@ void FileContext::removeRanges(const FileRange& range, Transaction& transaction)
     query.execute();
 }
 
+void FileContext::retry(FileReadRequest&& request)
+{
+    // Called on the service's thread pool to execute the request again.
+    auto retry = [](std::weak_ptr<FileContext>& cookie, FileReadRequest& request, const Task& task)
+    {
+        // Check if our context is still alive.
+        auto context = cookie.lock();
+
+        // Context's dead or the service's being torn down.
+        if (!context || task.cancelled())
+            return request.mCallback(unexpected(FILE_CANCELLED));
+
+        // Execute the request again.
+        context->execute(request, false);
+    }; // retry
+
+    // Queue the request for execution.
+    mService.execute(std::bind(std::move(retry),
+                               weak_from_this(),
+                               std::move(request),
+                               std::placeholders::_1));
+}
+
 FileResult FileContext::setRemoved(bool replaced)
 try
 {
@@ -1633,6 +1873,9 @@ FileContext::FileContext(Activity activity,
     mNumPendingWriteRequests(0u),
     mRanges(),
     mRangesLock(),
+    mReadAheadOffset(),
+    mReadAheadRange(0u, 0u),
+    mReadAheadSize(0u),
     mReadWriteState(),
     mReclaimContext(),
     mReclaimContextLock(),
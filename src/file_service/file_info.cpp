@@ -75,6 +75,16 @@ std::int64_t FileInfo::modified() const
     return mContext->modified();
 }
 
+std::uint64_t FileInfo::readHits() const
+{
+    return mContext->readHits();
+}
+
+std::uint64_t FileInfo::readMisses() const
+{
+    return mContext->readMisses();
+}
+
 void FileInfo::removeObserver(FileEventObserverID id)
 {
     mContext->removeObserver(id);
@@ -64,6 +64,8 @@ FileInfoContext::FileInfoContext(std::int64_t accessed,
     mLocation(std::move(location)),
     mLock(),
     mModified(modified),
+    mReadHits(0u),
+    mReadMisses(0u),
     mRemoved(false),
     mReportedSize(reportedSize),
     mService(service),
@@ -189,6 +191,23 @@ std::int64_t FileInfoContext::modified() const
     return get(&FileInfoContext::mModified);
 }
 
+void FileInfoContext::read(bool hit)
+{
+    std::lock_guard guard(mLock);
+
+    ++(hit ? mReadHits : mReadMisses);
+}
+
+std::uint64_t FileInfoContext::readHits() const
+{
+    return get(&FileInfoContext::mReadHits);
+}
+
+std::uint64_t FileInfoContext::readMisses() const
+{
+    return get(&FileInfoContext::mReadMisses);
+}
+
 void FileInfoContext::removed(bool replaced)
 {
     set(&FileInfoContext::mRemoved, true);
@@ -55,8 +55,11 @@ void FileRangeContext::completed([[maybe_unused]] Lock&& lock, Error result)
             // Convenience.
             auto& request = const_cast<FileReadRequest&>(*i);
 
-            // Fail the request.
-            mManager.failed(std::move(request), result_);
+            // Request arrived after we were abandoned so try it again.
+            if (mAbandoned)
+                mManager.retry(std::move(request));
+            else
+                mManager.failed(std::move(request), result_);
 
             // Remove the request from our set.
             i = mRequests.erase(i);
@@ -197,6 +200,7 @@ FileRangeContext::FileRangeContext(Activity activity,
                                    FileRangeContextManager& manager):
     PartialDownloadCallback(),
     mInstanceLogger("FileRangeContext", *this, logger()),
+    mAbandoned(false),
     mActivity(std::move(activity)),
     mBuffer(),
     mCallbacks(),
@@ -213,6 +217,19 @@ FileRangeContext::~FileRangeContext()
     assert(mRequests.empty());
 }
 
+void FileRangeContext::abandon()
+{
+    // Someone's waiting for our data.
+    if (!mRequests.empty() || !mCallbacks.empty())
+        return;
+
+    // Any requests that arrive from now on will need to be retried.
+    mAbandoned = true;
+
+    // Cancel our download.
+    cancel();
+}
+
 void FileRangeContext::cancel()
 {
     // Download's alive so cancel it.
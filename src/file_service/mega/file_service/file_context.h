@@ -21,7 +21,7 @@
 #include <mega/file_service/file_info_forward.h>
 #include <mega/file_service/file_range_context_manager.h>
 #include <mega/file_service/file_range_context_pointer_map.h>
-#include <mega/file_service/file_range_forward.h>
+#include <mega/file_service/file_range.h>
 #include <mega/file_service/file_range_vector.h>
 #include <mega/file_service/file_read_request_forward.h>
 #include <mega/file_service/file_read_write_state.h>
@@ -40,6 +40,7 @@
 #include <list>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <type_traits>
 #include <variant>
 
@@ -122,6 +123,10 @@ class FileContext final: FileRangeContextManager, public std::enable_shared_from
     // Try and execute a read request.
     void execute(FileReadRequest& request);
 
+    // Same as above but lets the caller decide whether the read should be
+    // considered when deciding whether to read ahead.
+    void execute(FileReadRequest& request, bool readAhead);
+
     // Try and execute a reclaim request.
     void execute(FileReclaimRequest& request);
 
@@ -167,6 +172,9 @@ class FileContext final: FileRangeContextManager, public std::enable_shared_from
     // Retrieve a copy of the service's current options.
     FileServiceOptions options() const override;
 
+    // Download any data in the specified range that we don't already have.
+    void prefetch(FileRange range);
+
     // Queue a request for later execution.
     template<typename Request>
     auto queue(std::unique_lock<std::mutex> lock, Request&& request)
@@ -176,6 +184,9 @@ class FileContext final: FileRangeContextManager, public std::enable_shared_from
     void queued(std::unique_lock<std::mutex> lock, FileReadRequestTag tag);
     void queued(std::unique_lock<std::mutex> lock, FileWriteRequestTag tag);
 
+    // Track how the file's being read and read ahead if it's being read sequentially.
+    void readAhead(const FileRange& range, const FileServiceOptions& options);
+
     // Return an error if this request should be rejected.
     template<typename Request>
     auto reject(const Request& request) -> std::enable_if_t<IsFileRequestV<Request>, FileResult>;
@@ -183,6 +194,9 @@ class FileContext final: FileRangeContextManager, public std::enable_shared_from
     // Remove zero or more ranges from the database.
     void removeRanges(const FileRange& range, common::Transaction& transaction);
 
+    // Called when a file read request must be executed again.
+    void retry(FileReadRequest&& request) override;
+
     // Mark the file as removed.
     FileResult setRemoved(bool replaced);
 
@@ -237,6 +251,20 @@ class FileContext final: FileRangeContextManager, public std::enable_shared_from
     // Serializes access to mRanges.
     mutable std::recursive_mutex mRangesLock;
 
+    // Where do we expect the next sequential read to begin?
+    //
+    // Empty until the first read so that no read is sequential before a
+    // previous read has ended where it begins.
+    //
+    // mReadAhead* members are protected by mRangesLock.
+    std::optional<std::uint64_t> mReadAheadOffset;
+
+    // What range did we last read ahead?
+    FileRange mReadAheadRange;
+
+    // How much data are we currently reading ahead?
+    std::uint64_t mReadAheadSize;
+
     // Tracks whether any reads or writes are in progress.
     FileReadWriteState mReadWriteState;
 
@@ -67,6 +67,12 @@ class FileInfoContext: FileEventEmitter, public FileSizeInfo
     // The time the file was last modified.
     std::int64_t mModified;
 
+    // How many reads were satisfied by data we had or were downloading?
+    std::uint64_t mReadHits;
+
+    // How many reads had to wait for a new download?
+    std::uint64_t mReadMisses;
+
     // Has this file been removed?
     bool mRemoved;
 
@@ -133,6 +139,15 @@ public:
     // When was this file last modified?
     auto modified() const -> std::int64_t;
 
+    // Record whether a read was satisfied by data we had or were downloading.
+    void read(bool hit);
+
+    // How many reads were satisfied by data we had or were downloading?
+    std::uint64_t readHits() const;
+
+    // How many reads had to wait for a new download?
+    std::uint64_t readMisses() const;
+
     // Remove an observer.
     using FileEventEmitter::removeObserver;
 
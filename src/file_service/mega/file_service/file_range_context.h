@@ -52,6 +52,9 @@ class FileRangeContext: private common::PartialDownloadCallback
     // Logs instance lifetime.
     common::InstanceLogger<FileRangeContext> mInstanceLogger;
 
+    // True if our download was cancelled because no one wanted our data.
+    bool mAbandoned;
+
     // Keeps our manager alive until we're dead.
     common::Activity mActivity;
 
@@ -83,6 +86,9 @@ public:
 
     ~FileRangeContext();
 
+    // Cancel this range's download if no one's waiting for its data.
+    void abandon();
+
     // Cancel this range's download.
     void cancel();
 
@@ -46,6 +46,9 @@ public:
 
     // Retrieve a copy of the service's current options.
     virtual FileServiceOptions options() const = 0;
+
+    // Called when a file read request must be executed again.
+    virtual void retry(FileReadRequest&& request) = 0;
 }; // FileRangeContextManager
 
 } // file_service
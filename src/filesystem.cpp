@@ -48,7 +48,9 @@ namespace mega
 std::atomic<int> FileSystemAccess::mMinimumDirectoryPermissions{0700};
 std::atomic<int> FileSystemAccess::mMinimumFilePermissions{0600};
 
+#ifdef MEGA_MEASURE_CODE
 CodeCounter::ScopeStats g_compareUtfTimings("compareUtfTimings");
+#endif // MEGA_MEASURE_CODE
 
 FSLogging FSLogging::noLogging(eNoLogging);
 FSLogging FSLogging::logOnError(eLogOnError);
@@ -134,7 +136,10 @@ int compareUtf(UnicodeCodepointIterator<CharT> first1, bool unescaping1,
                UnicodeCodepointIterator<CharU> first2, bool unescaping2,
                UnaryOperation transform)
 {
+#ifdef MEGA_MEASURE_CODE
+    // Too hot to time outside of measurement builds.
     CodeCounter::ScopeTimer rst(g_compareUtfTimings);
+#endif // MEGA_MEASURE_CODE
 
 #ifdef _WIN32
     first1 = skipPrefix(first1);
@@ -1704,8 +1709,10 @@ bool isNetworkFilesystem(FileSystemType type)
 
 
 std::atomic<size_t> ScanService::mNumServices(0);
-std::unique_ptr<ScanService::Worker> ScanService::mWorker;
+std::shared_ptr<ScanService::Worker> ScanService::mWorker;
 std::mutex ScanService::mWorkerLock;
+size_t ScanService::mNumThreads = 1;
+std::mutex ScanService::mSetNumThreadsLock;
 
 ScanService::ScanService()
 {
@@ -1715,7 +1722,7 @@ ScanService::ScanService()
 
     if (++mNumServices == 1)
     {
-        mWorker.reset(new Worker());
+        mWorker = std::make_shared<Worker>(mNumThreads);
     }
 }
 
@@ -1728,6 +1735,38 @@ ScanService::~ScanService()
     }
 }
 
+void ScanService::setNumThreads(size_t numThreads)
+{
+    // Always at least one thread.
+    numThreads = std::max<size_t>(numThreads, 1);
+
+    // The last call must win: its resize can't be overtaken by that of an earlier call.
+    std::lock_guard<std::mutex> setLock(mSetNumThreadsLock);
+
+    std::shared_ptr<Worker> worker;
+
+    {
+        std::lock_guard<std::mutex> lock(mWorkerLock);
+
+        LOG_debug << "Setting ScanService threads to " << numThreads;
+        mNumThreads = numThreads;
+        worker = mWorker;
+    }
+
+    // Surplus threads are joined once they finish their current scan: don't keep services from
+    // being created or destroyed meanwhile.
+    if (worker)
+    {
+        worker->resize(numThreads);
+    }
+}
+
+size_t ScanService::numThreads()
+{
+    std::lock_guard<std::mutex> lock(mWorkerLock);
+    return mNumThreads;
+}
+
 auto ScanService::queueScan(LocalPath targetPath, handle expectedFsid, bool followSymlinks, map<LocalPath, FSNode>&& priorScanChildren, shared_ptr<Waiter> waiter) -> RequestPtr
 {
     // Create a request to represent the scan.
@@ -1754,6 +1793,51 @@ ScanService::ScanRequest::ScanRequest(shared_ptr<Waiter> waiter,
 {
 }
 
+auto ScanService::ScanRequest::Stats::operator+=(const Stats& other) -> Stats&
+{
+    numEntries += other.numEntries;
+    numFingerprinted += other.numFingerprinted;
+    bytesFingerprinted += other.bytesFingerprinted;
+
+    // Scans run in several threads and complete in any order: only count the time other ran
+    // outside of the latest run of overlapping scans.
+    auto otherStarted = other.finished - other.elapsed;
+
+    if (otherStarted >= finished)
+    {
+        elapsed += other.elapsed;
+        started = otherStarted;
+    }
+    else
+    {
+        if (otherStarted < started)
+        {
+            elapsed += started - otherStarted;
+            started = otherStarted;
+        }
+
+        if (other.finished > finished)
+        {
+            elapsed += other.finished - finished;
+        }
+    }
+
+    finished = std::max(finished, other.finished);
+    return *this;
+}
+
+double ScanService::ScanRequest::Stats::entriesPerSecond() const
+{
+    auto seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0 ? static_cast<double>(numEntries) / seconds : 0;
+}
+
+double ScanService::ScanRequest::Stats::bytesFingerprintedPerSecond() const
+{
+    auto seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0 ? static_cast<double>(bytesFingerprinted) / seconds : 0;
+}
+
 ScanService::Worker::Worker(size_t numThreads)
     : mFsAccess(new FSACCESS_CLASS())
     , mPending()
@@ -1766,20 +1850,8 @@ ScanService::Worker::Worker(size_t numThreads)
 
     LOG_debug << "Starting ScanService worker...";
 
-    // Start the threads.
-    while (numThreads--)
-    {
-        try
-        {
-            mThreads.emplace_back([this]() { loop(); });
-        }
-        catch (std::system_error& e)
-        {
-            LOG_err << "Failed to start worker thread: " << e.what();
-        }
-    }
+    resize(numThreads);
 
-    LOG_debug << mThreads.size() << " worker thread(s) started.";
     LOG_debug << "ScanService worker started.";
 }
 
@@ -1787,6 +1859,8 @@ ScanService::Worker::~Worker()
 {
     LOG_debug << "Stopping ScanService worker...";
 
+    std::lock_guard<std::mutex> resizeLock(mResizeLock);
+
     // Queue the 'terminate' sentinel.
     {
         std::unique_lock<std::mutex> lock(mPendingLock);
@@ -1807,6 +1881,57 @@ ScanService::Worker::~Worker()
     LOG_debug << "ScanService worker stopped.";
 }
 
+void ScanService::Worker::resize(size_t numThreads)
+{
+    assert(numThreads > 0);
+
+    std::lock_guard<std::mutex> resizeLock(mResizeLock);
+    std::vector<std::thread> stopping;
+
+    {
+        std::unique_lock<std::mutex> lock(mPendingLock);
+        mNumActiveThreads = numThreads;
+
+        while (mThreads.size() > numThreads)
+        {
+            stopping.emplace_back(std::move(mThreads.back()));
+            mThreads.pop_back();
+        }
+    }
+
+    // Surplus threads exit once they finish what they're doing.
+    mPendingNotifier.notify_all();
+
+    for (auto& thread : stopping)
+    {
+        thread.join();
+    }
+
+    while (mThreads.size() < numThreads)
+    {
+        try
+        {
+            startThread(mThreads.size());
+        }
+        catch (std::system_error& e)
+        {
+            LOG_err << "Failed to start worker thread: " << e.what();
+            break;
+        }
+    }
+
+    LOG_debug << mThreads.size() << " worker thread(s) running.";
+}
+
+void ScanService::Worker::startThread(size_t threadIndex)
+{
+    mThreads.emplace_back(
+        [this, threadIndex]()
+        {
+            loop(threadIndex);
+        });
+}
+
 void ScanService::Worker::queue(ScanRequestPtr request)
 {
     // Queue the request.
@@ -1819,10 +1944,13 @@ void ScanService::Worker::queue(ScanRequestPtr request)
     mPendingNotifier.notify_one();
 }
 
-void ScanService::Worker::loop()
+void ScanService::Worker::loop(size_t threadIndex)
 {
     // We're ready when we have some work to do.
-    auto ready = [this]() { return !mPending.empty(); };
+    auto ready = [this, threadIndex]()
+    {
+        return !mFingerprints.empty() || !mPending.empty() || threadIndex >= mNumActiveThreads;
+    };
 
     for ( ; ; )
     {
@@ -1833,7 +1961,24 @@ void ScanService::Worker::loop()
             std::unique_lock<std::mutex> lock(mPendingLock);
             mPendingNotifier.wait(lock, ready);
 
-            assert(ready()); // condition variable should have taken care of this
+            // Help with the directories already being fingerprinted before starting others.
+            if (!mFingerprints.empty())
+            {
+                auto job = std::move(mFingerprints.front());
+                mFingerprints.pop_front();
+                lock.unlock();
+
+                fingerprint(job);
+                continue;
+            }
+
+            // Are we surplus after a resize?
+            if (threadIndex >= mNumActiveThreads)
+            {
+                return;
+            }
+
+            assert(!mPending.empty()); // condition variable should have taken care of this
 
             // Are we being told to terminate?
             if (!mPending.front())
@@ -1847,20 +1992,20 @@ void ScanService::Worker::loop()
         }
 
         LOG_verbose << "Directory scan begins: " << request->mTargetPath;
-        using namespace std::chrono;
-        auto scanStart = high_resolution_clock::now();
 
         // Process the request.
-        unsigned nFingerprinted = 0;
-        auto result = scan(request, nFingerprinted);
-        auto scanEnd = high_resolution_clock::now();
+        auto result = scan(request);
 
         if (result == SCAN_SUCCESS)
         {
+            using namespace std::chrono;
+
+            const auto& stats = request->mStats;
             LOG_verbose << "Directory scan complete for: " << request->mTargetPath
-                << " entries: " << request->mResults.size()
-                << " taking " << duration_cast<milliseconds>(scanEnd - scanStart).count() << "ms"
-                << " fingerprinted: " << nFingerprinted;
+                << " entries: " << stats.numEntries
+                << " taking " << duration_cast<milliseconds>(stats.elapsed).count() << "ms"
+                << " fingerprinted: " << stats.numFingerprinted
+                << " (" << stats.bytesFingerprinted << " bytes)";
         }
         else
         {
@@ -1876,23 +2021,107 @@ void ScanService::Worker::loop()
 // regardless of multiple clients too - there is only one filesystem after all (but not singleton!!)
 CodeCounter::ScopeStats ScanService::syncScanTime = { "folderScan" };
 
-auto ScanService::Worker::scan(ScanRequestPtr request, unsigned& nFingerprinted) -> ScanResult
+auto ScanService::Worker::scan(ScanRequestPtr request) -> ScanResult
 {
     CodeCounter::ScopeTimer rst(syncScanTime);
+    auto start = std::chrono::steady_clock::now();
 
+    std::vector<PendingFingerprint> pendingFingerprints;
     auto result = mFsAccess->directoryScan(request->mTargetPath,
         request->mExpectedFsid,
         request->mKnown,
         request->mResults,
         request->mFollowSymLinks,
-        nFingerprinted);
+        pendingFingerprints);
 
     // No need to keep this data around anymore.
     request->mKnown.clear();
 
+    if (result == SCAN_SUCCESS)
+    {
+        fingerprint(request, std::move(pendingFingerprints));
+    }
+
+    request->mStats.numEntries = request->mResults.size();
+    request->mStats.started = start;
+    request->mStats.finished = std::chrono::steady_clock::now();
+    request->mStats.elapsed = request->mStats.finished - start;
+
     return result;
 }
 
+void ScanService::Worker::fingerprint(ScanRequestPtr request,
+                                      std::vector<PendingFingerprint>&& pending)
+{
+    if (pending.empty())
+    {
+        return;
+    }
+
+    auto batch = std::make_shared<FingerprintBatch>();
+    batch->request = std::move(request);
+    batch->numPending = pending.size();
+
+    std::unique_lock<std::mutex> lock(mPendingLock);
+
+    for (auto& fingerprint : pending)
+    {
+        mFingerprints.push_back(FingerprintJob{batch, std::move(fingerprint)});
+    }
+
+    lock.unlock();
+    mPendingNotifier.notify_all();
+    lock.lock();
+
+    // Idle threads help, but this one fingerprints too until the whole directory is done.
+    for ( ; ; )
+    {
+        mPendingNotifier.wait(lock,
+                              [this, &batch]()
+                              {
+                                  return !batch->numPending || !mFingerprints.empty();
+                              });
+
+        if (!batch->numPending)
+        {
+            break;
+        }
+
+        auto job = std::move(mFingerprints.front());
+        mFingerprints.pop_front();
+        lock.unlock();
+
+        fingerprint(job);
+
+        lock.lock();
+    }
+
+    auto& stats = batch->request->mStats;
+    stats.numFingerprinted = batch->numFingerprinted;
+    stats.bytesFingerprinted = batch->bytesFingerprinted;
+}
+
+void ScanService::Worker::fingerprint(FingerprintJob& job)
+{
+    auto& batch = *job.batch;
+    auto& node = batch.request->mResults[job.fingerprint.index];
+
+    if (job.fingerprint.compute(node))
+    {
+        ++batch.numFingerprinted;
+        batch.bytesFingerprinted += node.fingerprint.size;
+    }
+
+    if (--batch.numPending == 0)
+    {
+        // Taking the lock ensures the owner of the batch is either waiting or yet to check.
+        {
+            std::lock_guard<std::mutex> lock(mPendingLock);
+        }
+        mPendingNotifier.notify_all();
+    }
+}
+
 unique_ptr<FSNode> FSNode::fromFOpened(FileAccess& fa, const LocalPath& fullPath, FileSystemAccess& fsa)
 {
     unique_ptr<FSNode> result(new FSNode);
@@ -24,6 +24,7 @@ using namespace common;
 
 Service::Service(Client& client, const ServiceFlags& flags)
   : mClient(client)
+  , mFileService(nullptr)
   , mContext()
   , mFlags(flags)
   , mFlagsLock()
@@ -36,6 +37,12 @@ Service::Service(Client& client)
 {
 }
 
+Service::Service(Client& client, file_service::FileService& fileService)
+  : Service(client, ServiceFlags())
+{
+    mFileService = &fileService;
+}
+
 Service::~Service()
 {
     FUSEDebug1("Service destroyed");
@@ -271,6 +278,14 @@ ServiceFlags Service::serviceFlags() const
     return mFlags;
 }
 
+ServiceStatistics Service::statistics() const
+{
+    if (mContext)
+        return mContext->statistics();
+
+    return ServiceStatistics();
+}
+
 void Service::updated(NodeEventQueue& events)
 {
     if (mContext)
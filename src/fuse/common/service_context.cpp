@@ -23,6 +23,11 @@ Client& ServiceContext::client() const
     return mService.mClient;
 }
 
+file_service::FileService* ServiceContext::fileService() const
+{
+    return mService.mFileService;
+}
+
 void ServiceContext::serviceFlags(const ServiceFlags&)
 {
 }
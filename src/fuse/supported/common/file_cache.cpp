@@ -353,6 +353,11 @@ TaskExecutor& FileCache::executor() const
     return mContext.mExecutor;
 }
 
+file_service::FileService* FileCache::fileService() const
+{
+    return mContext.fileService();
+}
+
 void FileCache::flush(const Mount& mount, FileInodeRefVector inodes)
 {
     // Flush each inode to the cloud.
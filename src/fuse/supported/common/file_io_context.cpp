@@ -3,6 +3,15 @@
 #include <mega/common/node_info.h>
 #include <mega/common/task_executor.h>
 #include <mega/common/upload.h>
+#include <mega/file_service/file.h>
+#include <mega/file_service/file_id.h>
+#include <mega/file_service/file_read_result.h>
+#include <mega/file_service/file_result.h>
+#include <mega/file_service/file_result_or.h>
+#include <mega/file_service/file_service.h>
+#include <mega/file_service/file_service_result.h>
+#include <mega/file_service/file_service_result_or.h>
+#include <mega/file_service/source.h>
 #include <mega/fuse/common/client.h>
 #include <mega/fuse/common/file_cache.h>
 #include <mega/fuse/common/file_info.h>
@@ -113,6 +122,12 @@ ErrorOr<FileAccessSharedPtr> FileIOContext::create()
     // File's been successfully created.
     mFileInfo = std::move(*info);
 
+    // Reads will now be satisfied locally.
+    {
+        std::lock_guard<std::mutex> guard(mRemoteFileLock);
+        mRemoteFile.reset();
+    }
+
     // Inject description into inode.
     mFile->fileInfo(mFileInfo);
 
@@ -196,6 +211,12 @@ ErrorOr<FileAccessSharedPtr> FileIOContext::download(const Mount& mount)
     mFileInfo = std::move(*info);
     mFilePath = std::move(path);
 
+    // Reads will now be satisfied locally.
+    {
+        std::lock_guard<std::mutex> guard(mRemoteFileLock);
+        mRemoteFile.reset();
+    }
+
     // Inject description into inode.
     mFile->fileInfo(mFileInfo);
 
@@ -209,6 +230,30 @@ ErrorOr<FileAccessSharedPtr> FileIOContext::download(const Mount& mount)
     return fileAccess;
 }
 
+void FileIOContext::firstByte(bool remote)
+{
+    std::optional<std::chrono::steady_clock::time_point> opened;
+
+    // Latch the time the file was opened.
+    {
+        std::lock_guard<std::mutex> guard(mRemoteFileLock);
+        std::swap(opened, mOpened);
+    }
+
+    // We've already read from the file since it was opened.
+    if (!opened)
+        return;
+
+    // Compute how long it took for the first byte to arrive.
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - *opened);
+
+    FUSEInfoF("Time to first byte for %s: %lldms (%s)",
+              toString(mFile->id()).c_str(),
+              static_cast<long long>(elapsed.count()),
+              remote ? "sparse read" : "local read");
+}
+
 std::chrono::seconds FileIOContext::flushDelay() const
 {
     return mFileCache.mContext.serviceFlags().mFlushDelay;
@@ -429,6 +474,126 @@ auto FileIOContext::open(FileIOContextSharedLock& shared, const Mount& mount, m_
     return result;
 }
 
+ErrorOr<std::string>
+    FileIOContext::read(file_service::File& file, m_off_t offset, unsigned int size)
+{
+    using file_service::FileReadResult;
+    using file_service::FileResultOr;
+
+    // Convenience.
+    auto fileSize = mFile->info().mSize;
+
+    // Clamp offset.
+    offset = std::min(offset, fileSize);
+
+    // Clamp size.
+    size = std::min(static_cast<unsigned int>(fileSize - offset), size);
+
+    // No data available for reading.
+    if (!size)
+        return std::string();
+
+    std::string buffer(size, '\0');
+    std::uint64_t count = 0u;
+
+    // The file service may satisfy our request in several chunks.
+    while (count < size)
+    {
+        // So we can wait for the file service's result.
+        std::promise<FileResultOr<std::uint64_t>> waiter;
+
+        // Copies the data we've read into our buffer.
+        auto wrapper = [&](FileResultOr<FileReadResult> result)
+        {
+            // Couldn't read any data.
+            if (!result)
+                return waiter.set_value(unexpected(result.error()));
+
+            // Make sure we don't overrun our buffer.
+            auto length = std::min<std::uint64_t>(result->mLength, size - count);
+
+            // Copy data into our buffer.
+            auto [copied, _] = result->mSource.read(&buffer[count], 0, length);
+
+            // Let our waiter know how much data we received.
+            waiter.set_value(copied);
+        }; // wrapper
+
+        // Ask the file service for the data we haven't received yet.
+        file.read(std::move(wrapper), static_cast<std::uint64_t>(offset) + count, size - count);
+
+        // Wait for the file service to provide our data.
+        auto result = waiter.get_future().get();
+
+        // Couldn't read from the file.
+        if (!result)
+        {
+            FUSEWarningF("Couldn't read %u byte(s) at offset %lld from %s: %s",
+                         size,
+                         static_cast<long long>(offset),
+                         toString(mFile->id()).c_str(),
+                         file_service::toString(result.error()));
+
+            return unexpected(API_EREAD);
+        }
+
+        // File's shorter than we expected.
+        if (!*result)
+            break;
+
+        count += *result;
+    }
+
+    // Return only what we actually read.
+    buffer.resize(static_cast<std::size_t>(count));
+
+    // Let interested parties know how long the read took.
+    firstByte(true);
+
+    // Return result to caller.
+    return buffer;
+}
+
+file_service::File* FileIOContext::remoteFile()
+{
+    // Convenience.
+    auto* service = mFileCache.fileService();
+
+    // No file service is available.
+    if (!service)
+        return nullptr;
+
+    // File doesn't exist in the cloud.
+    if (mFile->removed() || mFile->handle().isUndef())
+        return nullptr;
+
+    // Make sure no one else is opening the file.
+    std::lock_guard<std::mutex> guard(mRemoteFileLock);
+
+    // File's already been opened.
+    if (mRemoteFile)
+        return mRemoteFile.get();
+
+    // Ask the file service to open the file.
+    auto file = service->open(file_service::FileID::from(mFile->handle()));
+
+    // Couldn't open the file so we'll have to download it.
+    if (!file)
+    {
+        FUSEDebugF("Couldn't open %s via the file service: %s",
+                   toString(mFile->id()).c_str(),
+                   file_service::toString(file.error()));
+
+        return nullptr;
+    }
+
+    // Latch the file for later reads.
+    mRemoteFile = std::make_unique<file_service::File>(std::move(*file));
+
+    // Return file to caller.
+    return mRemoteFile.get();
+}
+
 FileIOContext::FileIOContext(FileCache& cache, FileInodeRef file, FileInfoRef info, bool modified):
     Lockable(),
     mFile(std::move(file)),
@@ -436,6 +601,9 @@ FileIOContext::FileIOContext(FileCache& cache, FileInodeRef file, FileInfoRef in
     mFileCache(cache),
     mFileInfo(std::move(info)),
     mFilePath(),
+    mOpened(),
+    mRemoteFile(),
+    mRemoteFileLock(),
     mFlushContext(),
     mFlushLock(),
     mFlushNeeded(modified),
@@ -564,6 +732,12 @@ Error FileIOContext::open(const Mount& mount, bool truncate)
     // Update file's access time.
     mFile->accessed();
 
+    // So we can tell how long it takes to read the file's first byte.
+    {
+        std::lock_guard<std::mutex> guard(mRemoteFileLock);
+        mOpened = std::chrono::steady_clock::now();
+    }
+
     // File's open.
     return API_OK;
 }
@@ -579,6 +753,16 @@ ErrorOr<std::string> FileIOContext::read(const Mount& mount, m_off_t offset, uns
     // Make sure nothing else is touching this file.
     FileIOContextSharedLock guard(*this);
 
+    // File's content isn't present locally.
+    //
+    // Rather than downloading the entire file, try and retrieve only the
+    // data we've been asked for.
+    if (!mFileInfo && mFileAccess.expired())
+    {
+        if (auto* file = remoteFile())
+            return read(*file, offset, size);
+    }
+
     // Make sure the file's present and open.
     auto result = open(guard, mount);
 
@@ -611,6 +795,9 @@ ErrorOr<std::string> FileIOContext::read(const Mount& mount, m_off_t offset, uns
     if (!fileAccess->fread(&buffer, size, 0, offset, FSLogging::logOnError))
         return unexpected(API_EREAD);
 
+    // Let interested parties know how long the read took.
+    firstByte(false);
+
     // Return result to caller.
     return buffer;
 }
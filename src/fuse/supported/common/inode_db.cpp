@@ -26,7 +26,9 @@
 
 #include <cassert>
 #include <chrono>
+#include <iterator>
 #include <map>
+#include <memory>
 #include <tuple>
 
 namespace mega
@@ -89,6 +91,17 @@ public:
     void operator()(NodeEventQueue& events);
 }; // EventObserver
 
+struct InodeDB::Listing
+{
+    // Describes each of the directory's children.
+    //
+    // The first entry is a dummy used to mark duplicate names.
+    NodeInfoList mChildren;
+
+    // Maps a child's name to its description.
+    std::map<std::string, NodeInfoList::iterator> mDescriptions;
+}; // Listing
+
 InodeDB::Queries::Queries(Database& database):
     mAddInode(database.query()),
     mGetChildrenByParentHandle(database.query()),
@@ -332,51 +345,12 @@ void InodeDB::childRemoved([[maybe_unused]] const Inode& inode,
 
 InodeRefVector InodeDB::children(const DirectoryInode& parent) const
 {
-    // Convenience.
-    using StringToNodeInfoPtrMap = std::map<std::string, NodeInfoList::iterator>;
-
-    // Stores the description of each of this node's children.
-    NodeInfoList storage;
-
-    // Maps a child's name to its description.
-    StringToNodeInfoPtrMap descriptions;
-
-    // Insert dummy for purposes of duplicate detection.
-    storage.emplace_back();
-
     // What children are present in the cloud?
-    client().each(
-        [&](NodeInfo description)
-        {
-            // Have we seen a child with this name before?
-            auto i = descriptions.find(description.mName);
-
-            // Haven't seen a child with this name before.
-            if (i == descriptions.end())
-            {
-                auto j = storage.end();
+    auto listing = this->listing(parent.handle());
 
-                // Latch the child's description.
-                j = storage.emplace(j, std::move(description));
-
-                // Add child to index.
-                descriptions[j->mName] = j;
-
-                // Process the next child.
-                return;
-            }
-
-            // We've already detected a duplicate with this name.
-            if (i->second == storage.begin())
-                return;
-
-            // Remove existing child's description.
-            storage.erase(i->second);
-
-            // Mark name as a duplicate.
-            i->second = storage.begin();
-        },
-        parent.handle());
+    // Convenience.
+    auto& descriptions = listing->mDescriptions;
+    auto duplicate = listing->mChildren.begin();
 
     auto guard = lockAll(mContext.mDatabase, *this);
 
@@ -426,7 +400,7 @@ InodeRefVector InodeDB::children(const DirectoryInode& parent) const
         if (i != descriptions.end())
         {
             // Child was a duplicate.
-            if (i->second == storage.begin())
+            if (i->second == duplicate)
                 continue;
 
             // Cloud child has replaced this local child.
@@ -447,20 +421,14 @@ InodeRefVector InodeDB::children(const DirectoryInode& parent) const
     // Convenience.
     auto& self = const_cast<InodeDB&>(*this);
 
-    // Pop dummy marker.
-    storage.pop_front();
-
     // Prepare query.
     query = transaction.query(mQueries.mGetExtensionAndInodeIDByHandle);
 
-    // Instantiate cloud children.
-    while (!storage.empty())
+    // Instantiate cloud children, skipping the dummy marker.
+    for (auto j = std::next(duplicate); j != listing->mChildren.end(); ++j)
     {
-        // Latch child's description.
-        auto info = std::move(storage.front());
-
-        // Pop description.
-        storage.pop_front();
+        // Convenience.
+        auto& info = *j;
 
         // Instantiate child.
         children.emplace_back((
@@ -599,7 +567,10 @@ InodeRefVector InodeDB::children(const DirectoryInode& parent) const
 
 void InodeDB::current()
 {
-    // No-op for now but left in case we need it later.
+    InodeDBLock guard(*this);
+
+    // Our view of the cloud has been refreshed.
+    invalidate();
 }
 
 bool InodeDB::discard() const
@@ -883,6 +854,9 @@ void InodeDB::handle(FileInode& file, NodeHandle& oldHandle, NodeHandle newHandl
 
     // Persist database changes.
     transaction.commit();
+
+    // The file's parent has a new child in the cloud.
+    invalidate(file.parentHandle(CachedOnly));
 }
 
 InodeID InodeDB::hasChild(const DirectoryInode& parent, const std::string& name) const
@@ -1001,6 +975,160 @@ ErrorOr<bool> InodeDB::hasChildren(const DirectoryInode& directory) const
     return query;
 }
 
+void InodeDB::invalidate()
+{
+    // Any listing being built may no longer be accurate.
+    ++mListingGeneration;
+
+    // Drop all listings.
+    mListedChildren.clear();
+    mListings.clear();
+}
+
+void InodeDB::invalidate(const NodeEvent& event)
+{
+    // Convenience.
+    auto handle = event.handle();
+    auto type = event.type();
+
+    // A change in permissions may affect the description of any child.
+    if (type == NODE_EVENT_PERMISSIONS)
+        return invalidate();
+
+    // Node's current parent has changed.
+    invalidate(event.parentHandle());
+
+    // Was the node described by some other parent's listing?
+    auto i = mListedChildren.find(handle);
+
+    // Node's previous parent has changed.
+    if (i != mListedChildren.end())
+        invalidate(i->second);
+
+    // A removed directory no longer has any children.
+    if (type == NODE_EVENT_REMOVED)
+        invalidate(handle);
+}
+
+void InodeDB::invalidate(NodeHandle parentHandle)
+{
+    // Any listing being built may no longer be accurate.
+    ++mListingGeneration;
+
+    // Is this directory's listing in memory?
+    auto i = mListings.find(parentHandle);
+
+    // Directory's listing isn't in memory.
+    if (i == mListings.end())
+        return;
+
+    // Forget which children were described by this listing.
+    for (auto& child: i->second->mChildren)
+    {
+        auto j = mListedChildren.find(child.mHandle);
+
+        if (j != mListedChildren.end() && j->second == parentHandle)
+            mListedChildren.erase(j);
+    }
+
+    // Drop the listing.
+    mListings.erase(i);
+}
+
+auto InodeDB::listing(NodeHandle parentHandle) const -> ListingPtr
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    using std::chrono::steady_clock;
+
+    // Lets us detect whether the listing became stale while being built.
+    std::uint64_t generation = 0u;
+
+    // Is this directory's listing already in memory?
+    {
+        InodeDBLock guard(*this);
+
+        auto i = mListings.find(parentHandle);
+
+        // Directory's listing is in memory.
+        if (i != mListings.end())
+        {
+            ++mStatistics.mListingHits;
+
+            return i->second;
+        }
+
+        // Directory's listing needs to be built.
+        ++mStatistics.mListingMisses;
+
+        generation = mListingGeneration;
+    }
+
+    auto began = steady_clock::now();
+    auto listing = std::make_shared<Listing>();
+
+    // Convenience.
+    auto& descriptions = listing->mDescriptions;
+    auto& storage = listing->mChildren;
+
+    // Insert dummy for purposes of duplicate detection.
+    storage.emplace_back();
+
+    // What children are present in the cloud?
+    client().each(
+        [&](NodeInfo description)
+        {
+            // Have we seen a child with this name before?
+            auto i = descriptions.find(description.mName);
+
+            // Haven't seen a child with this name before.
+            if (i == descriptions.end())
+            {
+                auto j = storage.end();
+
+                // Latch the child's description.
+                j = storage.emplace(j, std::move(description));
+
+                // Add child to index.
+                descriptions[j->mName] = j;
+
+                // Process the next child.
+                return;
+            }
+
+            // We've already detected a duplicate with this name.
+            if (i->second == storage.begin())
+                return;
+
+            // Remove existing child's description.
+            storage.erase(i->second);
+
+            // Mark name as a duplicate.
+            i->second = storage.begin();
+        },
+        parentHandle);
+
+    auto elapsed = duration_cast<microseconds>(steady_clock::now() - began);
+
+    InodeDBLock guard(*this);
+
+    mStatistics.mListingRebuildTime += elapsed;
+
+    // Directory may have changed while we were listing it.
+    if (generation != mListingGeneration)
+        return listing;
+
+    // Remember which children are described by this listing.
+    for (auto i = std::next(storage.begin()); i != storage.end(); ++i)
+        mListedChildren[i->mHandle] = parentHandle;
+
+    // Cache the listing for later use.
+    mListings[parentHandle] = listing;
+
+    // Return listing to caller.
+    return listing;
+}
+
 ErrorOr<MakeInodeResult> InodeDB::makeDirectory(const platform::Mount&,
                                                 const std::string& name,
                                                 DirectoryInodeRef parent)
@@ -1028,6 +1156,9 @@ ErrorOr<MakeInodeResult> InodeDB::makeDirectory(const platform::Mount&,
     if (!ref)
         ref = add(&InodeDB::buildDirectory, info);
 
+    // Parent has a new child in the cloud.
+    invalidate(parent->handle());
+
     // Return result to caller.
     return std::make_tuple(std::move(ref), std::move(info));
 }
@@ -1146,8 +1277,25 @@ Error InodeDB::move(InodeRef source, const std::string& targetName, DirectoryIno
     assert(!targetName.empty());
     assert(targetParent);
 
+    // Convenience.
+    auto sourceParentHandle = source->parentHandle(CachedOnly);
+    auto targetParentHandle = targetParent->handle();
+
     // Ask the client to move the child.
-    return client().move(targetName, source->handle(), targetParent->handle());
+    auto result = client().move(targetName, source->handle(), targetParentHandle);
+
+    // Couldn't move the child.
+    if (result != API_OK)
+        return result;
+
+    InodeDBLock guard(*this);
+
+    // Child's parents have changed in the cloud.
+    invalidate(sourceParentHandle);
+    invalidate(targetParentHandle);
+
+    // Let the caller know the child was moved.
+    return result;
 }
 
 Error InodeDB::move(FileInodeRef source,
@@ -1215,6 +1363,9 @@ void InodeDB::remove(const DirectoryInode& inode, InodeDBLock)
 
     static_cast<void>(count);
 
+    // Directory's listing is no longer needed.
+    invalidate(inode.handle());
+
     // Let any waiters know an inode's been removed.
     mCV.notify_all();
 }
@@ -1354,6 +1505,13 @@ Error InodeDB::replace(FileInodeRef source,
     // Persist database changes.
     transaction.commit();
 
+    // Source or target has changed in the cloud.
+    if (!sourceHandle.isUndef() || !targetHandle.isUndef())
+    {
+        invalidate(sourceParent->handle());
+        invalidate(targetParentHandle);
+    }
+
     // Let the mounts know the target has been replaced.
     mContext.mMountDB.each(
         [&](Mount& mount)
@@ -1382,13 +1540,30 @@ Error InodeDB::replace(FileInodeRef source,
 Error InodeDB::replace(DirectoryInodeRef source,
                        DirectoryInodeRef target,
                        const std::string&,
-                       DirectoryInodeRef)
+                       DirectoryInodeRef targetParent)
 {
     assert(source);
     assert(target);
+    assert(targetParent);
+
+    // Convenience.
+    auto sourceParentHandle = source->parentHandle(CachedOnly);
 
     // Ask the client to replace target with source.
-    return client().replace(source->handle(), target->handle());
+    auto result = client().replace(source->handle(), target->handle());
+
+    // Couldn't replace the target.
+    if (result != API_OK)
+        return result;
+
+    InodeDBLock guard(*this);
+
+    // Source and target's parents have changed in the cloud.
+    invalidate(sourceParentHandle);
+    invalidate(targetParent->handle());
+
+    // Let the caller know the target was replaced.
+    return result;
 }
 
 Error InodeDB::unlink(InodeRef inode)
@@ -1403,6 +1578,13 @@ Error InodeDB::unlink(InodeRef inode)
     if (result != API_OK)
         return result;
 
+    // Parent has lost a child in the cloud.
+    {
+        InodeDBLock guard(*this);
+
+        invalidate(inode->parentHandle(CachedOnly));
+    }
+
     // Mark inode as removed.
     inode->removed(true);
 
@@ -1434,6 +1616,11 @@ Error InodeDB::unlink(FileInodeRef file)
     // Remove the file from the database.
     {
         auto guard = lockAll(mContext.mDatabase, *this);
+
+        // Parent has lost a child in the cloud.
+        if (!handle.isUndef())
+            invalidate(parent->handle());
+
         auto transaction = mContext.mDatabase.transaction();
         auto query = transaction.query(mQueries.mRemoveInodeByID);
 
@@ -1465,10 +1652,14 @@ InodeDB::InodeDB(platform::ServiceContext& context):
     mByHandle(),
     mByID(),
     mByParentHandleAndName(),
+    mListedChildren(),
+    mListingGeneration(0u),
+    mListings(),
     mCV(),
     mContext(context),
     mDiscard(false),
-    mQueries(context.mDatabase)
+    mQueries(context.mDatabase),
+    mStatistics()
 {
     FUSEDebug1("Inode DB constructed");
 }
@@ -1799,6 +1990,13 @@ FileInodeRefVector InodeDB::modified(NodeHandle parent) const
     return modified;
 }
 
+ServiceStatistics InodeDB::statistics() const
+{
+    InodeDBLock guard(*this);
+
+    return mStatistics;
+}
+
 void InodeDB::updated(NodeEventQueue& events)
 {
     // Processing node events.
@@ -1807,6 +2005,11 @@ void InodeDB::updated(NodeEventQueue& events)
 
     // Discarding node events.
     FUSEDebugF("Discarding %zu node event(s)", events.size());
+
+    InodeDBLock guard(*this);
+
+    // Our listings may no longer reflect the cloud.
+    invalidate();
 }
 
 void InodeDB::EventObserver::added(const NodeEvent& event)
@@ -2166,6 +2369,9 @@ void InodeDB::EventObserver::operator()(NodeEventQueue& events)
         // Sanity.
         assert(handler);
 
+        // Drop any listings affected by this event.
+        mInodeDB.invalidate(event);
+
         // Handle the event.
         (this->*handler)(event);
     }
@@ -5,6 +5,7 @@
 #include <mega/common/lockable.h>
 #include <mega/common/platform/folder_locker.h>
 #include <mega/common/task_executor_forward.h>
+#include <mega/file_service/file_service_forward.h>
 #include <mega/filesystem.h>
 #include <mega/fuse/common/file_cache_forward.h>
 #include <mega/fuse/common/file_extension_db_forward.h>
@@ -110,6 +111,9 @@ public:
     // Who do we call when we want to execute something on another thread?
     common::TaskExecutor& executor() const;
 
+    // Who do we call to read files that aren't in the cache?
+    file_service::FileService* fileService() const;
+
     // Flush zero or more modified inodes to the cloud.
     void flush(const Mount& mount, FileInodeRefVector inodes);
 
@@ -7,6 +7,7 @@
 #include <mega/common/shared_mutex.h>
 #include <mega/common/task_queue.h>
 #include <mega/common/utility.h>
+#include <mega/file_service/file_forward.h>
 #include <mega/filesystem.h>
 #include <mega/fuse/common/file_cache_forward.h>
 #include <mega/fuse/common/file_info_forward.h>
@@ -18,8 +19,11 @@
 #include <mega/fuse/common/ref.h>
 #include <mega/types.h>
 
+#include <chrono>
 #include <cstddef>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 
 namespace mega
@@ -59,6 +63,11 @@ class FileIOContext: public common::Lockable<FileIOContext>
     // Create the file.
     common::ErrorOr<FileAccessSharedPtr> create();
 
+    // Called when data has been read from the file.
+    //
+    // Logs how long it took to read the first byte after the file was opened.
+    void firstByte(bool remote);
+
     // Download the file from the cloud.
     common::ErrorOr<FileAccessSharedPtr> download(const Mount& mount);
 
@@ -88,6 +97,12 @@ class FileIOContext: public common::Lockable<FileIOContext>
     auto open(FileIOContextSharedLock& lock, const Mount& mount, m_off_t hint = -1)
         -> common::ErrorOr<FileAccessSharedPtr>;
 
+    // Read data from the cloud without downloading the entire file.
+    common::ErrorOr<std::string> read(file_service::File& file, m_off_t offset, unsigned int size);
+
+    // Retrieve the file service's view of this file, if possible.
+    file_service::File* remoteFile();
+
     // What file does this entry represent?
     FileInodeRef mFile;
 
@@ -103,6 +118,15 @@ class FileIOContext: public common::Lockable<FileIOContext>
     // Where is the file stored on disk?
     LocalPath mFilePath;
 
+    // When was the file opened, if we haven't read from it since?
+    std::optional<std::chrono::steady_clock::time_point> mOpened;
+
+    // How we read the file's content when it isn't present locally.
+    std::unique_ptr<file_service::File> mRemoteFile;
+
+    // Serializes access to mOpened and mRemoteFile.
+    std::mutex mRemoteFileLock;
+
     // State required for the current flush, if any.
     FlushContextPtr mFlushContext;
 
@@ -22,13 +22,16 @@
 #include <mega/fuse/common/inode_db_forward.h>
 #include <mega/fuse/common/inode_forward.h>
 #include <mega/fuse/common/inode_id_forward.h>
+#include <mega/fuse/common/service_statistics.h>
 #include <mega/fuse/common/tags.h>
 #include <mega/fuse/platform/mount_forward.h>
 #include <mega/fuse/platform/service_context_forward.h>
 #include <mega/types.h>
 
 #include <condition_variable>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <utility>
@@ -92,6 +95,11 @@ class InodeDB final: public common::Lockable<InodeDB>, public common::NodeEventO
     // Clarity.
     class EventObserver;
 
+    // Describes a directory's children in the cloud.
+    struct Listing;
+
+    using ListingPtr = std::shared_ptr<const Listing>;
+
     // So we can use an inode's name and parent handle as a key.
     using NodeHandleStringPtrPair = std::pair<NodeHandle, const std::string*>;
 
@@ -231,6 +239,18 @@ class InodeDB final: public common::Lockable<InodeDB>, public common::NodeEventO
     // Specify what cloud node is associated with the specified file.
     void handle(FileInode& file, NodeHandle& oldHandle, NodeHandle newHandle);
 
+    // Invalidate all directory listings.
+    void invalidate();
+
+    // Invalidate any directory listings affected by the specified event.
+    void invalidate(const common::NodeEvent& event);
+
+    // Invalidate the listing of the specified directory.
+    void invalidate(NodeHandle parentHandle);
+
+    // Retrieve a description of a directory's children in the cloud.
+    ListingPtr listing(NodeHandle parentHandle) const;
+
     // Check if parent contains the named child.
     InodeID hasChild(const DirectoryInode& parent, const std::string& name) const;
 
@@ -292,6 +312,15 @@ class InodeDB final: public common::Lockable<InodeDB>, public common::NodeEventO
     // Tracks which inode is visible under what parent with what name.
     mutable FromNodeHandleStringPtrPairMap<InodeRawPtr> mByParentHandleAndName;
 
+    // Tracks which directory listing describes what child.
+    mutable std::map<NodeHandle, NodeHandle> mListedChildren;
+
+    // Incremented whenever a directory listing is invalidated.
+    std::uint64_t mListingGeneration;
+
+    // Tracks what directory listings are cached in memory.
+    mutable std::map<NodeHandle, ListingPtr> mListings;
+
     // Signalled when an inode is purged from memory.
     std::condition_variable_any mCV;
 
@@ -304,6 +333,9 @@ class InodeDB final: public common::Lockable<InodeDB>, public common::NodeEventO
     // What queries do we perform?
     mutable Queries mQueries;
 
+    // Tracks how effective our directory listing cache has been.
+    mutable ServiceStatistics mStatistics;
+
 public:
     InodeDB(platform::ServiceContext& context);
 
@@ -358,6 +390,9 @@ public:
     // Return a reference to all modified inodes under the specified parent.
     FileInodeRefVector modified(NodeHandle parent) const;
 
+    // Query how effective our directory listing cache has been.
+    ServiceStatistics statistics() const;
+
     // Called when nodes have been updated in the cloud.
     void updated(common::NodeEventQueue& events) override;
 }; // InodeDB
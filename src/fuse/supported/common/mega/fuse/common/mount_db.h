@@ -218,6 +218,9 @@ public:
     // Check whether the specified path is "syncable."
     bool syncable(const common::NormalizedPath& path) const;
 
+    // Should new mounts let the kernel cache writes?
+    bool writebackCache() const;
+
     // The context this database belongs to.
     platform::ServiceContext& mContext;
 }; // MountDB
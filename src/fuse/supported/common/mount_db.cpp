@@ -1084,5 +1084,10 @@ bool MountDB::syncable(const NormalizedPath& path) const
     return true;
 }
 
+bool MountDB::writebackCache() const
+{
+    return mContext.serviceFlags().mWritebackCache;
+}
+
 } // fuse
 } // mega
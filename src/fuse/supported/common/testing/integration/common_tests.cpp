@@ -9,6 +9,7 @@
 #include <mega/fuse/common/mount_event_type.h>
 #include <mega/fuse/common/mount_info.h>
 #include <mega/fuse/common/mount_result.h>
+#include <mega/fuse/common/service.h>
 #include <mega/fuse/common/testing/client.h>
 #include <mega/fuse/common/testing/mount_event_observer.h>
 #include <mega/fuse/common/testing/printers.h>
@@ -19,6 +20,8 @@
 
 #include <filesystem>
 #include <fstream>
+#include <set>
+#include <string>
 
 namespace mega
 {
@@ -66,8 +69,8 @@ TEST_F(FUSECommonTests, cached_true_when_cached)
 {
     ASSERT_FALSE(ClientW()->isCached(MountPathW() / "sf0"));
 
-    auto data = readFile(MountPathW() / "sf0");
-    ASSERT_FALSE(data.empty());
+    // Reads are served by the file service but writes need a local copy.
+    ASSERT_TRUE(makeFile(MountPathW() / "sf0", 32));
 
     ASSERT_TRUE(ClientW()->isCached(MountPathW() / "sf0"));
 
@@ -401,6 +404,47 @@ TEST_F(FUSECommonTests, file_cache_load)
     std::filebuf x;
 }
 
+TEST_F(FUSECommonTests, listing_cached_until_directory_changes)
+{
+    // Retrieve the names of each entry in the mount's root.
+    auto entries = [&]()
+    {
+        std::set<std::string> names;
+        std::error_code error;
+
+        for (auto& entry: fs::directory_iterator(MountPathW().path(), error))
+            names.emplace(entry.path().filename().string());
+
+        return names;
+    }; // entries
+
+    auto& service = ClientW()->fuseService();
+
+    // Make sure the root's listing is in memory.
+    auto before = entries();
+    ASSERT_FALSE(before.empty());
+
+    auto statistics = service.statistics();
+
+    // Listing an unchanged directory should be served from memory.
+    EXPECT_EQ(entries(), before);
+    EXPECT_GT(service.statistics().mListingHits, statistics.mListingHits);
+
+    // Change the directory in the cloud.
+    auto handle = ClientW()->makeDirectory("sdx", "/x/s");
+    ASSERT_TRUE(handle);
+
+    // The directory's listing should reflect the change.
+    EXPECT_TRUE(waitFor(
+        [&]()
+        {
+            return entries().count("sdx") > 0;
+        },
+        mDefaultTimeout));
+
+    LOG_info << "Directory listing hit ratio: " << service.statistics().listingHitRatio();
+}
+
 TEST_F(FUSECommonTests, reload)
 {
     // Create a new client so not to interfere with future tests.
@@ -513,6 +557,111 @@ TEST_F(FUSECommonTests, reload)
     EXPECT_EQ(fsidOf(client->storagePath() / "s" / "sdx" / "sf0"), sf0i);
 }
 
+TEST_F(FUSECommonTests, read_uncached_file_without_download)
+{
+    // Large enough that the file service won't retrieve all of it at once.
+    auto content = randomBytes(8u << 20);
+
+    auto handle = ClientW()->upload(content, "sfr", "/x/s");
+    ASSERT_EQ(handle.errorOr(API_OK), API_OK);
+
+    // Wait for the file to be visible via our mount.
+    ASSERT_TRUE(waitFor(
+        [&]()
+        {
+            return fsidOf(MountPathW() / "sfr") == handle->as8byte();
+        },
+        mDefaultTimeout));
+
+    ASSERT_FALSE(ClientW()->isCached(MountPathW() / "sfr"));
+
+    // Read a little from the middle of the file.
+    {
+        std::ifstream istream((MountPathW() / "sfr").path(), std::ios::binary);
+        ASSERT_TRUE(istream);
+
+        auto offset = content.size() / 2;
+        std::string buffer(4096, '\0');
+
+        istream.seekg(static_cast<std::streamoff>(offset));
+        istream.read(&buffer[0], static_cast<std::streamsize>(buffer.size()));
+        ASSERT_EQ(istream.gcount(), static_cast<std::streamsize>(buffer.size()));
+
+        EXPECT_EQ(buffer, content.substr(offset, buffer.size()));
+
+        // The read was served remotely, without downloading the file.
+        EXPECT_FALSE(ClientW()->isCached(MountPathW() / "sfr"));
+    }
+
+    // Closing the file doesn't download it either.
+    EXPECT_FALSE(ClientW()->isCached(MountPathW() / "sfr"));
+
+    // Reading the entire file yields the same content.
+    EXPECT_EQ(readFile(MountPathW() / "sfr"), content);
+    EXPECT_FALSE(ClientW()->isCached(MountPathW() / "sfr"));
+
+    // Writing to the file downloads it.
+    {
+        std::ofstream ostream((MountPathW() / "sfr").path(),
+                              std::ios::binary | std::ios::in | std::ios::out);
+        ASSERT_TRUE(ostream);
+
+        ostream.seekp(0);
+        ostream.write("x", 1);
+        ostream.close();
+
+        ASSERT_TRUE(ostream);
+    }
+
+    EXPECT_TRUE(ClientW()->isCached(MountPathW() / "sfr"));
+
+    content[0] = 'x';
+
+    EXPECT_EQ(readFile(MountPathW() / "sfr"), content);
+}
+
+TEST_F(FUSECommonTests, logout_after_uncached_read)
+{
+    // Create a new client so not to interfere with later tests.
+    auto client = CreateClient("logout_" + randomName());
+    ASSERT_TRUE(client);
+
+    // Log the client in.
+    ASSERT_EQ(client->login(1), API_OK);
+
+    auto handle = client->handle("/x/s");
+    ASSERT_EQ(handle.errorOr(API_OK), API_OK);
+
+    // Add and enable a mount.
+    MountInfo mount;
+
+    mount.mHandle = *handle;
+    mount.name("s");
+    mount.mPath = client->storagePath() / "s";
+
+    UNIX_ONLY(ASSERT_TRUE(fs::create_directories(Path(mount.mPath))));
+
+    ASSERT_EQ(client->addMount(mount), MOUNT_SUCCESS);
+    ASSERT_EQ(client->enableMount(mount.name(), false), MOUNT_SUCCESS);
+
+    auto sf0Path = client->storagePath() / "s" / "sf0";
+
+    ASSERT_TRUE(waitFor(
+        [&]()
+        {
+            std::error_code error;
+            return fs::exists(sf0Path, error);
+        },
+        mDefaultTimeout));
+
+    // Read the file via the file service.
+    ASSERT_FALSE(readFile(sf0Path).empty());
+    ASSERT_FALSE(client->isCached(sf0Path));
+
+    // Logging out shouldn't wait on files FUSE still holds open in the file service.
+    ASSERT_EQ(client->logout(false), API_OK);
+}
+
 TEST_F(FUSECommonTests, share_changes_permissions)
 {
     // Convenience.
@@ -8,11 +8,19 @@
 #include <mega/fuse/common/mount_event_type.h>
 #include <mega/fuse/common/mount_info.h>
 #include <mega/fuse/common/mount_result.h>
+#include <mega/fuse/common/service.h>
+#include <mega/fuse/common/service_flags.h>
 #include <mega/fuse/common/testing/client.h>
 #include <mega/fuse/common/testing/mount_event_observer.h>
 #include <mega/fuse/common/testing/mount_tests.h>
 #include <mega/fuse/common/testing/utility.h>
 #include <mega/fuse/platform/platform.h>
+#include <mega/logging.h>
+#include <mega/scoped_helpers.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 
 namespace mega
 {
@@ -24,6 +32,7 @@ namespace testing
 using common::testing::Directory;
 using common::testing::File;
 using common::testing::Path;
+using common::testing::randomBytes;
 using common::testing::randomName;
 using common::testing::waitFor;
 
@@ -1222,6 +1231,91 @@ TEST_F(FUSEMountTests, remove_succeeds_when_mount_unknown)
     ASSERT_TRUE(observer->wait(mDefaultTimeout));
 }
 
+TEST_F(FUSEMountTests, sequential_write_succeeds_with_writeback_cache)
+{
+    // How much data we'll write and how much we'll write at a time.
+    constexpr auto ChunkSize = 1u << 20;
+    constexpr auto FileSize = 64u << 20;
+
+    auto handle = ClientW()->handle("/x/s");
+    ASSERT_EQ(handle.errorOr(API_OK), API_OK);
+
+    // Make sure the service's flags are restored when we're done.
+    auto flags = ClientW()->fuseService().serviceFlags();
+
+    auto restorer = makeScopedDestructor(
+        [&]()
+        {
+            ClientW()->fuseService().serviceFlags(flags);
+        }); // restorer
+
+    auto chunk = randomBytes(ChunkSize);
+
+    // Write a file sequentially to a freshly enabled mount.
+    auto write = [&](bool writebackCache)
+    {
+        auto flags_ = flags;
+
+        flags_.mWritebackCache = writebackCache;
+
+        ClientW()->fuseService().serviceFlags(flags_);
+
+        MountInfo mount;
+
+        mount.mHandle = *handle;
+        mount.name("s");
+        mount.mPath = MountPathW();
+
+        ASSERT_EQ(ClientW()->addMount(mount), MOUNT_SUCCESS);
+        ASSERT_EQ(ClientW()->enableMount(mount.name(), false), MOUNT_SUCCESS);
+
+        std::error_code error;
+
+        ASSERT_TRUE(waitFor(
+            [&]()
+            {
+                return fs::exists(SentinelPathW(), error);
+            },
+            mDefaultTimeout));
+
+        auto path = (MountPathW() / "sfw").path();
+        auto started = std::chrono::steady_clock::now();
+
+        {
+            std::ofstream ostream(path, std::ios::binary | std::ios::trunc);
+            ASSERT_TRUE(ostream);
+
+            for (auto written = 0u; written < FileSize; written += ChunkSize)
+                ASSERT_TRUE(ostream.write(chunk.data(), static_cast<std::streamsize>(ChunkSize)));
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - started;
+
+        ASSERT_EQ(fs::file_size(path, error), FileSize);
+
+        auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+
+        milliseconds = std::max(milliseconds, std::chrono::milliseconds(1));
+
+        LOG_info << "Sequential write " << (writebackCache ? "with" : "without")
+                 << " writeback cache: " << FileSize / 1024 * 1000 / milliseconds.count() << "KB/s";
+
+        ASSERT_TRUE(waitFor(
+            [&]()
+            {
+                return ClientW()->removeMounts(true) == MOUNT_SUCCESS;
+            },
+            mDefaultTimeout));
+    }; // write
+
+    write(false);
+
+    if (HasFatalFailure())
+        return;
+
+    write(true);
+}
+
 TEST_F(FUSEMountTests, temporary_disable_is_not_remembered)
 {
     auto handle = ClientW()->handle("/x/s");
@@ -83,6 +83,9 @@ public:
     // Update the service's flags.
     void serviceFlags(const ServiceFlags& flags) override;
 
+    // Query the service's statistics.
+    ServiceStatistics statistics() const override;
+
     // Check whether the specified path is "syncable."
     bool syncable(const common::NormalizedPath& path) const override;
 
@@ -48,7 +48,7 @@ DirectoryContext* DirectoryContext::directory()
     return this;
 }
 
-InodeInfo DirectoryContext::get(std::size_t index) const
+std::pair<InodeRef, InodeInfo> DirectoryContext::entry(std::size_t index) const
 {
     assert(index < size());
 
@@ -65,21 +65,26 @@ InodeInfo DirectoryContext::get(std::size_t index) const
 
     // Child no longer exists.
     if (!child || child->removed())
-        return InodeInfo();
+        return std::make_pair(InodeRef(), InodeInfo());
 
     // Get our hands on the child's description.
     auto info = child->info();
 
     // Child's no longer below this directory.
     if (index >= 2 && info.mParentID != mDirectory->id())
-        return InodeInfo();
+        return std::make_pair(InodeRef(), InodeInfo());
 
     // Tweak filename for symbolic links.
     if (index < 2)
         info.mName.assign(index + 1, '.');
 
-    // Return description to caller.
-    return info;
+    // Return reference and description to caller.
+    return std::make_pair(std::move(child), std::move(info));
+}
+
+InodeInfo DirectoryContext::get(std::size_t index) const
+{
+    return entry(index).second;
 }
 
 InodeRef DirectoryContext::inode() const
@@ -0,0 +1,96 @@
+#include <mega/fuse/common/inode.h>
+#include <mega/fuse/common/inode_info.h>
+#include <mega/fuse/common/mount_inode_id.h>
+#include <mega/fuse/platform/constants.h>
+#include <mega/fuse/platform/directory_context.h>
+#include <mega/fuse/platform/mount.h>
+#include <mega/fuse/platform/request.h>
+#include <mega/fuse/platform/utility.h>
+
+#include <cassert>
+#include <cstring>
+
+namespace mega
+{
+namespace fuse
+{
+namespace platform
+{
+
+void Mount::readdirplus(Request request,
+                        MountInodeID,
+                        std::size_t size,
+                        off_t offset,
+                        fuse_file_info& info)
+{
+    // Reject if the originating process is self
+    if (isSelfForbidden(request))
+        return request.replyError(EPERM);
+
+    // Retrieve directory context.
+    auto* context = reinterpret_cast<DirectoryContext*>(info.fh);
+
+    // Sanity.
+    assert(context);
+    assert(offset >= 0);
+
+    // Where we'll be storing directory entries.
+    std::string buffer;
+
+    // Type safety.
+    auto m = static_cast<std::size_t>(offset);
+    auto n = context->size();
+
+    // Collect directory entries and their attributes.
+    //
+    // NOTE: The first two directory entries are always symlinks to the
+    // directory itself (.) and to its immediate parent (..).
+    while (m < n)
+    {
+        // Get our hands on the current child.
+        auto [ref, info] = context->entry(m);
+
+        // Child no longer exists.
+        if (!ref)
+        {
+            // Either we or our parent no longer exist.
+            if (m++ < 2)
+                return request.replyBuffer(std::string());
+
+            // Process the next child.
+            continue;
+        }
+
+        // Mount's not writable.
+        if (!writable())
+            info.mPermissions = RDONLY;
+
+        auto entry = fuse_entry_param();
+
+        std::memset(&entry, 0, sizeof(entry));
+
+        entry.attr_timeout = AttributeTimeout;
+        entry.entry_timeout = EntryTimeout;
+
+        // Translate info into something meaningful.
+        translate(entry, map(info.mID), info);
+
+        // Try and add the entry to our buffer.
+        if (!request.addDirEntryPlus(entry, buffer, info.mName, m + 1, size - buffer.size()))
+            break;
+
+        // The kernel takes a reference to every entry but . and ..
+        //
+        // Pin the child just as lookup would so that it stays in memory
+        // until the kernel tells us it's forgotten about it.
+        if (m++ >= 2)
+            pin(std::move(ref), info);
+    }
+
+    // Report directory entries to FUSE.
+    request.replyBuffer(std::move(buffer));
+}
+
+} // platform
+} // fuse
+} // mega
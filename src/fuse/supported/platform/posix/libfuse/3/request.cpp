@@ -0,0 +1,43 @@
+#include <mega/fuse/platform/request.h>
+
+namespace mega
+{
+namespace fuse
+{
+namespace platform
+{
+
+bool Request::addDirEntryPlus(const fuse_entry_param& entry,
+                              std::string& buffer,
+                              const std::string& name,
+                              const std::size_t offset,
+                              const std::size_t size)
+{
+    // How much have we written to the buffer?
+    auto current = buffer.size();
+
+    // How much space does this entry need?
+    auto required = fuse_add_direntry_plus(mRequest, nullptr, 0, name.c_str(), nullptr, 0);
+
+    // Don't have enough space for this entry.
+    if (current + required > size)
+        return false;
+
+    // Expand the buffer.
+    buffer.resize(current + required);
+
+    // Add the entry to the buffer.
+    fuse_add_direntry_plus(mRequest,
+                           &buffer[current],
+                           required,
+                           name.c_str(),
+                           &entry,
+                           static_cast<off_t>(offset));
+
+    // Let the caller know the entry's been added.
+    return true;
+}
+
+} // platform
+} // fuse
+} // mega
@@ -28,9 +28,36 @@ void Session::populateCapabilities(fuse_conn_info* connection)
     SessionBase::populateCapabilities(connection);
 
     connection->want |= FUSE_CAP_EXPLICIT_INVAL_DATA;
+
+    // Let the kernel retrieve entries and their attributes in one go.
+    //
+    // The kernel decides per directory whether to issue readdir or
+    // readdirplus depending on whether the entries are then looked up.
+    if ((connection->capable & FUSE_CAP_READDIRPLUS))
+        connection->want |= FUSE_CAP_READDIRPLUS | FUSE_CAP_READDIRPLUS_AUTO;
 #ifdef FUSE_CAP_NO_EXPORT
     connection->want |= FUSE_CAP_NO_EXPORT;
 #endif // FUSE_CAP_NO_EXPORT
+
+    // User doesn't want the kernel to cache writes.
+    if (!mMount.mMountDB.writebackCache())
+        return;
+
+    // Kernel can't cache writes.
+    if (!(connection->capable & FUSE_CAP_WRITEBACK_CACHE))
+    {
+        FUSEWarningF("Kernel can't cache writes to %s", mMount.name().c_str());
+        return;
+    }
+
+    // Let the kernel cache writes and send them to us in larger chunks.
+    //
+    // libfuse will clamp max_write to the size of its receive buffer.
+    connection->max_write = MaxWriteSize;
+    connection->want |= FUSE_CAP_WRITEBACK_CACHE;
+
+    // Let the mount know the kernel will be caching writes.
+    mMount.mWritebackCache = true;
 }
 
 void Session::populateOperations(fuse_lowlevel_ops& operations)
@@ -38,9 +65,34 @@ void Session::populateOperations(fuse_lowlevel_ops& operations)
     SessionBase::populateOperations(operations);
 
     operations.forget = &Session::forget;
+    operations.readdirplus = &Session::readdirplus;
     operations.rename = &Session::rename;
 }
 
+void Session::readdirplus(fuse_req_t request,
+                          fuse_ino_t inode,
+                          std::size_t size,
+                          off_t offset,
+                          fuse_file_info* info)
+{
+    MountInodeID inode_(inode);
+
+    FUSEDebugF("readdirplus: info: %p, inode: %s, offset: %lld, size: %zu, request: %p",
+               info,
+               toString(inode_).c_str(),
+               static_cast<long long>(offset),
+               size,
+               request);
+
+    mount(request).execute(&Mount::readdirplus,
+                           true,
+                           Request(request),
+                           inode_,
+                           size,
+                           offset,
+                           *info);
+}
+
 void Session::rename(fuse_req_t request,
                      fuse_ino_t parent,
                      const char* name,
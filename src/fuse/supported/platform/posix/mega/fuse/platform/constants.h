@@ -14,6 +14,9 @@ namespace platform
 constexpr auto AttributeTimeout = 120.0;
 constexpr auto EntryTimeout = 120.0;
 
+// How large a write should we accept when the kernel's caching writes?
+constexpr auto MaxWriteSize = 1u << 20;
+
 extern const std::string FilesystemName;
 
 } // platform
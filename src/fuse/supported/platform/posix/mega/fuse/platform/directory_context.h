@@ -5,6 +5,8 @@
 #include <mega/fuse/platform/context.h>
 #include <mega/fuse/platform/directory_context_forward.h>
 
+#include <utility>
+
 namespace mega
 {
 namespace fuse
@@ -40,6 +42,9 @@ public:
     // Check if this context represents a directory.
     DirectoryContext* directory() override;
 
+    // Retrieve a reference to and information about a specific directory entry.
+    std::pair<InodeRef, InodeInfo> entry(std::size_t index) const;
+
     // Retrieve information about a specific directory entry.
     InodeInfo get(std::size_t index) const;
 
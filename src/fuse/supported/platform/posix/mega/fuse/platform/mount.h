@@ -7,7 +7,7 @@
 #include <mega/fuse/common/inode_forward.h>
 #include <mega/fuse/common/logger.h>
 #include <mega/fuse/common/mount.h>
-#include <mega/fuse/common/mount_inode_id_forward.h>
+#include <mega/fuse/common/mount_inode_id.h>
 #include <mega/fuse/common/tags.h>
 #include <mega/fuse/platform/inode_invalidator.h>
 #include <mega/fuse/platform/library.h>
@@ -15,8 +15,13 @@
 #include <mega/fuse/platform/request_forward.h>
 #include <mega/fuse/platform/session.h>
 
+#include <deque>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace mega
@@ -44,26 +49,44 @@ class Mount final: public fuse::Mount
     static constexpr auto IsMountCallbackV =
         std::is_invocable_r_v<void, Callback, Mount*, Arguments...>;
 
+    // Does a request with these arguments target a specific inode?
+    template<typename... Arguments>
+    static constexpr bool targetsInode()
+    {
+        if constexpr (sizeof...(Arguments) < 2)
+            return false;
+        else
+        {
+            using Types = std::tuple<std::decay_t<Arguments>...>;
+
+            return std::is_same_v<std::tuple_element_t<0, Types>, Request> &&
+                   std::is_same_v<std::tuple_element_t<1, Types>, MountInodeID>;
+        }
+    }
+
     template<typename... Arguments, typename Callback>
     auto execute(Callback callback, bool spawnWorker, Arguments&&... arguments)
         -> std::enable_if_t<IsMountCallbackV<Callback, Arguments...>>
     {
-        std::function<void()> callback_ =
-            std::bind(callback, this, std::forward<Arguments>(arguments)...);
-
-        auto wrapper = [](common::Activity, auto& callback, const common::Task&)
+        // Requests targeting the same inode are executed in the order received.
+        if constexpr (targetsInode<Arguments...>())
         {
-            callback();
-        }; // wrapper
+            MountInodeID inode = std::get<1>(std::forward_as_tuple(arguments...));
 
-        std::function<void(const common::Task&)> wrapper_ = std::bind(std::move(wrapper),
-                                                                      mActivities.begin(),
-                                                                      std::move(callback_),
-                                                                      std::placeholders::_1);
-
-        mExecutor.execute(std::move(wrapper_), spawnWorker);
+            schedule(inode,
+                     std::bind(callback, this, std::forward<Arguments>(arguments)...),
+                     spawnWorker);
+        }
+        else
+        {
+            schedule(std::bind(callback, this, std::forward<Arguments>(arguments)...),
+                     spawnWorker);
+        }
     }
 
+    // Execute the requests queued for a specific inode.
+    void drain(MountInodeID inode);
+
     void lookup(Request request, MountInodeID parent, const std::string& name);
 
     void flush(Request request, MountInodeID inode, fuse_file_info& info);
@@ -96,6 +119,13 @@ class Mount final: public fuse::Mount
                  off_t offset,
                  fuse_file_info& info);
 
+    // Only available with libfuse3.
+    void readdirplus(Request request,
+                     MountInodeID inode,
+                     std::size_t size,
+                     off_t offset,
+                     fuse_file_info& info);
+
     void release(Request request, MountInodeID inode, fuse_file_info& info);
 
     void releasedir(Request request, MountInodeID inode, fuse_file_info& info);
@@ -109,6 +139,12 @@ class Mount final: public fuse::Mount
 
     void rmdir(Request request, MountInodeID parent, const std::string& name);
 
+    // Execute a request on one of our workers.
+    void schedule(std::function<void()> callback, bool spawnWorker);
+
+    // Execute a request after any requests already queued for inode.
+    void schedule(MountInodeID inode, std::function<void()> callback, bool spawnWorker);
+
     void setattr(Request request, MountInodeID inode, struct stat& attributes, int changes);
 
     void statfs(Request request, MountInodeID inode);
@@ -129,6 +165,15 @@ class Mount final: public fuse::Mount
     // Responsible for performing requests.
     common::TaskExecutor mExecutor;
 
+    // Requests waiting for earlier requests on the same inode to complete.
+    //
+    // An inode is present in this map only while one of our workers is
+    // executing its requests.
+    std::map<MountInodeID, std::deque<std::function<void()>>> mPendingRequests;
+
+    // Serializes access to mPendingRequests.
+    std::mutex mPendingRequestsLock;
+
     // Where is the mount mounted?
     common::NormalizedPath mPath;
 
@@ -138,6 +183,12 @@ class Mount final: public fuse::Mount
     // Responsible for invalidating inodes.
     InodeInvalidator mInvalidator;
 
+    // Is the kernel caching writes to this mount?
+    //
+    // Latched when the session's initialized as the kernel's behavior
+    // can't change until the mount's been remounted.
+    bool mWritebackCache;
+
 public:
     Mount(const MountInfo& info, MountDB& mountDB);
 
@@ -29,6 +29,13 @@ public:
                      const std::size_t offset,
                      const std::size_t size);
 
+    // Only available with libfuse3.
+    bool addDirEntryPlus(const fuse_entry_param& entry,
+                         std::string& buffer,
+                         const std::string& name,
+                         const std::size_t offset,
+                         const std::size_t size);
+
     gid_t group() const;
 
     uid_t owner() const;
@@ -136,6 +136,47 @@ void Mount::doUnlink(Request request,
     request.replyError(translate(result));
 }
 
+void Mount::drain(MountInodeID inode)
+{
+    std::unique_lock<std::mutex> lock(mPendingRequestsLock);
+
+    // Locate the inode's queue of pending requests.
+    auto i = mPendingRequests.find(inode);
+
+    // Sanity.
+    assert(i != mPendingRequests.end());
+    assert(!i->second.empty());
+
+    // Latch the inode's oldest request.
+    //
+    // The request remains in the queue while it executes so that any
+    // new requests for this inode know a worker's already responsible.
+    auto callback = std::move(i->second.front());
+
+    lock.unlock();
+
+    // Execute the request.
+    callback();
+
+    lock.lock();
+
+    // Request's been executed.
+    i->second.pop_front();
+
+    // No more requests are pending for this inode.
+    if (i->second.empty())
+    {
+        mPendingRequests.erase(i);
+        return;
+    }
+
+    lock.unlock();
+
+    // Execute the next request on a (possibly) different worker so that
+    // a busy inode can't monopolize this one.
+    schedule(std::bind(&Mount::drain, this, inode), true);
+}
+
 void Mount::lookup(Request request, MountInodeID parent, const std::string& name)
 {
     // Reject if the originating process is self
@@ -185,8 +226,14 @@ void Mount::lookup(Request request, MountInodeID parent, const std::string& name
     request.replyEntry(entry);
 }
 
-void Mount::flush(Request request, MountInodeID, fuse_file_info&)
+void Mount::flush(Request request, MountInodeID inode, fuse_file_info&)
 {
+    // The kernel's written back any data it was caching before flushing
+    // so make sure it picks up the file's size and modification time from
+    // the file cache rather than trusting its own.
+    if (mWritebackCache)
+        mInvalidator.invalidateAttributes(mActivities, inode);
+
     request.replyOk();
 }
 
@@ -373,7 +420,10 @@ void Mount::open(Request request, MountInodeID inode, fuse_file_info& info)
         flags |= FOF_WRITABLE;
 
         // User wants to append data to the file.
-        if ((info.flags & O_APPEND))
+        //
+        // When the kernel's caching writes, it resolves appends itself
+        // and tells us precisely where each write should be placed.
+        if ((info.flags & O_APPEND) && !mWritebackCache)
             flags |= FOF_APPEND;
 
         // User wants to truncate existing content.
@@ -521,7 +571,7 @@ void Mount::readdir(Request request,
     request.replyBuffer(std::move(buffer));
 }
 
-void Mount::release(Request request, MountInodeID, fuse_file_info& info)
+void Mount::release(Request request, MountInodeID inode, fuse_file_info& info)
 {
     // Reject if the originating process is self
     if (isSelfForbidden(request))
@@ -533,6 +583,11 @@ void Mount::release(Request request, MountInodeID, fuse_file_info& info)
     // Make sure the context is properly released.
     delete context;
 
+    // Releasing the context may have flushed the file's content so make
+    // sure the kernel doesn't keep any attributes it cached while writing.
+    if (mWritebackCache)
+        mInvalidator.invalidateAttributes(mActivities, inode);
+
     // Let FUSE know that the context's been released.
     request.replyOk();
 }
@@ -618,6 +673,40 @@ void Mount::rmdir(Request request, MountInodeID parent, const std::string& name)
     doUnlink(request, parent, std::move(predicate), name);
 }
 
+void Mount::schedule(std::function<void()> callback, bool spawnWorker)
+{
+    auto wrapper = [](Activity, auto& callback, const Task&)
+    {
+        callback();
+    }; // wrapper
+
+    std::function<void(const Task&)> wrapper_ = std::bind(std::move(wrapper),
+                                                          mActivities.begin(),
+                                                          std::move(callback),
+                                                          std::placeholders::_1);
+
+    mExecutor.execute(std::move(wrapper_), spawnWorker);
+}
+
+void Mount::schedule(MountInodeID inode, std::function<void()> callback, bool spawnWorker)
+{
+    {
+        std::lock_guard<std::mutex> guard(mPendingRequestsLock);
+
+        // Queue the request behind any others for this inode.
+        auto& requests = mPendingRequests[inode];
+
+        requests.emplace_back(std::move(callback));
+
+        // A worker's already executing this inode's requests.
+        if (requests.size() > 1)
+            return;
+    }
+
+    // Execute the inode's requests on one of our workers.
+    schedule(std::bind(&Mount::drain, this, inode), spawnWorker);
+}
+
 void Mount::setattr(Request request, MountInodeID inode, struct stat& attributes, int changes)
 {
     // Reject if the originating process is self
@@ -860,9 +949,12 @@ Mount::Mount(const MountInfo& info, MountDB& mountDB):
     fuse::Mount(info, mountDB),
     mActivities(),
     mExecutor(mountDB.executorFlags(), logger()),
+    mPendingRequests(),
+    mPendingRequestsLock(),
     mPath(info.mPath),
     mSession(*this),
-    mInvalidator(mSession)
+    mInvalidator(mSession),
+    mWritebackCache(false)
 {
     // Let the database know a new session has been added.
     mMountDB.sessionAdded(mSession);
@@ -1,6 +1,7 @@
 #include <mega/common/error_or.h>
 #include <mega/common/node_info.h>
 #include <mega/common/testing/cloud_path.h>
+#include <mega/common/testing/directory.h>
 #include <mega/fuse/common/testing/client.h>
 #include <mega/fuse/common/testing/utility.h>
 #include <mega/fuse/platform/constants.h>
@@ -9,6 +10,7 @@
 #include <mega/fuse/platform/testing/platform_tests.h>
 #include <mega/fuse/platform/testing/printers.h>
 #include <mega/fuse/platform/testing/wrappers.h>
+#include <fcntl.h>
 #include <mega/logging.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -16,6 +18,7 @@
 #include <algorithm>
 #include <chrono>
 #include <map>
+#include <string>
 #include <thread>
 
 namespace mega
@@ -817,6 +820,75 @@ TEST_P(FUSEPlatformTests, read_succeeds)
     ASSERT_EQ(buffer, "sf0");
 }
 
+TEST_P(FUSEPlatformTests, read_succeeds_when_parallel)
+{
+    // How many files we'll read concurrently.
+    constexpr auto NumFiles = 8u;
+
+    // How large each of those files is.
+    constexpr auto FileSize = 4u << 20;
+
+    std::vector<std::string> contents;
+    std::vector<std::string> names;
+
+    // Upload the files we'll be reading.
+    for (auto i = 0u; i < NumFiles; ++i)
+    {
+        contents.emplace_back(randomBytes(FileSize));
+        names.emplace_back("sfp" + std::to_string(i));
+
+        auto handle = ClientW()->upload(contents.back(), names.back(), "/x/s");
+        ASSERT_EQ(handle.errorOr(API_OK), API_OK);
+    }
+
+    // Wait for the files to become visible in the mount.
+    ASSERT_TRUE(waitFor(
+        [&]()
+        {
+            return std::all_of(names.begin(),
+                               names.end(),
+                               [&](const std::string& name)
+                               {
+                                   return !access(MountPathR() / name, F_OK);
+                               });
+        },
+        mDefaultTimeout));
+
+    // What each reader read.
+    std::vector<std::string> results(NumFiles);
+    std::vector<std::thread> readers;
+
+    auto started = std::chrono::steady_clock::now();
+
+    // Read each file on its own thread.
+    //
+    // Requests for different files should be processed concurrently.
+    for (auto i = 0u; i < NumFiles; ++i)
+    {
+        readers.emplace_back(
+            [&, i]()
+            {
+                auto descriptor = open(MountPathR() / names[i], O_RDONLY);
+
+                if (descriptor)
+                    results[i] = descriptor.readAll();
+            });
+    }
+
+    // Wait for the readers to complete.
+    for (auto& reader: readers)
+        reader.join();
+
+    auto elapsed = std::chrono::steady_clock::now() - started;
+
+    // Make sure each reader read what we uploaded.
+    for (auto i = 0u; i < NumFiles; ++i)
+        ASSERT_EQ(results[i], contents[i]);
+
+    LOG_info << "Read " << NumFiles << " files of " << FileSize << " bytes concurrently in "
+             << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms";
+}
+
 TEST_P(FUSEPlatformTests, read_write_succeeds)
 {
     constexpr auto BYTES_PER_THREAD = 4u;
@@ -1014,6 +1086,66 @@ TEST_P(FUSEPlatformTests, readdir_succeeds)
     ASSERT_TRUE(expectations.empty());
 }
 
+TEST_P(FUSEPlatformTests, readdirplus_stat_succeeds_when_directory_is_large)
+{
+    // How many entries our directory should contain.
+    constexpr auto NumEntries = 1024u;
+
+    // Populate a large directory locally.
+    Directory sdx("sdx", mScratchPath);
+
+    for (auto i = 0u; i < NumEntries; ++i)
+        ASSERT_TRUE(fs::create_directory(sdx.path().path() / ("d" + std::to_string(i))));
+
+    // Upload the directory to the cloud.
+    ASSERT_EQ(ClientW()->upload("/x/s", sdx.path()).errorOr(API_OK), API_OK);
+
+    // Wait for the directory to become visible in the mount.
+    ASSERT_TRUE(waitFor(
+        [&]()
+        {
+            return !access(MountPathW() / "sdx", F_OK);
+        },
+        mDefaultTimeout));
+
+    auto sdx_ = open(MountPathW() / "sdx", O_RDONLY);
+    ASSERT_TRUE(sdx_);
+
+    auto iterator = fdopendir(std::move(sdx_));
+    ASSERT_TRUE(iterator);
+
+    // Convenience.
+    auto descriptor = ::dirfd(iterator.get());
+
+    // Mimic ls -l: list the directory and stat each entry.
+    auto started = std::chrono::steady_clock::now();
+    auto count = 0u;
+
+    errno = 0;
+
+    while (auto* entry = readdir(iterator.get()))
+    {
+        Stat attributes;
+
+        ASSERT_EQ(::fstatat(descriptor, entry->d_name, &attributes, AT_SYMLINK_NOFOLLOW), 0);
+        ASSERT_EQ(entry->d_ino, attributes.st_ino);
+
+        ++count;
+
+        errno = 0;
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - started;
+
+    ASSERT_EQ(errno, 0);
+
+    // Two extra for . and ..
+    ASSERT_EQ(count, NumEntries + 2);
+
+    LOG_info << "Listed and stat'd " << count << " entries in "
+             << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms";
+}
+
 TEST_P(FUSEPlatformTests, rename_fails_when_below_file)
 {
     ASSERT_TRUE(rename(MountPathW() / "sf0" / "x", MountPathW() / "x"));
@@ -206,6 +206,11 @@ void ServiceContext::serviceFlags(const ServiceFlags& flags)
     mMountDB.fileExplorerView(flags.mFileExplorerView);
 }
 
+ServiceStatistics ServiceContext::statistics() const
+{
+    return mInodeDB.statistics();
+}
+
 bool ServiceContext::syncable(const NormalizedPath& path) const
 {
     return mMountDB.syncable(path);
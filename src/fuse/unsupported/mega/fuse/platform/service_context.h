@@ -71,6 +71,9 @@ public:
     // Remove a disabled mount from the database.
     MountResult remove(const std::string& path) override;
 
+    // Query the service's statistics.
+    ServiceStatistics statistics() const override;
+
     // Check whether the specified path is "syncable."
     bool syncable(const common::NormalizedPath& path) const override;
 
@@ -122,6 +122,11 @@ MountResult ServiceContext::remove(const std::string&)
     return MOUNT_UNKNOWN;
 }
 
+ServiceStatistics ServiceContext::statistics() const
+{
+    return ServiceStatistics();
+}
+
 bool ServiceContext::syncable(const NormalizedPath&) const
 {
     return true;
@@ -341,6 +341,7 @@ HttpReq::HttpReq(bool b):
     timeoutms = 0;
     type = REQ_JSON;
     buflen = 0;
+    bufcapacity = 0;
     protect = false;
     minspeed = false;
     mChunked = false;
@@ -412,6 +413,11 @@ void HttpReq::put(void* data, unsigned len, bool purge)
         }
 
         memcpy(buf + bufpos, data, len);
+
+        if (mCopiedBytes)
+        {
+            *mCopiedBytes += len;
+        }
     }
     else
     {
@@ -428,8 +434,8 @@ void HttpReq::put(void* data, unsigned len, bool purge)
 }
 
 
-HttpReq::http_buf_t::http_buf_t(byte* b, size_t s, size_t e)
-    : start(s), end(e), buf(b)
+HttpReq::http_buf_t::http_buf_t(byte* b, size_t s, size_t e, size_t c)
+    : start(s), end(e), buf(b), capacity(c)
 {
 }
 
@@ -443,6 +449,18 @@ void HttpReq::http_buf_t::swap(http_buf_t& other)
     byte* tb = buf; buf = other.buf; other.buf = tb;
     size_t ts = start; start = other.start; other.start = ts;
     size_t te = end; end = other.end; other.end = te;
+    size_t tc = capacity; capacity = other.capacity; other.capacity = tc;
+}
+
+byte* HttpReq::http_buf_t::release(size_t& c)
+{
+    byte* b = buf;
+    c = capacity;
+    buf = NULL;
+    start = 0;
+    end = 0;
+    capacity = 0;
+    return b;
 }
 
 bool HttpReq::http_buf_t::isNull() const
@@ -464,10 +482,12 @@ size_t HttpReq::http_buf_t::datalen() const
 // give up ownership of the buffer for client to use.
 struct HttpReq::http_buf_t* HttpReq::release_buf()
 {
-    HttpReq::http_buf_t* result = new HttpReq::http_buf_t(buf, inpurge, (size_t)bufpos);
+    HttpReq::http_buf_t* result =
+        new HttpReq::http_buf_t(buf, inpurge, (size_t)bufpos, bufcapacity);
     buf = NULL;
     inpurge = 0;
     buflen = 0;
+    bufcapacity = 0;
     bufpos = 0;
     outpos = 0;
     notifiedbufpos = 0;
@@ -559,21 +579,91 @@ void HttpReqDL::prepare(const char* tempurl,
     size = (unsigned)(npos - downloadPosition);
     buffer_released = false;
 
-    if (!buf || buflen != size)
+    // SymmCipher::ctr_crypt requirement: data must be padded to BLOCKSIZE
+    const size_t paddedSize = (static_cast<size_t>(size) + SymmCipher::BLOCKSIZE - 1) &
+                              ~(static_cast<size_t>(SymmCipher::BLOCKSIZE) - 1);
+
+    if (!buf || (mBufferPool ? bufcapacity < paddedSize : buflen != size))
     {
         // (re)allocate buffer
         if (buf)
         {
-            delete[] buf;
+            if (mBufferPool)
+            {
+                mBufferPool->put(buf, bufcapacity);
+            }
+            else
+            {
+                delete[] buf;
+            }
             buf = NULL;
+            bufcapacity = 0;
         }
 
         if (size)
         {
-            buf = new byte[(size + SymmCipher::BLOCKSIZE - 1) &
-                           ~(static_cast<size_t>(SymmCipher::BLOCKSIZE) - 1)];
+            if (mBufferPool)
+            {
+                buf = mBufferPool->get(paddedSize, bufcapacity);
+            }
+            else
+            {
+                buf = new byte[paddedSize];
+                bufcapacity = paddedSize;
+            }
         }
-        buflen = size;
+    }
+    buflen = size;
+}
+
+byte* HttpBufferPool::get(size_t size, size_t& capacity)
+{
+    // the smallest free buffer that is large enough
+    auto best = mFree.end();
+    for (auto it = mFree.begin(); it != mFree.end(); ++it)
+    {
+        if (it->second >= size && (best == mFree.end() || it->second < best->second))
+        {
+            best = it;
+        }
+    }
+
+    if (best != mFree.end())
+    {
+        byte* buffer = best->first;
+        capacity = best->second;
+        *best = mFree.back();
+        mFree.pop_back();
+        return buffer;
+    }
+
+    ++mNumAllocated;
+    capacity = (size + SymmCipher::BLOCKSIZE - 1) &
+               ~(static_cast<size_t>(SymmCipher::BLOCKSIZE) - 1);
+    return new byte[capacity];
+}
+
+void HttpBufferPool::put(byte* buffer, size_t capacity)
+{
+    if (!buffer)
+    {
+        return;
+    }
+
+    if (!capacity || mFree.size() >= mNumAllocated)
+    {
+        delete[] buffer;
+        return;
+    }
+
+    mFree.emplace_back(buffer, capacity);
+}
+
+HttpBufferPool::~HttpBufferPool()
+{
+    for (auto& buffer: mFree)
+    {
+        delete[] buffer.first;
     }
 }
 
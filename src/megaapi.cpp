@@ -2238,6 +2238,11 @@ long long MegaApi::getSDKtime()
     return pImpl->getSDKtime();
 }
 
+char* MegaApi::getMetrics(int format)
+{
+    return pImpl->getMetrics(format);
+}
+
 void MegaApi::getSessionTransferURL(const char *path, MegaRequestListener *listener)
 {
     pImpl->getSessionTransferURL(path, listener);
@@ -4073,6 +4078,36 @@ void MegaApi::checkSyncUploadsThrottled(MegaRequestListener* const listener)
     pImpl->checkSyncUploadsThrottled(listener);
 }
 
+void MegaApi::setSyncScanThreads(int numThreads)
+{
+    pImpl->setSyncScanThreads(numThreads);
+}
+
+int MegaApi::getSyncScanThreads()
+{
+    return pImpl->getSyncScanThreads();
+}
+
+void MegaApi::setSyncTimeSlice(int milliseconds)
+{
+    pImpl->setSyncTimeSlice(milliseconds);
+}
+
+int MegaApi::getSyncTimeSlice()
+{
+    return pImpl->getSyncTimeSlice();
+}
+
+void MegaApi::useSyncFanotify(bool enable)
+{
+    pImpl->useSyncFanotify(enable);
+}
+
+bool MegaApi::usingSyncFanotify()
+{
+    return pImpl->usingSyncFanotify();
+}
+
 MegaSync *MegaApi::getSyncByBackupId(MegaHandle backupId)
 {
     return pImpl->getSyncByBackupId(backupId);
@@ -4431,6 +4466,11 @@ int MegaApi::enableSearchDBIndexes(bool enable)
     return pImpl->enableSearchDBIndexes(enable);
 }
 
+int MegaApi::enableNodeSkeletonSnapshot(bool enable)
+{
+    return pImpl->enableNodeSkeletonSnapshot(enable);
+}
+
 const char* MegaApi::generateViewId()
 {
     return strdup(pImpl->generateViewId().c_str());
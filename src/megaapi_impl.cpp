@@ -1830,6 +1830,36 @@ void MegaApiImpl::checkSyncUploadsThrottled(MegaRequestListener* const listener)
     waiter->notify();
 }
 
+void MegaApiImpl::setSyncScanThreads(int numThreads)
+{
+    ScanService::setNumThreads(static_cast<size_t>(std::max(numThreads, 1)));
+}
+
+int MegaApiImpl::getSyncScanThreads()
+{
+    return static_cast<int>(ScanService::numThreads());
+}
+
+void MegaApiImpl::setSyncTimeSlice(int milliseconds)
+{
+    client->syncs.setRecurseTimeSlice(static_cast<unsigned>(std::max(milliseconds, 0)));
+}
+
+int MegaApiImpl::getSyncTimeSlice()
+{
+    return static_cast<int>(client->syncs.recurseTimeSlice());
+}
+
+void MegaApiImpl::useSyncFanotify(bool enable)
+{
+    client->syncs.useFanotify(enable);
+}
+
+bool MegaApiImpl::usingSyncFanotify()
+{
+    return client->syncs.usingFanotify();
+}
+
 MegaSyncStallPrivate::MegaSyncStallPrivate(const SyncStallEntry& e)
 :info(e)
 {}
@@ -7415,6 +7445,22 @@ long long MegaApiImpl::getSDKtime()
     return Waiter::ds;
 }
 
+char* MegaApiImpl::getMetrics(int format)
+{
+    // The registry is thread-safe: no need to lock the SDK.
+    auto& registry = CodeCounter::Registry::instance();
+
+    switch (format)
+    {
+        case MegaApi::METRICS_FORMAT_JSON:
+            return MegaApi::strdup(registry.toJson().c_str());
+        case MegaApi::METRICS_FORMAT_PROMETHEUS:
+            return MegaApi::strdup(registry.toPrometheus().c_str());
+        default:
+            return nullptr;
+    }
+}
+
 MegaHandle MegaApiImpl::base32ToHandle(const char *base32Handle)
 {
     if(!base32Handle) return INVALID_HANDLE;
@@ -12843,6 +12889,18 @@ int MegaApiImpl::enableSearchDBIndexes(bool enable)
     return API_OK;
 }
 
+int MegaApiImpl::enableNodeSkeletonSnapshot(bool enable)
+{
+    if (client->loggedin() != sessiontype_t::NOTLOGGEDIN)
+    {
+        LOG_warn << "This method should be called before login";
+        return API_EACCESS;
+    }
+
+    client->enableNodeSkeletonSnapshot(enable);
+    return API_OK;
+}
+
 string MegaApiImpl::generateViewId()
 {
     return MegaClient::generateViewId(client->rng);
@@ -41114,6 +41172,11 @@ MegaFuseExecutorFlags* MegaFuseFlagsPrivate::getSubsystemExecutorFlags()
     return &mSubsystemExecutorFlags;
 }
 
+bool MegaFuseFlagsPrivate::getWritebackCache() const
+{
+    return mFlags.mWritebackCache;
+}
+
 void MegaFuseFlagsPrivate::setFlushDelay(size_t seconds)
 {
     mFlags.mFlushDelay = std::chrono::seconds(seconds);
@@ -41129,6 +41192,11 @@ void MegaFuseFlagsPrivate::setFileExplorerView(int view)
     mFlags.mFileExplorerView = static_cast<fuse::FileExplorerView>(view);
 }
 
+void MegaFuseFlagsPrivate::setWritebackCache(bool enable)
+{
+    mFlags.mWritebackCache = enable;
+}
+
 MegaMountPrivate::MegaMountPrivate()
   : MegaMount()
   , mFlags(std::make_unique<MegaMountFlagsPrivate>())
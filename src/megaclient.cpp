@@ -840,6 +840,11 @@ void MegaClient::enableSearchDBIndexes(bool enable)
     mEnableSearchDBIndexes = enable;
 }
 
+void MegaClient::enableNodeSkeletonSnapshot(bool enable)
+{
+    mEnableNodeSkeletonSnapshot = enable;
+}
+
 void MegaClient::dropSearchDBIndexes()
 {
     mNodeManager.dropSearchDBIndexes();
@@ -1989,7 +1994,7 @@ MegaClient::MegaClient(MegaApp* a,
     mJourneyId(),
     mClientAdapter(*this),
     mFileService(),
-    mFuseService(mClientAdapter)
+    mFuseService(mClientAdapter, mFileService)
 {
 #ifdef __ANDROID__
     if (!AndroidFileSystemAccess::isFileWrapperActive(fsaccess.get()))
@@ -4979,6 +4984,11 @@ void MegaClient::locallogout(bool removecaches, [[maybe_unused]] bool keepSyncsC
     // Clear cached request progress.
     mRequestProgress.reset();
 
+    if (!removecaches)
+    {
+        saveNodeSkeleton();
+    }
+
     sctable.reset();
     mNodeManager.setTable(nullptr);
 
@@ -5050,12 +5060,15 @@ void MegaClient::locallogout(bool removecaches, [[maybe_unused]] bool keepSyncsC
     freeq(GET);  // freeq after closetc due to optimizations
     freeq(PUT);
 
-    // Deinitialize the File Service.
-    mFileService.deinitialize();
-
     // Deinitialize the FUSE Service.
+    //
+    // This must happen first as FUSE holds references to files in the
+    // File Service and the File Service waits for those to be released.
     mFuseService.deinitialize();
 
+    // Deinitialize the File Service.
+    mFileService.deinitialize();
+
     purgenodesusersabortsc(false);
     userid = 0;
     mNodeManager.reset();
@@ -5165,6 +5178,8 @@ void MegaClient::removeCaches()
 
     if (sctable)
     {
+        fsaccess->unlinklocal(nodeSkeletonPath());
+
         mNodeManager.setTable(nullptr);
         sctable->remove();
         sctable.reset();
@@ -5362,6 +5377,7 @@ void MegaClient::sc_storeSn(JSON& json)
                   << ")";
         sctable->commit();
         sctable->begin();
+        mCommittedNodeChanges = mNodeManager.getNodeChanges();
         app->notify_dbcommit();
     }
 }
@@ -5947,6 +5963,10 @@ void MegaClient::initsc()
             LOG_debug << "DB transaction COMMIT (sessionid: " << string(sessionid, sizeof(sessionid)) << ")";
             sctable->commit();
             sctable->begin();
+            mCommittedNodeChanges = mNodeManager.getNodeChanges();
+
+            // The whole tree has just been written: snapshot it for the next resumption.
+            saveNodeSkeleton();
         }
     }
 }
@@ -6114,6 +6134,31 @@ void MegaClient::finalizesc(bool complete)
     }
 }
 
+LocalPath MegaClient::nodeSkeletonPath()
+{
+    // sctable is named after the session (or folder link), as the transfer DB is
+    LocalPath path = dbaccess->databasePath(*fsaccess, getTransferDBName(), DbAccess::DB_VERSION);
+    path.append(LocalPath::fromRelativePath(".skeleton"));
+    return path;
+}
+
+void MegaClient::saveNodeSkeleton()
+{
+    if (!mEnableNodeSkeletonSnapshot || !sctable || !dbaccess || ISUNDEF(cachedscsn))
+    {
+        return;
+    }
+
+    // A snapshot of uncommitted nodes wouldn't match the DB found on resumption
+    if (mNodeManager.getNodeChanges() != mCommittedNodeChanges)
+    {
+        LOG_debug << "Node skeleton snapshot not saved: node changes are not committed yet";
+        return;
+    }
+
+    mNodeManager.saveSkeleton(*fsaccess, nodeSkeletonPath(), cachedscsn);
+}
+
 // queue node file attribute for retrieval or cancel retrieval
 error MegaClient::getfa(handle h, string *fileattrstring, const string &nodekey, fatype t, int cancel)
 {
@@ -10832,6 +10877,16 @@ int MegaClient::readnode(JSON* j,
             else // Only need to save in DB if node is not notified
             {
                 mNodeManager.saveNodeInDb(n.get());
+
+                // The scsn is only stored once fetchnodes completes, so a partially committed
+                // tree is discarded rather than resumed
+                if (sctable && ++mFetchedNodesSinceCommit >= FETCHNODES_NODES_PER_TRANSACTION)
+                {
+                    LOG_debug << "DB transaction COMMIT (fetched nodes)";
+                    sctable->commit();
+                    sctable->begin();
+                    mFetchedNodesSinceCommit = 0;
+                }
             }
 
             n = nullptr;    // ownership is taken by NodeManager upon addNode()
@@ -15072,10 +15127,64 @@ void MegaClient::setkeypair()
     mKeyManager.setPostRegistration(true);
 }
 
+static void decodeStateCacheRecord(StateCacheRecord& record, SymmCipher& cipher)
+{
+    // as DbTable::next(): record 0 isn't encrypted
+    record.decrypted = !record.id || PaddedCBC::decrypt(&record.data, &cipher);
+    if (!record.decrypted)
+    {
+        return;
+    }
+
+    switch (record.id & (DbTable::IDSPACING - 1))
+    {
+        case MegaClient::CACHEDPCR:
+            record.pcr.reset(PendingContactRequest::unserialize(&record.data));
+            break;
+
+        case MegaClient::CACHEDSET:
+            record.set = Set::unserialize(&record.data);
+            break;
+
+        case MegaClient::CACHEDSETELEMENT:
+            record.setElement = SetElement::unserialize(&record.data);
+            break;
+    }
+}
+
+size_t StateCacheRecord::decode(MegaClientAsyncQueue& queue,
+                                const SymmCipher& key,
+                                std::vector<StateCacheRecord>& records)
+{
+    constexpr size_t RECORDS_PER_TASK = 64;
+
+    queue.forEachRange(records.size(),
+                       RECORDS_PER_TASK,
+                       [&](size_t first, size_t last, SymmCipher& cipher)
+                       {
+                           cipher.setkey(key.key);
+                           for (size_t i = first; i < last; ++i)
+                           {
+                               decodeStateCacheRecord(records[i], cipher);
+                           }
+                       });
+
+    auto undecrypted = std::find_if(records.begin(),
+                                    records.end(),
+                                    [](const StateCacheRecord& record)
+                                    {
+                                        return !record.decrypted;
+                                    });
+
+    return static_cast<size_t>(undecrypted - records.begin());
+}
+
 bool MegaClient::fetchsc(DbTable* stateCacheTable)
 {
-    uint32_t id;
-    string data;
+    // records are decrypted and unserialized in parallel, in batches of this size
+    constexpr size_t RECORDS_PER_BATCH = 4096;
+
+    uint32_t id = 0;
     std::shared_ptr<Node> n;
     User* u;
     PendingContactRequest* pcr;
@@ -15084,136 +15193,166 @@ bool MegaClient::fetchsc(DbTable* stateCacheTable)
 
     stateCacheTable->rewind();
 
-    bool hasNext = stateCacheTable->next(&id, &data, &key);
+    StateCacheRecord nextRecord;
+    bool hasNext = stateCacheTable->nextEncrypted(&nextRecord.id, &nextRecord.data);
     WAIT_CLASS::bumpds();
     fnstats.timeToFirstByte = Waiter::ds - fnstats.startTime;
 
     bool isDbUpgraded = false;      // true when legacy DB is migrated to NOD's DB schema
 
     std::map<NodeHandle, std::vector<std::shared_ptr<Node> >> delayedParents;
+    std::vector<StateCacheRecord> records;
     while (hasNext)
     {
-        switch (id & (DbTable::IDSPACING - 1))
+        records.clear();
+        while (hasNext && records.size() < RECORDS_PER_BATCH)
         {
-            case CACHEDSCSN:
-                if (data.size() != sizeof cachedscsn)
-                {
-                    return false;
-                }
-                break;
+            records.push_back(std::move(nextRecord));
+            nextRecord = StateCacheRecord();
+            hasNext = stateCacheTable->nextEncrypted(&nextRecord.id, &nextRecord.data);
+        }
 
-            case CACHEDNODE:
-                if ((n = mNodeManager.getNodeFromBlob(&data)))
-                {
-                    // When all nodes are loaded we force a commit
-                   isDbUpgraded = true;
+        auto start = std::chrono::steady_clock::now();
+        auto usable = StateCacheRecord::decode(mAsyncQueue, key, records);
+        auto decoded = std::chrono::steady_clock::now();
+        fnstats.cacheDecodeTime +=
+            std::chrono::duration_cast<std::chrono::milliseconds>(decoded - start).count();
 
-                   bool rootNode = n->type == ROOTNODE || n->type == RUBBISHNODE || n->type == VAULTNODE;
-                   if (rootNode)
-                   {
-                       mNodeManager.setrootnode(n);
-                   }
-                   else if (n->parent == nullptr)
-                   {
-                       // nodes in 'statecache' are not ordered by parent-child
-                       // -> we might load nodes whose parents are not loaded yet
-                       delayedParents[n->parentHandle()].push_back(n);
-                   }
+        if (usable < records.size())
+        {
+            records.resize(usable);
+            hasNext = false;
+        }
 
-                   stateCacheTable->del(id); // delete record from old DB table 'statecache'
-                }
-                else
-                {
-                    LOG_err << "Failed - node record read error";
-                    return false;
-                }
-                break;
+        for (auto& record: records)
+        {
+            id = record.id;
+            string& data = record.data;
+            switch (id & (DbTable::IDSPACING - 1))
+            {
+                case CACHEDSCSN:
+                    if (data.size() != sizeof cachedscsn)
+                    {
+                        return false;
+                    }
+                    break;
 
-            case CACHEDPCR:
-                pcr = PendingContactRequest::unserialize(&data);
-                if (pcr)
-                {
-                    mappcr(pcr->id, unique_ptr<PendingContactRequest>(pcr));
-                    pcr->dbid = id;
-                }
-                else
-                {
-                    LOG_err << "Failed - pcr record read error";
-                    return false;
-                }
-                break;
+                case CACHEDNODE:
+                    if ((n = mNodeManager.getNodeFromBlob(&data)))
+                    {
+                        // When all nodes are loaded we force a commit
+                       isDbUpgraded = true;
 
-            case CACHEDUSER:
-                u = User::unserialize(this, &data);
-                if (u)
-                {
-                    u->dbid = id;
-                }
-                else
-                {
-                    LOG_err << "Failed - user record read error";
-                    return false;
-                }
-                break;
+                       bool rootNode = n->type == ROOTNODE || n->type == RUBBISHNODE || n->type == VAULTNODE;
+                       if (rootNode)
+                       {
+                           mNodeManager.setrootnode(n);
+                       }
+                       else if (n->parent == nullptr)
+                       {
+                           // nodes in 'statecache' are not ordered by parent-child
+                           // -> we might load nodes whose parents are not loaded yet
+                           delayedParents[n->parentHandle()].push_back(n);
+                       }
 
-            case CACHEDALERT:
-            {
-                if (loggedIntoFolder())
-                {
-                    stateCacheTable->del(id); // delete record from old DB table 'statecache'
-                }
-                else if (!useralerts.unserializeAlert(&data, id))
-                {
-                    LOG_err << "Failed - user notification read error";
-                    // don't break execution, just ignore it
-                }
-                break;
-            }
+                       stateCacheTable->del(id); // delete record from old DB table 'statecache'
+                    }
+                    else
+                    {
+                        LOG_err << "Failed - node record read error";
+                        return false;
+                    }
+                    break;
 
-            case CACHEDCHAT:
-#ifdef ENABLE_CHAT
-                {
-                    TextChat *chat;
-                    chat = TextChat::unserialize(this, &data);
-                    if (chat)
+                case CACHEDPCR:
+                    pcr = record.pcr.release();
+                    if (pcr)
                     {
-                        chat->dbid = id;
+                        mappcr(pcr->id, unique_ptr<PendingContactRequest>(pcr));
+                        pcr->dbid = id;
                     }
                     else
                     {
-                        LOG_err << "Failed - chat record read error";
+                        LOG_err << "Failed - pcr record read error";
                         return false;
                     }
-                }
-#endif
-                break;
+                    break;
 
-            case CACHEDDBSTATE:
+                case CACHEDUSER:
+                    u = User::unserialize(this, &data);
+                    if (u)
+                    {
+                        u->dbid = id;
+                    }
+                    else
+                    {
+                        LOG_err << "Failed - user record read error";
+                        return false;
+                    }
+                    break;
+
+                case CACHEDALERT:
                 {
-                    mScDbStateRecord = ScDbStateRecord::unserialize(data);
-                    mScDbStateRecord.dbid = id;
-                    LOG_debug << "reloaded seqtag from db: " << mScDbStateRecord.seqTag;
+                    if (loggedIntoFolder())
+                    {
+                        stateCacheTable->del(id); // delete record from old DB table 'statecache'
+                    }
+                    else if (!useralerts.unserializeAlert(&data, id))
+                    {
+                        LOG_err << "Failed - user notification read error";
+                        // don't break execution, just ignore it
+                    }
+                    break;
                 }
-                break;
-            case CACHEDSET:
-            {
-                if (!fetchscset(&data, id))
+
+                case CACHEDCHAT:
+#ifdef ENABLE_CHAT
+                    {
+                        TextChat *chat;
+                        chat = TextChat::unserialize(this, &data);
+                        if (chat)
+                        {
+                            chat->dbid = id;
+                        }
+                        else
+                        {
+                            LOG_err << "Failed - chat record read error";
+                            return false;
+                        }
+                    }
+#endif
+                    break;
+
+                case CACHEDDBSTATE:
+                    {
+                        mScDbStateRecord = ScDbStateRecord::unserialize(data);
+                        mScDbStateRecord.dbid = id;
+                        LOG_debug << "reloaded seqtag from db: " << mScDbStateRecord.seqTag;
+                    }
+                    break;
+                case CACHEDSET:
                 {
-                    return false;
+                    if (!fetchscset(std::move(record.set), id))
+                    {
+                        return false;
+                    }
+                    break;
                 }
-                break;
-            }
 
-            case CACHEDSETELEMENT:
-            {
-                if (!fetchscsetelement(&data, id))
+                case CACHEDSETELEMENT:
                 {
-                    return false;
+                    if (!fetchscsetelement(std::move(record.setElement), id))
+                    {
+                        return false;
+                    }
+                    break;
                 }
-                break;
             }
         }
-        hasNext = stateCacheTable->next(&id, &data, &key);
+
+        fnstats.cacheApplyTime += std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      std::chrono::steady_clock::now() - decoded)
+                                      .count();
     }
 
     LOG_debug << "Max dbId after resume session: " << id;
@@ -15245,6 +15384,11 @@ bool MegaClient::fetchsc(DbTable* stateCacheTable)
     }
     else
     {
+        if (mEnableNodeSkeletonSnapshot)
+        {
+            mNodeManager.mapSkeleton(nodeSkeletonPath(), cachedscsn);
+        }
+
         // nodes are not loaded, proceed to load them only after Users and PCRs are loaded,
         // since Node::unserialize() will call mergenewshare(), and the latter requires
         // Users and PCRs to be available
@@ -15255,6 +15399,9 @@ bool MegaClient::fetchsc(DbTable* stateCacheTable)
 
     }
 
+    // Nodes in memory match what has been committed to the DB
+    mCommittedNodeChanges = mNodeManager.getNodeChanges();
+
     WAIT_CLASS::bumpds();
     fnstats.timeToLastByte = Waiter::ds - fnstats.startTime;
 
@@ -15911,6 +16058,7 @@ void MegaClient::fetchnodes(bool nocache, bool loadSyncs, bool forceLoadFromServ
             fnstats.nodesCached = static_cast<long long>(mNodeManager.getNodeCount());
             fnstats.timeToCached = Waiter::ds - fnstats.startTime;
             fnstats.timeToResult = fnstats.timeToCached;
+            fnstats.measureCached();
 
             statecurrent = false;
 
@@ -22089,9 +22237,8 @@ bool MegaClient::initscsetelements()
     return true;
 }
 
-bool MegaClient::fetchscset(string* data, uint32_t id)
+bool MegaClient::fetchscset(unique_ptr<Set> s, uint32_t id)
 {
-    auto s = Set::unserialize(data);
     if (!s)
     {
         LOG_err << "Failed - Set record read error";
@@ -22108,9 +22255,8 @@ bool MegaClient::fetchscset(string* data, uint32_t id)
     return true;
 }
 
-bool MegaClient::fetchscsetelement(string* data, uint32_t id)
+bool MegaClient::fetchscsetelement(unique_ptr<SetElement> el, uint32_t id)
 {
-    auto el = SetElement::unserialize(data);
     if (!el)
     {
         LOG_err << "Failed - SetElement record read error";
@@ -23066,6 +23212,20 @@ void FetchNodesStats::init()
     timeToSyncsResumed = NEVER;
     timeToCurrent = NEVER;
     timeToTransfersResumed = NEVER;
+    cacheDecodeTime = 0;
+    cacheApplyTime = 0;
+    nodesPerSecond = 0;
+    peakMemory = 0;
+}
+
+void FetchNodesStats::measureCached()
+{
+    dstime elapsed = timeToCached - (timeToFirstByte == NEVER ? 0 : timeToFirstByte);
+    nodesPerSecond = elapsed > 0 ? nodesCached * 10 / elapsed : 0;
+    peakMemory = static_cast<long long>(platformGetPeakMemoryUsage());
+
+    LOG_info << "Fetchnodes: " << nodesCached << " nodes cached (" << nodesPerSecond
+             << " nodes/s). Peak memory: " << peakMemory << " bytes";
 }
 
 void FetchNodesStats::toJsonArray(string *json)
@@ -23082,7 +23242,9 @@ void FetchNodesStats::toJsonArray(string *json)
         << timeToFirstByte << "," << timeToLastByte << ","
         << timeToCached << "," << timeToResult << ","
         << timeToSyncsResumed << "," << timeToCurrent << ","
-        << timeToTransfersResumed << "," << cache << "]";
+        << timeToTransfersResumed << "," << cache << ","
+        << cacheDecodeTime << "," << cacheApplyTime << ","
+        << nodesPerSecond << "," << peakMemory << "]";
     json->append(oss.str());
 }
 
@@ -2111,6 +2111,22 @@ void LocalNode::moveContentTo(LocalNode* ln, LocalPath& fullPath, bool setScanAg
     ln->setRecomputeExclusionState(true, false);
 }
 
+localnode_map& LocalNodeChildMap::allocated()
+{
+    if (!mMap)
+    {
+        mMap = std::make_unique<localnode_map>();
+    }
+
+    return *mMap;
+}
+
+localnode_map& LocalNodeChildMap::emptyMap()
+{
+    static localnode_map empty;
+    return empty;
+}
+
 // delay uploads by 1.1 s to prevent server flooding while a file is still being written
 void LocalNode::bumpnagleds()
 {
@@ -2670,6 +2686,7 @@ bool LocalNode::processBackgroundFolderScan(SyncRow& row, SyncPath& fullPath)
         }
         else if (SCAN_SUCCESS == ourScanRequest->completionResult())
         {
+            sync->mScanStats += ourScanRequest->stats();
             lastFolderScan.reset(new vector<FSNode>(ourScanRequest->resultNodes()));
 
             for (auto& i : *lastFolderScan)
@@ -3624,6 +3641,12 @@ WatchResult LocalNode::watch(const LocalPath& path, handle fsid)
         static_cast<AndroidDirNotify&>(*sync->dirnotify);
 #endif
 
+#ifdef USE_FANOTIFY
+    // The notifier's filesystem mark already covers this directory.
+    if (notifier.usesFanotify())
+        return WR_SUCCESS;
+#endif // USE_FANOTIFY
+
     // Add the watch.
     auto result = notifier.addWatch(*this, path, fsid);
 
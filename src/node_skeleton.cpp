@@ -0,0 +1,477 @@
+/**
+ * @file node_skeleton.cpp
+ * @brief Memory-mapped snapshot of the node tree's structure
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/node_skeleton.h"
+
+#include "mega/base64.h"
+#include "mega/filesystem.h"
+#include "mega/logging.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mega {
+
+struct NodeSkeleton::Header
+{
+    char mMagic[8];
+    uint32_t mVersion;
+    uint32_t mEntrySize;
+    uint64_t mScsn;
+    uint64_t mCount;
+};
+
+namespace
+{
+
+constexpr char MAGIC[8] = {'M', 'E', 'G', 'A', 'S', 'K', 'E', 'L'};
+
+// Chunk size used when writing the snapshot to disk.
+constexpr size_t WRITE_CHUNK_SIZE = 1 << 20;
+
+bool writeAll(FileAccess& file, const void* data, size_t length, m_off_t& position)
+{
+    auto* bytes = static_cast<const unsigned char*>(data);
+
+    while (length)
+    {
+        auto chunk = std::min(length, WRITE_CHUNK_SIZE);
+
+        if (!file.fwrite(bytes, static_cast<unsigned long>(chunk), position))
+        {
+            return false;
+        }
+
+        bytes += chunk;
+        length -= chunk;
+        position += static_cast<m_off_t>(chunk);
+    }
+
+    return true;
+}
+
+// Map the whole file at path read-only. Returns nullptr (and length 0) on failure.
+const unsigned char* mapFile(const LocalPath& path, size_t& length)
+{
+    length = 0;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.asPlatformEncoded(false).c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_DELETE,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return nullptr;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+    {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (!mapping)
+    {
+        return nullptr;
+    }
+
+    // The view keeps the mapping alive once the handle is closed.
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (!data)
+    {
+        return nullptr;
+    }
+
+    length = static_cast<size_t>(size.QuadPart);
+    return static_cast<const unsigned char*>(data);
+#else
+    int descriptor = ::open(path.asPlatformEncoded(false).c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0)
+    {
+        return nullptr;
+    }
+
+    struct stat attributes;
+    if (::fstat(descriptor, &attributes) || attributes.st_size <= 0)
+    {
+        ::close(descriptor);
+        return nullptr;
+    }
+
+    auto size = static_cast<size_t>(attributes.st_size);
+
+    // The mapping outlives the descriptor.
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+
+    if (data == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    length = size;
+    return static_cast<const unsigned char*>(data);
+#endif
+}
+
+void unmapFile(const unsigned char* data, [[maybe_unused]] size_t length)
+{
+    if (!data)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    ::munmap(const_cast<unsigned char*>(data), length);
+#endif
+}
+
+} // namespace
+
+NodeSkeleton::~NodeSkeleton()
+{
+    unmapFile(mData, mLength);
+}
+
+std::unique_ptr<NodeSkeleton> NodeSkeleton::map(const LocalPath& path, handle scsn)
+{
+    std::unique_ptr<NodeSkeleton> skeleton(new NodeSkeleton());
+
+    skeleton->mData = mapFile(path, skeleton->mLength);
+    if (!skeleton->mData)
+    {
+        return nullptr;
+    }
+
+    if (skeleton->mLength < sizeof(Header))
+    {
+        LOG_warn << "Node skeleton snapshot is truncated: " << path;
+        return nullptr;
+    }
+
+    auto* header = reinterpret_cast<const Header*>(skeleton->mData);
+
+    if (std::memcmp(header->mMagic, MAGIC, sizeof(MAGIC)) || header->mVersion != FORMAT_VERSION ||
+        header->mEntrySize != sizeof(Entry))
+    {
+        LOG_warn << "Node skeleton snapshot has an unknown format: " << path;
+        return nullptr;
+    }
+
+    if (header->mScsn != scsn)
+    {
+        LOG_debug << "Node skeleton snapshot is stale (scsn "
+                  << Base64Str<sizeof(handle)>(header->mScsn) << " vs "
+                  << Base64Str<sizeof(handle)>(scsn) << ")";
+        return nullptr;
+    }
+
+    auto count = header->mCount;
+    auto maxCount = (skeleton->mLength - sizeof(Header)) / (sizeof(Entry) + sizeof(uint32_t));
+
+    if (count > maxCount ||
+        sizeof(Header) + count * (sizeof(Entry) + sizeof(uint32_t)) != skeleton->mLength)
+    {
+        LOG_warn << "Node skeleton snapshot has an invalid size: " << path;
+        return nullptr;
+    }
+
+    skeleton->mHeader = header;
+    skeleton->mEntries = reinterpret_cast<const Entry*>(skeleton->mData + sizeof(Header));
+    skeleton->mChildIndex = reinterpret_cast<const uint32_t*>(skeleton->mEntries + count);
+
+    // Lookups binary search both tables and index entries through mChildIndex: make sure a
+    // corrupt snapshot can't send them out of bounds. It'll be rebuilt from the DB when saved.
+    if (!skeleton->valid())
+    {
+        LOG_warn << "Node skeleton snapshot is corrupt: " << path;
+        return nullptr;
+    }
+
+    return skeleton;
+}
+
+bool NodeSkeleton::write(FileSystemAccess& fsAccess,
+                         const LocalPath& path,
+                         handle scsn,
+                         std::vector<Entry> entries)
+{
+    if (entries.size() > std::numeric_limits<uint32_t>::max())
+    {
+        LOG_warn << "Too many nodes for a skeleton snapshot: " << entries.size();
+        return false;
+    }
+
+    std::sort(entries.begin(),
+              entries.end(),
+              [](const Entry& lhs, const Entry& rhs)
+              {
+                  return lhs.mHandle < rhs.mHandle;
+              });
+
+    std::vector<uint32_t> childIndex(entries.size());
+
+    for (size_t i = 0; i < childIndex.size(); ++i)
+    {
+        entries[i].mReserved = 0;
+        childIndex[i] = static_cast<uint32_t>(i);
+    }
+
+    // Entries are already ordered by handle so a stable sort on parent yields (parent, handle).
+    std::stable_sort(childIndex.begin(),
+                     childIndex.end(),
+                     [&entries](uint32_t lhs, uint32_t rhs)
+                     {
+                         return entries[lhs].mParentHandle < entries[rhs].mParentHandle;
+                     });
+
+    Header header;
+    std::memcpy(header.mMagic, MAGIC, sizeof(MAGIC));
+    header.mVersion = FORMAT_VERSION;
+    header.mEntrySize = static_cast<uint32_t>(sizeof(Entry));
+    header.mScsn = scsn;
+    header.mCount = entries.size();
+
+    LocalPath temporaryPath = path;
+    temporaryPath.append(LocalPath::fromRelativePath(".tmp"));
+
+    {
+        auto file = fsAccess.newfileaccess();
+
+        if (!file->fopen(temporaryPath, false, true, FSLogging::logOnError) || !file->ftruncate())
+        {
+            LOG_warn << "Unable to create node skeleton snapshot: " << temporaryPath;
+            return false;
+        }
+
+        m_off_t position = 0;
+
+        if (!writeAll(*file, &header, sizeof(header), position) ||
+            !writeAll(*file, entries.data(), entries.size() * sizeof(Entry), position) ||
+            !writeAll(*file, childIndex.data(), childIndex.size() * sizeof(uint32_t), position))
+        {
+            LOG_warn << "Unable to write node skeleton snapshot: " << temporaryPath;
+            file.reset();
+            fsAccess.unlinklocal(temporaryPath);
+            return false;
+        }
+    }
+
+    if (!fsAccess.renamelocal(temporaryPath, path, true))
+    {
+        LOG_warn << "Unable to replace node skeleton snapshot: " << path;
+        fsAccess.unlinklocal(temporaryPath);
+        return false;
+    }
+
+    LOG_debug << "Node skeleton snapshot written with " << entries.size() << " nodes";
+
+    return true;
+}
+
+bool NodeSkeleton::valid() const
+{
+    auto count = size();
+
+    for (size_t i = 1; i < count; ++i)
+    {
+        if (mEntries[i - 1].mHandle >= mEntries[i].mHandle)
+        {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (mChildIndex[i] >= count)
+        {
+            return false;
+        }
+
+        if (!i)
+        {
+            continue;
+        }
+
+        auto& previous = mEntries[mChildIndex[i - 1]];
+        auto& current = mEntries[mChildIndex[i]];
+
+        if (previous.mParentHandle > current.mParentHandle ||
+            (previous.mParentHandle == current.mParentHandle &&
+             previous.mHandle >= current.mHandle))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool NodeSkeleton::contains(NodeHandle node) const
+{
+    return find(node) != nullptr;
+}
+
+std::optional<bool> NodeSkeleton::isAncestor(NodeHandle node,
+                                             NodeHandle ancestor,
+                                             CancelToken cancelToken) const
+{
+    auto* entry = find(node);
+    if (!entry)
+    {
+        return std::nullopt;
+    }
+
+    if (ancestor.isUndef())
+    {
+        return false;
+    }
+
+    // A well-formed tree is never deeper than the number of nodes: bound the walk in case the
+    // snapshot holds a cycle.
+    for (auto depth = size(); depth; --depth)
+    {
+        if (cancelToken.isCancelled())
+        {
+            return false;
+        }
+
+        if (entry->mParentHandle == ancestor.as8byte())
+        {
+            return true;
+        }
+
+        if (!(entry = find(NodeHandle().set6byte(entry->mParentHandle))))
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+size_t NodeSkeleton::numChildren(NodeHandle parent) const
+{
+    auto range = children(parent);
+
+    return static_cast<size_t>(range.second - range.first);
+}
+
+size_t NodeSkeleton::numChildrenByType(NodeHandle parent, nodetype_t type) const
+{
+    auto range = children(parent);
+
+    return static_cast<size_t>(std::count_if(range.first,
+                                             range.second,
+                                             [this, type](uint32_t position)
+                                             {
+                                                 return mEntries[position].mType == type;
+                                             }));
+}
+
+std::optional<NodeHandle> NodeSkeleton::parent(NodeHandle node) const
+{
+    auto* entry = find(node);
+    if (!entry)
+    {
+        return std::nullopt;
+    }
+
+    return NodeHandle().set6byte(entry->mParentHandle);
+}
+
+handle NodeSkeleton::scsn() const
+{
+    return mHeader->mScsn;
+}
+
+size_t NodeSkeleton::size() const
+{
+    return static_cast<size_t>(mHeader->mCount);
+}
+
+auto NodeSkeleton::find(NodeHandle node) const -> const Entry*
+{
+    auto* end = mEntries + size();
+    auto* entry = std::lower_bound(mEntries,
+                                   end,
+                                   node.as8byte(),
+                                   [](const Entry& entry, uint64_t handle)
+                                   {
+                                       return entry.mHandle < handle;
+                                   });
+
+    if (entry == end || entry->mHandle != node.as8byte())
+    {
+        return nullptr;
+    }
+
+    return entry;
+}
+
+std::pair<const uint32_t*, const uint32_t*> NodeSkeleton::children(NodeHandle parent) const
+{
+    auto parentHandle = parent.as8byte();
+    auto* begin = mChildIndex;
+    auto* end = mChildIndex + size();
+
+    auto* first = std::lower_bound(begin,
+                                   end,
+                                   parentHandle,
+                                   [this](uint32_t position, uint64_t handle)
+                                   {
+                                       return mEntries[position].mParentHandle < handle;
+                                   });
+
+    auto* last = std::upper_bound(first,
+                                  end,
+                                  parentHandle,
+                                  [this](uint64_t handle, uint32_t position)
+                                  {
+                                      return handle < mEntries[position].mParentHandle;
+                                  });
+
+    return {first, last};
+}
+
+} // namespace mega
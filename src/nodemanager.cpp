@@ -163,6 +163,7 @@ void NodeManager::setTable_internal(DBTableNodes *table)
 {
     assert(mMutex.owns_lock());
     mTable = table;
+    mSkeleton.reset();
 }
 
 void NodeManager::reset()
@@ -326,6 +327,13 @@ bool NodeManager::addNode_internal(std::shared_ptr<Node> node, bool notify, bool
     if (keepNodeInMemory)
     {
         saveNodeInRAM(node, rootNode || isFolderLink, missingParentNodes);   // takes ownership
+
+        if (isFetching && !notify)
+        {
+            // Children only written to DB aren't indexed (see below), and they may have arrived
+            // before this node
+            node->mNodePosition->second.mAllChildrenHandleLoaded = false;
+        }
     }
     else
     {
@@ -333,12 +341,14 @@ bool NodeManager::addNode_internal(std::shared_ptr<Node> node, bool notify, bool
         assert(!mNodeToWriteInDb);
         mNodeToWriteInDb = node;
 
-        // when keepNodeInMemory is true, NodeManager::addChild is called by Node::setParent (from NodeManager::saveNodeInRAM)
-        auto pair = mNodes.emplace(node->nodeHandle(), NodeManagerNode(*this, node->nodeHandle()));
-        // The NodeManagerNode could have been added by NodeManager::addChild() but, in that case, mNode would be invalid
-        auto& nodePosition = pair.first;
-        nodePosition->second.mAllChildrenHandleLoaded = true; // Receive a new node, children aren't received yet or they are stored in nodesWithMissingParents
-        addChild_internal(node->parentHandle(), node->nodeHandle(), nullptr);
+        // Nodes only written to DB aren't indexed in mNodes: as after resuming a session, the tree
+        // below the nodes in memory is read from DB on demand. Otherwise, memory would grow with
+        // the size of the account during fetchnodes.
+        auto parentIt = mNodes.find(node->parentHandle());
+        if (parentIt != mNodes.end())
+        {
+            parentIt->second.mAllChildrenHandleLoaded = false;
+        }
     }
 
     return true;
@@ -385,6 +395,16 @@ void NodeManager::reportNullRootNodes(const size_t rootNodesSize)
 
 std::shared_ptr<Node> NodeManager::getNodeByHandle(NodeHandle handle)
 {
+    if (handle.isUndef()) return nullptr;
+
+    {
+        SharedLockGuard g(mMutex);
+        if (std::shared_ptr<Node> node = getNodeInRAM_shared(handle))
+        {
+            return node;
+        }
+    }
+
     LockGuard g(mMutex);
     return getNodeByHandle_internal(handle);
 }
@@ -412,6 +432,15 @@ sharedNode_list NodeManager::getChildren(const Node* parent,
                                          CancelToken cancelToken,
                                          bool includeVersions)
 {
+    {
+        SharedLockGuard g(mMutex);
+        sharedNode_list childrenList;
+        if (getChildrenInRAM_shared(parent, cancelToken, childrenList))
+        {
+            return childrenList;
+        }
+    }
+
     LockGuard g(mMutex);
     return getChildren_internal(parent, cancelToken, includeVersions);
 }
@@ -1228,80 +1257,111 @@ void NodeManager::updateTreeCounter(std::shared_ptr<Node> origin, NodeCounter nc
     }
 }
 
-NodeCounter NodeManager::calculateNodeCounter(const NodeHandle& nodehandle, nodetype_t parentType, std::shared_ptr<Node> node, bool isInRubbish)
+void NodeManager::calculateNodeCounters()
 {
     assert(mMutex.owns_lock());
 
-    NodeCounter nc;
     if (!mTable)
     {
         assert(false);
-        return nc;
+        return;
     }
 
-    m_off_t nodeSize = 0u;
-    uint64_t flags = 0;
-    nodetype_t nodeType = TYPE_UNKNOWN;
-    if (node)
+    // Nodes are visited depth-first, so only the counters of the ancestors of the current node are
+    // still open: memory is bounded by the depth of the tree rather than by its size
+    struct OpenNode
     {
-        nodeType = node->type;
-        nodeSize = node->size;
-        flags = node->getDBFlags();
-    }
-    else
+        NodeTreeVisit mNode;
+        bool mIsInRubbish = false;
+        NodeCounter mCounter;
+    };
+
+    std::vector<OpenNode> openNodes;
+
+    auto close = [this, &openNodes]()
     {
-        if (!mTable->getNodeSizeTypeAndFlags(nodehandle, nodeSize, nodeType, flags))
+        OpenNode& last = openNodes.back();
+        const NodeTreeVisit& node = last.mNode;
+        NodeCounter& nc = last.mCounter;
+
+        nodetype_t parentType =
+            openNodes.size() > 1 ? openNodes[openNodes.size() - 2].mNode.mType : TYPE_UNKNOWN;
+        bool isVersion = parentType == FILENODE;
+
+        if (node.mType == FILENODE)
         {
-            assert(false);
-            return nc;
+            if (isVersion)
+            {
+                nc.versions++;
+                nc.versionStorage += node.mSize;
+            }
+            else
+            {
+                nc.files++;
+                nc.storage += node.mSize;
+            }
+        }
+        else if (node.mType == FOLDERNODE)
+        {
+            nc.folders++;
         }
-        std::bitset<Node::FLAGS_SIZE> bitset(flags);
-        flags = Node::getDBFlags(flags, isInRubbish, parentType == FILENODE, bitset.test(Node::FLAGS_IS_MARKED_SENSTIVE));
-    }
 
-    std::map<NodeHandle, NodeManagerNode*>* children = nullptr;
-    auto it = mNodes.find(nodehandle);
-    if (it != mNodes.end())
-    {
-        children = it->second.mChildren.get();
-    }
+        std::bitset<Node::FLAGS_SIZE> bitset(node.mFlags);
+        uint64_t flags = Node::getDBFlags(node.mFlags,
+                                          last.mIsInRubbish,
+                                          isVersion,
+                                          bitset.test(Node::FLAGS_IS_MARKED_SENSTIVE));
 
-    if (children)
-    {
-        for (auto& itNode : *children)
+        auto it = mNodes.find(node.mHandle);
+        if (it != mNodes.end())
         {
-            shared_ptr<Node> child = itNode.second ? itNode.second->getNodeInRam() : nullptr;
-            nc += calculateNodeCounter(itNode.first, nodeType, child, isInRubbish);
+            if (shared_ptr<Node> n = it->second.getNodeInRam(false))
+            {
+                setNodeCounter(n, nc, false, nullptr);
+            }
         }
-    }
 
-    if (nodeType == FILENODE)
-    {
-        bool isVersion = parentType == FILENODE;
-        if (isVersion)
+        mTable->updateCounterAndFlags(node.mHandle, flags, nc.serialize());
+
+        NodeCounter closed = nc;
+        openNodes.pop_back();
+
+        if (!openNodes.empty())
         {
-            nc.versions++;
-            nc.versionStorage += nodeSize;
+            openNodes.back().mCounter += closed;
         }
-        else
+    };
+
+    bool visited = mTable->visitNodesDepthFirst(
+        [&openNodes, &close](const NodeTreeVisit& node)
         {
-            nc.files++;
-            nc.storage += nodeSize;
-        }
-    }
-    else if (nodeType == FOLDERNODE)
+            // Close the nodes that aren't ancestors of this one
+            while (!openNodes.empty() && openNodes.size() >= node.mDepth)
+            {
+                close();
+            }
+
+            OpenNode open;
+            open.mNode = node;
+
+            if (!openNodes.empty())
+            {
+                const OpenNode& parent = openNodes.back();
+                open.mIsInRubbish = parent.mIsInRubbish || parent.mNode.mType == RUBBISHNODE;
+            }
+
+            openNodes.push_back(open);
+        });
+
+    while (!openNodes.empty())
     {
-        nc.folders++;
+        close();
     }
 
-    if (node)
+    if (!visited)
     {
-        setNodeCounter(node, nc, false, nullptr);
+        LOG_err << "Failed to calculate node counters";
     }
-
-    mTable->updateCounterAndFlags(nodehandle, flags, nc.serialize());
-
-    return nc;
 }
 
 
@@ -1328,6 +1388,15 @@ std::vector<NodeHandle> NodeManager::getFavouritesNodeHandles_internal(NodeHandl
 
 size_t NodeManager::getNumberOfChildrenFromNode(NodeHandle parentHandle)
 {
+    {
+        SharedLockGuard g(mMutex);
+        auto parentIt = mNodes.find(parentHandle);
+        if (mTable && parentIt != mNodes.end() && parentIt->second.mAllChildrenHandleLoaded)
+        {
+            return parentIt->second.mChildren ? parentIt->second.mChildren->size() : 0;
+        }
+    }
+
     LockGuard g(mMutex);
     return getNumberOfChildrenFromNode_internal(parentHandle);
 }
@@ -1348,6 +1417,11 @@ size_t NodeManager::getNumberOfChildrenFromNode_internal(NodeHandle parentHandle
         return parentIt->second.mChildren ? parentIt->second.mChildren->size() : 0;
     }
 
+    if (mSkeleton && mSkeleton->contains(parentHandle))
+    {
+        return mSkeleton->numChildren(parentHandle);
+    }
+
     return static_cast<size_t>(mTable->getNumberOfChildren(parentHandle));
 }
 
@@ -1369,6 +1443,11 @@ size_t NodeManager::getNumberOfChildrenByType_internal(NodeHandle parentHandle,
 
     assert(nodeType == FILENODE || nodeType == FOLDERNODE);
 
+    if (mSkeleton && mSkeleton->contains(parentHandle))
+    {
+        return mSkeleton->numChildrenByType(parentHandle, nodeType);
+    }
+
     return static_cast<size_t>(mTable->getNumberOfChildrenByType(parentHandle, nodeType));
 }
 
@@ -1388,6 +1467,14 @@ bool NodeManager::isAncestor_internal(NodeHandle nodehandle, NodeHandle ancestor
         return false;
     }
 
+    if (mSkeleton)
+    {
+        if (auto result = mSkeleton->isAncestor(nodehandle, ancestor, cancelFlag))
+        {
+            return *result;
+        }
+    }
+
     return mTable->isAncestor(nodehandle, ancestor, cancelFlag);
 }
 
@@ -1439,12 +1526,17 @@ void NodeManager::cleanNodes_internal()
     mFingerPrintsNoMtime.clear();
     mNodes.clear();
     mCacheLRU.clear();
+    {
+        std::lock_guard<std::mutex> g(mPendingCacheLRUTouchesMutex);
+        mPendingCacheLRUTouches.clear();
+    }
     mNodeToWriteInDb.reset();
     mNodeNotify.clear();
     mNodePendingApplyKeys.clear();
 
     rootnodes.clear();
 
+    nodesChanged_internal();
     if (mTable) mTable->removeNodes();
 
     mInitialized = false;
@@ -1476,7 +1568,7 @@ shared_ptr<Node> NodeManager::unserializeNode(const std::string *d, bool fromOld
     if (shared_ptr<Node> n = Node::unserialize(mClient, d, fromOldCache, ownNewshares))
     {
 
-        auto pair = mNodes.emplace(n->nodeHandle(), NodeManagerNode(*this, n->nodeHandle()));
+        auto pair = mNodes.try_emplace(n->nodeHandle(), *this, n->nodeHandle());
         // The NodeManagerNode could have been added in the initial fetch nodes (without session)
         // Now, the node is loaded from DB, NodeManagerNode is updated with correct values
         auto& nodePosition = pair.first;
@@ -1631,6 +1723,7 @@ void NodeManager::notifyPurge()
                 mNodes.erase(n->mNodePosition);
                 n->mNodePosition = mNodes.end();
 
+                nodesChanged_internal();
                 mTable->remove(h);
 
                 removed += 1;
@@ -1666,6 +1759,61 @@ bool NodeManager::loadNodes()
     return loadNodes_internal();
 }
 
+bool NodeManager::mapSkeleton(const LocalPath& path, handle scsn)
+{
+    LockGuard g(mMutex);
+
+    mSkeleton = NodeSkeleton::map(path, scsn);
+    if (!mSkeleton)
+    {
+        return false;
+    }
+
+    LOG_info << "Node skeleton snapshot mapped with " << mSkeleton->size() << " nodes";
+    return true;
+}
+
+bool NodeManager::saveSkeleton(FileSystemAccess& fsAccess, const LocalPath& path, handle scsn)
+{
+    LockGuard g(mMutex);
+
+    if (!mTable)
+    {
+        assert(false);
+        return false;
+    }
+
+    // The mapped snapshot was taken at this scsn and still describes the DB: nothing to write
+    if (mSkeleton && mSkeleton->scsn() == scsn)
+    {
+        return true;
+    }
+
+    std::vector<NodeSkeleton::Entry> entries;
+    if (!mTable->getNodeSkeleton(entries))
+    {
+        return false;
+    }
+
+    // Release the mapping, if any, so the file can be replaced on every platform
+    mSkeleton.reset();
+
+    if (!NodeSkeleton::write(fsAccess, path, scsn, std::move(entries)))
+    {
+        return false;
+    }
+
+    // The new snapshot describes the DB as it is now
+    mSkeleton = NodeSkeleton::map(path, scsn);
+    return true;
+}
+
+uint64_t NodeManager::getNodeChanges() const
+{
+    LockGuard g(mMutex);
+    return mNodeChanges;
+}
+
 bool NodeManager::loadNodes_internal()
 {
     assert(mMutex.owns_lock());
@@ -1686,6 +1834,125 @@ bool NodeManager::loadNodes_internal()
     return true;
 }
 
+shared_ptr<Node> NodeManager::getNodeInRAM_shared(NodeHandle handle)
+{
+    assert(mMutex.owns_shared_lock());
+
+    auto itNode = mNodes.find(handle);
+    if (itNode == mNodes.end())
+    {
+        return nullptr;
+    }
+
+    // Nodes out of the LRU need the exclusive path to be reinserted (and their fingerprint
+    // indexed again). Nodes in the LRU are kept alive by it.
+    if (itNode->second.mLRUPosition == invalidCacheLRUPos())
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Node> node = itNode->second.getNodeInRam(false);
+    if (node)
+    {
+        touchNodeCacheLRU_shared(handle);
+    }
+
+    return node;
+}
+
+bool NodeManager::getChildrenInRAM_shared(const Node* parent,
+                                          CancelToken cancelToken,
+                                          sharedNode_list& children)
+{
+    assert(mMutex.owns_shared_lock());
+    assert(children.empty());
+
+    if (!parent || !mTable || mNodes.empty())
+    {
+        return true;
+    }
+
+    const NodeManagerNode& parentNode = parent->mNodePosition->second;
+
+    // Handles of some children are unknown: the DB has to be queried
+    if (!parentNode.mAllChildrenHandleLoaded)
+    {
+        return false;
+    }
+
+    if (!parentNode.mChildren)
+    {
+        return true;
+    }
+
+    for (const auto& child: *parentNode.mChildren)
+    {
+        if (cancelToken.isCancelled())
+        {
+            children.clear();
+            return true;
+        }
+
+        std::shared_ptr<Node> node;
+        if (child.second && child.second->mLRUPosition != invalidCacheLRUPos())
+        {
+            node = child.second->getNodeInRam(false);
+        }
+
+        if (!node)
+        {
+            // at least one child has to be loaded from DB
+            children.clear();
+            return false;
+        }
+
+        children.push_back(std::move(node));
+    }
+
+    for (const auto& child: children)
+    {
+        touchNodeCacheLRU_shared(child->nodeHandle());
+    }
+
+    return true;
+}
+
+void NodeManager::touchNodeCacheLRU_shared(NodeHandle handle)
+{
+    // LRU order only matters if nodes can be evicted
+    if (mCacheLRUMaxSize == std::numeric_limits<uint64_t>::max())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> g(mPendingCacheLRUTouchesMutex);
+    if (mPendingCacheLRUTouches.size() < mCacheLRUMaxSize)
+    {
+        mPendingCacheLRUTouches.push_back(handle);
+    }
+}
+
+void NodeManager::applyPendingCacheLRUTouches()
+{
+    assert(mMutex.owns_lock());
+
+    std::vector<NodeHandle> touches;
+    {
+        std::lock_guard<std::mutex> g(mPendingCacheLRUTouchesMutex);
+        touches.swap(mPendingCacheLRUTouches);
+    }
+
+    // the last node touched ends up at the front (most recently used)
+    for (const NodeHandle& handle: touches)
+    {
+        auto itNode = mNodes.find(handle);
+        if (itNode != mNodes.end() && itNode->second.mLRUPosition != invalidCacheLRUPos())
+        {
+            mCacheLRU.splice(mCacheLRU.begin(), mCacheLRU, itNode->second.mLRUPosition);
+        }
+    }
+}
+
 shared_ptr<Node> NodeManager::getNodeInRAM(NodeHandle handle)
 {
     assert(mMutex.owns_lock());
@@ -1705,7 +1972,7 @@ void NodeManager::saveNodeInRAM(std::shared_ptr<Node> node, bool isRootnode, Mis
 {
     assert(mMutex.owns_lock());
 
-    auto pair = mNodes.emplace(node->nodeHandle(), NodeManagerNode(*this, node->nodeHandle()));
+    auto pair = mNodes.try_emplace(node->nodeHandle(), *this, node->nodeHandle());
     // The NodeManagerNode could have been added by NodeManager::addChild() but, in that case, mNode would be invalid
     auto& nodePosition = pair.first;
     nodePosition->second.setNode(node);
@@ -1925,16 +2192,14 @@ void NodeManager::initCompleted_internal()
     sharedNode_vector rootNodes = getRootNodesAndInshares();
     for (auto& node: rootNodes)
     {
-        if (node)
-        {
-            calculateNodeCounter(node->nodeHandle(), TYPE_UNKNOWN, node, node->type == RUBBISHNODE);
-        }
-        else
+        if (!node)
         {
             reportNullRootNodes(rootNodes.size());
         }
     }
 
+    calculateNodeCounters();
+
     mTable->createIndexes(mClient.mEnableSearchDBIndexes);
     mInitialized = true;
 }
@@ -1966,6 +2231,12 @@ void NodeManager::insertNodeCacheLRU_internal(std::shared_ptr<Node> node)
 void NodeManager::unLoadNodeFromCacheLRU()
 {
     assert(mMutex.owns_lock() && "Mutex should be locked by this thread");
+    if (mCacheLRU.size() > mCacheLRUMaxSize)
+    {
+        // take into account accesses done by readers before choosing what to unload
+        applyPendingCacheLRUTouches();
+    }
+
     while (mCacheLRU.size() > mCacheLRUMaxSize)
     {
         std::shared_ptr<Node> node = mCacheLRU.back();
@@ -2211,7 +2482,7 @@ void NodeManager::addChild_internal(NodeHandle parent, NodeHandle child, Node* n
 {
     assert(mMutex.owns_lock());
 
-    auto pair = mNodes.emplace(parent, NodeManagerNode(*this, parent));
+    auto pair = mNodes.try_emplace(parent, *this, parent);
     // The NodeManagerNode could have been added in add node, only update the child
     if (!pair.first->second.mChildren)
     {
@@ -2345,7 +2616,7 @@ sharedNode_vector NodeManager::processUnserializedNodes(const std::vector<std::p
     return nodes;
 }
 
-void NodeManager::putNodeInDb(Node* node) const
+void NodeManager::putNodeInDb(Node* node)
 {
     if (!node)
     {
@@ -2364,9 +2635,35 @@ void NodeManager::putNodeInDb(Node* node) const
         }
     }
 
+    nodesChanged_internal(node);
     mTable->put(node);
 }
 
+void NodeManager::nodesChanged_internal(const Node* node)
+{
+    assert(mMutex.owns_lock());
+
+    ++mNodeChanges;
+
+    if (!mSkeleton)
+    {
+        return;
+    }
+
+    // The node is already known under the same parent: the tree's shape hasn't changed
+    if (node)
+    {
+        auto parent = mSkeleton->parent(node->nodeHandle());
+        if (parent && *parent == node->parentHandle())
+        {
+            return;
+        }
+    }
+
+    LOG_debug << "Node skeleton snapshot dropped: the node tree has changed";
+    mSkeleton.reset();
+}
+
 size_t NodeManager::nodeNotifySize() const
 {
     LockGuard g(mMutex);
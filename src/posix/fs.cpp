@@ -940,6 +940,12 @@ LinuxFileSystemAccess::~LinuxFileSystemAccess()
     if (mNotifyFd >= 0)
         close(mNotifyFd);
 
+#ifdef USE_FANOTIFY
+    // Release fanotify descriptor, if any.
+    if (mFanotifyFd >= 0)
+        close(mFanotifyFd);
+#endif // USE_FANOTIFY
+
 #endif // ENABLE_SYNC
 }
 
@@ -980,11 +986,21 @@ void LinuxFileSystemAccess::addevents([[maybe_unused]] Waiter* waiter, int /*fla
 {
 #ifdef ENABLE_SYNC
 
+    auto w = static_cast<PosixWaiter*>(waiter);
+
+#ifdef USE_FANOTIFY
+    if (mFanotifyFd >= 0)
+    {
+        MEGA_FD_SET(mFanotifyFd, &w->rfds);
+        MEGA_FD_SET(mFanotifyFd, &w->ignorefds);
+
+        w->bumpmaxfd(mFanotifyFd);
+    }
+#endif // USE_FANOTIFY
+
     if (mNotifyFd < 0)
         return;
 
-    auto w = static_cast<PosixWaiter*>(waiter);
-
     MEGA_FD_SET(mNotifyFd, &w->rfds);
     MEGA_FD_SET(mNotifyFd, &w->ignorefds);
 
@@ -1000,6 +1016,12 @@ int LinuxFileSystemAccess::checkevents([[maybe_unused]] Waiter* waiter)
 
 #ifdef ENABLE_SYNC
 
+    auto* w = static_cast<PosixWaiter*>(waiter);
+
+#ifdef USE_FANOTIFY
+    result |= checkFanotifyEvents(*w);
+#endif // USE_FANOTIFY
+
     if (mNotifyFd < 0)
         return result;
 
@@ -1009,8 +1031,6 @@ int LinuxFileSystemAccess::checkevents([[maybe_unused]] Waiter* waiter)
             ++notifier->mErrorCount;
     };
 
-    auto* w = static_cast<PosixWaiter*>(waiter);
-
     if (!MEGA_FD_ISSET(mNotifyFd, &w->rfds))
         return result;
 
@@ -1112,6 +1132,205 @@ int LinuxFileSystemAccess::checkevents([[maybe_unused]] Waiter* waiter)
     return result;
 }
 
+#ifdef USE_FANOTIFY
+
+bool LinuxFileSystemAccess::openFanotify()
+{
+    if (mFanotifyFd >= 0)
+        return true;
+
+    // Whether we may actually mark a filesystem is only known once a sync tries to.
+    mFanotifyFd = fanotify_init(FAN_CLASS_NOTIF | FAN_REPORT_DFID_NAME | FAN_NONBLOCK | FAN_CLOEXEC,
+                                O_RDONLY | O_LARGEFILE);
+
+    if (mFanotifyFd >= 0)
+        return true;
+
+    mFanotifyFd = -errno;
+
+    LOG_debug << "fanotify is unavailable, using inotify: " << -mFanotifyFd;
+
+    return false;
+}
+
+string LinuxFileSystemAccess::fanotifyDirectory(int mountFd,
+                                                const __kernel_fsid_t& fsid,
+                                                file_handle& handle,
+                                                bool& failed)
+{
+    // Handles are only unique within a filesystem.
+    string key(reinterpret_cast<const char*>(&fsid), sizeof(fsid));
+
+    key.append(reinterpret_cast<const char*>(&handle.handle_type), sizeof(handle.handle_type));
+    key.append(reinterpret_cast<const char*>(handle.f_handle), handle.handle_bytes);
+
+    if (auto i = mFanotifyDirectories.find(key); i != mFanotifyDirectories.end())
+        return i->second;
+
+    auto fd = open_by_handle_at(mountFd, &handle, O_PATH | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        // The directory is already gone: its parent's event covers the change.
+        if (errno != ESTALE)
+        {
+            LOG_warn << "Unable to resolve fanotify event: " << errno;
+            failed = true;
+        }
+
+        return string();
+    }
+
+    string directory(PATH_MAX, '\0');
+    auto link = "/proc/self/fd/" + std::to_string(fd);
+    auto size = readlink(link.c_str(), directory.data(), directory.size());
+
+    close(fd);
+
+    if (size <= 0)
+        return string();
+
+    directory.resize(static_cast<size_t>(size));
+
+    // Every directory on a busy filesystem could end up here otherwise.
+    if (mFanotifyDirectories.size() >= 4096)
+        mFanotifyDirectories.clear();
+
+    mFanotifyDirectories.emplace(std::move(key), directory);
+
+    return directory;
+}
+
+int LinuxFileSystemAccess::checkFanotifyEvents(PosixWaiter& waiter)
+{
+    int result = 0;
+
+    if (mFanotifyFd < 0 || !MEGA_FD_ISSET(mFanotifyFd, &waiter.rfds))
+        return result;
+
+    // Called so that syncs monitored by fanotify perform a rescan.
+    auto notifyTransientFailure = [&]()
+    {
+        for (auto* notifier : mNotifiers)
+        {
+            if (static_cast<LinuxDirNotify*>(notifier)->usesFanotify())
+                ++notifier->mErrorCount;
+        }
+    };
+
+    alignas(fanotify_event_metadata) char buffer[64 * 1024];
+    ssize_t length;
+
+    while ((length = read(mFanotifyFd, buffer, sizeof(buffer))) > 0)
+    {
+        auto* event = reinterpret_cast<fanotify_event_metadata*>(buffer);
+
+        for (; FAN_EVENT_OK(event, length); event = FAN_EVENT_NEXT(event, length))
+        {
+            if (event->vers != FANOTIFY_METADATA_VERSION)
+            {
+                LOG_err << "fanotify metadata version mismatch: " << int(event->vers);
+
+                notifyTransientFailure();
+                return result | Waiter::NEEDEXEC;
+            }
+
+            if ((event->mask & FAN_Q_OVERFLOW))
+            {
+                LOG_err << "fanotify FAN_Q_OVERFLOW";
+
+                // Directories may have moved while their events were dropped.
+                mFanotifyDirectories.clear();
+
+                notifyTransientFailure();
+                result |= Waiter::NEEDEXEC;
+                continue;
+            }
+
+            // With FAN_REPORT_DFID_NAME, events identify the directory by handle and the
+            // entry by name, rather than passing us a descriptor.
+            if (event->event_len < sizeof(*event) + sizeof(fanotify_event_info_fid))
+                continue;
+
+            auto* info = reinterpret_cast<fanotify_event_info_fid*>(event + 1);
+
+            if (info->hdr.info_type != FAN_EVENT_INFO_TYPE_DFID_NAME &&
+                info->hdr.info_type != FAN_EVENT_INFO_TYPE_DFID)
+                continue;
+
+            auto* handle = reinterpret_cast<file_handle*>(info->handle);
+            const char* name = "";
+
+            if (info->hdr.info_type == FAN_EVENT_INFO_TYPE_DFID_NAME)
+                name = reinterpret_cast<const char*>(handle->f_handle + handle->handle_bytes);
+
+            // Reported for the directory itself.
+            if (!strcmp(name, "."))
+                name = "";
+
+            // The mark covers the whole filesystem: only resolve events some sync lives on.
+            LinuxDirNotify* marked = nullptr;
+
+            for (auto* notifier : mNotifiers)
+            {
+                auto* candidate = static_cast<LinuxDirNotify*>(notifier);
+
+                if (candidate->usesFanotify() && candidate->onFilesystem(info->fsid))
+                {
+                    marked = candidate;
+                    break;
+                }
+            }
+
+            if (!marked)
+                continue;
+
+            bool failed = false;
+            auto directory = fanotifyDirectory(marked->rootDescriptor(), info->fsid, *handle, failed);
+
+            if (failed)
+            {
+                // Whatever we couldn't resolve may have invalidated what we cached.
+                mFanotifyDirectories.clear();
+
+                notifyTransientFailure();
+                result |= Waiter::NEEDEXEC;
+            }
+
+            // Directories that moved or went away take their subdirectories' paths with them.
+            if ((event->mask & FAN_ONDIR) && (event->mask & (FAN_DELETE | FAN_MOVED_FROM)))
+                mFanotifyDirectories.clear();
+
+            if (directory.empty())
+                continue;
+
+            bool matched = false;
+
+            for (auto* notifier : mNotifiers)
+            {
+                auto* candidate = static_cast<LinuxDirNotify*>(notifier);
+
+                if (candidate->usesFanotify() && candidate->onFilesystem(info->fsid) &&
+                    candidate->notifyFanotifyEvent(directory, name, event->mask))
+                    matched = true;
+            }
+
+            if (!matched)
+                continue;
+
+            LOG_verbose << "Filesystem notification:"
+                        << " event " << directory << "/" << name << ": " << std::hex
+                        << event->mask;
+
+            result |= Waiter::NEEDEXEC;
+        }
+    }
+
+    return result;
+}
+
+#endif // USE_FANOTIFY
+
 #endif //  __linux__
 
 
@@ -1777,8 +1996,14 @@ void PosixFileSystemAccess::statsid(string *id) const
 #if defined(ENABLE_SYNC)
 #if defined(__linux__)
 
+#ifdef USE_FANOTIFY
+// What we ask fanotify to report: the equivalent of our inotify watches.
+static constexpr uint64_t FANOTIFY_EVENTS = FAN_ATTRIB | FAN_CLOSE_WRITE | FAN_CREATE | FAN_DELETE |
+                                            FAN_MOVED_FROM | FAN_MOVED_TO | FAN_ONDIR;
+#endif // USE_FANOTIFY
+
 LinuxDirNotify::LinuxDirNotify(LinuxFileSystemAccess& owner,
-                               LocalNode& /*root*/,
+                               [[maybe_unused]] LocalNode& root,
                                const LocalPath& rootPath):
     DirNotify(rootPath),
     mOwner(owner),
@@ -1787,6 +2012,17 @@ LinuxDirNotify::LinuxDirNotify(LinuxFileSystemAccess& owner,
     // Assume our owner couldn't initialize.
     setFailed(-owner.mNotifyFd, "Unable to create filesystem monitor.");
 
+#ifdef USE_FANOTIFY
+    mRoot = &root;
+
+    // One mark covers the whole sync, however many directories it has.
+    if (addFanotifyMark(rootPath))
+    {
+        setFailed(0, "");
+        return;
+    }
+#endif // USE_FANOTIFY
+
     // Did our owner initialize correctly?
     if (owner.mNotifyFd >= 0)
         setFailed(0, "");
@@ -1794,10 +2030,186 @@ LinuxDirNotify::LinuxDirNotify(LinuxFileSystemAccess& owner,
 
 LinuxDirNotify::~LinuxDirNotify()
 {
+#ifdef USE_FANOTIFY
+    if (usesFanotify())
+    {
+        // Remove the mark once no other sync needs its filesystem monitored.
+        auto marks = mOwner.mFanotifyMarks.find(fanotifyMarkKey());
+
+        assert(marks != mOwner.mFanotifyMarks.end());
+
+        if (marks != mOwner.mFanotifyMarks.end() && !--marks->second)
+        {
+            fanotify_mark(mOwner.mFanotifyFd,
+                          FAN_MARK_REMOVE | FAN_MARK_FILESYSTEM,
+                          FANOTIFY_EVENTS,
+                          mRootFd,
+                          nullptr);
+
+            mOwner.mFanotifyMarks.erase(marks);
+        }
+
+        close(mRootFd);
+    }
+#endif // USE_FANOTIFY
+
     // Remove ourselves from our owner's list of notiifers.
     mOwner.mNotifiers.erase(mNotifiersIt);
 }
 
+#ifdef USE_FANOTIFY
+
+bool LinuxDirNotify::addFanotifyMark(const LocalPath& rootPath)
+{
+    if (!mOwner.mUseFanotify || !mOwner.openFanotify())
+        return false;
+
+    auto path = rootPath.toPath(false);
+
+    // Events report directories by their canonical path.
+    std::unique_ptr<char, decltype(&free)> canonical(realpath(path.c_str(), nullptr), &free);
+
+    if (!canonical)
+        return false;
+
+    mRootPath = canonical.get();
+
+    auto started = std::chrono::steady_clock::now();
+
+    mRootFd = open(mRootPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if (mRootFd < 0)
+        return false;
+
+    auto fallBack = [&](const char* reason)
+    {
+        LOG_debug << "Unable to monitor " << path << " with fanotify, using inotify: " << reason
+                  << ": " << errno;
+
+        close(mRootFd);
+        mRootFd = -1;
+
+        return false;
+    };
+
+    struct statfs filesystem;
+
+    if (fstatfs(mRootFd, &filesystem))
+        return fallBack("statfs");
+
+    // The mark is on the filesystem as a whole, so it is shared by every sync whose root has the
+    // same fsid, even where their devices differ (say, btrfs subvolumes.)
+    memcpy(&mRootFsid, &filesystem.f_fsid, sizeof(mRootFsid));
+
+    // Resolving events needs CAP_DAC_READ_SEARCH: make sure we have it before relying on them.
+    alignas(file_handle) char buffer[sizeof(file_handle) + MAX_HANDLE_SZ];
+    auto* handle = reinterpret_cast<file_handle*>(buffer);
+    int mountId;
+
+    handle->handle_bytes = MAX_HANDLE_SZ;
+
+    if (name_to_handle_at(mRootFd, "", handle, &mountId, AT_EMPTY_PATH))
+        return fallBack("name_to_handle_at");
+
+    auto fd = open_by_handle_at(mRootFd, handle, O_PATH | O_CLOEXEC);
+
+    if (fd < 0)
+        return fallBack("open_by_handle_at");
+
+    close(fd);
+
+    // Filesystem marks need CAP_SYS_ADMIN.
+    if (!mOwner.mFanotifyMarks.count(fanotifyMarkKey()) &&
+        fanotify_mark(mOwner.mFanotifyFd,
+                      FAN_MARK_ADD | FAN_MARK_FILESYSTEM,
+                      FANOTIFY_EVENTS,
+                      mRootFd,
+                      nullptr))
+        return fallBack("fanotify_mark");
+
+    ++mOwner.mFanotifyMarks[fanotifyMarkKey()];
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started);
+
+    LOG_info << "Monitoring " << path << " with a fanotify filesystem mark, set up in "
+             << elapsed.count() << "us";
+
+    return true;
+}
+
+std::optional<string> LinuxDirNotify::fanotifyRelativePath(const string& root,
+                                                          const string& directory,
+                                                          const char* name)
+{
+    string relative;
+
+    if (directory.size() > root.size())
+    {
+        // Not within our sync.
+        if (directory.compare(0, root.size(), root) ||
+            (directory[root.size()] != '/' && root != "/"))
+            return std::nullopt;
+
+        relative = directory.substr(root.size() + (root != "/"));
+    }
+    else if (directory != root)
+    {
+        return std::nullopt;
+    }
+
+    if (*name)
+    {
+        if (!relative.empty())
+            relative.push_back('/');
+
+        relative.append(name);
+    }
+
+    return relative;
+}
+
+bool LinuxDirNotify::notifyFanotifyEvent(const string& directory, const char* name, uint64_t mask)
+{
+    auto path = fanotifyRelativePath(mRootPath, directory, name);
+
+    if (!path)
+        return false;
+
+    auto& relative = *path;
+
+    LOG_debug << "Filesystem notification:"
+              << " Root: " << mRoot->localname << " Path: " << relative;
+
+    notify(fsEventq,
+           mRoot,
+           Notification::NEEDS_PARENT_SCAN,
+           LocalPath::fromPlatformEncodedRelative(relative));
+
+    // Rescan directories whose permissions changed, as inotify does.
+    if ((mask & FAN_ATTRIB) && (mask & FAN_ONDIR))
+        notify(fsEventq,
+               mRoot,
+               Notification::FOLDER_NEEDS_SELF_SCAN,
+               LocalPath::fromPlatformEncodedRelative(relative));
+
+    return true;
+}
+
+string LinuxDirNotify::fanotifyMarkKey() const
+{
+    return string(reinterpret_cast<const char*>(&mRootFsid), sizeof(mRootFsid));
+}
+
+bool LinuxDirNotify::onFilesystem(const __kernel_fsid_t& fsid) const
+{
+    static_assert(sizeof(fsid) == sizeof(mRootFsid));
+
+    return !memcmp(&fsid, &mRootFsid, sizeof(mRootFsid));
+}
+
+#endif // USE_FANOTIFY
+
 #if defined(USE_INOTIFY)
 
 AddWatchResult LinuxDirNotify::addWatch(LocalNode& node,
@@ -1959,7 +2371,7 @@ ScanResult PosixFileSystemAccess::directoryScan(const LocalPath& targetPath,
                                                 map<LocalPath, FSNode>& known,
                                                 std::vector<FSNode>& results,
                                                 bool followSymLinks,
-                                                unsigned& nFingerprinted)
+                                                std::vector<PendingFingerprint>& pendingFingerprints)
 {
     // Scan path should always be absolute.
     assert(targetPath.isAbsolute());
@@ -2156,23 +2568,27 @@ ScanResult PosixFileSystemAccess::directoryScan(const LocalPath& targetPath,
             continue;
         }
 
-        // Try and open the file for reading.
-        UnixStreamAccess isAccess(newpath.toPath(false).c_str(), result.fingerprint.size);
-
-        // Only fingerprint the file if we could actually open it.
-        if (!isAccess)
-        {
-            LOG_warn << "directoryScan: "
-                     << "Unable to open file for fingerprinting: " << newpath
-                     << ". Error was: " << errno;
-            continue;
-        }
-
-        // Fingerprint the file.
-        result.fingerprint.genfingerprint(
-          &isAccess, result.fingerprint.mtime);
-
-        ++nFingerprinted;
+        // Leave the fingerprint to our caller, so files can be read in parallel.
+        pendingFingerprints.push_back(
+            {results.size() - 1,
+             [newpath](FSNode& node)
+             {
+                 // Try and open the file for reading.
+                 UnixStreamAccess isAccess(newpath.toPath(false).c_str(), node.fingerprint.size);
+
+                 // Only fingerprint the file if we could actually open it.
+                 if (!isAccess)
+                 {
+                     LOG_warn << "directoryScan: "
+                              << "Unable to open file for fingerprinting: " << newpath
+                              << ". Error was: " << errno;
+                     return false;
+                 }
+
+                 // Fingerprint the file.
+                 node.fingerprint.genfingerprint(&isAccess, node.fingerprint.mtime);
+                 return true;
+             }});
     }
 
     // We're done iterating the directory.
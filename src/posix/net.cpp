@@ -380,9 +380,7 @@ CurlHttpIO::CurlHttpIO()
 
 void CurlHttpIO::addcurlevents(Waiter* eventWaiter, direction_t d)
 {
-#ifdef MEGA_MEASURE_CODE
     CodeCounter::ScopeTimer ccst(countAddCurlEventsCode);
-#endif
 
 #if defined(_WIN32)
     bool anyWriters = false;
@@ -455,9 +453,7 @@ void CurlHttpIO::closecurlevents(direction_t d)
 
 void CurlHttpIO::processcurlevents(direction_t d)
 {
-#ifdef MEGA_MEASURE_CODE
     CodeCounter::ScopeTimer ccst(countProcessCurlEventsCode);
-#endif
 
 #ifdef WIN32
     mSocketsWaitEvent_curl_call_needed = false;
@@ -713,9 +709,7 @@ int CurlHttpIO::cacheresolvedurls(const std::vector<string>& urls, const std::ve
 // wake up from cURL I/O
 void CurlHttpIO::addevents(Waiter* w, int)
 {
-#ifdef MEGA_MEASURE_CODE
     CodeCounter::ScopeTimer ccst(countCurlHttpIOAddevents);
-#endif
 
     waiter = (WAIT_CLASS*)w;
     long curltimeoutms = -1;
@@ -25,6 +25,7 @@
 #include "mega/testhooks.h"
 #include "mega.h" // for thread definitions
 #include "mega/raidproxy.h"
+#include "mega/raid_kernels.h"
 
 #undef min //avoids issues with std::min
 
@@ -361,11 +362,33 @@ void RaidBufferManager::bufferWriteCompleted(unsigned connectionNum, bool succes
                 bufferWriteCompletedAction(*aob->second);
             }
 
+            // the buffer can receive more data, unless someone else still refers to the piece
+            if (aob->second.use_count() == 1)
+            {
+                recycle(*aob->second);
+            }
             aob->second.reset();
         }
     }
 }
 
+void RaidBufferManager::recycle(FilePiece& piece)
+{
+    size_t capacity = 0;
+    byte* buffer = piece.buf.release(capacity);
+    mBufferPool.put(buffer, capacity);
+}
+
+HttpBufferPool& RaidBufferManager::bufferPool()
+{
+    return mBufferPool;
+}
+
+m_off_t RaidBufferManager::copiedBytes() const
+{
+    return mCopiedBytes;
+}
+
 void RaidBufferManager::bufferWriteCompletedAction(FilePiece&)
 {
     // overridden for Transfers
@@ -544,6 +567,7 @@ void RaidBufferManager::combineRaidParts(unsigned connectionNum)
             // fill in the last of the buffer with non-full sectors from the end of the file
             assert(outputfilepos + m_off_t(sumdatalen) == acquirelimitpos);
             combineLastRaidLine(dest, sumdatalen);
+            mCopiedBytes += static_cast<m_off_t>(sumdatalen);
             rollInputBuffers(RAIDSECTOR);
         }
         else if (!processToEnd && outputfilepos > macchunkpos)
@@ -553,6 +577,7 @@ void RaidBufferManager::combineRaidParts(unsigned connectionNum)
             FilePiece newleftover(outputfilepos - static_cast<m_off_t>(excessdata), excessdata);
             leftoverchunk.swap(newleftover);
             memcpy(leftoverchunk.buf.datastart(), outputrec->buf.datastart() + outputrec->buf.datalen() - excessdata, excessdata);
+            mCopiedBytes += static_cast<m_off_t>(excessdata);
             outputrec->buf.end -= excessdata;
             outputfilepos -= excessdata;
             assert(raidpartspos * EFFECTIVE_RAIDPARTS == outputfilepos + m_off_t(leftoverchunk.buf.datalen()));
@@ -584,6 +609,7 @@ void RaidBufferManager::combineRaidParts(unsigned connectionNum)
         }
         else
         {
+            recycle(*outputrec);
             delete outputrec;  // this would happen if we got some data to process on all connections, but not enough to reach the next chunk boundary yet (and combined data is in leftoverchunk)
         }
     }
@@ -594,66 +620,61 @@ RaidBufferManager::FilePiece* RaidBufferManager::combineRaidParts(size_t partsle
     assert(prevleftoverchunk.buf.datalen() == 0 || prevleftoverchunk.pos == filepos);
 
     // add a bit of extra space and copy prev chunk to the front
-    FilePiece* result = new FilePiece(filepos, bufflen + prevleftoverchunk.buf.datalen());
+    const size_t len = bufflen + prevleftoverchunk.buf.datalen();
+    size_t capacity = 0;
+    byte* buffer = mBufferPool.get(len + std::min<size_t>(SymmCipher::BLOCKSIZE, RAIDSECTOR), capacity);
+    FilePiece* result = new FilePiece(filepos, new HttpReq::http_buf_t(buffer, 0, len, capacity));
     if (prevleftoverchunk.buf.datalen() > 0)
     {
         memcpy(result->buf.datastart(), prevleftoverchunk.buf.datastart(), prevleftoverchunk.buf.datalen());
+        mCopiedBytes += static_cast<m_off_t>(prevleftoverchunk.buf.datalen());
     }
 
     // usual case, for simple and fast processing: all input buffers are the same size, and aligned, and a multiple of raidsector
     if (partslen > 0)
     {
-        byte* inputbufs[RAIDPARTS];
+        const byte* inputbufs[RAIDPARTS];
         for (unsigned i = RAIDPARTS; i--; )
         {
             FilePiece* inputPiece = raidinputparts[i].front();
             inputbufs[i] = inputPiece->buf.isNull() ? NULL : inputPiece->buf.datastart();
         }
 
-        byte* b = result->buf.datastart() + prevleftoverchunk.buf.datalen();
-        byte* endpos = b + partslen * EFFECTIVE_RAIDPARTS;
+        const RaidKernels& kernels = RaidKernels::get();
 
-        for (unsigned i = 0; b < endpos; i += RAIDSECTOR)
+        // a missing data part is the xor of all the others, parity included
+        std::unique_ptr<byte[]> recoveredPart;
+        for (unsigned j = 1; j < RAIDPARTS; ++j)
         {
-            for (unsigned j = 1; j < RAIDPARTS; ++j)
+            if (inputbufs[j])
             {
-                assert(b + RAIDSECTOR <= result->buf.datastart() + result->buf.datalen());
-                if (inputbufs[j])
-                {
-                    memcpy(b, inputbufs[j] + i, RAIDSECTOR);
-                }
-                else
-                {
-                    recoverSectorFromParity(b, inputbufs, i);
-                }
-                b += RAIDSECTOR;
+                continue;
             }
-        }
-        assert(b == endpos);
-    }
-    return result;
-}
 
-void RaidBufferManager::recoverSectorFromParity(byte* dest, byte* inputbufs[], unsigned offset)
-{
-    assert(sizeof(m_off_t)*2 == RAIDSECTOR);
-    bool set = false;
-    for (unsigned i = RAIDPARTS; i--; )
-    {
-        if (inputbufs[i])
-        {
-            if (!set)
-            {
-                memcpy(dest, inputbufs[i] + offset, RAIDSECTOR);
-                set = true;
-            }
-            else
+            if (!recoveredPart)
             {
-                *(m_off_t*)dest ^= *(m_off_t*)(inputbufs[i] + offset);
-                *(m_off_t*)(dest + sizeof(m_off_t)) ^= *(m_off_t*)(inputbufs[i] + offset + sizeof(m_off_t));
+                const byte* sources[RAIDPARTS];
+                unsigned numSources = 0;
+                for (unsigned i = 0; i < RAIDPARTS; ++i)
+                {
+                    if (inputbufs[i])
+                    {
+                        sources[numSources++] = inputbufs[i];
+                    }
+                }
+
+                recoveredPart.reset(new byte[partslen]);
+                kernels.xorParts(recoveredPart.get(), sources, numSources, partslen);
             }
+            inputbufs[j] = recoveredPart.get();
         }
+
+        byte* b = result->buf.datastart() + prevleftoverchunk.buf.datalen();
+        assert(b + partslen * EFFECTIVE_RAIDPARTS <= result->buf.datastart() + result->buf.datalen());
+        kernels.interleaveLines(b, inputbufs + 1, partslen / RAIDSECTOR);
+        mCopiedBytes += static_cast<m_off_t>(partslen * EFFECTIVE_RAIDPARTS);
     }
+    return result;
 }
 
 void RaidBufferManager::combineLastRaidLine(byte* dest, size_t remainingbytes)
@@ -702,6 +723,7 @@ void RaidBufferManager::rollInputBuffers(size_t dataToDiscard)
             ip.pos += dataToDiscard;
             if (ip.buf.start >= ip.buf.end)
             {
+                recycle(ip);
                 delete raidinputparts[i].front();
                 raidinputparts[i].pop_front();
             }
@@ -1234,6 +1256,14 @@ public:
         return true;
     }
 
+    bool addCopiedBytes(m_off_t bytes)
+    {
+        if (!mStarted)
+            return false;
+        mTSlot->tsStats.mNumBytesCopied += bytes;
+        return true;
+    }
+
     /* CloudRaid functionality */
     bool balancedRequest(int connection, const std::vector<std::string> &tempUrls, size_t cfilesize, m_off_t cstart, size_t creqlen)
     {
@@ -1429,6 +1459,13 @@ bool CloudRaid::processRequestLatency(const std::shared_ptr<HttpReqXfer>& req)
     return mPimpl()->processRequestLatency(req);
 }
 
+bool CloudRaid::addCopiedBytes(m_off_t bytes)
+{
+    if (!mShown)
+        return false;
+    return mPimpl()->addCopiedBytes(bytes);
+}
+
 bool CloudRaid::init(TransferSlot* tslot, MegaClient* client, int connections)
 {
     m_pImpl = std::make_unique<CloudRaidImpl>(tslot, client, static_cast<uint8_t>(connections));
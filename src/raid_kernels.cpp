@@ -0,0 +1,327 @@
+/**
+ * @file raid_kernels.cpp
+ * @brief Vectorized routines to combine the parts of cloudraid files
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/raid_kernels.h"
+
+#include "mega/logging.h"
+
+#include <cassert>
+#include <cstring>
+
+// SSE2 and NEON are part of the baseline of the architectures where they are enabled below, so
+// only AVX2 needs to be detected at runtime
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RAID_KERNELS_SSE2 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define RAID_KERNELS_AVX2 1
+#define RAID_KERNELS_TARGET_AVX2
+#elif defined(__GNUC__)
+#define RAID_KERNELS_AVX2 1
+#define RAID_KERNELS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define RAID_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace mega {
+
+namespace {
+
+static_assert(RAIDSECTOR == 16, "The kernels move one RAIDSECTOR per 128-bit vector");
+
+// 128-bit vector operations for each instruction set. Unaligned loads and stores everywhere.
+struct Portable
+{
+    struct Vector
+    {
+        uint64_t low;
+        uint64_t high;
+    };
+
+    static constexpr const char* name = "portable";
+
+    static Vector load(const byte* source)
+    {
+        Vector v;
+        memcpy(&v.low, source, sizeof(v.low));
+        memcpy(&v.high, source + sizeof(v.low), sizeof(v.high));
+        return v;
+    }
+
+    static void store(byte* dest, Vector v)
+    {
+        memcpy(dest, &v.low, sizeof(v.low));
+        memcpy(dest + sizeof(v.low), &v.high, sizeof(v.high));
+    }
+
+    static Vector exclusiveOr(Vector a, Vector b)
+    {
+        return {a.low ^ b.low, a.high ^ b.high};
+    }
+};
+
+#if RAID_KERNELS_SSE2
+struct Sse2
+{
+    using Vector = __m128i;
+
+    static constexpr const char* name = "SSE2";
+
+    static Vector load(const byte* source)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+    }
+
+    static void store(byte* dest, Vector v)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), v);
+    }
+
+    static Vector exclusiveOr(Vector a, Vector b)
+    {
+        return _mm_xor_si128(a, b);
+    }
+};
+#endif
+
+#if RAID_KERNELS_NEON
+struct Neon
+{
+    using Vector = uint8x16_t;
+
+    static constexpr const char* name = "NEON";
+
+    static Vector load(const byte* source)
+    {
+        return vld1q_u8(source);
+    }
+
+    static void store(byte* dest, Vector v)
+    {
+        vst1q_u8(dest, v);
+    }
+
+    static Vector exclusiveOr(Vector a, Vector b)
+    {
+        return veorq_u8(a, b);
+    }
+};
+#endif
+
+void xorBytes(byte* dest, const byte* const sources[], unsigned numSources, size_t from, size_t to)
+{
+    for (size_t i = from; i < to; ++i)
+    {
+        byte value = sources[0][i];
+        for (unsigned j = 1; j < numSources; ++j)
+        {
+            value = static_cast<byte>(value ^ sources[j][i]);
+        }
+        dest[i] = value;
+    }
+}
+
+template<typename V>
+struct Kernels
+{
+    static constexpr size_t VECTOR_SIZE = RAIDSECTOR;
+
+    static void xorParts(byte* dest, const byte* const sources[], unsigned numSources, size_t len)
+    {
+        assert(numSources > 0);
+        size_t i = 0;
+        for (; i + VECTOR_SIZE <= len; i += VECTOR_SIZE)
+        {
+            auto v = V::load(sources[0] + i);
+            for (unsigned j = 1; j < numSources; ++j)
+            {
+                v = V::exclusiveOr(v, V::load(sources[j] + i));
+            }
+            V::store(dest + i, v);
+        }
+        xorBytes(dest, sources, numSources, i, len);
+    }
+
+    static void interleaveLines(byte* dest,
+                                const byte* const parts[EFFECTIVE_RAIDPARTS],
+                                size_t numLines)
+    {
+        for (size_t offset = 0; offset < numLines * RAIDSECTOR; offset += RAIDSECTOR)
+        {
+            // unrolled by the compiler, EFFECTIVE_RAIDPARTS is a constant
+            for (unsigned n = 0; n < EFFECTIVE_RAIDPARTS; ++n)
+            {
+                V::store(dest + n * RAIDSECTOR, V::load(parts[n] + offset));
+            }
+            dest += RAIDLINE;
+        }
+    }
+
+    static void scatterPart(byte* lines, const byte* part, size_t numSectors)
+    {
+        for (size_t i = 0; i < numSectors; ++i)
+        {
+            V::store(lines, V::load(part));
+            lines += RAIDLINE;
+            part += RAIDSECTOR;
+        }
+    }
+
+    static void recoverLines(byte* lines, const byte* parity, unsigned missing, size_t numLines)
+    {
+        assert(missing < EFFECTIVE_RAIDPARTS);
+        for (size_t l = 0; l < numLines; ++l)
+        {
+            auto v = V::load(parity);
+            for (unsigned n = 0; n < EFFECTIVE_RAIDPARTS; ++n)
+            {
+                if (n != missing)
+                {
+                    v = V::exclusiveOr(v, V::load(lines + n * RAIDSECTOR));
+                }
+            }
+            V::store(lines + missing * RAIDSECTOR, v);
+            lines += RAIDLINE;
+            parity += RAIDSECTOR;
+        }
+    }
+
+    static const RaidKernels implementation;
+};
+
+template<typename V>
+const RaidKernels Kernels<V>::implementation{V::name,
+                                             &Kernels<V>::xorParts,
+                                             &Kernels<V>::interleaveLines,
+                                             &Kernels<V>::scatterPart,
+                                             &Kernels<V>::recoverLines};
+
+#if RAID_KERNELS_AVX2
+// Only the XOR of whole parts is worth 256-bit vectors: the other kernels move single sectors,
+// so they are the SSE2 ones
+RAID_KERNELS_TARGET_AVX2 void
+    xorPartsAvx2(byte* dest, const byte* const sources[], unsigned numSources, size_t len)
+{
+    assert(numSources > 0);
+    size_t i = 0;
+    for (; i + sizeof(__m256i) <= len; i += sizeof(__m256i))
+    {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sources[0] + i));
+        for (unsigned j = 1; j < numSources; ++j)
+        {
+            v = _mm256_xor_si256(v,
+                                 _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sources[j] + i)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), v);
+    }
+
+    if (i + sizeof(__m128i) <= len)
+    {
+        auto v = Sse2::load(sources[0] + i);
+        for (unsigned j = 1; j < numSources; ++j)
+        {
+            v = Sse2::exclusiveOr(v, Sse2::load(sources[j] + i));
+        }
+        Sse2::store(dest + i, v);
+        i += sizeof(__m128i);
+    }
+
+    xorBytes(dest, sources, numSources, i, len);
+
+    // avoid the penalty of mixing AVX and SSE code in the caller
+    _mm256_zeroupper();
+}
+
+bool cpuSupportsAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+
+    // the OS must save the AVX registers (OSXSAVE and AVX bits, then XMM and YMM state in XCR0)
+    __cpuid(info, 1);
+    constexpr int osxsaveAndAvx = (1 << 27) | (1 << 28);
+    if ((info[2] & osxsaveAndAvx) != osxsaveAndAvx || (_xgetbv(0) & 6) != 6)
+    {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+const RaidKernels avx2Implementation{"AVX2",
+                                     &xorPartsAvx2,
+                                     &Kernels<Sse2>::interleaveLines,
+                                     &Kernels<Sse2>::scatterPart,
+                                     &Kernels<Sse2>::recoverLines};
+#endif
+
+} // namespace
+
+const std::vector<const RaidKernels*>& RaidKernels::supported()
+{
+    static const std::vector<const RaidKernels*> implementations = []()
+    {
+        std::vector<const RaidKernels*> result;
+#if RAID_KERNELS_AVX2
+        if (cpuSupportsAvx2())
+        {
+            result.push_back(&avx2Implementation);
+        }
+#endif
+#if RAID_KERNELS_SSE2
+        result.push_back(&Kernels<Sse2>::implementation);
+#endif
+#if RAID_KERNELS_NEON
+        result.push_back(&Kernels<Neon>::implementation);
+#endif
+        result.push_back(&Kernels<Portable>::implementation);
+        return result;
+    }();
+
+    return implementations;
+}
+
+const RaidKernels& RaidKernels::get()
+{
+    static const RaidKernels& best = []() -> const RaidKernels&
+    {
+        const RaidKernels& kernels = *supported().front();
+        LOG_debug << "Raid kernels: " << kernels.name;
+        return kernels;
+    }();
+
+    return best;
+}
+
+} // namespace
@@ -5,6 +5,7 @@
 #include <climits>
 
 #include "mega/raidproxy.h"
+#include "mega/raid_kernels.h"
 #include "mega.h"
 
 using namespace ::mega::RaidProxy;
@@ -361,6 +362,24 @@ void PartFetcher::closesocket(bool reuseSocket)
     mConnected = false;
 }
 
+void PartFetcher::recycleInbuf()
+{
+    size_t capacity = 0;
+    byte* buffer = mInbuf->release(capacity);
+    mInbuf.reset(nullptr);
+
+    auto& httpReq = rr->mHttpReqs[part];
+    if (httpReq && !httpReq->buf && capacity)
+    {
+        httpReq->buf = buffer;
+        httpReq->bufcapacity = capacity;
+    }
+    else
+    {
+        delete[] buffer;
+    }
+}
+
 // perform I/O on socket (which is assumed to exist)
 int64_t PartFetcher::io()
 {
@@ -420,7 +439,7 @@ int64_t PartFetcher::io()
 
         if (mInbuf)
         {
-            mInbuf.reset(nullptr);
+            recycleInbuf();
         }
 
         m_off_t npos = mPos + mRem;
@@ -515,7 +534,7 @@ int64_t PartFetcher::io()
             }
             else if (mInbuf->datalen() == 0)
             {
-                mInbuf.reset(nullptr);
+                recycleInbuf();
                 httpReq->status = REQ_READY;
             }
             else
@@ -1003,6 +1022,7 @@ void RaidReq::procdata(uint8_t part, byte* ptr, m_off_t pos, m_off_t len)
                                                           static_cast<size_t>(ahead_len))) :
                           static_cast<byte*>(malloc(static_cast<size_t>(ahead_len)));
             std::copy(ahead_ptr, ahead_ptr + ahead_len, p);
+            mCloudRaid->addCopiedBytes(ahead_len);
             mFetcher[part].mReadahead[ahead_pos] = pair<byte*, unsigned>(p, static_cast<unsigned>(ahead_len));
         }
         // if this is a pure readahead, we're done
@@ -1031,6 +1051,7 @@ void RaidReq::procdata(uint8_t part, byte* ptr, m_off_t pos, m_off_t len)
     }
 
     // copy (partial) blocks to data or parity buf
+    mCloudRaid->addCopiedBytes(len);
     if (part)
     {
         part--;
@@ -1048,12 +1069,13 @@ void RaidReq::procdata(uint8_t part, byte* ptr, m_off_t pos, m_off_t len)
             len2 -= sectorBytes;
             ptr2 += sectorBytes;
         }
-        while (len2 >= RAIDSECTOR)
+        if (len2 >= RAIDSECTOR)
         {
-            *reinterpret_cast<raidsector_t*>(target) = *reinterpret_cast<raidsector_t*>(ptr2);
-            target += RAIDSECTOR * EFFECTIVE_RAIDPARTS;
-            ptr2 += RAIDSECTOR;
-            len2 -= RAIDSECTOR;
+            auto numSectors = len2 / RAIDSECTOR;
+            RaidKernels::get().scatterPart(target, ptr2, static_cast<size_t>(numSectors));
+            target += numSectors * RAIDLINE;
+            ptr2 += numSectors * RAIDSECTOR;
+            len2 -= numSectors * RAIDSECTOR;
         }
         partialSector = len2;
         if (partialSector != 0)
@@ -1068,6 +1090,23 @@ void RaidReq::procdata(uint8_t part, byte* ptr, m_off_t pos, m_off_t len)
     }
 
     // merge new consecutive completed RAID lines so they are ready to be sent, direct from the data[] array
+    // lines missing the same data part are rebuilt from parity together, usually the whole range
+    const RaidKernels& kernels = RaidKernels::get();
+    m_off_t recoverFrom = mCompleted;
+    int recoverIndex = -1;
+    auto recoverPendingLines = [this, &kernels, &recoverFrom, &recoverIndex]()
+    {
+        if (recoverIndex > 0 && mCompleted > recoverFrom)
+        {
+            kernels.recoverLines(mData.get() + RAIDLINE * recoverFrom,
+                                 mParity.get() + RAIDSECTOR * recoverFrom,
+                                 static_cast<unsigned>(recoverIndex - 1),
+                                 static_cast<size_t>(mCompleted - recoverFrom));
+        }
+        recoverFrom = mCompleted;
+        recoverIndex = -1;
+    };
+
     auto old_completed = mCompleted;
     for (; mCompleted < until; mCompleted++)
     {
@@ -1082,11 +1121,11 @@ void RaidReq::procdata(uint8_t part, byte* ptr, m_off_t pos, m_off_t len)
         }
         else
         {
+            int index = -1;
             if (!(mask & 1))
             {
                 // parity involved in this line
 
-                int index = -1;
 #ifdef _MSC_VER
                 unsigned long bitIndex;
                 if (_BitScanForward(&bitIndex, mask))
@@ -1109,21 +1148,16 @@ void RaidReq::procdata(uint8_t part, byte* ptr, m_off_t pos, m_off_t len)
                 }
 #endif
 #endif
-                if (index != -1) // index > 0 && index < RAIDLINE
-                {
-                    auto sectors = reinterpret_cast<raidsector_t*>(mData.get() + (RAIDLINE * mCompleted));
-                    raidsector_t& target = sectors[index - 1];
-
-                    target = reinterpret_cast<raidsector_t*>(mParity.get())[mCompleted];
-                    if (!(mask & (1 << 1))) target ^= sectors[0]; // this method requires source and target are both aligned to their size
-                    if (!(mask & (1 << 2))) target ^= sectors[1];
-                    if (!(mask & (1 << 3))) target ^= sectors[2];
-                    if (!(mask & (1 << 4))) target ^= sectors[3];
-                    if (!(mask & (1 << 5))) target ^= sectors[4];
-                }
+            }
+
+            if (index != recoverIndex)
+            {
+                recoverPendingLines();
+                recoverIndex = index; // index > 0 && index < RAIDLINE if it's to be rebuilt
             }
         }
     }
+    recoverPendingLines();
 
     if (mCompleted > old_completed)
     {
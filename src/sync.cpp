@@ -926,119 +926,224 @@ const fsfp_t& Sync::fsfp() const
     return getConfig().mFilesystemFingerprint;
 }
 
-void Sync::addstatecachechildren(uint32_t parent_dbid, idlocalnode_map* tmap, LocalPath& localpath, LocalNode *p, int maxdepth)
+void Sync::addstatecachechildren(uint32_t parent_dbid, StateCacheNodes& nodes, const LocalPath& localpath, LocalNode *p, int maxdepth)
 {
     assert(syncs.onSyncThread());
 
-    auto range = tmap->equal_range(parent_dbid);
+    // LocalNodes are attached below their parent, whose path is kept alongside
+    using Parent = std::pair<LocalNode*, LocalPath>;
 
-    // remove processed elements as we go, so we can then clean the database at the end.
-    for (auto it = range.first; it != tmap->end() && it->first == parent_dbid; it = tmap->erase(it))
+    struct Tree
     {
-        LocalNode* const l = it->second;
+        Sync& sync;
 
-        auto preExisting = p->children.find(l->localname);
-        if (preExisting != p->children.end())
+        LocalNode* duplicate(const Parent& parent, LocalNode& l)
+        {
+            auto preExisting = parent.first->children.find(l.localname);
+
+            return preExisting != parent.first->children.end() ? preExisting->second : nullptr;
+        }
+
+        void remove(LocalNode& duplicate)
         {
             // tidying up from prior versions of the SDK which might have duplicate LocalNodes
-            LOG_debug << "Removing duplicate LocalNode: " << preExisting->second->debugGetParentList();
-            delete preExisting->second;   // also detaches and preps removal from db
-            assert(p->children.find(l->localname) == p->children.end());
-            // l will be added in its place.  Later entries were the ones used by the old algorithm
+            LOG_debug << "Removing duplicate LocalNode: " << duplicate.debugGetParentList();
+            delete &duplicate;   // also detaches and preps removal from db
         }
 
-        LocalPath newpath{localpath};
+        Parent attach(const Parent& parent, LocalNode& l)
+        {
+            auto* p = parent.first;
 
-        newpath.appendWithSeparator(l->localname, true);
+            assert(p->children.find(l.localname) == p->children.end());
 
-        handle fsid = l->fsid_lastSynced;
-        m_off_t size = l->syncedFingerprint.size;
+            LocalPath newpath{parent.second};
 
-        // clear localname to force newnode = true in setnameparent
-        l->localname.clear();
+            newpath.appendWithSeparator(l.localname, true);
 
-        // if we already have the shortname from database, use that, otherwise (db is from old code) look it up
-        std::unique_ptr<LocalPath> shortname;
-        if (l->slocalname_in_db)
-        {
-            // null if there is no shortname, or the shortname matches the localname.
-            shortname.reset(l->slocalname.release());
-        }
-        else
-        {
-            shortname = syncs.fsaccess->fsShortname(newpath);
-        }
+            handle fsid = l.fsid_lastSynced;
+            m_off_t size = l.syncedFingerprint.size;
 
-        l->init(l->type, p, newpath, nullptr);
+            // clear localname to force newnode = true in setnameparent
+            l.localname.clear();
 
-        l->syncedFingerprint.size = size;
-        l->setSyncedFsid(fsid, syncs.localnodeBySyncedFsid, l->localname, std::move(shortname));
-        l->setSyncedNodeHandle(l->syncedCloudNodeHandle);
-        l->oneTimeUseSyncedFingerprintInScan = true;
+            // if we already have the shortname from database, use that, otherwise (db is from old code) look it up
+            std::unique_ptr<LocalPath> shortname;
+            if (l.slocalname_in_db)
+            {
+                // null if there is no shortname, or the shortname matches the localname.
+                shortname.reset(l.slocalname.release());
+            }
+            else
+            {
+                shortname = sync.syncs.fsaccess->fsShortname(newpath);
+            }
 
-        if (!l->slocalname_in_db)
-        {
-            statecacheadd(l);
-            if (insertq.size() > 50000)
+            l.init(l.type, p, newpath, nullptr);
+
+            l.syncedFingerprint.size = size;
+            l.setSyncedFsid(fsid, sync.syncs.localnodeBySyncedFsid, l.localname, std::move(shortname));
+            l.setSyncedNodeHandle(l.syncedCloudNodeHandle);
+            l.oneTimeUseSyncedFingerprintInScan = true;
+
+            if (!l.slocalname_in_db)
             {
-                DBTableTransactionCommitter committer(statecachetable);
-                cachenodes();  // periodically output updated nodes with shortname updates, so people who restart megasync still make progress towards a fast startup
+                sync.statecacheadd(&l);
+                if (sync.insertq.size() > 50000)
+                {
+                    DBTableTransactionCommitter committer(sync.statecachetable);
+                    sync.cachenodes();  // periodically output updated nodes with shortname updates, so people who restart megasync still make progress towards a fast startup
+                }
             }
+
+            return {&l, std::move(newpath)};
         }
 
-        if (maxdepth)
+        uint32_t id(const LocalNode& l) const
         {
-            addstatecachechildren(l->dbid, tmap, newpath, l, maxdepth - 1);
+            return l.dbid;
         }
-    }
+    } tree{*this};
+
+    attachStateCacheChildren(nodes, parent_dbid, Parent(p, localpath), maxdepth, tree);
+}
+
+size_t decodeSyncStateCacheRows(MegaClientAsyncQueue& queue,
+                                const SymmCipher& key,
+                                std::vector<SyncStateCacheRow>& rows)
+{
+    constexpr size_t ROWS_PER_TASK = 256;
+
+    queue.forEachRange(rows.size(),
+                       ROWS_PER_TASK,
+                       [&](size_t first, size_t last, SymmCipher& cipher)
+                       {
+                           cipher.setkey(key.key);
+                           for (size_t i = first; i < last; ++i)
+                           {
+                               auto& row = rows[i];
+
+                               // as DbTable::next(): row 0 isn't encrypted
+                               row.decrypted = !row.id || PaddedCBC::decrypt(&row.data, &cipher);
+                               row.unserialized =
+                                   row.decrypted && row.core.read(row.data, row.parentID);
+                               row.data.clear();
+                           }
+                       });
+
+    auto undecrypted = std::find_if(rows.begin(),
+                                    rows.end(),
+                                    [](const SyncStateCacheRow& row)
+                                    {
+                                        return !row.decrypted;
+                                    });
+
+    return static_cast<size_t>(undecrypted - rows.begin());
 }
 
 void Sync::readstatecache()
 {
     assert(syncs.onSyncThread());
 
-    string cachedata;
-    idlocalnode_map tmap;
-    uint32_t cid;
+    // rows are decrypted and unserialized in parallel, in batches of this size
+    constexpr size_t ROWS_PER_BATCH = 16384;
+
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    using std::chrono::steady_clock;
 
     LOG_debug << syncname << "Sync " << toHandle(getConfig().mBackupId) << " about to load from db";
 
+    auto started = steady_clock::now();
+    steady_clock::duration readTime{};
+    steady_clock::duration decodeTime{};
+
     statecachetable->rewind();
-    unsigned numLocalNodes = 0;
 
-    // bulk-load cached nodes into tmap
+    StateCacheNodes nodes;
+    std::vector<SyncStateCacheRow> rows;
+    bool hasNext = true;
+
+    // bulk-load cached nodes
     assert(!SymmCipher::isZeroKey(syncs.syncKey.key, sizeof(syncs.syncKey.key)));
-    while (statecachetable->next(&cid, &cachedata, &syncs.syncKey))
+    while (hasNext)
     {
-        uint32_t parentID = 0;
+        auto readStart = steady_clock::now();
 
-        if (auto l = LocalNode::unserialize(*this, cachedata, parentID))
+        rows.clear();
+        while (rows.size() < ROWS_PER_BATCH)
         {
-            l->dbid = cid;
-            tmap.emplace(parentID, l.release());
-            numLocalNodes += 1;
+            SyncStateCacheRow row;
+            if (!(hasNext = statecachetable->nextEncrypted(&row.id, &row.data)))
+            {
+                break;
+            }
+            rows.push_back(std::move(row));
+        }
+
+        auto decodeStart = steady_clock::now();
+        auto usable = decodeSyncStateCacheRows(syncs.mClient.mAsyncQueue, syncs.syncKey, rows);
+        auto decodeEnd = steady_clock::now();
+
+        readTime += decodeStart - readStart;
+        decodeTime += decodeEnd - decodeStart;
+
+        if (usable < rows.size())
+        {
+            rows.resize(usable);
+            hasNext = false;
+        }
+
+        for (auto& row: rows)
+        {
+            if (!row.unserialized)
+            {
+                continue;
+            }
+
+            auto l = std::make_unique<LocalNode>(this);
+            static_cast<LocalNodeCore&>(*l) = std::move(row.core);
+            l->dbid = row.id;
+            nodes.emplace_back(row.parentID, l.release());
         }
     }
 
+    auto treeStart = steady_clock::now();
+
+    sortStateCacheNodes(nodes);
+
     // recursively build LocalNode tree
+    size_t numOrphans = 0;
     {
         DBTableTransactionCommitter committer(statecachetable);
         LocalPath pathBuffer = localroot->localname; // don't let localname be appended during recurse
-        addstatecachechildren(0, &tmap, pathBuffer, localroot.get(), 100);
+        addstatecachechildren(0, nodes, pathBuffer, localroot.get(), 100);
 
-        if (!tmap.empty())
+        // if there is anything left, those are orphan nodes - tidy up the db
+        for (auto& ln: nodes)
         {
-            // if there is anything left in tmap, those are orphan nodes - tidy up the db
-            LOG_debug << "Removing " << tmap.size() << " LocalNode orphans from db";
-            for (auto& ln : tmap)
+            if (ln.second)
             {
                 statecachedel(ln.second);
+                ++numOrphans;
             }
         }
+
+        if (numOrphans)
+        {
+            LOG_debug << "Removing " << numOrphans << " LocalNode orphans from db";
+        }
     }
     cachenodes();
 
-    LOG_debug << syncname << "Sync " << toHandle(getConfig().mBackupId) << " loaded from db with " << numLocalNodes << " sync nodes";
+    auto finished = steady_clock::now();
+
+    LOG_debug << syncname << "Sync " << toHandle(getConfig().mBackupId) << " loaded from db with "
+              << nodes.size() - numOrphans << " sync nodes in "
+              << duration_cast<milliseconds>(finished - started).count() << "ms (read "
+              << duration_cast<milliseconds>(readTime).count() << "ms, decode "
+              << duration_cast<milliseconds>(decodeTime).count() << "ms, tree "
+              << duration_cast<milliseconds>(finished - treeStart).count() << "ms)";
 
     localroot->setScanAgain(false, true, true, 0);
 }
@@ -3778,6 +3883,50 @@ bool Sync::checkCloudPathForMovesRenames(SyncRow& row, SyncRow& parentRow, SyncP
     return false;
 }
 
+void Sync::changeDetected(dstime detectedDs)
+{
+    if (mFirstPendingChange)
+    {
+        return;
+    }
+
+    auto detected = std::chrono::steady_clock::now();
+
+    // Notifications are stamped when queued, which can be a while before we get to them.
+    if (auto currentDs = syncs.waiter->ds.load(); detectedDs && detectedDs < currentDs)
+    {
+        detected -= std::chrono::milliseconds(100 * (currentDs - detectedDs));
+    }
+
+    mFirstPendingChange = detected;
+}
+
+void Sync::changesHandled()
+{
+    if (!mFirstPendingChange)
+    {
+        return;
+    }
+
+    mLastChangeLatency = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - *mFirstPendingChange);
+    mMaxChangeLatency = std::max(mMaxChangeLatency, mLastChangeLatency);
+    mFirstPendingChange.reset();
+
+    LOG_verbose << syncname << "Changes acted upon after " << mLastChangeLatency.count() << "ms";
+}
+
+bool Sync::recurseTimeSliceExpired()
+{
+    if (!mRecurseTimeSliceEnd || std::chrono::steady_clock::now() < *mRecurseTimeSliceEnd)
+    {
+        return false;
+    }
+
+    mRecurseYielded = true;
+    return true;
+}
+
 //  Just mark the relative LocalNodes as needing to be rescanned.
 dstime Sync::procscanq()
 {
@@ -3818,6 +3967,8 @@ dstime Sync::procscanq()
             continue;
         }
 
+        changeDetected(notification.timestamp);
+
         LocalPath remainder;
         LocalNode* nearest = nullptr;
         LocalNode* node = notification.localnode;
@@ -7924,7 +8075,9 @@ auto Sync::computeSyncTriplets(vector<CloudNode>& cloudNodes, const LocalNode& s
 {
     assert(syncs.onSyncThread());
 
+#ifdef MEGA_MEASURE_CODE
     CodeCounter::ScopeTimer rst(syncs.mClient.performanceStats.computeSyncTripletsTime);
+#endif // MEGA_MEASURE_CODE
 
     vector<SyncRow> triplets;
     triplets.reserve(cloudNodes.size() + syncParent.children.size() + fsNodes.size());
@@ -8026,7 +8179,9 @@ bool Sync::inferRegeneratableTriplets(vector<CloudNode>& cloudChildren, const Lo
 {
     assert(syncs.onSyncThread());
 
+#ifdef MEGA_MEASURE_CODE
     CodeCounter::ScopeTimer rst(syncs.mClient.performanceStats.inferSyncTripletsTime);
+#endif // MEGA_MEASURE_CODE
 
     if (cloudChildren.size() != syncParent.children.size()) return false;
 
@@ -8073,7 +8228,9 @@ bool Sync::inferRegeneratableTriplets(vector<CloudNode>& cloudChildren, const Lo
 using IndexPair = pair<size_t, size_t>;
 using IndexPairVector = vector<IndexPair>;
 
+#ifdef MEGA_MEASURE_CODE
 CodeCounter::ScopeStats computeSyncSequencesStats = { "computeSyncSequences" };
+#endif // MEGA_MEASURE_CODE
 
 
 static IndexPairVector computeSyncSequences(vector<SyncRow>& children)
@@ -8082,7 +8239,9 @@ static IndexPairVector computeSyncSequences(vector<SyncRow>& children)
     if (children.empty())
         return IndexPairVector();
 
+#ifdef MEGA_MEASURE_CODE
     CodeCounter::ScopeTimer rst(computeSyncSequencesStats);
+#endif // MEGA_MEASURE_CODE
 
     // Separate our children into those that are ignore files and those that are not.
     auto i = std::partition(children.begin(), children.end(), [](const SyncRow& child) {
@@ -8234,6 +8393,10 @@ bool Sync::recursiveSync(SyncRow& row, SyncPath& fullPath, bool belowRemovedClou
 
     bool earlyExit = false;
 
+    // A time slice only runs out between subfolders, once we recursed into one of them: each
+    // pass then completes at least one subtree, however short the slice.
+    bool recursedIntoChild = false;
+
     if (syncHere || recurseHere)
     {
         // Reset these flags before we evaluate each subnode.
@@ -8361,7 +8524,8 @@ bool Sync::recursiveSync(SyncRow& row, SyncPath& fullPath, bool belowRemovedClou
                     // in case of sync failing while we recurse
                     if (getConfig().mError) return false;
 
-                    if (syncs.mSyncFlags->earlyRecurseExitRequested)
+                    if (syncs.mSyncFlags->earlyRecurseExitRequested ||
+                        (step == 2 && recursedIntoChild && recurseTimeSliceExpired()))
                     {
                         // restore flags to at least what they were, for when we revisit on next full recurse
                         row.syncNode->scanAgain = std::max<TreeState>(row.syncNode->scanAgain, originalScanAgain);
@@ -8370,7 +8534,10 @@ bool Sync::recursiveSync(SyncRow& row, SyncPath& fullPath, bool belowRemovedClou
                         row.syncNode->conflicts = std::max<TreeState>(row.syncNode->conflicts, originalConflicsFlag);
 
                         LOG_debug << syncname
-                            << "recursiveSync early exit due to pending outside request with "
+                            << "recursiveSync early exit "
+                            << (mRecurseYielded ? "to let other syncs run"
+                                                : "due to pending outside request")
+                            << " with "
                             << row.syncNode->scanAgain  << "-"
                             << row.syncNode->checkMovesAgain << "-"
                             << row.syncNode->syncAgain << " ("
@@ -8573,6 +8740,8 @@ bool Sync::recursiveSync(SyncRow& row, SyncPath& fullPath, bool belowRemovedClou
                             {
                                 earlyExit = true;
                             }
+
+                            recursedIntoChild = true;
                         }
                         break;
 
@@ -8703,7 +8872,9 @@ bool Sync::syncItem_checkMoves(SyncRow& row, SyncRow& parentRow, SyncPath& fullP
         bool belowRemovedCloudNode, bool belowRemovedFsNode)
 {
     assert(syncs.onSyncThread());
+#ifdef MEGA_MEASURE_CODE
     CodeCounter::ScopeTimer rst(syncs.mClient.performanceStats.syncItemCheckMove);
+#endif // MEGA_MEASURE_CODE
 
     // Since we are visiting this node this time, reset its flags-for-parent
     // They should only stay set when the conditions require it
@@ -9357,7 +9528,9 @@ struct DifferentValueDetector_nodetype
 
 bool Sync::syncItem(SyncRow& row, SyncRow& parentRow, SyncPath& fullPath, PerFolderLogSummaryCounts& pflsc)
 {
+#ifdef MEGA_MEASURE_CODE
     CodeCounter::ScopeTimer rst(syncs.mClient.performanceStats.syncItem);
+#endif // MEGA_MEASURE_CODE
 
     assert(syncs.onSyncThread());
 
@@ -9654,7 +9827,9 @@ bool Sync::syncItem(SyncRow& row, SyncRow& parentRow, SyncPath& fullPath, PerFol
     {
         case SRT_CSF:
         {
+#ifdef MEGA_MEASURE_CODE
             CodeCounter::ScopeTimer csfTime(syncs.mClient.performanceStats.syncItemCSF);
+#endif // MEGA_MEASURE_CODE
 
             // Are we part of a move and was our source a download-in-progress?
             resolve_checkMoveDownloadComplete(row, fullPath);
@@ -9824,7 +9999,9 @@ bool Sync::syncItem(SyncRow& row, SyncRow& parentRow, SyncPath& fullPath, PerFol
         }
     case SRT_XSF:
     {
+#ifdef MEGA_MEASURE_CODE
         CodeCounter::ScopeTimer xsfTime(syncs.mClient.performanceStats.syncItemXSF);
+#endif // MEGA_MEASURE_CODE
 
         if (row.syncNode->type == TYPE_DONOTSYNC ||
             row.isLocalOnlyIgnoreFile() ||
@@ -9871,7 +10048,9 @@ bool Sync::syncItem(SyncRow& row, SyncRow& parentRow, SyncPath& fullPath, PerFol
     }
     case SRT_CSX:
     {
+#ifdef MEGA_MEASURE_CODE
         CodeCounter::ScopeTimer csxTime(syncs.mClient.performanceStats.syncItemCSX);
+#endif // MEGA_MEASURE_CODE
 
         // local item not present
         if (isBackup())
@@ -9947,14 +10126,18 @@ bool Sync::syncItem(SyncRow& row, SyncRow& parentRow, SyncPath& fullPath, PerFol
     }
     case SRT_XSX:
     {
+#ifdef MEGA_MEASURE_CODE
         CodeCounter::ScopeTimer xsxTime(syncs.mClient.performanceStats.syncItemXSX);
+#endif // MEGA_MEASURE_CODE
 
         // local and cloud disappeared; remove sync item also
         return resolve_delSyncNode(row, parentRow, fullPath, confirmDeleteCount);
     }
     case SRT_CXF:
     {
+#ifdef MEGA_MEASURE_CODE
         CodeCounter::ScopeTimer cxfTime(syncs.mClient.performanceStats.syncItemCXF);
+#endif // MEGA_MEASURE_CODE
 
         // we have to check both, due to the size parameter
         auto cloudside = parentRow.exclusionState(row.fsNode->localname, row.fsNode->type, row.fsNode->fingerprint.size);
@@ -10028,7 +10211,9 @@ bool Sync::syncItem(SyncRow& row, SyncRow& parentRow, SyncPath& fullPath, PerFol
     }
     case SRT_XXF:
     {
+#ifdef MEGA_MEASURE_CODE
         CodeCounter::ScopeTimer xxfTime(syncs.mClient.performanceStats.syncItemXXF);
+#endif // MEGA_MEASURE_CODE
 
         // Don't create a sync node for this file unless we know that it's included.
         if (parentRow.exclusionState(*row.fsNode) != ES_INCLUDED)
@@ -10040,7 +10225,9 @@ bool Sync::syncItem(SyncRow& row, SyncRow& parentRow, SyncPath& fullPath, PerFol
     }
     case SRT_CXX:
     {
+#ifdef MEGA_MEASURE_CODE
         CodeCounter::ScopeTimer cxxTime(syncs.mClient.performanceStats.syncItemCXX);
+#endif // MEGA_MEASURE_CODE
 
         // Don't create sync nodes unless we know the row is included.
         if (parentRow.exclusionState(*row.cloudNode) != ES_INCLUDED)
@@ -10058,7 +10245,9 @@ bool Sync::syncItem(SyncRow& row, SyncRow& parentRow, SyncPath& fullPath, PerFol
 
     // SRT_XXX  (should not occur)
     // no entries - can occur when names clash, but should be caught above
+#ifdef MEGA_MEASURE_CODE
     CodeCounter::ScopeTimer rstXXX(syncs.mClient.performanceStats.syncItemXXX);
+#endif // MEGA_MEASURE_CODE
     assert(false);
     return false;
 }
@@ -12293,6 +12482,7 @@ void Syncs::processTriggerHandles()
                     auto& syncs = *this;
                     SYNC_verbose << mClient.clientname << "Triggering sync flag for " << it->second->getLocalPath() << (recurse ? " recursive" : "");
                     it->second->setSyncAgain(false, true, recurse);
+                    it->second->sync->changeDetected(0);
                 }
             }
             break;
@@ -12300,6 +12490,36 @@ void Syncs::processTriggerHandles()
     }
 }
 
+void Syncs::setRecurseTimeSlice(unsigned milliseconds)
+{
+    mRecurseTimeSliceMs = milliseconds;
+
+    LOG_debug << "Sync recursion time slice set to " << milliseconds << "ms";
+}
+
+unsigned Syncs::recurseTimeSlice() const
+{
+    return mRecurseTimeSliceMs.load();
+}
+
+void Syncs::useFanotify([[maybe_unused]] bool enable)
+{
+#ifdef USE_FANOTIFY
+    static_cast<FSACCESS_CLASS&>(*fsaccess).useFanotify(enable);
+
+    LOG_debug << "Sync monitoring with fanotify " << (enable ? "enabled" : "disabled");
+#endif // USE_FANOTIFY
+}
+
+bool Syncs::usingFanotify() const
+{
+#ifdef USE_FANOTIFY
+    return static_cast<FSACCESS_CLASS&>(*fsaccess).usingFanotify();
+#else // USE_FANOTIFY
+    return false;
+#endif // ! USE_FANOTIFY
+}
+
 void Syncs::setdefaultfilepermissions(int permissions)
 {
     queueSync(
@@ -13252,6 +13472,7 @@ void Syncs::syncLoop()
 
     unsigned lastRecurseMs = 0;
     bool lastLoopEarlyExit = false;
+    bool lastLoopYielded = false;
 
     for (;;)
     {
@@ -13500,6 +13721,7 @@ void Syncs::syncLoop()
             (waiter->ds < mSyncFlags->recursiveSyncLastCompletedDs + 10) &&
             (waiter->ds > mSyncFlags->recursiveSyncLastCompletedDs) &&
             !lastLoopEarlyExit &&
+            !lastLoopYielded &&
             !mSyncVec.empty())
         {
             LOG_debug << "Don't process syncs too often in stall state";
@@ -13507,6 +13729,9 @@ void Syncs::syncLoop()
         }
 
         bool earlyExit = false;
+
+        // Whether a sync's pass was cut short by its time slice rather than by an outside request.
+        bool yielded = false;
         auto recurseStart = std::chrono::high_resolution_clock::now();
         CodeCounter::ScopeTimer rst(mClient.performanceStats.recursiveSyncTime);
 
@@ -13534,8 +13759,17 @@ void Syncs::syncLoop()
 
         unsigned skippedForScanning = 0;
 
-        for (auto& us : mSyncVec)
+        // When passes are time sliced, one large sync can't hold back the others: each pass is
+        // cut short after its slice, and the next loop starts with the sync that didn't finish.
+        // Running out of time isn't an early exit: the end-of-pass bookkeeping still happens.
+        auto timeSlice = std::chrono::milliseconds(mRecurseTimeSliceMs.load());
+        auto numSyncs = mSyncVec.size();
+        auto firstSync = timeSlice.count() && numSyncs ? mFirstSyncToRecurse % numSyncs : 0;
+        std::optional<size_t> nextFirstSync;
+
+        for (size_t n = 0; n < numSyncs; ++n)
         {
+            auto& us = mSyncVec[(firstSync + n) % numSyncs];
             Sync* sync = us->mSync.get();
 
             if (sync && !us->mConfig.mError)
@@ -13629,14 +13863,44 @@ void Syncs::syncLoop()
 
                         DBTableTransactionCommitter committer(sync->statecachetable);
 
+                        sync->mRecurseYielded = false;
+                        if (timeSlice.count())
+                        {
+                            sync->mRecurseTimeSliceEnd = std::chrono::steady_clock::now() + timeSlice;
+                        }
+
                         if (!sync->recursiveSync(row, pathBuffer, false, false, 0))
                         {
-                            earlyExit = true;
+                            if (sync->mRecurseYielded && !mSyncFlags->earlyRecurseExitRequested)
+                            {
+                                yielded = true;
+                            }
+                            else
+                            {
+                                earlyExit = true;
+                            }
+
+                            if (!nextFirstSync)
+                            {
+                                nextFirstSync = (firstSync + n) % numSyncs;
+                            }
+                        }
+                        else if (!sync->localroot->scanRequired())
+                        {
+                            sync->changesHandled();
                         }
 
+                        sync->mRecurseTimeSliceEnd.reset();
+
                         sync->cachenodes();
                     }
 
+                    if (sync->mRecurseYielded)
+                    {
+                        // Come straight back for the rest of the pass.
+                        skipWait = true;
+                    }
+
                     if (!earlyExit)
                     {
                         if (sync->isBackupAndMirroring() &&
@@ -13653,7 +13917,14 @@ void Syncs::syncLoop()
                 if (!us->mConfig.mFinishedInitialScanning &&
                     !sync->localroot->scanRequired())
                 {
-                    LOG_debug << "Finished initial sync scan at " << sync->localroot->getLocalPath();
+                    LOG_debug << "Finished initial sync scan at " << sync->localroot->getLocalPath()
+                              << " entries: " << sync->mScanStats.numEntries << " ("
+                              << sync->mScanStats.entriesPerSecond() << "/s)"
+                              << " fingerprinted: " << sync->mScanStats.numFingerprinted << " ("
+                              << sync->mScanStats.bytesFingerprinted << " bytes, "
+                              << sync->mScanStats.bytesFingerprintedPerSecond() << " bytes/s)";
+                    LOG_debug << "LocalNodes in all syncs: " << totalLocalNodes.load() << " of "
+                              << sizeof(LocalNode) << " bytes each, excluding their names";
                     us->mConfig.mFinishedInitialScanning = true;
                 }
 
@@ -13666,6 +13937,10 @@ void Syncs::syncLoop()
                 SyncTransferCounts stc = sync->threadSafeState->transferCounts();
                 counts.numUploads = static_cast<int32_t>(stc.mUploads.mPending);
                 counts.numDownloads = static_cast<int32_t>(stc.mDownloads.mPending);
+                counts.scannedEntriesPerSecond = sync->mScanStats.entriesPerSecond();
+                counts.fingerprintedBytesPerSecond = sync->mScanStats.bytesFingerprintedPerSecond();
+                counts.lastChangeLatencyMs = sync->mLastChangeLatency.count();
+                counts.maxChangeLatencyMs = sync->mMaxChangeLatency.count();
                 if (us->lastReportedDisplayStats != counts)
                 {
                     mClient.app->syncupdate_stats(us->mConfig.mBackupId, counts);
@@ -13674,6 +13949,11 @@ void Syncs::syncLoop()
             }
         }
 
+        if (timeSlice.count())
+        {
+            mFirstSyncToRecurse = nextFirstSync.value_or(firstSync);
+        }
+
         if (mTransferPauseFlagsChanged.load())
         {
             mTransferPauseFlagsChanged = false;
@@ -13685,9 +13965,7 @@ void Syncs::syncLoop()
             }
         }
 
-#ifdef MEGA_MEASURE_CODE
         rst.complete();
-#endif
         lastRecurseMs = unsigned(std::chrono::duration_cast<std::chrono::milliseconds>(
                         std::chrono::high_resolution_clock::now() - recurseStart).count());
 
@@ -13710,6 +13988,12 @@ void Syncs::syncLoop()
             earlyExit = true;
         }
 
+        if (yielded)
+        {
+            // Part of a tree wasn't visited, so this pass can't tell whether all of it was scanned.
+            mSyncFlags->reachableNodesAllScannedThisPass = false;
+        }
+
         if (earlyExit)
         {
             unsetSyncsScanningWasComplete_inThread();
@@ -13718,7 +14002,11 @@ void Syncs::syncLoop()
         }
         else
         {
-            mSyncFlags->isInitialPass = false;
+            // The first pass is over once every sync got through its whole tree.
+            if (!yielded)
+            {
+                mSyncFlags->isInitialPass = false;
+            }
 
             // Process name conflicts
             processSyncConflicts();
@@ -13751,6 +14039,7 @@ void Syncs::syncLoop()
         processDelayedUploads();
 
         lastLoopEarlyExit = earlyExit;
+        lastLoopYielded = yielded;
     }
 }
 
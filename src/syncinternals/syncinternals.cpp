@@ -703,15 +703,16 @@ std::optional<FsCloudComparisonResult> quickFingerprintComparison(const CloudNod
 }
 
 /**
- * @brief Process one chunk of MAC computation on worker thread.
+ * @brief Read one range of the file and compute its chunk MACs on a worker thread.
  *
  * Shared by CSF async MAC and clone candidate MAC computation.
- * Called from mAsyncQueue worker thread.
+ * Called from mAsyncQueue worker threads, possibly for several ranges of the same file at once.
+ * The worker that completes the last range computes the file MAC.
  */
-void processChunkOnWorkerThread(std::weak_ptr<MacComputationState> weakMac,
-                                m_off_t chunkStart,
-                                m_off_t chunkEnd,
-                                std::shared_ptr<byte[]> chunkData,
+void processRangeOnWorkerThread(std::weak_ptr<MacComputationState> weakMac,
+                                std::shared_ptr<FileAccess> fa,
+                                m_off_t rangeStart,
+                                m_off_t rangeEnd,
                                 const std::string& logPrefix)
 {
     auto macComp = weakMac.lock();
@@ -721,6 +722,56 @@ void processChunkOnWorkerThread(std::weak_ptr<MacComputationState> weakMac,
         return;
     }
 
+    // Whatever happens, this range is no longer in flight when we return
+    auto rangeDone = makeScopedDestructor(
+        [&macComp]()
+        {
+            macComp->rangesInFlight.fetch_sub(1, std::memory_order_acq_rel);
+        });
+
+    if (macComp->hasFailed())
+    {
+        return;
+    }
+
+    // Open file briefly with FILE_SHARE_DELETE
+    if (!fa->fopenForMacRead(macComp->filePath, FSLogging::logOnError))
+    {
+        LOG_debug << logPrefix << "Cannot open file: " << macComp->filePath;
+        macComp->setFailed();
+        return;
+    }
+
+    // Verify file size matches expected
+    if (fa->size != macComp->totalSize)
+    {
+        LOG_debug << logPrefix << "File size changed: expected " << macComp->totalSize
+                  << ", got " << fa->size;
+        fa->fclose();
+        macComp->setFailed();
+        return;
+    }
+
+    // Read range into buffer
+    const m_off_t rangeSize = rangeEnd - rangeStart;
+    std::unique_ptr<byte[]> rangeData(
+        new byte[static_cast<size_t>(rangeSize) + SymmCipher::BLOCKSIZE]);
+    memset(rangeData.get() + rangeSize, 0, SymmCipher::BLOCKSIZE);
+
+    bool readOk = fa->frawread(rangeData.get(),
+                               static_cast<unsigned>(rangeSize),
+                               rangeStart,
+                               true,
+                               FSLogging::logOnError);
+    fa->fclose();
+
+    if (!readOk)
+    {
+        LOG_debug << logPrefix << "Read failed at " << rangeStart << ": " << macComp->filePath;
+        macComp->setFailed();
+        return;
+    }
+
     // Create cipher and compute chunk MACs
     SymmCipher cipher;
     cipher.setkey(macComp->transferkey.data());
@@ -728,13 +779,13 @@ void processChunkOnWorkerThread(std::weak_ptr<MacComputationState> weakMac,
     chunkmac_map chunkMacs;
 
     // Process using the MEGA chunk boundaries (128KB-1MB chunks)
-    m_off_t pos = chunkStart;
-    byte* bufPtr = chunkData.get();
+    m_off_t pos = rangeStart;
+    byte* bufPtr = rangeData.get();
 
-    while (pos < chunkEnd)
+    while (pos < rangeEnd)
     {
         m_off_t chunkBoundary = ChunkedHash::chunkceil(pos, macComp->totalSize);
-        m_off_t thisChunkEnd = std::min(chunkBoundary, chunkEnd);
+        m_off_t thisChunkEnd = std::min(chunkBoundary, rangeEnd);
         unsigned chunkSize = static_cast<unsigned>(thisChunkEnd - pos);
 
         // Compute MAC for this chunk
@@ -749,55 +800,32 @@ void processChunkOnWorkerThread(std::weak_ptr<MacComputationState> weakMac,
         pos = thisChunkEnd;
     }
 
-    // Check if this was the last chunk
-    if (chunkEnd >= macComp->totalSize)
+    if (!macComp->addChunkMacs(std::move(chunkMacs), rangeSize))
     {
-        // Compute final local MAC
-        {
-            std::lock_guard<std::mutex> g(macComp->macsMutex);
-            chunkMacs.copyEntriesTo(macComp->partialMacs);
-        }
-
-        int64_t localMac = macComp->partialMacs.macsmac(&cipher);
-
-        LOG_debug << logPrefix << "Local MAC computed: " << localMac;
-
-        macComp->setComplete(localMac);
+        // Other ranges still to process
+        LOG_verbose << logPrefix << "Range [" << rangeStart << "-" << rangeEnd
+                    << "] done: " << macComp->filePath;
+        return;
     }
-    else
-    {
-        // More chunks to process
-        macComp->addChunkMacs(std::move(chunkMacs), chunkEnd);
-        macComp->chunkInProgress.store(false, std::memory_order_release);
 
-        LOG_verbose << logPrefix << "Chunk done, progress: " << chunkEnd << "/"
-                    << macComp->totalSize;
+    // This was the last range: compute final local MAC
+    int64_t localMac;
+    {
+        std::lock_guard<std::mutex> g(macComp->macsMutex);
+        localMac = macComp->partialMacs.macsmac(&cipher);
     }
-}
 
-/**
- * @brief Result of advanceMacComputation.
- */
-enum class MacAdvanceResult
-{
-    Pending, // Chunk queued or in progress
-    Ready, // Local MAC is computed (check state->localMac)
-    Failed // Error occurred
-};
+    macComp->setComplete(localMac);
+
+    auto seconds = std::chrono::duration<double>(macComp->elapsed).count();
+    LOG_debug << logPrefix << "Local MAC computed: " << localMac << " [size="
+              << macComp->totalSize << ", ms=" << static_cast<int64_t>(seconds * 1000)
+              << ", MB/s="
+              << (seconds > 0 ? static_cast<double>(macComp->totalSize) / (1024 * 1024) / seconds :
+                                0)
+              << "]";
+}
 
-/**
- * @brief Advance local file MAC computation by one chunk.
- *
- * This is the shared core for both CSF and clone candidate MAC computation.
- * It handles reading the next chunk and queueing it to the worker thread.
- *
- * @param mc MegaClient for file access and async queue.
- * @param state The MAC computation state (must have cipher params initialized).
- *              Passed by value to ensure the state stays alive during the function,
- *              even if another thread resets the original shared_ptr.
- * @param logPrefix Prefix for log messages.
- * @return MacAdvanceResult indicating current state.
- */
 MacAdvanceResult advanceMacComputation(MegaClient& mc,
                                        std::shared_ptr<MacComputationState> state,
                                        const std::string& logPrefix)
@@ -818,92 +846,71 @@ MacAdvanceResult advanceMacComputation(MegaClient& mc,
         return MacAdvanceResult::Ready;
     }
 
-    if (state->isChunkInProgress())
-    {
-        return MacAdvanceResult::Pending;
-    }
-
-    // Ready for next chunk - read and queue
-    m_off_t readStart = state->currentPosition;
-    m_off_t tentativeEnd = std::min(readStart + MacComputationState::BUFFER_SIZE, state->totalSize);
-
-    // Round down to nearest MEGA chunk boundary (unless it's the file end)
-    m_off_t readEnd;
-    if (tentativeEnd >= state->totalSize)
-    {
-        readEnd = state->totalSize;
-    }
-    else
-    {
-        readEnd = ChunkedHash::chunkfloor(tentativeEnd);
-        if (readEnd <= readStart)
-        {
-            readEnd = ChunkedHash::chunkceil(readStart, state->totalSize);
-        }
-    }
-
-    m_off_t readSize = readEnd - readStart;
-
-    if (readSize <= 0)
-    {
-        LOG_err << logPrefix << "Invalid read size: " << readSize;
-        state->setFailed();
-        return MacAdvanceResult::Failed;
-    }
-
-    // Open file briefly with FILE_SHARE_DELETE
-    auto fa = mc.fsaccess->newfileaccess();
-    if (!fa || !fa->fopenForMacRead(state->filePath, FSLogging::logOnError))
+    if (state->totalSize <= 0)
     {
-        LOG_debug << logPrefix << "Cannot open file: " << state->filePath;
+        LOG_err << logPrefix << "Invalid read size: " << state->totalSize;
         state->setFailed();
         return MacAdvanceResult::Failed;
     }
 
-    // Verify file size matches expected
-    if (fa->size != state->totalSize)
+    if (state->nextRangeStart == 0)
     {
-        LOG_debug << logPrefix << "File size changed: expected " << state->totalSize << ", got "
-                  << fa->size;
-        fa->fclose();
-        state->setFailed();
-        return MacAdvanceResult::Failed;
+        state->startTime = std::chrono::steady_clock::now();
     }
 
-    // Read chunk into buffer
-    auto chunkData =
-        std::shared_ptr<byte[]>(new byte[static_cast<size_t>(readSize) + SymmCipher::BLOCKSIZE]);
-    memset(chunkData.get() + readSize, 0, SymmCipher::BLOCKSIZE);
-
-    bool readOk = fa->frawread(chunkData.get(),
-                               static_cast<unsigned>(readSize),
-                               readStart,
-                               true,
-                               FSLogging::logOnError);
-    fa->fclose();
+    std::weak_ptr<MacComputationState> weakMac = state;
+    const std::string workerLogPre = logPrefix + "(worker): ";
 
-    if (!readOk)
+    while (state->canQueueRange())
     {
-        LOG_debug << logPrefix << "Read failed at " << readStart << ": " << state->filePath;
-        state->setFailed();
-        return MacAdvanceResult::Failed;
-    }
+        m_off_t rangeStart = state->nextRangeStart;
+        m_off_t tentativeEnd =
+            std::min(rangeStart + MacComputationState::BUFFER_SIZE, state->totalSize);
 
-    // Mark chunk in progress and queue to worker thread
-    state->chunkInProgress.store(true, std::memory_order_release);
+        // Round down to nearest MEGA chunk boundary (unless it's the file end)
+        m_off_t rangeEnd;
+        if (tentativeEnd >= state->totalSize)
+        {
+            rangeEnd = state->totalSize;
+        }
+        else
+        {
+            rangeEnd = ChunkedHash::chunkfloor(tentativeEnd);
+            if (rangeEnd <= rangeStart)
+            {
+                rangeEnd = ChunkedHash::chunkceil(rangeStart, state->totalSize);
+            }
+        }
 
-    std::weak_ptr<MacComputationState> weakMac = state;
-    const std::string workerLogPre = logPrefix + "(worker): ";
+        if (rangeEnd <= rangeStart)
+        {
+            LOG_err << logPrefix << "Invalid read size: " << rangeEnd - rangeStart;
+            state->setFailed();
+            return MacAdvanceResult::Failed;
+        }
 
-    mc.mAsyncQueue.push(
-        [weakMac, readStart, readEnd, chunkData, workerLogPre](SymmCipher&)
+        // Created here, opened and read by the worker
+        std::shared_ptr<FileAccess> fa = mc.fsaccess->newfileaccess();
+        if (!fa)
         {
-            processChunkOnWorkerThread(weakMac, readStart, readEnd, chunkData, workerLogPre);
-        },
-        true);
+            LOG_debug << logPrefix << "Cannot access file: " << state->filePath;
+            state->setFailed();
+            return MacAdvanceResult::Failed;
+        }
+
+        state->nextRangeStart = rangeEnd;
+        state->rangesInFlight.fetch_add(1, std::memory_order_acq_rel);
 
-    LOG_verbose << logPrefix << "Queued chunk [" << readStart << "-" << readEnd
-                << "]: " << state->filePath;
+        mc.mAsyncQueue.push(
+            [weakMac, fa, rangeStart, rangeEnd, workerLogPre](SymmCipher&)
+            {
+                processRangeOnWorkerThread(weakMac, fa, rangeStart, rangeEnd, workerLogPre);
+            },
+            true);
+
+        LOG_verbose << logPrefix << "Queued range [" << rangeStart << "-" << rangeEnd
+                    << "]: " << state->filePath;
+    }
 
     return MacAdvanceResult::Pending;
 }
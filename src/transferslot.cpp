@@ -33,6 +33,13 @@
 
 namespace mega {
 
+// milliseconds since 'start'
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
 TransferSlotFileAccess::TransferSlotFileAccess(std::unique_ptr<FileAccess>&& p, Transfer* t)
     : transfer(t)
 {
@@ -83,6 +90,47 @@ double stats::TransferSlotStats::averageStartTransferTime() const
                       static_cast<double>(mNumRequestsWithCalculatedLatency));
 }
 
+double stats::TransferSlotStats::averageUploadStageTime(double totalStageTime) const
+{
+    if (totalStageTime <= 0 || !mNumUploadedChunks)
+    {
+        return 0;
+    }
+    return std::round(totalStageTime / static_cast<double>(mNumUploadedChunks));
+}
+
+// Time uploaded chunks spend in each stage of the pipeline, across all the transfers
+static CodeCounter::ScopeStats uploadChunkReadStats{"TransferSlot_uploadRead"};
+static CodeCounter::ScopeStats uploadChunkEncryptQueueStats{"TransferSlot_uploadEncryptQueue"};
+static CodeCounter::ScopeStats uploadChunkEncryptStats{"TransferSlot_uploadEncrypt"};
+static CodeCounter::ScopeStats uploadChunkSendStats{"TransferSlot_uploadSend"};
+
+static void publishUploadStageTime(CodeCounter::ScopeStats& scope, double ms)
+{
+    using namespace std::chrono;
+
+    scope.started();
+    scope.finished(
+        duration_cast<high_resolution_clock::duration>(duration<double, std::milli>(ms)));
+}
+
+void stats::TransferSlotStats::addUploadedChunk(double readTime,
+                                                double encryptQueueTime,
+                                                double encryptTime,
+                                                double sendTime)
+{
+    ++mNumUploadedChunks;
+    mTotalReadTime += readTime;
+    mTotalEncryptQueueTime += encryptQueueTime;
+    mTotalEncryptTime += encryptTime;
+    mTotalSendTime += sendTime;
+
+    publishUploadStageTime(uploadChunkReadStats, readTime);
+    publishUploadStageTime(uploadChunkEncryptQueueStats, encryptQueueTime);
+    publishUploadStageTime(uploadChunkEncryptStats, encryptTime);
+    publishUploadStageTime(uploadChunkSendStats, sendTime);
+}
+
 // transfer attempts are considered failed after XFERTIMEOUT deciseconds
 // without data flow
 const dstime TransferSlot::XFERTIMEOUT = 600;
@@ -389,6 +437,12 @@ void TransferSlot::processTransferStats()
                 << " ms. Total requests = " << tsStats.mNumTotalRequests
                 << " (with calculated latency: " << tsStats.mNumRequestsWithCalculatedLatency
                 << "). Failed requests = " << tsStats.mNumFailedRequests
+                << ". Bytes copied = " << (tsStats.mNumBytesCopied + transferbuf.copiedBytes())
+                << ". Average chunk read/encrypt queue/encrypt/send time: "
+                << tsStats.averageUploadStageTime(tsStats.mTotalReadTime) << "/"
+                << tsStats.averageUploadStageTime(tsStats.mTotalEncryptQueueTime) << "/"
+                << tsStats.averageUploadStageTime(tsStats.mTotalEncryptTime) << "/"
+                << tsStats.averageUploadStageTime(tsStats.mTotalSendTime) << " ms"
                 << ". [Transfer->name = " << transfer->localfilename << "]"
                 << " [cloudRaid = " << (void*)(cloudRaid.get()) << "]";
 
@@ -746,6 +800,8 @@ void TransferSlot::doio(MegaClient* client, TransferDbCommitter& committer)
 
                     if (transfer->type == PUT)
                     {
+                        processUploadStagesTime(static_cast<HttpReqUL&>(*reqs[i]));
+
                         // completed put transfers are signalled through the
                         // return of the upload token
                         if (reqs[i]->in.size() == UPLOADTOKENLEN)
@@ -1084,35 +1140,12 @@ void TransferSlot::doio(MegaClient* client, TransferDbCommitter& committer)
                             if (transfer->type == PUT)
                             {
                                 LOG_verbose << "Conn " << i << " : Async read succeeded (size: " << asyncIO[i]->dataBufferLen << ")";
-                                m_off_t npos = asyncIO[i]->posOfBuffer + asyncIO[i]->dataBufferLen;
-                                string finaltempurl = transferbuf.tempURL(i);
-                                if (client->usealtupport &&
-                                    Utils::startswith(finaltempurl, "http:"))
-                                {
-                                    size_t index = finaltempurl.find("/", 8);
-                                    if(index != string::npos && finaltempurl.find(":", 8) == string::npos)
-                                    {
-                                        finaltempurl.insert(index, ":8080");
-                                    }
-                                }
-
-                                auto pos = asyncIO[i]->posOfBuffer;
-                                auto req = reqs[i];    // shared_ptr so no object is deleted out from under the worker
-                                auto transferkey = transfer->transferkey;
-                                auto ctriv = transfer->ctriv;
-                                req->pos = pos;
-                                req->status = REQ_ENCRYPTING;
-
-                                client->mAsyncQueue.push([req, transferkey, ctriv, finaltempurl, pos, npos](SymmCipher& sc)
-                                    {
-                                        sc.setkey(transferkey.data());
-                                        req->prepare(finaltempurl.c_str(),
-                                                     &sc,
-                                                     static_cast<uint64_t>(ctriv),
-                                                     pos,
-                                                     npos);
-                                        req->status = REQ_PREPARED;
-                                    }, true);   // discardable - if the transfer or client are being destroyed, we won't be sending that data.
+                                auto& uploadRequest = static_cast<HttpReqUL&>(*reqs[i]);
+                                uploadRequest.mReadTime = elapsedMs(uploadRequest.mStageStart);
+                                encryptUploadChunk(i,
+                                                   asyncIO[i]->posOfBuffer,
+                                                   asyncIO[i]->posOfBuffer +
+                                                       asyncIO[i]->dataBufferLen);
                             }
                             else
                             {
@@ -1265,13 +1298,23 @@ void TransferSlot::doio(MegaClient* client, TransferDbCommitter& committer)
                                 asyncIO[i] = NULL;
                             }
 
+                            static_cast<HttpReqUL*>(reqs[i].get())->mStageStart =
+                                std::chrono::steady_clock::now();
                             asyncIO[i] = fa->asyncfread(reqs[i]->out, size, (-(int)size) & (SymmCipher::BLOCKSIZE - 1), pos, FSLogging::logOnError);
                             reqs[i]->status = REQ_ASYNCIO;
                             prepare = false;
                         }
                         else
                         {
-                            if (!fa->fread(reqs[i]->out, size, (-(int)size) & (SymmCipher::BLOCKSIZE - 1), transfer->pos, FSLogging::logOnError))
+                            auto& uploadRequest = static_cast<HttpReqUL&>(*reqs[i]);
+                            uploadRequest.mStageStart = std::chrono::steady_clock::now();
+                            if (fa->fread(reqs[i]->out, size, (-(int)size) & (SymmCipher::BLOCKSIZE - 1), transfer->pos, FSLogging::logOnError))
+                            {
+                                uploadRequest.mReadTime = elapsedMs(uploadRequest.mStageStart);
+                                encryptUploadChunk(i, posrange.first, posrange.second);
+                                prepare = false;
+                            }
+                            else
                             {
                                 LOG_warn << "Conn " << i << " : Error preparing transfer: " << fa->retry;
                                 if (!fa->retry)
@@ -1383,6 +1426,11 @@ void TransferSlot::doio(MegaClient* client, TransferDbCommitter& committer)
                     }
                     else // if (!transferbuf.isNewRaid())
                     {
+                        if (transfer->type == PUT)
+                        {
+                            static_cast<HttpReqUL*>(reqs[i].get())->mStageStart =
+                                std::chrono::steady_clock::now();
+                        }
                         processRequestPost(client, reqs[i]);
                     }
 
@@ -1586,6 +1634,14 @@ m_off_t TransferSlot::updatecontiguousprogress()
 
 void TransferSlot::prepareRequest(const std::shared_ptr<HttpReqXfer>& httpReq, const string& tempURL, m_off_t pos, m_off_t npos)
 {
+    if (transfer->type == GET)
+    {
+        // data is received in pooled buffers, decrypted in place and written from there
+        auto downloadRequest = static_cast<HttpReqDL*>(httpReq.get());
+        downloadRequest->mBufferPool = &transferbuf.bufferPool();
+        downloadRequest->mCopiedBytes = &tsStats.mNumBytesCopied;
+    }
+
     string finaltempURL = tempURL;
     if (!finaltempURL.empty() &&
         ((transfer->type == GET && transfer->client->usealtdownport) ||
@@ -1609,6 +1665,52 @@ void TransferSlot::prepareRequest(const std::shared_ptr<HttpReqXfer>& httpReq, c
     httpReq->status = REQ_PREPARED;
 }
 
+void TransferSlot::encryptUploadChunk(unsigned connection, m_off_t pos, m_off_t npos)
+{
+    assert(transfer->type == PUT);
+
+    string finaltempurl = transferbuf.tempURL(connection);
+    if (transfer->client->usealtupport && Utils::startswith(finaltempurl, "http:"))
+    {
+        size_t index = finaltempurl.find("/", 8);
+        if (index != string::npos && finaltempurl.find(":", 8) == string::npos)
+        {
+            finaltempurl.insert(index, ":8080");
+        }
+    }
+
+    auto req = reqs[connection]; // shared_ptr so no object is deleted out from under the worker
+    auto transferkey = transfer->transferkey;
+    auto ctriv = transfer->ctriv;
+    req->pos = pos;
+    req->status = REQ_ENCRYPTING;
+    static_cast<HttpReqUL*>(req.get())->mStageStart = std::chrono::steady_clock::now();
+
+    transfer->client->mAsyncQueue.push(
+        [req, transferkey, ctriv, finaltempurl, pos, npos](SymmCipher& sc)
+        {
+            auto& uploadRequest = static_cast<HttpReqUL&>(*req);
+            uploadRequest.mEncryptQueueTime = elapsedMs(uploadRequest.mStageStart);
+
+            const auto start = std::chrono::steady_clock::now();
+            sc.setkey(transferkey.data());
+            req->prepare(finaltempurl.c_str(), &sc, static_cast<uint64_t>(ctriv), pos, npos);
+            uploadRequest.mEncryptTime = elapsedMs(start);
+
+            req->status = REQ_PREPARED;
+        },
+        true); // discardable - if the transfer or client are being destroyed, we won't be sending
+               // that data.
+}
+
+void TransferSlot::processUploadStagesTime(HttpReqUL& req)
+{
+    tsStats.addUploadedChunk(req.mReadTime,
+                             req.mEncryptQueueTime,
+                             req.mEncryptTime,
+                             elapsedMs(req.mStageStart));
+}
+
 void TransferSlot::processRequestPost(MegaClient* client,
                                       const std::shared_ptr<HttpReqXfer>& httpReq)
 {
@@ -1769,6 +1871,7 @@ std::pair<error, dstime> TransferSlot::processRaidReq(size_t connection, m_off_t
     raidReqProgress = static_cast<m_off_t>(cloudRaid->readData(static_cast<int>(connection), buf, len));
     if (raidReqProgress > 0)
     {
+        tsStats.mNumBytesCopied += raidReqProgress;
         httpReq->bufpos += raidReqProgress;
         if (httpReq->bufpos == httpReq->size)
         {
@@ -50,6 +50,7 @@
 
 #ifdef WIN32
 #include <direct.h>
+#include <psapi.h>
 #else
 #include <sys/time.h>
 #include <sys/resource.h>
@@ -473,11 +474,133 @@ bool CacheableReader::unserializebinary(byte* data, size_t len)
 }
 
 
+// Chunks grow by one SEGSIZE until they are 8 SEGSIZEs long (see ChunkedHash)
+static const size_t NUM_GROWING_CHUNKS = 8;
+static const m_off_t GROWING_CHUNKS_SIZE = 36 * ChunkedHash::SEGSIZE;
+static const m_off_t FULL_CHUNK_SIZE = 8 * ChunkedHash::SEGSIZE;
+
+size_t chunkmac_map::chunkNumber(m_off_t pos)
+{
+    if (pos < 0)
+    {
+        return NOT_A_CHUNK;
+    }
+
+    size_t chunk = 0;
+    if (pos >= GROWING_CHUNKS_SIZE)
+    {
+        chunk = NUM_GROWING_CHUNKS + static_cast<size_t>((pos - GROWING_CHUNKS_SIZE) / FULL_CHUNK_SIZE);
+    }
+    else
+    {
+        while (chunkPos(chunk + 1) <= pos)
+        {
+            ++chunk;
+        }
+    }
+
+    return chunkPos(chunk) == pos ? chunk : NOT_A_CHUNK;
+}
+
+m_off_t chunkmac_map::chunkPos(size_t chunk)
+{
+    if (chunk <= NUM_GROWING_CHUNKS)
+    {
+        return ChunkedHash::SEGSIZE * static_cast<m_off_t>(chunk * (chunk + 1) / 2);
+    }
+
+    return GROWING_CHUNKS_SIZE + static_cast<m_off_t>(chunk - NUM_GROWING_CHUNKS) * FULL_CHUNK_SIZE;
+}
+
+size_t chunkmac_map::nextSlot(size_t slot) const
+{
+    while (slot < mPresent.size() && !mPresent[slot])
+    {
+        ++slot;
+    }
+    return slot;
+}
+
+chunkmac_map::ChunkMAC* chunkmac_map::find(m_off_t pos)
+{
+    size_t chunk = chunkNumber(pos);
+    if (chunk == NOT_A_CHUNK || chunk < mFirstChunk)
+    {
+        return nullptr;
+    }
+
+    size_t slot = chunk - mFirstChunk;
+    return slot < mPresent.size() && mPresent[slot] ? &mMacs[slot] : nullptr;
+}
+
+chunkmac_map::ChunkMAC& chunkmac_map::get(m_off_t pos)
+{
+    size_t chunk = chunkNumber(pos);
+    if (chunk == NOT_A_CHUNK)
+    {
+        // Rounding down would mix this data into the MAC of the chunk that starts before it
+        LOG_err << "Rejected chunk MAC position: " << pos;
+        static thread_local ChunkMAC rejected;
+        rejected = ChunkMAC();
+        return rejected;
+    }
+
+    if (!mCount)
+    {
+        mMacs.clear();
+        mPresent.clear();
+        mFirstChunk = chunk;
+        mBegin = 0;
+    }
+    else if (chunk < mFirstChunk)
+    {
+        // rare: entries are mostly added in order
+        size_t numSlots = mFirstChunk - chunk;
+        mMacs.insert(mMacs.begin(), numSlots, ChunkMAC());
+        mPresent.insert(mPresent.begin(), numSlots, false);
+        mFirstChunk = chunk;
+        mBegin += numSlots;
+    }
+
+    size_t slot = chunk - mFirstChunk;
+    if (slot >= mMacs.size())
+    {
+        mMacs.resize(slot + 1);
+        mPresent.resize(slot + 1, false);
+    }
+
+    if (!mPresent[slot])
+    {
+        mPresent[slot] = true;
+        mMacs[slot] = ChunkMAC();
+        mBegin = std::min(mBegin, slot);
+        ++mCount;
+    }
+    return mMacs[slot];
+}
+
+void chunkmac_map::eraseFirst()
+{
+    assert(mCount);
+    mPresent[mBegin] = false;
+    --mCount;
+    mBegin = nextSlot(mBegin + 1);
+
+    // release the unused slots once they are the majority
+    if (mBegin > mMacs.size() / 2)
+    {
+        mMacs.erase(mMacs.begin(), mMacs.begin() + static_cast<ptrdiff_t>(mBegin));
+        mPresent.erase(mPresent.begin(), mPresent.begin() + static_cast<ptrdiff_t>(mBegin));
+        mFirstChunk += mBegin;
+        mBegin = 0;
+    }
+}
+
 void chunkmac_map::serialize(string& d) const
 {
     unsigned short ll = (unsigned short)size();
     d.append((char*)&ll, sizeof(ll));
-    for (auto& it : mMacMap)
+    for (auto it : *this)
     {
         d.append((char*)&it.first, sizeof(it.first));
         d.append((char*)&it.second, sizeof(it.second));
@@ -499,10 +622,19 @@ bool chunkmac_map::unserialize(const char*& ptr, const char* end)
         m_off_t pos = MemAccess::get<m_off_t>(ptr);
         ptr += sizeof(m_off_t);
 
-        memcpy(&(mMacMap[pos]), ptr, sizeof(ChunkMAC));
+        // entries are serialized in order, and always at the start of a chunk
+        if (chunkNumber(pos) == NOT_A_CHUNK ||
+            (mCount && pos <= chunkPos(mFirstChunk + mMacs.size() - 1)))
+        {
+            LOG_err << "Invalid chunk MAC position: " << pos;
+            return false;
+        }
+
+        ChunkMAC& chunk = get(pos);
+        memcpy(&chunk, ptr, sizeof(ChunkMAC));
         ptr += sizeof(ChunkMAC);
 
-        if (mMacMap[pos].isMacsmacSoFar())
+        if (chunk.isMacsmacSoFar())
         {
             macsmacSoFarPos = pos;
             assert(i == 0);
@@ -520,7 +652,7 @@ void chunkmac_map::calcprogress(m_off_t size, m_off_t& chunkpos, m_off_t& progre
     chunkpos = 0;
     progresscompleted = 0;
 
-    for (auto& it : mMacMap)
+    for (auto it : *this)
     {
         m_off_t chunkceil = ChunkedHash::chunkceil(it.first, size);
 
@@ -558,17 +690,17 @@ m_off_t chunkmac_map::nextUnprocessedPosFrom(m_off_t pos)
 {
     assert(pos > macsmacSoFarPos);
 
-    for (auto it = mMacMap.find(ChunkedHash::chunkfloor(pos));
-        it != mMacMap.end();
-        it = mMacMap.find(ChunkedHash::chunkfloor(pos)))
+    for (auto chunk = find(ChunkedHash::chunkfloor(pos));
+        chunk;
+        chunk = find(ChunkedHash::chunkfloor(pos)))
     {
-        if (it->second.finished)
+        if (chunk->finished)
         {
             pos = ChunkedHash::chunkceil(pos);
         }
         else
         {
-            pos += it->second.offset;
+            pos += chunk->offset;
             break;
         }
     }
@@ -579,11 +711,11 @@ m_off_t chunkmac_map::expandUnprocessedPiece(m_off_t pos, m_off_t npos, m_off_t
 {
     assert(pos > macsmacSoFarPos);
 
-    for (auto it = mMacMap.find(npos);
+    for (auto chunk = find(npos);
         npos < fileSize &&
         (npos - pos) < maxReqSize &&
-        (it == mMacMap.end() || it->second.notStarted());
-        it = mMacMap.find(npos))
+        (!chunk || chunk->notStarted());
+        chunk = find(npos))
     {
         npos = ChunkedHash::chunkceil(npos, fileSize);
     }
@@ -594,24 +726,23 @@ m_off_t chunkmac_map::hasUnfinishedGap(m_off_t fileSize)
 {
     bool sawUnfinished = false;
 
-    for (auto it = mMacMap.begin();
-        it != mMacMap.end(); )
+    for (size_t slot = mBegin; slot < mMacs.size(); )
     {
-        if (!it->second.finished)
+        if (!mMacs[slot].finished)
         {
             sawUnfinished = true;
         }
 
-        auto nextpos = ChunkedHash::chunkceil(it->first, fileSize);
-        auto expected_it = mMacMap.find(nextpos);
+        auto nextpos = ChunkedHash::chunkceil(chunkPos(mFirstChunk + slot), fileSize);
+        auto expected = find(nextpos);
 
-        if (sawUnfinished && expected_it != mMacMap.end() && expected_it->second.finished)
+        if (sawUnfinished && expected && expected->finished)
         {
             return true;
         }
 
-        ++it;
-        if (it != expected_it)
+        slot = nextSlot(slot + 1);
+        if (slot == mMacs.size() ? expected != nullptr : expected != &mMacs[slot])
         {
             sawUnfinished = true;
         }
@@ -626,7 +757,7 @@ void chunkmac_map::ctr_encrypt(m_off_t chunkid, SymmCipher *cipher, byte *chunks
     assert(startpos > macsmacSoFarPos);
 
     // encrypt is always done on whole chunks
-    auto& chunk = mMacMap[chunkid];
+    auto& chunk = get(chunkid);
     cipher->ctr_crypt(chunkstart,
                       unsigned(chunksize),
                       startpos,
@@ -644,7 +775,7 @@ void chunkmac_map::ctr_decrypt(m_off_t chunkid, SymmCipher *cipher, byte *chunks
     assert(chunkid > macsmacSoFarPos);
     assert(startpos >= chunkid);
     assert(startpos + chunksize <= ChunkedHash::chunkceil(chunkid));
-    ChunkMAC& chunk = mMacMap[chunkid];
+    ChunkMAC& chunk = get(chunkid);
 
     cipher->ctr_crypt(chunkstart,
                       chunksize,
@@ -675,7 +806,11 @@ void chunkmac_map::setProgressContiguous(const m_off_t p)
 
 void chunkmac_map::swap(chunkmac_map& other)
 {
-    mMacMap.swap(other.mMacMap);
+    mMacs.swap(other.mMacs);
+    mPresent.swap(other.mPresent);
+    std::swap(mFirstChunk, other.mFirstChunk);
+    std::swap(mBegin, other.mBegin);
+    std::swap(mCount, other.mCount);
     std::swap(macsmacSoFarPos, other.macsmacSoFarPos);
     std::swap(progresscontiguous, other.progresscontiguous);
     DEBUG_TEST_HOOK_ON_PROGRESS_CONTIGUOUS_UPDATE(progresscontiguous);
@@ -683,13 +818,13 @@ void chunkmac_map::swap(chunkmac_map& other)
 
 void chunkmac_map::finishedUploadChunks(chunkmac_map& macs)
 {
-    for (auto& m : macs.mMacMap)
+    for (auto m : macs)
     {
         assert(m.first > macsmacSoFarPos);
-        assert(mMacMap.find(m.first) == mMacMap.end() || !mMacMap[m.first].isMacsmacSoFar());
+        assert(!find(m.first) || !find(m.first)->isMacsmacSoFar());
 
         m.second.finished = true;
-        mMacMap[m.first] = m.second;
+        get(m.first) = m.second;
         LOG_verbose << "Upload chunk completed: " << m.first;
     }
 }
@@ -698,9 +833,8 @@ bool chunkmac_map::finishedAt(m_off_t pos)
 {
     assert(pos > macsmacSoFarPos);
 
-    auto pcit = mMacMap.find(pos);
-    return pcit != mMacMap.end()
-        && pcit->second.finished;
+    auto chunk = find(pos);
+    return chunk && chunk->finished;
 }
 
 m_off_t chunkmac_map::updateContiguousProgress(m_off_t fileSize)
@@ -721,25 +855,24 @@ void chunkmac_map::updateMacsmacProgress(SymmCipher *cipher)
     while (macsmacSoFarPos + 1024 * 1024 * 5 < progresscontiguous  // never go past contiguous-from-start section
            && size() > 32 * 3 + 5)   // leave enough room for the mac-with-late-gaps corrective calculation to occur
     {
-        if (mMacMap.begin()->second.isMacsmacSoFar())
+        if (mMacs[mBegin].isMacsmacSoFar())
         {
-            auto it = mMacMap.begin();
-            auto& calcSoFar = it->second;
-            auto& next = (++it)->second;
+            auto& calcSoFar = mMacs[mBegin];
+            auto nextslot = nextSlot(mBegin + 1);
+            auto& next = mMacs[nextslot];
 
-            assert(it->first == ChunkedHash::chunkfloor(it->first));
             SymmCipher::xorblock(next.mac, calcSoFar.mac);
             cipher->ecb_encrypt(calcSoFar.mac);
             memcpy(next.mac, calcSoFar.mac, sizeof(next.mac));
 
-            macsmacSoFarPos = it->first;
+            macsmacSoFarPos = chunkPos(mFirstChunk + nextslot);
             next.offset = unsigned(-1);
             assert(next.isMacsmacSoFar());
-            mMacMap.erase(mMacMap.begin());
+            eraseFirst();
         }
-        else if (mMacMap.begin()->first == 0 && finishedAt(0))
+        else if (chunkPos(mFirstChunk + mBegin) == 0 && finishedAt(0))
         {
-            auto& first = mMacMap.begin()->second;
+            auto& first = mMacs[mBegin];
 
             byte mac[SymmCipher::BLOCKSIZE] = { 0 };
             SymmCipher::xorblock(first.mac, mac);
@@ -755,16 +888,16 @@ void chunkmac_map::updateMacsmacProgress(SymmCipher *cipher)
 
     if (updated)
     {
-        LOG_verbose << "Macsmac calculation advanced to " << mMacMap.begin()->first;
+        LOG_verbose << "Macsmac calculation advanced to " << chunkPos(mFirstChunk + mBegin);
     }
 }
 
 void chunkmac_map::copyEntriesTo(chunkmac_map& other)
 {
-    for (auto& e : mMacMap)
+    for (auto e : *this)
     {
         assert(e.first > macsmacSoFarPos);
-        other.mMacMap[e.first] = e.second;
+        other.get(e.first) = e.second;
     }
 }
 
@@ -791,7 +924,7 @@ m_off_t chunkmac_map::copyEntriesToUntilRaidlineBeforePos(m_off_t maxPos, chunkm
     if (maxPos == 0)
         return 0;
 
-    for (auto& e: mMacMap)
+    for (auto e: *this)
     {
         if (e.first >= maxPos)
         {
@@ -806,7 +939,7 @@ m_off_t chunkmac_map::copyEntriesToUntilRaidlineBeforePos(m_off_t maxPos, chunkm
                       << "), break";
             break;
         }
-        other.mMacMap[e.first] = e.second;
+        other.get(e.first) = e.second;
     }
 
     return maxPos;
@@ -815,12 +948,13 @@ m_off_t chunkmac_map::copyEntriesToUntilRaidlineBeforePos(m_off_t maxPos, chunkm
 void chunkmac_map::copyEntryTo(m_off_t pos, chunkmac_map& other)
 {
     assert(pos > macsmacSoFarPos);
-    mMacMap[pos] = other.mMacMap[pos];
+    const ChunkMAC chunk = other.get(pos);
+    get(pos) = chunk;
 }
 
 void chunkmac_map::debugLogOuputMacs()
 {
-    for (auto& it : mMacMap)
+    for (auto it : *this)
     {
         LOG_debug << "macs: " << it.first << " " << Base64Str<SymmCipher::BLOCKSIZE>(it.second.mac) << " " << it.second.finished;
     }
@@ -831,11 +965,11 @@ int64_t chunkmac_map::macsmac(SymmCipher *cipher)
 {
     byte mac[SymmCipher::BLOCKSIZE] = { 0 };
 
-    for (auto& it : mMacMap)
+    for (auto it : *this)
     {
         if (it.second.isMacsmacSoFar())
         {
-            assert(it.first == mMacMap.begin()->first);
+            assert(it.first == chunkPos(mFirstChunk + mBegin));
             memcpy(mac, it.second.mac, sizeof(mac));
         }
         else
@@ -859,12 +993,13 @@ int64_t chunkmac_map::macsmac_gaps(SymmCipher *cipher, size_t g1, size_t g2, siz
     byte mac[SymmCipher::BLOCKSIZE] = { 0 };
 
     size_t n = 0;
-    for (auto it = mMacMap.begin(); it != mMacMap.end(); it++, n++)
+    for (auto it = begin(); it != end(); ++it, n++)
     {
-        if (it->second.isMacsmacSoFar())
+        auto entry = *it;
+        if (entry.second.isMacsmacSoFar())
         {
-            memcpy(mac, it->second.mac, sizeof(mac));
-            for (m_off_t pos = 0; pos <= it->first; pos = ChunkedHash::chunkceil(pos))
+            memcpy(mac, entry.second.mac, sizeof(mac));
+            for (m_off_t pos = 0; pos <= entry.first; pos = ChunkedHash::chunkceil(pos))
             {
                 ++n;
             }
@@ -873,8 +1008,8 @@ int64_t chunkmac_map::macsmac_gaps(SymmCipher *cipher, size_t g1, size_t g2, siz
         {
             if ((n >= g1 && n < g2) || (n >= g3 && n < g4)) continue;
 
-            assert(it->first == ChunkedHash::chunkfloor(it->first));
-            SymmCipher::xorblock(it->second.mac, mac);
+            assert(entry.first == ChunkedHash::chunkfloor(entry.first));
+            SymmCipher::xorblock(entry.second.mac, mac);
             cipher->ecb_encrypt(mac);
         }
     }
@@ -2873,6 +3008,42 @@ void MegaClientAsyncQueue::push(std::function<void(SymmCipher&)> f, bool discard
     }
 }
 
+void MegaClientAsyncQueue::forEachRange(
+    size_t count,
+    size_t rangeSize,
+    const std::function<void(size_t first, size_t last, SymmCipher&)>& f)
+{
+    assert(rangeSize);
+
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t pendingRanges = (count + rangeSize - 1) / rangeSize;
+
+    for (size_t first = 0; first < count; first += rangeSize)
+    {
+        const size_t last = std::min(first + rangeSize, count);
+        push(
+            [&, first, last](SymmCipher& cipher)
+            {
+                f(first, last, cipher);
+
+                std::lock_guard<std::mutex> g(mutex);
+                if (!--pendingRanges)
+                {
+                    done.notify_one();
+                }
+            },
+            false);
+    }
+
+    std::unique_lock<std::mutex> g(mutex);
+    done.wait(g,
+              [&pendingRanges]()
+              {
+                  return !pendingRanges;
+              });
+}
+
 MegaClientAsyncQueue::MegaClientAsyncQueue(Waiter& w, unsigned threadCount)
     : mWaiter(w)
 {
@@ -3341,6 +3512,31 @@ void debugLogHeapUsage()
 #endif
 }
 
+uint64_t platformGetPeakMemoryUsage()
+{
+#ifdef WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+
+    return static_cast<uint64_t>(counters.PeakWorkingSetSize);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage))
+    {
+        return 0;
+    }
+
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss); // bytes
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+#endif
+}
+
 bool haveDuplicatedValues(const string_map& readableVals, const string_map& b64Vals)
 {
     return
@@ -3675,6 +3871,56 @@ bool foldCaseAccentEqual(uint32_t codePoint1, uint32_t codePoint2, bool stripAcc
            u_foldCase(codePoint1, U_FOLD_CASE_DEFAULT);
 }
 
+std::string foldCaseAccent(const char* str, const bool stripAccents)
+{
+    std::string result;
+    if (!str)
+        return result;
+
+    // Same options used by foldCaseAccentEqual()
+    auto options = UTF8PROC_CASEFOLD | UTF8PROC_COMPOSE | UTF8PROC_NULLTERM | UTF8PROC_STABLE;
+    if (stripAccents)
+    {
+        options |= UTF8PROC_STRIPMARK;
+    }
+
+    auto d = reinterpret_cast<const utf8proc_uint8_t*>(str);
+    while (*d)
+    {
+        utf8proc_int32_t c;
+        auto nn = utf8proc_iterate(d, -1, &c);
+        if (nn <= 0)
+        {
+            // Malformed UTF-8 sequence, keep the byte as it is
+            result.push_back(static_cast<char>(*d++));
+            continue;
+        }
+        d += nn;
+
+        std::array<utf8proc_int32_t, 8> folded;
+        auto count = utf8proc_decompose_char(c,
+                                             folded.data(),
+                                             static_cast<utf8proc_ssize_t>(folded.size()),
+                                             static_cast<utf8proc_option_t>(options),
+                                             nullptr);
+        if (count < 0 || count > static_cast<utf8proc_ssize_t>(folded.size()))
+        {
+            folded[0] = u_foldCase(c, U_FOLD_CASE_DEFAULT);
+            count = 1;
+        }
+
+        for (utf8proc_ssize_t i = 0; i < count; ++i)
+        {
+            char buff[8];
+            auto charLen = utf8proc_encode_char(folded[static_cast<size_t>(i)],
+                                                reinterpret_cast<utf8proc_uint8_t*>(buff));
+            result.append(buff, static_cast<size_t>(charLen));
+        }
+    }
+
+    return result;
+}
+
 // This code has been taken from sqlite repository (https://www.sqlite.org/src/file?name=ext/icu/icu.c)
 
 /*
@@ -2114,7 +2114,7 @@ ScanResult WinFileSystemAccess::directoryScan(const LocalPath& path,
                                               map<LocalPath, FSNode>& known,
                                               std::vector<FSNode>& results,
                                               [[maybe_unused]] bool followSymLinks,
-                                              unsigned& nFingerprinted)
+                                              std::vector<PendingFingerprint>& pendingFingerprints)
 {
     assert(path.isAbsolute());
     assert(!followSymLinks && "Symlinks are not supported on Windows!");
@@ -2261,19 +2261,24 @@ ScanResult WinFileSystemAccess::directoryScan(const LocalPath& path,
                     }
                     else
                     {
+                        // Leave the fingerprint to our caller, so files can be read in parallel.
                         LocalPath p = path;
                         p.appendWithSeparator(result.localname, false);
-                        auto fa = newfileaccess();
-                        if (fa->fopen(p, true, false, FSLogging::logOnError))
-                        {
-                            result.fingerprint.genfingerprint(fa.get());
-                            nFingerprinted += 1;
-                        }
-                        else
-                        {
-                            // The file may be opened exclusively by another process
-                            // In this case, the fingerprint (the crc portion) is invalid (for now)
-                        }
+                        pendingFingerprints.push_back(
+                            {results.size(),
+                             [this, p](FSNode& node)
+                             {
+                                 auto fa = newfileaccess();
+                                 if (!fa->fopen(p, true, false, FSLogging::logOnError))
+                                 {
+                                     // The file may be opened exclusively by another process
+                                     // In this case, the fingerprint (the crc portion) is invalid (for now)
+                                     return false;
+                                 }
+
+                                 node.fingerprint.genfingerprint(fa.get());
+                                 return true;
+                             }});
                     }
                 }
 
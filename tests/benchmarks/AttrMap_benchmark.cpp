@@ -0,0 +1,105 @@
+/**
+ * @file AttrMap_benchmark.cpp
+ * @brief Benchmarks of the (un)serialization of node attributes
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <benchmark/benchmark.h>
+#include <mega/attrmap.h>
+
+#include <string>
+
+using namespace mega;
+
+namespace
+{
+
+// Attributes of a typical file node
+AttrMap fileAttributes()
+{
+    AttrMap attrs;
+    attrs.map[AttrMap::string2nameid("n")] = "Presentaci\xC3\xB3n \"final\" 2024.pptx";
+    attrs.map[AttrMap::string2nameid("c")] = "kb2Qq8J7HR9pMJLsWRfWJgS7dI-cZnrp";
+    attrs.map[AttrMap::string2nameid("t")] = "work,slides,2024";
+    attrs.map[AttrMap::string2nameid("fav")] = "1";
+    attrs.map[AttrMap::string2nameid("lbl")] = "2";
+    attrs.map[AttrMap::string2nameid("d")] = "Last version sent to the customer";
+    return attrs;
+}
+
+// Binary format of the attributes stored in the local cache
+void BM_AttrMap_serialize(benchmark::State& state)
+{
+    const auto attrs = fileAttributes();
+    std::string serialized;
+
+    for (auto _: state)
+    {
+        serialized.clear();
+        attrs.serialize(&serialized);
+        benchmark::DoNotOptimize(serialized);
+    }
+}
+
+BENCHMARK(BM_AttrMap_serialize);
+
+void BM_AttrMap_unserialize(benchmark::State& state)
+{
+    std::string serialized;
+    fileAttributes().serialize(&serialized);
+    const char* end = serialized.data() + serialized.size();
+
+    for (auto _: state)
+    {
+        AttrMap attrs;
+        benchmark::DoNotOptimize(attrs.unserialize(serialized.data(), end));
+    }
+}
+
+BENCHMARK(BM_AttrMap_unserialize);
+
+// JSON format of the attributes exchanged with the servers
+void BM_AttrMap_getjson(benchmark::State& state)
+{
+    const auto attrs = fileAttributes();
+    std::string json;
+
+    for (auto _: state)
+    {
+        attrs.getjson(&json);
+        benchmark::DoNotOptimize(json);
+    }
+}
+
+BENCHMARK(BM_AttrMap_getjson);
+
+void BM_AttrMap_fromjson(benchmark::State& state)
+{
+    const auto json = fileAttributes().getjson();
+
+    for (auto _: state)
+    {
+        AttrMap attrs;
+        attrs.fromjson(json.c_str());
+        benchmark::DoNotOptimize(attrs.map);
+    }
+}
+
+BENCHMARK(BM_AttrMap_fromjson);
+
+} // namespace
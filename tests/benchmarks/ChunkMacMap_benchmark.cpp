@@ -0,0 +1,216 @@
+/**
+ * @file ChunkMacMap_benchmark.cpp
+ * @brief Benchmarks of the chunk MACs kept for transfers of large files
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "benchmark_utils.h"
+
+#include <benchmark/benchmark.h>
+#include <mega/utils.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace mega;
+
+namespace
+{
+
+// Same layout as chunkmac_map::ChunkMAC, which is serialized as raw bytes
+struct RawChunkMAC
+{
+    byte mac[SymmCipher::BLOCKSIZE];
+    unsigned int offset;
+    bool finished;
+};
+
+// Finished chunk MACs of a file of state.range(0) GB, serialized in batches as the count of
+// serialized entries is 16 bits.
+class ChunkMacMapFixture: public benchmark::Fixture
+{
+public:
+    void SetUp(benchmark::State& state) override
+    {
+        mFileSize = static_cast<m_off_t>(state.range(0)) << 30;
+
+        const auto key = mt::randomBytes(SymmCipher::KEYLENGTH);
+        mCipher.setkey(key.data());
+
+        std::vector<std::pair<m_off_t, RawChunkMAC>> entries;
+        for (m_off_t pos = 0; pos < mFileSize; pos = ChunkedHash::chunkceil(pos))
+        {
+            entries.emplace_back(pos, RawChunkMAC{});
+            entries.back().second.finished = true;
+        }
+
+        const auto macs = mt::randomBytes(entries.size() * SymmCipher::BLOCKSIZE);
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            std::copy_n(macs.begin() + static_cast<ptrdiff_t>(i * SymmCipher::BLOCKSIZE),
+                        SymmCipher::BLOCKSIZE,
+                        entries[i].second.mac);
+        }
+
+        for (size_t i = 0; i < entries.size(); i += 0xFFFF)
+        {
+            const auto count =
+                static_cast<unsigned short>(std::min<size_t>(0xFFFF, entries.size() - i));
+            std::string batch(reinterpret_cast<const char*>(&count), sizeof(count));
+
+            for (size_t j = i; j < i + count; ++j)
+            {
+                batch.append(reinterpret_cast<const char*>(&entries[j].first),
+                             sizeof(entries[j].first));
+                batch.append(reinterpret_cast<const char*>(&entries[j].second),
+                             sizeof(entries[j].second));
+            }
+
+            mBatches.push_back(std::move(batch));
+        }
+
+        mNumChunks = entries.size();
+        state.counters["chunks"] = static_cast<double>(mNumChunks);
+    }
+
+    void TearDown(benchmark::State&) override
+    {
+        mBatches.clear();
+    }
+
+protected:
+    m_off_t mFileSize = 0;
+    size_t mNumChunks = 0;
+    SymmCipher mCipher;
+    std::vector<std::string> mBatches;
+
+    bool load(chunkmac_map& macs) const
+    {
+        for (const auto& batch: mBatches)
+        {
+            const char* ptr = batch.data();
+            if (!macs.unserialize(ptr, batch.data() + batch.size()))
+            {
+                return false;
+            }
+        }
+
+        return macs.size() == mNumChunks;
+    }
+};
+
+BENCHMARK_DEFINE_F(ChunkMacMapFixture, unserialize)(benchmark::State& state)
+{
+    for (auto _: state)
+    {
+        chunkmac_map macs;
+        if (!load(macs))
+        {
+            state.SkipWithError("Unable to load the chunk MACs");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(mNumChunks));
+}
+
+BENCHMARK_REGISTER_F(ChunkMacMapFixture, unserialize)
+    ->ArgName("GB")
+    ->Arg(1)
+    ->Arg(100)
+    ->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(ChunkMacMapFixture, serialize)(benchmark::State& state)
+{
+    chunkmac_map macs;
+    if (!load(macs))
+    {
+        state.SkipWithError("Unable to load the chunk MACs");
+    }
+
+    for (auto _: state)
+    {
+        std::string data;
+        macs.serialize(data);
+        benchmark::DoNotOptimize(data.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(mNumChunks));
+}
+
+BENCHMARK_REGISTER_F(ChunkMacMapFixture, serialize)
+    ->ArgName("GB")
+    ->Arg(1)
+    ->Arg(100)
+    ->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(ChunkMacMapFixture, macsmac)(benchmark::State& state)
+{
+    chunkmac_map macs;
+    if (!load(macs))
+    {
+        state.SkipWithError("Unable to load the chunk MACs");
+    }
+
+    for (auto _: state)
+    {
+        benchmark::DoNotOptimize(macs.macsmac(&mCipher));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(mNumChunks));
+}
+
+BENCHMARK_REGISTER_F(ChunkMacMapFixture, macsmac)
+    ->ArgName("GB")
+    ->Arg(1)
+    ->Arg(100)
+    ->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+
+// Collapses the leading entries of a completed file into their macsmac so far
+BENCHMARK_DEFINE_F(ChunkMacMapFixture, collapse)(benchmark::State& state)
+{
+    for (auto _: state)
+    {
+        state.PauseTiming();
+        chunkmac_map macs;
+        if (!load(macs))
+        {
+            state.SkipWithError("Unable to load the chunk MACs");
+            break;
+        }
+        state.ResumeTiming();
+
+        macs.setProgressContiguous(mFileSize);
+        macs.updateMacsmacProgress(&mCipher);
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(mNumChunks));
+}
+
+BENCHMARK_REGISTER_F(ChunkMacMapFixture, collapse)
+    ->ArgName("GB")
+    ->Arg(1)
+    ->Arg(100)
+    ->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,104 @@
+/**
+ * @file Crypto_benchmark.cpp
+ * @brief Benchmarks of the CTR encryption of file data and of the chunk MACs computation
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "benchmark_utils.h"
+
+#include <benchmark/benchmark.h>
+#include <mega/crypto/cryptopp.h>
+#include <mega/utils.h>
+
+using namespace mega;
+
+namespace
+{
+
+void setKey(SymmCipher& cipher)
+{
+    const auto key = mt::randomBytes(SymmCipher::KEYLENGTH);
+    cipher.setkey(key.data());
+}
+
+// Encrypts or decrypts (state.range(1) != 0) a buffer of state.range(0) bytes
+void BM_SymmCipher_ctr_crypt(benchmark::State& state)
+{
+    SymmCipher cipher;
+    setKey(cipher);
+
+    auto data = mt::randomBytes(static_cast<size_t>(state.range(0)));
+    const bool encrypt = state.range(1) != 0;
+    byte mac[SymmCipher::BLOCKSIZE];
+
+    for (auto _: state)
+    {
+        cipher.ctr_crypt(data.data(),
+                         static_cast<unsigned>(data.size()),
+                         0,
+                         0x0102030405060708,
+                         mac,
+                         encrypt);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SymmCipher_ctr_crypt)
+    ->ArgNames({"bytes", "encrypt"})
+    ->Args({128 * 1024, 1})
+    ->Args({128 * 1024, 0})
+    ->Args({1024 * 1024, 1})
+    ->Args({1024 * 1024, 0});
+
+// Computes the chunk MACs of a file of state.range(0) bytes, as uploads do
+void BM_chunkmac_map_ctr_encrypt(benchmark::State& state)
+{
+    SymmCipher cipher;
+    setKey(cipher);
+
+    const auto size = static_cast<m_off_t>(state.range(0));
+    auto data = mt::randomBytes(static_cast<size_t>(size));
+
+    for (auto _: state)
+    {
+        chunkmac_map macs;
+
+        for (m_off_t pos = 0; pos < size;)
+        {
+            const m_off_t end = ChunkedHash::chunkceil(pos, size);
+            macs.ctr_encrypt(pos,
+                             &cipher,
+                             data.data() + pos,
+                             static_cast<unsigned>(end - pos),
+                             pos,
+                             0x0102030405060708,
+                             true);
+            pos = end;
+        }
+
+        benchmark::DoNotOptimize(macs.macsmac(&cipher));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_chunkmac_map_ctr_encrypt)->Arg(1024 * 1024)->Arg(64 * 1024 * 1024);
+
+} // namespace
@@ -0,0 +1,73 @@
+/**
+ * @file FileFingerprint_benchmark.cpp
+ * @brief Benchmarks of the fingerprinting of local files
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "benchmark_utils.h"
+
+#include <benchmark/benchmark.h>
+#include <mega.h>
+#include <mega/filefingerprint.h>
+
+#include <fstream>
+
+using namespace mega;
+
+namespace
+{
+
+// Fingerprints a file of state.range(0) bytes. The file is in the page cache after the first
+// iteration, so this measures the CRC computation and the I/O calls, not the disk.
+void BM_FileFingerprint_genfingerprint(benchmark::State& state)
+{
+    mt::TemporaryDirectory directory;
+    const auto filePath = directory.path() / "file";
+    {
+        const auto content = mt::randomBytes(static_cast<size_t>(state.range(0)));
+        std::ofstream file(filePath, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(content.data()),
+                   static_cast<std::streamsize>(content.size()));
+    }
+
+    FSACCESS_CLASS fsAccess;
+    const auto path = LocalPath::fromAbsolutePath(filePath.string());
+
+    for (auto _: state)
+    {
+        auto fileAccess = fsAccess.newfileaccess();
+        FileFingerprint fingerprint;
+        if (!fileAccess->fopen(path, FSLogging::logOnError) ||
+            !fingerprint.genfingerprint(fileAccess.get()))
+        {
+            state.SkipWithError("Unable to fingerprint the file");
+            break;
+        }
+        benchmark::DoNotOptimize(fingerprint.crc);
+    }
+
+    // Big files are sampled, not read completely, so their throughput in bytes is meaningless.
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_FileFingerprint_genfingerprint)
+    ->Arg(16 * 1024)
+    ->Arg(1024 * 1024)
+    ->Arg(64 * 1024 * 1024);
+
+} // namespace
@@ -0,0 +1,169 @@
+/**
+ * @file JSON_benchmark.cpp
+ * @brief Benchmarks of JSON parsing, as a whole buffer and streamed with JSONSplitter
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "benchmark_utils.h"
+
+#include <benchmark/benchmark.h>
+#include <mega/base64.h>
+#include <mega/json.h>
+#include <mega/megaclient.h>
+
+#include <map>
+#include <string>
+
+using namespace mega;
+
+namespace
+{
+
+std::string randomBase64(size_t numBytes, unsigned seed)
+{
+    const auto bytes = mt::randomBytes(numBytes, seed);
+    return Base64::btoa(std::string(bytes.begin(), bytes.end()));
+}
+
+// Response to a fetchnodes command with 'numNodes' nodes, as sent by the servers
+std::string fetchnodesResponse(size_t numNodes)
+{
+    const std::string owner = randomBase64(MegaClient::USERHANDLE, 0);
+
+    std::string json = "{\"f\":[";
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        if (i)
+        {
+            json += ',';
+        }
+
+        json += "{\"h\":\"" + randomBase64(MegaClient::NODEHANDLE, i + 1) + "\",\"p\":\"" +
+                randomBase64(MegaClient::NODEHANDLE, i / 100 + 1) + "\",\"u\":\"" + owner +
+                "\",\"t\":0,\"a\":\"" + randomBase64(64, i) + "\",\"k\":\"" + owner + ":" +
+                randomBase64(FILENODEKEYLENGTH, i) + "\",\"s\":" + std::to_string(i * 1000) +
+                ",\"ts\":1700000000}";
+    }
+    json += "]}";
+
+    return json;
+}
+
+// Reads the fields of a node object, as MegaClient::readnode does
+bool readNode(JSON& json, std::string& buffer)
+{
+    for (;;)
+    {
+        switch (json.getnameid())
+        {
+            case 'h':
+            case 'p':
+                benchmark::DoNotOptimize(json.gethandle());
+                break;
+
+            case 'u':
+                benchmark::DoNotOptimize(json.gethandle(MegaClient::USERHANDLE));
+                break;
+
+            case 't':
+            case 's':
+            case MAKENAMEID2('t', 's'):
+                benchmark::DoNotOptimize(json.getint());
+                break;
+
+            case EOO:
+                return true;
+
+            default:
+                if (!json.storeobject(&buffer))
+                {
+                    return false;
+                }
+        }
+    }
+}
+
+void BM_JSON_parse(benchmark::State& state)
+{
+    const auto response = fetchnodesResponse(static_cast<size_t>(state.range(0)));
+    std::string buffer;
+
+    for (auto _: state)
+    {
+        JSON json;
+        json.begin(response.c_str());
+        json.enterobject();
+        json.getnameid();
+        json.enterarray();
+        while (json.enterobject())
+        {
+            readNode(json, buffer);
+            json.leaveobject();
+        }
+        json.leavearray();
+        json.leaveobject();
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(response.size()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_JSON_parse)->Arg(1000)->Arg(100000);
+
+// Feeds the response in chunks of state.range(1) bytes, as received from the network
+void BM_JSONSplitter_processChunk(benchmark::State& state)
+{
+    const auto response = fetchnodesResponse(static_cast<size_t>(state.range(0)));
+    const auto chunkSize = static_cast<size_t>(state.range(1));
+    std::string buffer;
+
+    std::map<std::string, JSONSplitter::FilterCallback> filters;
+    filters["{[f{"] = [&buffer](JSON* json)
+    {
+        json->enterobject();
+        return JSONSplitter::ResultFromBool(readNode(*json, buffer) && json->leaveobject());
+    };
+
+    for (auto _: state)
+    {
+        JSONSplitter splitter;
+        std::string received;
+
+        for (size_t pos = 0; pos < response.size() && !splitter.hasFailed(); pos += chunkSize)
+        {
+            received.append(response, pos, chunkSize);
+            const auto consumed = splitter.processChunk(&filters, received.c_str());
+            received.erase(0, static_cast<size_t>(consumed));
+        }
+
+        if (!splitter.hasFinished())
+        {
+            state.SkipWithError("The response wasn't completely processed");
+            break;
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(response.size()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_JSONSplitter_processChunk)
+    ->Args({100000, 16 * 1024})
+    ->Args({100000, 1024 * 1024});
+
+} // namespace
@@ -0,0 +1,88 @@
+/**
+ * @file LocalNode_benchmark.cpp
+ * @brief Benchmarks of the memory layout of the sync's LocalNode tree
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <benchmark/benchmark.h>
+#include <mega.h>
+
+#include <string>
+#include <vector>
+
+#ifdef ENABLE_SYNC
+
+using namespace mega;
+
+namespace
+{
+
+// Folders in the synthetic tree have this many children, the rest of the nodes are files.
+constexpr size_t FANOUT = 16;
+
+// Builds the child maps of a synthetic tree of state.range(0) nodes, as LocalNodes keep them,
+// and reports the fixed size of a LocalNode. LocalNodes themselves need a running sync, so only
+// the child maps are built: they are what differs between files and folders.
+void BM_LocalNode_childMaps(benchmark::State& state)
+{
+    const auto numNodes = static_cast<size_t>(state.range(0));
+
+    std::vector<LocalPath> names;
+    names.reserve(numNodes);
+
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+        names.emplace_back(LocalPath::fromRelativePath("node " + std::to_string(i)));
+    }
+
+    size_t numFolders = 0;
+
+    for (auto _: state)
+    {
+        std::vector<LocalNodeChildMap> children(numNodes);
+
+        // Node 0 is the sync root, the parent of node i is node (i - 1) / FANOUT.
+        for (size_t i = 1; i < numNodes; ++i)
+        {
+            children[(i - 1) / FANOUT][names[i]] = nullptr;
+        }
+
+        numFolders = 0;
+
+        for (const auto& folder: children)
+        {
+            numFolders += !folder.empty();
+        }
+
+        benchmark::DoNotOptimize(children.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["LocalNodeBytes"] = static_cast<double>(sizeof(LocalNode));
+    state.counters["Folders"] = static_cast<double>(numFolders);
+}
+
+BENCHMARK(BM_LocalNode_childMaps)
+    ->Arg(100000)
+    ->Arg(5000000)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+} // namespace
+
+#endif // ENABLE_SYNC
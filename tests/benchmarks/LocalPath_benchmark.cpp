@@ -0,0 +1,111 @@
+/**
+ * @file LocalPath_benchmark.cpp
+ * @brief Benchmarks of the normalization and conversion of local paths
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <benchmark/benchmark.h>
+#include <mega.h>
+#include <mega/localpath.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace mega;
+
+namespace
+{
+
+// Names as found in a synced folder: plain ASCII, precomposed and decomposed accents, CJK and
+// characters that must be escaped on some filesystems.
+const std::vector<std::string>& names()
+{
+    static const std::vector<std::string> names{
+        "document.pdf",
+        "Presentaci\xC3\xB3n final.pptx", // precomposed
+        "Presentacio\xCC\x81n final.pptx", // decomposed
+        "\xE5\x86\x99\xE7\x9C\x9F 2024-01-01.jpg",
+        "report: draft?.docx",
+        "a very long file name that is still perfectly valid for every filesystem.txt",
+    };
+    return names;
+}
+
+void BM_LocalPath_utf8_normalize(benchmark::State& state)
+{
+    for (auto _: state)
+    {
+        for (const auto& name: names())
+        {
+            std::string normalized = name;
+            LocalPath::utf8_normalize(&normalized);
+            benchmark::DoNotOptimize(normalized);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(names().size()));
+}
+
+BENCHMARK(BM_LocalPath_utf8_normalize);
+
+// Cloud names to local paths, escaping the characters forbidden in the filesystem
+void BM_LocalPath_fromRelativeName(benchmark::State& state)
+{
+    FSACCESS_CLASS fsAccess;
+    const auto fsType = static_cast<FileSystemType>(state.range(0));
+
+    for (auto _: state)
+    {
+        for (const auto& name: names())
+        {
+            benchmark::DoNotOptimize(LocalPath::fromRelativeName(name, fsAccess, fsType));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(names().size()));
+}
+
+BENCHMARK(BM_LocalPath_fromRelativeName)->Arg(FS_EXT)->Arg(FS_NTFS);
+
+// Local paths back to normalized UTF-8, as done when comparing them with cloud names
+void BM_LocalPath_toPath(benchmark::State& state)
+{
+    std::vector<LocalPath> paths;
+    auto parent = LocalPath::fromAbsolutePath(std::filesystem::temp_directory_path().string());
+    parent.appendWithSeparator(LocalPath::fromRelativePath("Camera Uploads"), true);
+    for (const auto& name: names())
+    {
+        paths.push_back(parent);
+        paths.back().appendWithSeparator(LocalPath::fromRelativePath(name), true);
+    }
+
+    for (auto _: state)
+    {
+        for (const auto& path: paths)
+        {
+            benchmark::DoNotOptimize(path.toPath(true));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(paths.size()));
+}
+
+BENCHMARK(BM_LocalPath_toPath);
+
+} // namespace
@@ -0,0 +1,132 @@
+/**
+ * @file NodeHandleMap_benchmark.cpp
+ * @brief Benchmarks of NodeHandleMap, the handle index of NodeManager::mNodes
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <benchmark/benchmark.h>
+#include <mega/node_handle_map.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace mega;
+
+namespace
+{
+
+// state.range(0) random handles, the same for every run
+std::vector<NodeHandle> randomHandles(const benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+
+    std::mt19937_64 generator(count);
+    std::vector<NodeHandle> handles;
+    handles.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        handles.push_back(NodeHandle().set6byte(generator() & 0xFFFFFFFFFFFF));
+    }
+
+    return handles;
+}
+
+// Lookups in a different order than the insertions
+std::vector<NodeHandle> shuffled(std::vector<NodeHandle> handles)
+{
+    std::shuffle(handles.begin(), handles.end(), std::mt19937_64(handles.size() + 1));
+    return handles;
+}
+
+// The std::map previously used by NodeManager::mNodes, for comparison
+template<class Map>
+void BM_insert(benchmark::State& state)
+{
+    const auto handles = randomHandles(state);
+
+    for (auto _: state)
+    {
+        Map map;
+        for (size_t i = 0; i < handles.size(); ++i)
+        {
+            map.emplace(handles[i], i);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<class Map>
+void BM_find(benchmark::State& state)
+{
+    const auto handles = randomHandles(state);
+    const auto lookups = shuffled(handles);
+
+    Map map;
+    for (size_t i = 0; i < handles.size(); ++i)
+    {
+        map.emplace(handles[i], i);
+    }
+
+    for (auto _: state)
+    {
+        size_t found = 0;
+        for (const auto& handle: lookups)
+        {
+            found += map.find(handle) != map.end();
+        }
+
+        if (found != handles.size())
+        {
+            state.SkipWithError("Some handles weren't found");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_insert, std::map<NodeHandle, size_t>)
+    ->ArgName("nodes")
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_insert, NodeHandleMap<size_t>)
+    ->ArgName("nodes")
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_find, std::map<NodeHandle, size_t>)
+    ->ArgName("nodes")
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_find, NodeHandleMap<size_t>)
+    ->ArgName("nodes")
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
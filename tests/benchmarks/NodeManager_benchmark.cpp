@@ -0,0 +1,427 @@
+/**
+ * @file NodeManager_benchmark.cpp
+ * @brief Benchmarks of the node look-ups done by NodeManager against the database
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "benchmark_utils.h"
+
+#include <benchmark/benchmark.h>
+#include <mega.h>
+#include <mega/megaapp.h>
+
+#include <atomic>
+#include <future>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mega;
+
+namespace
+{
+
+// Account with a root node, stored in an in-memory SqliteAccountState. Benchmarks add the nodes
+// they need with buildTree() or addNode() before timing anything.
+class NodeManagerFixture: public benchmark::Fixture
+{
+public:
+    void SetUp(benchmark::State& state) override
+    {
+        mClient = mt::makeClientWithInMemoryDb(mApp);
+        if (!mClient)
+        {
+            state.SkipWithError("Unable to open the in-memory database");
+            return;
+        }
+
+        mRoot = addNode(ROOTNODE, nullptr);
+    }
+
+    void TearDown(benchmark::State&) override
+    {
+        mFiles.clear();
+        mFolders.clear();
+        mRoot.reset();
+        mClient.reset();
+    }
+
+protected:
+    MegaApp mApp;
+    NodeManager::MissingParentNodes mMissingParentNodes;
+    uint64_t mIndex = 1;
+    std::shared_ptr<MegaClient> mClient;
+
+    std::shared_ptr<Node> mRoot;
+    std::vector<std::shared_ptr<Node>> mFolders;
+    std::vector<NodeHandle> mFiles;
+
+    // Files get a different size each, so their fingerprints are unique. Nodes added while not
+    // fetching are added as action packets would.
+    std::shared_ptr<Node> addNode(nodetype_t type,
+                                  const std::shared_ptr<Node>& parent,
+                                  const std::string& name = std::string(),
+                                  bool isFetching = true)
+    {
+        const auto handle = NodeHandle().set6byte(mIndex);
+        const auto parentHandle = parent ? parent->nodeHandle() : NodeHandle();
+        const auto size = type == FILENODE ? static_cast<m_off_t>(mIndex) : -1;
+        ++mIndex;
+
+        std::shared_ptr<Node> node(
+            new Node{*mClient, handle, parentHandle, type, size, UNDEF, nullptr, 0});
+
+        if (type == FILENODE || type == FOLDERNODE)
+        {
+            node->setkey(reinterpret_cast<const byte*>(
+                std::string(type == FILENODE ? FILENODEKEYLENGTH : FOLDERNODEKEYLENGTH, 'X')
+                    .c_str()));
+        }
+
+        if (type == FILENODE)
+        {
+            node->mtime = 1700000000;
+            node->isvalid = true;
+        }
+
+        if (!name.empty())
+        {
+            node->attrs.map[AttrMap::string2nameid("n")] = name;
+        }
+
+        mClient->mNodeManager.addNode(node, false, isFetching, mMissingParentNodes);
+        mClient->mNodeManager.saveNodeInDb(node.get());
+        return node;
+    }
+
+    // numFolders folders below the root, of filesPerFolder files each
+    void buildTree(int64_t numFolders, int64_t filesPerFolder)
+    {
+        if (!mClient)
+        {
+            return;
+        }
+
+        for (int64_t i = 0; i < numFolders; ++i)
+        {
+            mFolders.push_back(addNode(FOLDERNODE, mRoot));
+            for (int64_t j = 0; j < filesPerFolder; ++j)
+            {
+                mFiles.push_back(addNode(FILENODE, mFolders.back())->nodeHandle());
+            }
+        }
+    }
+
+    // depth nested folders below the root, of filesPerFolder files each
+    void buildDeepTree(int64_t depth, int64_t filesPerFolder)
+    {
+        if (!mClient)
+        {
+            return;
+        }
+
+        auto parent = mRoot;
+        for (int64_t i = 0; i < depth; ++i)
+        {
+            mFolders.push_back(parent = addNode(FOLDERNODE, parent));
+            for (int64_t j = 0; j < filesPerFolder; ++j)
+            {
+                mFiles.push_back(addNode(FILENODE, parent)->nodeHandle());
+            }
+        }
+    }
+
+    DBTableNodes& table()
+    {
+        auto table = dynamic_cast<DBTableNodes*>(mClient->sctable.get());
+        assert(table);
+        return *table;
+    }
+};
+
+BENCHMARK_DEFINE_F(NodeManagerFixture, getNodeByHandle)(benchmark::State& state)
+{
+    buildTree(state.range(0), state.range(1));
+
+    std::mt19937 generator(1);
+
+    for (auto _: state)
+    {
+        const auto& handle = mFiles[generator() % mFiles.size()];
+        benchmark::DoNotOptimize(mClient->mNodeManager.getNodeByHandle(handle));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(NodeManagerFixture, getNodeByHandle)->Args({100, 100})->Args({1000, 100});
+
+BENCHMARK_DEFINE_F(NodeManagerFixture, getChildren)(benchmark::State& state)
+{
+    buildTree(state.range(0), state.range(1));
+
+    std::mt19937 generator(1);
+
+    for (auto _: state)
+    {
+        const auto& folder = mFolders[generator() % mFolders.size()];
+        benchmark::DoNotOptimize(mClient->mNodeManager.getChildren(folder.get()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+BENCHMARK_REGISTER_F(NodeManagerFixture, getChildren)->Args({100, 100})->Args({1000, 100});
+
+// Nodes in RAM are checked first, the database is queried for the rest
+BENCHMARK_DEFINE_F(NodeManagerFixture, getNodesByFingerprint)(benchmark::State& state)
+{
+    buildTree(state.range(0), state.range(1));
+
+    std::mt19937 generator(1);
+
+    for (auto _: state)
+    {
+        const auto node = mClient->mNodeManager.getNodeByHandle(
+            mFiles[generator() % mFiles.size()]);
+        benchmark::DoNotOptimize(mClient->mNodeManager.getNodesByFingerprint(*node));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(NodeManagerFixture, getNodesByFingerprint)
+    ->Args({100, 100})
+    ->Args({1000, 100});
+
+// Every tenth folder is marked sensitive, and the search has to leave out the whole subtree of each
+BENCHMARK_DEFINE_F(NodeManagerFixture, searchNodesExcludingSensitive)(benchmark::State& state)
+{
+    buildTree(state.range(0), state.range(1));
+
+    for (size_t i = 0; i < mFolders.size(); i += 10)
+    {
+        mFolders[i]->attrs.map[AttrMap::string2nameid("sen")] = "1";
+        mClient->mNodeManager.saveNodeInDb(mFolders[i].get());
+    }
+
+    NodeSearchFilter filter;
+    filter.byAncestors({mRoot->nodehandle, UNDEF, UNDEF});
+    filter.bySensitivity(NodeSearchFilter::BoolFilter::onlyTrue);
+
+    for (auto _: state)
+    {
+        benchmark::DoNotOptimize(
+            mClient->mNodeManager.searchNodes(filter, 0, CancelToken(), NodeSearchPage{0, 0}));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(mFiles.size()));
+}
+
+BENCHMARK_REGISTER_F(NodeManagerFixture, searchNodesExcludingSensitive)
+    ->Args({100, 100})
+    ->Args({1000, 100})
+    ->Unit(benchmark::kMillisecond);
+
+// Lookups of random files and listings of random folders by state.range(2) threads at once, while
+// another thread adds files to random folders as action packets would
+BENCHMARK_DEFINE_F(NodeManagerFixture, readWhileWriting)(benchmark::State& state)
+{
+    constexpr int64_t readsPerThread = 1000;
+
+    buildTree(state.range(0), state.range(1));
+
+    const auto numReaders = static_cast<unsigned>(state.range(2));
+    const auto filesPerFolder = static_cast<size_t>(state.range(1));
+
+    auto read = [this, filesPerFolder](unsigned seed)
+    {
+        std::mt19937 generator(seed);
+
+        for (int64_t i = 0; i < readsPerThread; ++i)
+        {
+            const auto& handle = mFiles[generator() % mFiles.size()];
+            auto node = mClient->mNodeManager.getNodeByHandle(handle);
+            if (!node || node->nodeHandle() != handle)
+            {
+                return false;
+            }
+
+            const auto& folder = mFolders[generator() % mFolders.size()];
+            if (mClient->mNodeManager.getChildren(folder.get()).size() < filesPerFolder)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    std::mt19937 writerGenerator(1);
+
+    for (auto _: state)
+    {
+        std::atomic<bool> stop{false};
+
+        auto writer = std::async(std::launch::async,
+                                 [this, &stop, &writerGenerator]()
+                                 {
+                                     while (!stop)
+                                     {
+                                         const auto& folder =
+                                             mFolders[writerGenerator() % mFolders.size()];
+                                         addNode(FILENODE, folder, std::string(), false);
+                                     }
+                                 });
+
+        std::vector<std::future<bool>> readers;
+        for (unsigned i = 0; i < numReaders; ++i)
+        {
+            readers.emplace_back(std::async(std::launch::async, read, i));
+        }
+
+        bool consistent = true;
+        for (auto& reader: readers)
+        {
+            consistent &= reader.get();
+        }
+
+        stop = true;
+        writer.get();
+
+        if (!consistent)
+        {
+            state.SkipWithError("A reader got an inconsistent result");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(2) * readsPerThread * 2);
+}
+
+BENCHMARK_REGISTER_F(NodeManagerFixture, readWhileWriting)
+    ->ArgNames({"folders", "files", "readers"})
+    ->Args({200, 100, 1})
+    ->Args({200, 100, 2})
+    ->Args({200, 100, 4})
+    ->Args({200, 100, 8})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Searches all the nodes below the top folder of a tree state.range(0) folders deep
+BENCHMARK_DEFINE_F(NodeManagerFixture, searchNodesBelowDeepTree)(benchmark::State& state)
+{
+    buildDeepTree(state.range(0), state.range(1));
+
+    NodeSearchFilter filter;
+    if (!mFolders.empty())
+    {
+        filter.byAncestors({mFolders.front()->nodehandle, UNDEF, UNDEF});
+    }
+
+    for (auto _: state)
+    {
+        benchmark::DoNotOptimize(
+            mClient->mNodeManager.searchNodes(filter, 0, CancelToken(), NodeSearchPage{0, 0}));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(mFiles.size()));
+}
+
+BENCHMARK_REGISTER_F(NodeManagerFixture, searchNodesBelowDeepTree)
+    ->ArgNames({"depth", "files"})
+    ->Args({100, 500})
+    ->Unit(benchmark::kMillisecond);
+
+// Whether the deepest file of a tree state.range(0) folders deep is below the root
+BENCHMARK_DEFINE_F(NodeManagerFixture, isAncestorOnDeepTree)(benchmark::State& state)
+{
+    buildDeepTree(state.range(0), state.range(1));
+
+    for (auto _: state)
+    {
+        if (!table().isAncestor(mFiles.back(), mRoot->nodeHandle(), CancelToken()))
+        {
+            state.SkipWithError("The root isn't an ancestor of the file");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(NodeManagerFixture, isAncestorOnDeepTree)
+    ->ArgNames({"depth", "files"})
+    ->Args({100, 500});
+
+// Searches by name below the root, with the full-text index if state.range(2), otherwise with the
+// recursive query. "needle" is the name of one file per folder, "file 1" a prefix of many names.
+BENCHMARK_DEFINE_F(NodeManagerFixture, searchNodesByName)(benchmark::State& state)
+{
+    if (mClient)
+    {
+        for (int64_t i = 0; i < state.range(0); ++i)
+        {
+            auto folder = addNode(FOLDERNODE, mRoot, "folder" + std::to_string(i));
+
+            for (int64_t j = 0; j < state.range(1); ++j)
+            {
+                addNode(FILENODE,
+                        folder,
+                        (j == i ? "needle " : "file ") + std::to_string(j) + ".jpg");
+            }
+        }
+
+        // The index is a search index: it's created and dropped along with the search DB
+        // indexes, which use their own transactions.
+        mClient->sctable->commit();
+
+        if (state.range(2))
+        {
+            table().createIndexes(true);
+        }
+        else
+        {
+            table().dropSearchDBIndexes();
+        }
+
+        mClient->sctable->begin();
+    }
+
+    NodeSearchFilter filter;
+    filter.byAncestors({mRoot ? mRoot->nodehandle : UNDEF, UNDEF, UNDEF});
+    filter.byName(state.range(3) ? "file 1" : "needle");
+
+    for (auto _: state)
+    {
+        benchmark::DoNotOptimize(
+            mClient->mNodeManager.searchNodes(filter, 0, CancelToken(), NodeSearchPage{0, 0}));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(NodeManagerFixture, searchNodesByName)
+    ->ArgNames({"folders", "files", "index", "common"})
+    ->Args({100, 1000, 1, 0})
+    ->Args({100, 1000, 0, 0})
+    ->Args({100, 1000, 1, 1})
+    ->Args({100, 1000, 0, 1})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,217 @@
+/**
+ * @file RaidBufferManager_benchmark.cpp
+ * @brief Benchmarks of the combination of the parts of cloudraid downloads
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "benchmark_utils.h"
+
+#include <benchmark/benchmark.h>
+#include <mega/raid_kernels.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace mega;
+
+namespace
+{
+
+// Splits a file in its parity and data parts, as stored by the servers
+std::vector<std::vector<byte>> splitInParts(const std::vector<byte>& file)
+{
+    const size_t numLines = (file.size() + RAIDLINE - 1) / RAIDLINE;
+    std::vector<std::vector<byte>> parts(RAIDPARTS, std::vector<byte>(numLines * RAIDSECTOR));
+
+    for (size_t i = 0; i < file.size(); ++i)
+    {
+        const size_t line = i / RAIDLINE;
+        const size_t part = 1 + (i % RAIDLINE) / RAIDSECTOR;
+        const size_t offset = line * RAIDSECTOR + i % RAIDSECTOR;
+
+        parts[part][offset] = file[i];
+        parts[0][offset] = static_cast<byte>(parts[0][offset] ^ file[i]);
+    }
+
+    return parts;
+}
+
+class BenchmarkRaidBufferManager: public RaidBufferManager
+{
+public:
+    // Downloads 'parts' in requests of 'requestSize' bytes, without connection 'unusedPart'.
+    // Returns the number of bytes of the file that were output.
+    m_off_t download(const std::vector<std::vector<byte>>& parts,
+                     m_off_t fileSize,
+                     unsigned unusedPart,
+                     size_t requestSize)
+    {
+        setIsRaid(std::vector<std::string>(RAIDPARTS, "http://localhost/"),
+                  0,
+                  fileSize,
+                  fileSize,
+                  static_cast<m_off_t>(requestSize) * RAIDPARTS,
+                  false);
+        setUnusedRaidConnection(unusedPart);
+
+        m_off_t output = 0;
+        const size_t partSize = parts[0].size();
+
+        for (size_t pos = 0; pos < partSize; pos += requestSize)
+        {
+            const size_t len = std::min(requestSize, partSize - pos);
+
+            for (unsigned part = 0; part < RAIDPARTS; ++part)
+            {
+                FilePiece* piece = nullptr;
+                if (part == unusedPart)
+                {
+                    piece = new FilePiece(static_cast<m_off_t>(pos),
+                                          new HttpReq::http_buf_t(nullptr, 0, len));
+                }
+                else
+                {
+                    piece = new FilePiece(static_cast<m_off_t>(pos), len);
+                    memcpy(piece->buf.datastart(), parts[part].data() + pos, len);
+                }
+                submitBuffer(part, piece);
+            }
+
+            while (auto piece = getAsyncOutputBufferPointer(0))
+            {
+                output += static_cast<m_off_t>(piece->buf.datalen());
+                bufferWriteCompleted(0, true);
+            }
+        }
+
+        return output;
+    }
+
+private:
+    void finalize(FilePiece&) override {}
+
+    m_off_t calcOutputChunkPos(m_off_t acquiredpos) override
+    {
+        return acquiredpos;
+    }
+};
+
+// Combines a file of 64 MB downloaded in 1 MB requests. The parity part is not used when
+// state.range(0) is 0. Otherwise, that data part is missing and it's rebuilt from parity.
+void BM_RaidBufferManager_combine(benchmark::State& state)
+{
+    constexpr size_t fileSize = 64 * 1024 * 1024;
+    constexpr size_t requestSize = 1024 * 1024;
+
+    const auto parts = splitInParts(mt::randomBytes(fileSize));
+    const auto unusedPart = static_cast<unsigned>(state.range(0));
+
+    for (auto _: state)
+    {
+        BenchmarkRaidBufferManager manager;
+        const auto output =
+            manager.download(parts, static_cast<m_off_t>(fileSize), unusedPart, requestSize);
+        if (output != static_cast<m_off_t>(fileSize))
+        {
+            state.SkipWithError("The file wasn't completely combined");
+            break;
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(fileSize));
+    state.SetLabel(RaidKernels::get().name);
+}
+
+BENCHMARK(BM_RaidBufferManager_combine)->ArgName("unusedPart")->Arg(0)->Arg(3);
+
+// Parts of a file of 64 MB, to run the kernels of RaidKernels::supported()[state.range(0)] on.
+// Implementations this CPU doesn't support are skipped.
+class RaidKernelsFixture: public benchmark::Fixture
+{
+public:
+    void SetUp(benchmark::State& state) override
+    {
+        const auto& supported = RaidKernels::supported();
+        const auto index = static_cast<size_t>(state.range(0));
+
+        if (index >= supported.size())
+        {
+            state.SkipWithError("Not supported by this CPU");
+            return;
+        }
+
+        mKernels = supported[index];
+        mParts = splitInParts(mt::randomBytes(64 * 1024 * 1024));
+
+        for (unsigned n = 0; n < EFFECTIVE_RAIDPARTS; ++n)
+        {
+            mSources[n] = mParts[n].data();
+        }
+
+        mLines.resize(mParts[0].size() * EFFECTIVE_RAIDPARTS);
+        state.SetLabel(mKernels->name);
+    }
+
+    void TearDown(benchmark::State&) override
+    {
+        mParts.clear();
+        mLines.clear();
+    }
+
+protected:
+    const RaidKernels* mKernels = nullptr;
+    std::vector<std::vector<byte>> mParts;
+    const byte* mSources[EFFECTIVE_RAIDPARTS]{};
+    std::vector<byte> mLines;
+};
+
+// Rebuilds a part from the parity and the other data parts
+BENCHMARK_DEFINE_F(RaidKernelsFixture, xorParts)(benchmark::State& state)
+{
+    const size_t partSize = mParts[0].size();
+
+    for (auto _: state)
+    {
+        mKernels->xorParts(mLines.data(), mSources, EFFECTIVE_RAIDPARTS, partSize);
+        benchmark::DoNotOptimize(mLines.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(mLines.size()));
+}
+
+BENCHMARK_REGISTER_F(RaidKernelsFixture, xorParts)->ArgName("kernels")->DenseRange(0, 2);
+
+// Combines the data parts into RAIDLINEs
+BENCHMARK_DEFINE_F(RaidKernelsFixture, interleaveLines)(benchmark::State& state)
+{
+    const size_t numLines = mParts[0].size() / RAIDSECTOR;
+
+    for (auto _: state)
+    {
+        mKernels->interleaveLines(mLines.data(), mSources, numLines);
+        benchmark::DoNotOptimize(mLines.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(mLines.size()));
+}
+
+BENCHMARK_REGISTER_F(RaidKernelsFixture, interleaveLines)->ArgName("kernels")->DenseRange(0, 2);
+
+} // namespace
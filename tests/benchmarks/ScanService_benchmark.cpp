@@ -0,0 +1,109 @@
+/**
+ * @file ScanService_benchmark.cpp
+ * @brief Benchmarks of ScanService, which scans directories and fingerprints their files
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "benchmark_utils.h"
+
+#include <benchmark/benchmark.h>
+#include <mega.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+using namespace mega;
+
+namespace
+{
+
+constexpr size_t NUM_FILES = 5000;
+
+// Directory of NUM_FILES files of up to 100 KB
+class ScanDirectory: public mt::TemporaryDirectory
+{
+public:
+    ScanDirectory()
+    {
+        for (size_t i = 0; i < NUM_FILES; ++i)
+        {
+            std::ofstream file(path() / ("file" + std::to_string(i)), std::ios::binary);
+            file << std::string((i * 7919) % 100000, static_cast<char>('a' + i % 26));
+        }
+    }
+};
+
+// Created once for all the runs
+const std::filesystem::path& directory()
+{
+    static const ScanDirectory directory;
+    return directory.path();
+}
+
+// Scans the directory, fingerprinting all of its files, with state.range(0) threads
+void BM_ScanService_scan(benchmark::State& state)
+{
+    const auto numThreads = static_cast<size_t>(state.range(0));
+    ScanService::setNumThreads(numThreads);
+
+    FSACCESS_CLASS fsAccess;
+    const auto path = LocalPath::fromAbsolutePath(directory().string());
+    const auto fsid = fsAccess.fsidOf(path, false, false, FSLogging::logOnError);
+
+    ScanService service;
+    m_off_t bytesFingerprinted = 0;
+
+    for (auto _: state)
+    {
+        auto request = service.queueScan(path, fsid, false, {}, std::make_shared<WAIT_CLASS>());
+
+        while (!request->completed())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        if (request->completionResult() != SCAN_SUCCESS ||
+            request->stats().numFingerprinted != NUM_FILES)
+        {
+            state.SkipWithError("The scan failed");
+            break;
+        }
+
+        bytesFingerprinted += request->stats().bytesFingerprinted;
+    }
+
+    ScanService::setNumThreads(1);
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(NUM_FILES));
+    state.SetBytesProcessed(bytesFingerprinted);
+}
+
+BENCHMARK(BM_ScanService_scan)
+    ->ArgName("threads")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Arg(16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
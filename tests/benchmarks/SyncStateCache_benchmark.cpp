@@ -0,0 +1,140 @@
+/**
+ * @file SyncStateCache_benchmark.cpp
+ * @brief Benchmarks of loading a sync's LocalNode tree from its state cache
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "benchmark_utils.h"
+
+#include <benchmark/benchmark.h>
+#include <mega.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifdef ENABLE_SYNC
+
+using namespace mega;
+
+namespace
+{
+
+constexpr size_t NUM_ROWS = 1000000;
+
+// Folders in the synthetic tree have this many children, the rest of the nodes are files.
+constexpr uint32_t FANOUT = 16;
+
+// Encrypted rows of a synthetic tree of NUM_ROWS LocalNodes, as Sync::statecacheadd writes them.
+// Row i has dbid i + 1 and its parent is row (i - 1) / FANOUT, or the sync root for row 0.
+const std::vector<std::pair<uint32_t, std::string>>& encryptedRows(SymmCipher& key)
+{
+    static const auto rows = [&key]()
+    {
+        PrnGen rng;
+        std::vector<std::pair<uint32_t, std::string>> rows(NUM_ROWS);
+
+        for (uint32_t i = 0; i < NUM_ROWS; ++i)
+        {
+            SyncStateCacheRow::Core core;
+            core.type = i < NUM_ROWS / FANOUT ? FOLDERNODE : FILENODE;
+            core.localname = LocalPath::fromRelativePath("node " + std::to_string(i));
+            core.fsid_lastSynced = i;
+            core.syncedCloudNodeHandle.set6byte(i);
+
+            if (core.type == FILENODE)
+            {
+                core.syncedFingerprint.size = i;
+                core.syncedFingerprint.mtime = 1700000000 + i;
+                core.syncedFingerprint.isvalid = true;
+            }
+
+            auto& [id, data] = rows[i];
+            id = i + 1;
+            core.write(data, i ? (i - 1) / FANOUT + 1 : 0);
+            PaddedCBC::encrypt(rng, &data, &key);
+        }
+
+        return rows;
+    }();
+
+    return rows;
+}
+
+// Decrypts and unserializes a 1M-row state cache with state.range(0) worker threads, then
+// orders the nodes by parent as Sync::readstatecache does to build the tree.
+void BM_SyncStateCache_decode(benchmark::State& state)
+{
+    SymmCipher key;
+    const auto keyBytes = mt::randomBytes(SymmCipher::KEYLENGTH);
+    key.setkey(keyBytes.data());
+
+    const auto& encrypted = encryptedRows(key);
+
+    WAIT_CLASS waiter;
+    MegaClientAsyncQueue queue(waiter, static_cast<unsigned>(state.range(0)));
+
+    for (auto _: state)
+    {
+        state.PauseTiming();
+        std::vector<SyncStateCacheRow> rows(encrypted.size());
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            rows[i].id = encrypted[i].first;
+            rows[i].data = encrypted[i].second;
+        }
+        state.ResumeTiming();
+
+        decodeSyncStateCacheRows(queue, key, rows);
+
+        std::vector<std::pair<uint32_t, const SyncStateCacheRow*>> nodes;
+        nodes.reserve(rows.size());
+
+        for (const auto& row: rows)
+        {
+            if (row.unserialized)
+            {
+                nodes.emplace_back(row.parentID, &row);
+            }
+        }
+
+        sortStateCacheNodes(nodes);
+
+        if (nodes.size() != rows.size())
+        {
+            state.SkipWithError("Rows failed to decode");
+            break;
+        }
+
+        benchmark::DoNotOptimize(nodes.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(NUM_ROWS));
+}
+
+BENCHMARK(BM_SyncStateCache_decode)
+    ->ArgName("threads")
+    ->Arg(0)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+#endif // ENABLE_SYNC
@@ -0,0 +1,120 @@
+/**
+ * @file benchmark_utils.cpp
+ * @brief Helpers shared by the benchmarks of the SDK hot paths
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "benchmark_utils.h"
+
+#include <mega.h>
+#include <mega/db/sqlite.h>
+#include <mega/megaapp.h>
+
+#include <algorithm>
+#include <random>
+
+namespace mt
+{
+
+std::vector<mega::byte> randomBytes(size_t count, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::vector<mega::byte> bytes(count);
+    std::generate(bytes.begin(),
+                  bytes.end(),
+                  [&generator]()
+                  {
+                      return static_cast<mega::byte>(generator());
+                  });
+    return bytes;
+}
+
+std::shared_ptr<mega::MegaClient> makeClientWithInMemoryDb(mega::MegaApp& app)
+{
+    struct HttpIo: mega::HttpIO
+    {
+        void addevents(mega::Waiter*, int) override {}
+
+        void post(struct mega::HttpReq*, const char* = NULL, unsigned = 0) override {}
+
+        void cancel(mega::HttpReq*) override {}
+
+        m_off_t postpos(void*) override
+        {
+            return {};
+        }
+
+        bool doio(void) override
+        {
+            return {};
+        }
+
+        void setuseragent(std::string*) override {}
+    };
+
+    using namespace mega;
+
+    auto httpio = new HttpIo;
+    auto deleter = [httpio](MegaClient* client)
+    {
+        delete client;
+        delete httpio;
+    };
+
+    // Nothing is written to the root path, the database is kept in memory.
+    auto dbAccess = new SqliteDbAccess(LocalPath::fromAbsolutePath(
+        std::filesystem::temp_directory_path().string()));
+    auto waiter = std::make_shared<WAIT_CLASS>();
+
+    std::shared_ptr<MegaClient> client{
+        new MegaClient{&app, waiter, httpio, dbAccess, nullptr, "mega_benchmarks", 0},
+        deleter};
+
+    client->sctable.reset(dbAccess->openTableWithNodes(client->rng,
+                                                       *client->fsaccess,
+                                                       "benchmarks",
+                                                       DB_OPEN_FLAG_IN_MEMORY,
+                                                       [](DBError) {}));
+    if (!client->sctable)
+    {
+        return nullptr;
+    }
+
+    auto nodeTable = dynamic_cast<DBTableNodes*>(client->sctable.get());
+    assert(nodeTable);
+    client->mNodeManager.setTable(nodeTable);
+    client->sctable->begin();
+
+    return client;
+}
+
+TemporaryDirectory::TemporaryDirectory()
+{
+    std::random_device device;
+    mPath = std::filesystem::temp_directory_path() /
+            ("mega_benchmarks_" + std::to_string(device()));
+    std::filesystem::create_directories(mPath);
+}
+
+TemporaryDirectory::~TemporaryDirectory()
+{
+    std::error_code ignored;
+    std::filesystem::remove_all(mPath, ignored);
+}
+
+} // namespace mt
@@ -0,0 +1,56 @@
+/**
+ * @file benchmark_utils.h
+ * @brief Helpers shared by the benchmarks of the SDK hot paths
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#pragma once
+
+#include <mega/megaclient.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mt
+{
+
+// Deterministic pseudo-random content, so results are comparable between runs
+std::vector<mega::byte> randomBytes(size_t count, unsigned seed = 1);
+
+// Client without network whose node table is an in-memory SqliteAccountState
+std::shared_ptr<mega::MegaClient> makeClientWithInMemoryDb(mega::MegaApp& app);
+
+// Directory removed with all its contents when destroyed
+class TemporaryDirectory
+{
+public:
+    TemporaryDirectory();
+    ~TemporaryDirectory();
+
+    const std::filesystem::path& path() const
+    {
+        return mPath;
+    }
+
+private:
+    std::filesystem::path mPath;
+};
+
+} // namespace mt
@@ -345,6 +345,7 @@ static const FileServiceOptions DisableReadahead = {
     DefaultOptions.mMaximumRangeRetries,
     0u,
     0u,
+    0u,
     DefaultOptions.mRangeRetryBackoff,
     DefaultOptions.mReclaimAgeThreshold,
     DefaultOptions.mReclaimBatchSize,
@@ -1964,6 +1965,80 @@ TEST_F(FileServiceTests, purge_foreign_file_succeeds)
     ASSERT_EQ(client->fileOpen(*id).errorOr(FILE_SERVICE_SUCCESS), FILE_SERVICE_FILE_DOESNT_EXIST);
 }
 
+TEST_F(FileServiceTests, read_ahead_succeeds)
+{
+    // Read ahead at most 256KiB, download at least 64KiB at a time.
+    auto options = DisableReadahead;
+
+    options.mMaximumReadAheadSize = 256_KiB;
+    options.mMinimumRangeSize = 64_KiB;
+
+    mClient->fileService().options(options);
+
+    // Open a file for reading.
+    auto file = mClient->fileOpen(mFileHandle);
+    ASSERT_EQ(file.errorOr(FILE_SERVICE_SUCCESS), FILE_SERVICE_SUCCESS);
+
+    // Read the first 64KiB of the file.
+    auto data = execute(read, *file, 0, 64_KiB);
+    ASSERT_EQ(data.errorOr(FILE_SUCCESS), FILE_SUCCESS);
+    EXPECT_TRUE(compare(*data, mFileContent, 0, 64_KiB));
+
+    // We had nothing so the read had to wait for a download.
+    EXPECT_EQ(file->info().readHits(), 0u);
+    EXPECT_EQ(file->info().readMisses(), 1u);
+
+    // No read ended where this one began so we don't know it's sequential.
+    ASSERT_EQ(execute(fetchBarrier, *file), FILE_SUCCESS);
+    EXPECT_EQ(file->ranges(), FileRangeVector{FileRange(0, 64_KiB)});
+
+    // Continue from where the last read ended.
+    data = execute(read, *file, 64_KiB, 64_KiB);
+    ASSERT_EQ(data.errorOr(FILE_SUCCESS), FILE_SUCCESS);
+    EXPECT_TRUE(compare(*data, mFileContent, 64_KiB, 64_KiB));
+
+    EXPECT_EQ(file->info().readHits(), 0u);
+    EXPECT_EQ(file->info().readMisses(), 2u);
+
+    // The read was sequential so we should read ahead of it.
+    EXPECT_TRUE(waitFor(
+        [&]()
+        {
+            return file->ranges() == FileRangeVector{FileRange(0, 192_KiB)};
+        },
+        mDefaultTimeout));
+
+    // Keep reading sequentially.
+    data = execute(read, *file, 128_KiB, 64_KiB);
+    ASSERT_EQ(data.errorOr(FILE_SUCCESS), FILE_SUCCESS);
+    EXPECT_TRUE(compare(*data, mFileContent, 128_KiB, 64_KiB));
+
+    // The read should've been satisfied by data we read ahead.
+    EXPECT_EQ(file->info().readHits(), 1u);
+    EXPECT_EQ(file->info().readMisses(), 2u);
+
+    // Our read-ahead window should have grown.
+    EXPECT_TRUE(waitFor(
+        [&]()
+        {
+            return file->ranges() == FileRangeVector{FileRange(0, 320_KiB)};
+        },
+        mDefaultTimeout));
+
+    // Read from somewhere else in the file.
+    data = execute(read, *file, 768_KiB, 64_KiB);
+    ASSERT_EQ(data.errorOr(FILE_SUCCESS), FILE_SUCCESS);
+    EXPECT_TRUE(compare(*data, mFileContent, 768_KiB, 64_KiB));
+
+    EXPECT_EQ(file->info().readHits(), 1u);
+    EXPECT_EQ(file->info().readMisses(), 3u);
+
+    // Random reads shouldn't trigger any read-ahead.
+    ASSERT_EQ(execute(fetchBarrier, *file), FILE_SUCCESS);
+    ASSERT_THAT(file->ranges(),
+                ElementsAre(FileRange(0, 320_KiB), FileRange(768_KiB, 832_KiB)));
+}
+
 TEST_F(FileServiceTests, read_cancel_on_client_logout_succeeds)
 {
     // Create a client that we can safely logout.
@@ -2022,6 +2097,7 @@ TEST_F(FileServiceTests, read_extension_succeeds)
 {
     // No minimum read size, extend if another range is <= 32K distant.
     mClient->fileService().options(FileServiceOptions{DefaultOptions.mMaximumRangeRetries,
+                                                      0u,
                                                       32_KiB,
                                                       0u,
                                                       DefaultOptions.mRangeRetryBackoff});
@@ -2198,8 +2274,9 @@ TEST_F(FileServiceTests, read_removed_file_succeeds)
 
 TEST_F(FileServiceTests, read_size_extension_succeeds)
 {
-    // Minimum read size is 64KiB, everything else are defaults.
+    // Minimum read size is 64KiB, no read-ahead, everything else are defaults.
     mClient->fileService().options(FileServiceOptions{DefaultOptions.mMaximumRangeRetries,
+                                                      0u,
                                                       DefaultOptions.mMinimumRangeDistance,
                                                       64_KiB,
                                                       DefaultOptions.mRangeRetryBackoff});
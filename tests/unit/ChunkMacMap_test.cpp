@@ -20,9 +20,226 @@
 
 #include <mega/utils.h>
 
+#include <random>
+#include <vector>
+
 namespace mega {
 
+namespace {
+
+// Same layout as chunkmac_map::ChunkMAC, which is serialized as raw bytes
+struct RawChunkMAC
+{
+    byte mac[SymmCipher::BLOCKSIZE];
+    unsigned int offset;
+    bool finished;
+};
+
+struct Entry
+{
+    m_off_t pos;
+    RawChunkMAC mac;
+};
+
+// Start of the n-th chunk, as defined by ChunkedHash
+m_off_t chunkStart(size_t n)
+{
+    m_off_t pos = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        pos = ChunkedHash::chunkceil(pos);
+    }
+    return pos;
+}
+
+std::vector<Entry> finishedChunks(size_t numChunks, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::vector<Entry> entries;
+    m_off_t pos = 0;
+    for (size_t i = 0; i < numChunks; ++i, pos = ChunkedHash::chunkceil(pos))
+    {
+        Entry entry{pos, RawChunkMAC{}};
+        for (auto& b: entry.mac.mac)
+        {
+            b = static_cast<byte>(generator());
+        }
+        entry.mac.finished = true;
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+// Format of serializechunkmacs(): count, then the position and the raw ChunkMAC of each entry
+std::string serialized(const std::vector<Entry>& entries)
+{
+    auto count = static_cast<unsigned short>(entries.size());
+    std::string data(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& entry: entries)
+    {
+        data.append(reinterpret_cast<const char*>(&entry.pos), sizeof(entry.pos));
+        data.append(reinterpret_cast<const char*>(&entry.mac), sizeof(entry.mac));
+    }
+    return data;
+}
 
+bool unserialize(chunkmac_map& macs, const std::string& data)
+{
+    const char* ptr = data.data();
+    return macs.unserialize(ptr, data.data() + data.size());
 }
 
+// Entries are added in batches, as the count of serialized entries is 16 bits
+void load(chunkmac_map& macs, const std::vector<Entry>& entries)
+{
+    for (size_t i = 0; i < entries.size(); i += 0xFFFF)
+    {
+        std::vector<Entry> batch(entries.begin() + static_cast<ptrdiff_t>(i),
+                                 entries.begin() +
+                                     static_cast<ptrdiff_t>(std::min(entries.size(), i + 0xFFFF)));
+        ASSERT_TRUE(unserialize(macs, serialized(batch)));
+    }
+}
+
+int64_t referenceMacsmac(SymmCipher& cipher, const std::vector<Entry>& entries)
+{
+    byte mac[SymmCipher::BLOCKSIZE] = {0};
+    for (const auto& entry: entries)
+    {
+        SymmCipher::xorblock(entry.mac.mac, mac);
+        cipher.ecb_encrypt(mac);
+    }
+
+    uint32_t* m = reinterpret_cast<uint32_t*>(mac);
+    m[0] ^= m[1];
+    m[1] = m[2] ^ m[3];
+    return MemAccess::get<int64_t>(reinterpret_cast<const char*>(mac));
+}
+
+void setTestKey(SymmCipher& cipher)
+{
+    byte key[SymmCipher::KEYLENGTH];
+    for (unsigned i = 0; i < sizeof(key); ++i)
+    {
+        key[i] = static_cast<byte>(i * 7);
+    }
+    cipher.setkey(key);
+}
+
+} // namespace
+
+TEST(ChunkMacMap, serializationRoundTrip)
+{
+    static_assert(sizeof(RawChunkMAC) == 24, "ChunkMAC is serialized as raw bytes");
+
+    // Gaps, partial chunks and chunks both of growing and of full size
+    std::vector<Entry> entries;
+    for (size_t n: {0, 1, 2, 5, 7, 8, 9, 20, 1000})
+    {
+        Entry entry{chunkStart(n), RawChunkMAC{}};
+        entry.mac.mac[0] = static_cast<byte>(n);
+        entry.mac.finished = n % 2 == 0;
+        entry.mac.offset = entry.mac.finished ? 0 : static_cast<unsigned>(n * 16);
+        entries.push_back(entry);
+    }
+
+    const auto data = serialized(entries);
+    chunkmac_map macs;
+    ASSERT_TRUE(unserialize(macs, data));
+    ASSERT_EQ(macs.size(), entries.size());
+
+    std::string reserialized;
+    macs.serialize(reserialized);
+    ASSERT_EQ(reserialized, data);
+
+    ASSERT_TRUE(macs.finishedAt(chunkStart(2)));
+    ASSERT_FALSE(macs.finishedAt(chunkStart(1)));
+    ASSERT_FALSE(macs.finishedAt(chunkStart(3)));
+
+    // Chunk 0 is finished, and chunk 1 is processed up to its offset
+    ASSERT_EQ(macs.nextUnprocessedPosFrom(0), chunkStart(1) + 16);
+
+    // Copies keep the order and the content
+    chunkmac_map copy;
+    macs.copyEntriesTo(copy);
+    std::string copied;
+    copy.serialize(copied);
+    ASSERT_EQ(copied, data);
 
+    macs.clear();
+    ASSERT_EQ(macs.size(), 0u);
+}
+
+TEST(ChunkMacMap, unserializeRejectsInvalidPositions)
+{
+    auto entries = finishedChunks(4, 1);
+
+    auto unaligned = entries;
+    unaligned[2].pos += 1;
+
+    auto negative = entries;
+    negative[0].pos = -ChunkedHash::SEGSIZE;
+
+    auto unordered = entries;
+    std::swap(unordered[1].pos, unordered[2].pos);
+
+    auto duplicated = entries;
+    duplicated[3].pos = duplicated[2].pos;
+
+    for (const auto& invalid: {unaligned, negative, unordered, duplicated})
+    {
+        chunkmac_map macs;
+        ASSERT_FALSE(unserialize(macs, serialized(invalid)));
+    }
+
+    chunkmac_map macs;
+    ASSERT_TRUE(unserialize(macs, serialized(entries)));
+}
+
+TEST(ChunkMacMap, unalignedPositionsAreNotStored)
+{
+    SymmCipher cipher;
+    setTestKey(cipher);
+
+    chunkmac_map macs;
+    byte data[SymmCipher::BLOCKSIZE] = {};
+    const m_off_t unaligned = ChunkedHash::SEGSIZE + SymmCipher::BLOCKSIZE;
+
+    // Not rounded down to the chunk starting at SEGSIZE, in any build
+    macs.ctr_encrypt(unaligned, &cipher, data, sizeof(data), unaligned, 0, true);
+
+    ASSERT_EQ(macs.size(), 0u);
+    ASSERT_FALSE(macs.finishedAt(ChunkedHash::SEGSIZE));
+}
+
+TEST(ChunkMacMap, macsmacMatchesReference)
+{
+    SymmCipher cipher;
+    setTestKey(cipher);
+
+    const auto entries = finishedChunks(300, 2);
+    const auto expected = referenceMacsmac(cipher, entries);
+
+    chunkmac_map macs;
+    load(macs, entries);
+    ASSERT_EQ(macs.macsmac(&cipher), expected);
+    ASSERT_EQ(macs.macsmac_gaps(&cipher, 0, 0, 0, 0), expected);
+
+    // Collapsing the leading entries doesn't change the result
+    const auto fileSize = ChunkedHash::chunkceil(entries.back().pos);
+    macs.setProgressContiguous(fileSize);
+    macs.updateMacsmacProgress(&cipher);
+    ASSERT_LT(macs.size(), entries.size());
+    ASSERT_EQ(macs.macsmac(&cipher), expected);
+
+    // Including when the collapsed map is restored from the DB
+    std::string data;
+    macs.serialize(data);
+    chunkmac_map restored;
+    ASSERT_TRUE(unserialize(restored, data));
+    ASSERT_EQ(restored.size(), macs.size());
+    ASSERT_EQ(restored.macsmac(&cipher), expected);
+    ASSERT_EQ(restored.hasUnfinishedGap(fileSize), 0);
+}
+
+}
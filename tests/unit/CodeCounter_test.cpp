@@ -0,0 +1,115 @@
+/* @brief Unit tests for the runtime code counters
+ *
+ * This test suite validates that scopes are counted from any thread and reported by the registry
+ */
+
+#include <gtest/gtest.h>
+#include <mega/code_counter.h>
+
+#include <thread>
+#include <vector>
+
+using namespace mega;
+using namespace CodeCounter;
+
+/**
+ * @brief Scopes timed from several threads are all counted
+ */
+TEST(CodeCounter, CountsFromManyThreads)
+{
+    ScopeStats stats("CodeCounter_CountsFromManyThreads");
+
+    std::vector<std::thread> threads;
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        threads.emplace_back(
+            [&stats]()
+            {
+                for (auto j = 0; j < 1000; ++j)
+                    ScopeTimer timer(stats);
+            });
+    }
+
+    for (auto& thread: threads)
+        thread.join();
+
+    auto snapshot = stats.snapshot();
+
+    EXPECT_EQ(snapshot.count, 4000u);
+    EXPECT_EQ(snapshot.active(), 0u);
+
+    uint64_t bucketed = 0;
+
+    for (auto count: snapshot.buckets)
+        bucketed += count;
+
+    EXPECT_EQ(bucketed, snapshot.count);
+}
+
+/**
+ * @brief Durations land in the right latency bucket
+ */
+TEST(CodeCounter, Buckets)
+{
+    ScopeStats stats("CodeCounter_Buckets");
+
+    stats.started();
+    stats.finished(std::chrono::microseconds(5));
+    stats.started();
+    stats.finished(std::chrono::milliseconds(2));
+    stats.started();
+    stats.finished(std::chrono::seconds(20));
+
+    auto snapshot = stats.snapshot();
+
+    EXPECT_EQ(snapshot.buckets[0], 1u);
+    EXPECT_EQ(snapshot.buckets[3], 1u);
+    EXPECT_EQ(snapshot.buckets.back(), 1u);
+    EXPECT_EQ(snapshot.longestNs, 20'000'000'000u);
+}
+
+/**
+ * @brief Scopes sharing a name are reported together, and only while they exist
+ */
+TEST(CodeCounter, Registry)
+{
+    auto& registry = Registry::instance();
+
+    {
+        ScopeStats first("CodeCounter_Registry");
+        ScopeStats second("CodeCounter_Registry");
+
+        ScopeTimer{first};
+        ScopeTimer{second};
+        ScopeStats::Snapshot active;
+
+        {
+            ScopeTimer running(first);
+
+            active = registry.snapshot()["CodeCounter_Registry"];
+        }
+
+        EXPECT_EQ(active.count, 2u);
+        EXPECT_EQ(active.active(), 1u);
+
+        auto json = registry.toJson();
+
+        EXPECT_NE(json.find("{\"name\":\"CodeCounter_Registry\",\"count\":3,\"active\":0"),
+                  std::string::npos)
+            << json;
+
+        auto prometheus = registry.toPrometheus();
+
+        EXPECT_NE(prometheus.find(
+                      "mega_scope_duration_seconds_count{scope=\"CodeCounter_Registry\"} 3\n"),
+                  std::string::npos)
+            << prometheus;
+        EXPECT_NE(prometheus.find("mega_scope_duration_seconds_bucket{"
+                                  "scope=\"CodeCounter_Registry\",le=\"+Inf\"} 3\n"),
+                  std::string::npos)
+            << prometheus;
+    }
+
+    EXPECT_FALSE(registry.snapshot().count("CodeCounter_Registry"));
+}
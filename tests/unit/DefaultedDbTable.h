@@ -134,6 +134,16 @@ public:
         return false;
     }
 
+    bool getNodeSkeleton(std::vector<mega::NodeSkeleton::Entry>&) override
+    {
+        return false;
+    }
+
+    bool visitNodesDepthFirst(const std::function<void(const mega::NodeTreeVisit&)>&) override
+    {
+        return false;
+    }
+
     uint64_t getNumberOfChildrenByType(mega::NodeHandle /*parentHandle*/, mega::nodetype_t) override
     {
       return 0;
@@ -0,0 +1,97 @@
+/**
+ * @brief Unitary tests for HttpBufferPool, the buffers that receive downloaded data
+ */
+
+#include <gtest/gtest.h>
+#include <mega/crypto/cryptopp.h>
+#include <mega/http.h>
+
+#include <memory>
+#include <string>
+
+using namespace mega;
+
+TEST(HttpBufferPool, CapacityIsPaddedToBlockSize)
+{
+    HttpBufferPool pool;
+    size_t capacity = 0;
+    byte* buffer = pool.get(1000, capacity);
+
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_GE(capacity, 1000u);
+    EXPECT_EQ(capacity % SymmCipher::BLOCKSIZE, 0u);
+
+    pool.put(buffer, capacity);
+}
+
+TEST(HttpBufferPool, BuffersAreReused)
+{
+    HttpBufferPool pool;
+    size_t capacity = 0;
+    byte* buffer = pool.get(4096, capacity);
+    pool.put(buffer, capacity);
+
+    // a smaller request fits in the same buffer
+    size_t reusedCapacity = 0;
+    EXPECT_EQ(pool.get(1024, reusedCapacity), buffer);
+    EXPECT_EQ(reusedCapacity, capacity);
+    pool.put(buffer, reusedCapacity);
+
+    // a larger one doesn't
+    size_t largerCapacity = 0;
+    byte* larger = pool.get(8192, largerCapacity);
+    EXPECT_NE(larger, buffer);
+    EXPECT_GE(largerCapacity, 8192u);
+    pool.put(larger, largerCapacity);
+}
+
+TEST(HttpBufferPool, DoesNotKeepMoreThanAllocated)
+{
+    HttpBufferPool pool;
+    size_t capacity = 0;
+    byte* buffer = pool.get(4096, capacity);
+    pool.put(buffer, capacity);
+
+    // buffers from elsewhere are deleted once the pool holds as many as it allocated
+    pool.put(new byte[4096], 4096);
+
+    size_t first = 0;
+    size_t second = 0;
+    byte* b1 = pool.get(4096, first);
+    byte* b2 = pool.get(4096, second);
+    EXPECT_EQ(b1, buffer);
+    EXPECT_NE(b2, buffer);
+    pool.put(b1, first);
+    pool.put(b2, second);
+}
+
+TEST(HttpBufferPool, DownloadRequestsReceiveInPooledBuffers)
+{
+    HttpBufferPool pool;
+    m_off_t copiedBytes = 0;
+
+    HttpReqDL req;
+    req.mBufferPool = &pool;
+    req.mCopiedBytes = &copiedBytes;
+    req.prepare(nullptr, nullptr, 0, 0, 1000);
+    ASSERT_NE(req.buf, nullptr);
+
+    std::string data(1000, 'x');
+    req.put(data.data(), static_cast<unsigned>(data.size()));
+    EXPECT_EQ(copiedBytes, 1000);
+
+    // the released buffer keeps its capacity, so it can go back to the pool
+    byte* received = req.buf;
+    std::unique_ptr<HttpReq::http_buf_t> buf(req.release_buf());
+    EXPECT_EQ(buf->datalen(), 1000u);
+
+    size_t capacity = 0;
+    EXPECT_EQ(buf->release(capacity), received);
+    EXPECT_EQ(capacity % SymmCipher::BLOCKSIZE, 0u);
+    EXPECT_TRUE(buf->isNull());
+    pool.put(received, capacity);
+
+    // and the next request reuses it
+    req.prepare(nullptr, nullptr, 0, 1000, 2000);
+    EXPECT_EQ(req.buf, received);
+}
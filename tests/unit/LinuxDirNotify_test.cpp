@@ -0,0 +1,59 @@
+/**
+ * @brief Unitary tests for how fanotify events are mapped to the syncs they concern
+ *
+ * They don't need the privileges that marking a filesystem requires.
+ */
+
+#include <gtest/gtest.h>
+#include <mega.h>
+
+#if defined(ENABLE_SYNC) && defined(USE_FANOTIFY)
+
+using namespace mega;
+
+namespace
+{
+
+std::optional<std::string>
+    relativePath(const std::string& root, const std::string& directory, const char* name = "")
+{
+    return LinuxDirNotify::fanotifyRelativePath(root, directory, name);
+}
+
+} // namespace
+
+TEST(LinuxDirNotify, EventsInTheRootAreRelativeToIt)
+{
+    EXPECT_EQ(relativePath("/home/user/sync", "/home/user/sync"), "");
+    EXPECT_EQ(relativePath("/home/user/sync", "/home/user/sync", "file"), "file");
+}
+
+TEST(LinuxDirNotify, EventsBelowTheRootAreRelativeToIt)
+{
+    EXPECT_EQ(relativePath("/home/user/sync", "/home/user/sync/a"), "a");
+    EXPECT_EQ(relativePath("/home/user/sync", "/home/user/sync/a/b", "file"), "a/b/file");
+}
+
+TEST(LinuxDirNotify, EventsOutsideTheRootAreIgnored)
+{
+    EXPECT_EQ(relativePath("/home/user/sync", "/home/user"), std::nullopt);
+    EXPECT_EQ(relativePath("/home/user/sync", "/home/user", "sync"), std::nullopt);
+    EXPECT_EQ(relativePath("/home/user/sync", "/home/user/other", "file"), std::nullopt);
+    EXPECT_EQ(relativePath("/home/user/sync", "/var/sync", "file"), std::nullopt);
+}
+
+TEST(LinuxDirNotify, SiblingsSharingTheRootsPrefixAreIgnored)
+{
+    EXPECT_EQ(relativePath("/home/user/sync", "/home/user/sync2"), std::nullopt);
+    EXPECT_EQ(relativePath("/home/user/sync", "/home/user/sync2/a", "file"), std::nullopt);
+    EXPECT_EQ(relativePath("/home/user/sync", "/home/user/syn", "c"), std::nullopt);
+}
+
+TEST(LinuxDirNotify, FilesystemRootSyncsEverything)
+{
+    EXPECT_EQ(relativePath("/", "/"), "");
+    EXPECT_EQ(relativePath("/", "/", "file"), "file");
+    EXPECT_EQ(relativePath("/", "/a/b", "file"), "a/b/file");
+}
+
+#endif // ENABLE_SYNC && USE_FANOTIFY
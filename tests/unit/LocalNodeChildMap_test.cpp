@@ -0,0 +1,79 @@
+/* @brief Unit tests for LocalNodeChildMap, the children of a LocalNode
+ *
+ * The map is only allocated once an entry is added. Until then, and after clear(), lookups use a
+ * single empty map shared by every LocalNodeChildMap.
+ */
+
+#include <gtest/gtest.h>
+#include <mega.h>
+
+#ifdef ENABLE_SYNC
+
+using namespace mega;
+
+namespace
+{
+
+const LocalPath name = LocalPath::fromRelativePath("child");
+
+TEST(LocalNodeChildMap, NeverAllocatedMapIsEmpty)
+{
+    LocalNodeChildMap children;
+    const auto& constChildren = children;
+
+    EXPECT_TRUE(children.empty());
+    EXPECT_EQ(children.size(), 0u);
+    EXPECT_EQ(children.begin(), children.end());
+    EXPECT_EQ(children.find(name), children.end());
+    EXPECT_EQ(constChildren.find(name), constChildren.end());
+    EXPECT_EQ(children.erase(name), 0u);
+}
+
+TEST(LocalNodeChildMap, EmptyMapIsShared)
+{
+    LocalNodeChildMap children;
+    const LocalNodeChildMap otherChildren;
+
+    // Both iterate the same static map
+    EXPECT_EQ(LocalNodeChildMap::const_iterator(children.end()), otherChildren.end());
+
+    // Lookups don't add anything to it
+    children.find(name);
+    EXPECT_EQ(otherChildren.begin(), otherChildren.end());
+}
+
+TEST(LocalNodeChildMap, AddingAChildAllocatesTheMap)
+{
+    LocalNodeChildMap children;
+    const LocalNodeChildMap otherChildren;
+
+    children[name] = nullptr;
+
+    EXPECT_FALSE(children.empty());
+    EXPECT_EQ(children.size(), 1u);
+    ASSERT_NE(children.find(name), children.end());
+    EXPECT_NE(LocalNodeChildMap::const_iterator(children.end()), otherChildren.end());
+    EXPECT_TRUE(otherChildren.empty());
+
+    children.erase(children.find(name));
+    EXPECT_TRUE(children.empty());
+}
+
+TEST(LocalNodeChildMap, ClearReleasesTheMap)
+{
+    LocalNodeChildMap children;
+    const LocalNodeChildMap otherChildren;
+
+    children[name] = nullptr;
+    children.clear();
+
+    EXPECT_TRUE(children.empty());
+    EXPECT_EQ(children.find(name), children.end());
+
+    // Back to the shared empty map
+    EXPECT_EQ(LocalNodeChildMap::const_iterator(children.end()), otherChildren.end());
+}
+
+} // namespace
+
+#endif // ENABLE_SYNC
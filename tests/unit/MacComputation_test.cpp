@@ -0,0 +1,163 @@
+/**
+ * @brief Unit tests for the pipelined computation of a local file's MAC
+ */
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+#include <mega.h>
+#include <mega/syncinternals/syncinternals.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <string>
+#include <thread>
+
+#ifdef ENABLE_SYNC
+
+using namespace mega;
+
+namespace
+{
+
+namespace fs = std::filesystem;
+
+class MacComputationTest: public ::testing::Test
+{
+protected:
+    fs::path mPath;
+
+    MegaApp mApp;
+    MacComputationThrottle mThrottle;
+    PrnGen mRng;
+
+    std::array<byte, SymmCipher::KEYLENGTH> mKey{};
+    int64_t mIv = 0;
+
+    void SetUp() override
+    {
+        // Unique per test and per run, as runs of the unit tests may share the temp directory
+        const auto* test = ::testing::UnitTest::GetInstance()->current_test_info();
+        mPath = fs::temp_directory_path() /
+                ("MacComputation_test_" + std::string(test->name()) + "_" +
+                 std::to_string(mRng.genuint32(std::numeric_limits<uint32_t>::max())) + ".bin");
+
+        mRng.genblock(mKey.data(), mKey.size());
+        mRng.genblock(reinterpret_cast<byte*>(&mIv), sizeof(mIv));
+    }
+
+    void TearDown() override
+    {
+        fs::remove(mPath);
+    }
+
+    void createFile(m_off_t size)
+    {
+        std::string content(static_cast<size_t>(size), '\0');
+        mRng.genblock(reinterpret_cast<byte*>(content.data()), content.size());
+
+        std::ofstream file(mPath, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    }
+
+    LocalPath path() const
+    {
+        return LocalPath::fromAbsolutePath(mPath.string());
+    }
+
+    std::shared_ptr<MacComputationState> state(m_off_t size)
+    {
+        auto state = std::make_shared<MacComputationState>(size, path(), mThrottle);
+        state->transferkey = mKey;
+        state->ctriv = mIv;
+        return state;
+    }
+
+    // The MAC of the whole file, computed in one go on this thread.
+    int64_t sequentialMac(MegaClient& client)
+    {
+        auto fa = client.fsaccess->newfileaccess();
+        EXPECT_TRUE(fa->fopen(path(), true, false, FSLogging::logOnError));
+
+        SymmCipher cipher;
+        cipher.setkey(mKey.data());
+
+        auto [succeeded, mac] = generateMetaMac(cipher, *fa, mIv, std::nullopt);
+        EXPECT_TRUE(succeeded);
+        return mac;
+    }
+
+    // Advances the computation until it's no longer pending.
+    static MacAdvanceResult complete(MegaClient& client,
+                                     std::shared_ptr<MacComputationState> state)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+        auto result = MacAdvanceResult::Pending;
+
+        while (result == MacAdvanceResult::Pending &&
+               std::chrono::steady_clock::now() < deadline)
+        {
+            result = advanceMacComputation(client, state, "MacComputationTest: ");
+
+            if (result == MacAdvanceResult::Pending)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return result;
+    }
+};
+
+} // namespace
+
+TEST_F(MacComputationTest, PipelinedMacMatchesSequentialMac)
+{
+    // Several ranges, the last of them not ending on a chunk boundary.
+    const m_off_t size = 2 * MacComputationState::BUFFER_SIZE + 654321;
+    createFile(size);
+
+    for (unsigned numThreads: {0u, 4u})
+    {
+        auto client = mt::makeClient(mApp, nullptr, numThreads);
+        auto computation = state(size);
+
+        ASSERT_EQ(complete(*client, computation), MacAdvanceResult::Ready) << numThreads;
+        ASSERT_EQ(computation->localMac, sequentialMac(*client)) << numThreads;
+    }
+}
+
+TEST_F(MacComputationTest, FailsWhenFileChangesDuringComputation)
+{
+    const m_off_t size = 2 * MacComputationState::BUFFER_SIZE;
+    createFile(size);
+
+    auto client = mt::makeClient(mApp, nullptr, 1);
+    auto computation = state(size);
+
+    // Keep the only worker busy so that the ranges are read after the file changes.
+    std::promise<void> release;
+    client->mAsyncQueue.push(
+        [released = release.get_future().share()](SymmCipher&)
+        {
+            released.wait();
+        },
+        false);
+
+    // Not asserted: the worker must be released whatever happens.
+    EXPECT_EQ(advanceMacComputation(*client, computation, "MacComputationTest: "),
+              MacAdvanceResult::Pending);
+
+    {
+        std::ofstream file(mPath, std::ios::binary | std::ios::app);
+        file << "more content";
+    }
+
+    release.set_value();
+
+    ASSERT_EQ(complete(*client, computation), MacAdvanceResult::Failed);
+    ASSERT_FALSE(computation->isReady());
+}
+
+#endif // ENABLE_SYNC
@@ -0,0 +1,174 @@
+/**
+ * @brief Unitary tests for NodeHandleMap, the handle index used by NodeManager::mNodes
+ */
+
+#include <gtest/gtest.h>
+#include <mega/node_handle_map.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mega;
+
+namespace
+{
+
+NodeHandle toNodeHandle(uint64_t h)
+{
+    return NodeHandle().set6byte(h & 0xFFFFFFFFFFFF);
+}
+
+std::vector<NodeHandle> randomHandles(size_t count, uint64_t seed)
+{
+    std::mt19937_64 generator(seed);
+    std::vector<NodeHandle> handles;
+    handles.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        handles.push_back(toNodeHandle(generator()));
+    }
+
+    return handles;
+}
+
+} // namespace
+
+TEST(NodeHandleMap, insertFindErase)
+{
+    NodeHandleMap<std::string> map;
+
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.find(toNodeHandle(1)), map.end());
+
+    auto [it, inserted] = map.try_emplace(toNodeHandle(1), "one");
+    ASSERT_TRUE(inserted);
+    ASSERT_EQ(it->first.as8byte(), 1u);
+    ASSERT_EQ(it->second, "one");
+
+    // Existing entries are neither replaced nor reconstructed.
+    auto [again, insertedAgain] = map.try_emplace(toNodeHandle(1), "uno");
+    ASSERT_FALSE(insertedAgain);
+    ASSERT_EQ(again, it);
+    ASSERT_EQ(again->second, "one");
+
+    map.emplace(toNodeHandle(2), "two");
+    ASSERT_EQ(map.size(), 2u);
+    ASSERT_EQ(map.count(toNodeHandle(2)), 1u);
+
+    map.erase(it);
+    ASSERT_EQ(map.size(), 1u);
+    ASSERT_EQ(map.find(toNodeHandle(1)), map.end());
+    ASSERT_EQ(map.find(toNodeHandle(2))->second, "two");
+
+    ASSERT_EQ(map.erase(toNodeHandle(2)), 1u);
+    ASSERT_EQ(map.erase(toNodeHandle(2)), 0u);
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.begin(), map.end());
+}
+
+TEST(NodeHandleMap, undefHandleIsAValidKey)
+{
+    NodeHandleMap<int> map;
+
+    map.try_emplace(NodeHandle(), 7);
+
+    auto it = map.find(NodeHandle());
+    ASSERT_NE(it, map.end());
+    ASSERT_TRUE(it->first.isUndef());
+    ASSERT_EQ(it->second, 7);
+}
+
+TEST(NodeHandleMap, defaultIteratorComparesEqualToEnd)
+{
+    NodeHandleMap<int> map;
+    NodeHandleMap<int>::iterator position;
+
+    map.try_emplace(toNodeHandle(1), 1);
+
+    ASSERT_EQ(position, map.end());
+}
+
+TEST(NodeHandleMap, addressesAreStableAcrossRehashAndErase)
+{
+    NodeHandleMap<size_t> map;
+    auto handles = randomHandles(20000, 1);
+
+    std::vector<std::pair<NodeHandle, size_t*>> addresses;
+
+    for (size_t i = 0; i < handles.size(); ++i)
+    {
+        auto [it, inserted] = map.try_emplace(handles[i], i);
+
+        if (inserted)
+        {
+            addresses.emplace_back(handles[i], &it->second);
+        }
+    }
+
+    // Erase every other element and insert new ones, reusing free slots.
+    for (size_t i = 0; i < addresses.size(); i += 2)
+    {
+        map.erase(addresses[i].first);
+    }
+
+    for (const auto& handle: randomHandles(10000, 2))
+    {
+        map.try_emplace(handle, 0);
+    }
+
+    for (size_t i = 1; i < addresses.size(); i += 2)
+    {
+        auto it = map.find(addresses[i].first);
+        ASSERT_NE(it, map.end());
+        ASSERT_EQ(&it->second, addresses[i].second);
+    }
+}
+
+TEST(NodeHandleMap, behavesLikeStdMap)
+{
+    NodeHandleMap<uint64_t> map;
+    std::map<NodeHandle, uint64_t> reference;
+
+    std::mt19937_64 generator(3);
+
+    // Small key space so that inserts, hits and erasures collide often.
+    for (int i = 0; i < 200000; ++i)
+    {
+        NodeHandle handle = toNodeHandle(generator() % 4096);
+
+        switch (generator() % 3)
+        {
+            case 0:
+                ASSERT_EQ(map.try_emplace(handle, handle.as8byte()).second,
+                          reference.emplace(handle, handle.as8byte()).second);
+                break;
+            case 1:
+                ASSERT_EQ(map.erase(handle), reference.erase(handle));
+                break;
+            default:
+                ASSERT_EQ(map.find(handle) != map.end(), reference.count(handle) == 1);
+                break;
+        }
+
+        ASSERT_EQ(map.size(), reference.size());
+    }
+
+    size_t visited = 0;
+
+    for (auto& [handle, value]: map)
+    {
+        ASSERT_EQ(handle.as8byte(), value);
+        ASSERT_EQ(reference.count(handle), 1u);
+        ++visited;
+    }
+
+    ASSERT_EQ(visited, reference.size());
+
+    map.clear();
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.begin(), map.end());
+}
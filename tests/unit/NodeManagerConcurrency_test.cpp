@@ -0,0 +1,224 @@
+/**
+ * @file NodeManagerConcurrency_test.cpp
+ * @brief Unitary tests for concurrent (shared) access to NodeManager
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "utils.h"
+
+#include <gtest/gtest.h>
+#include <mega/megaapp.h>
+#include <mega/megaclient.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(RecursiveSharedMutex, sharedLockInsideExclusiveLock)
+{
+    RecursiveSharedMutex mutex;
+
+    std::lock_guard<RecursiveSharedMutex> exclusive(mutex);
+    {
+        std::shared_lock<RecursiveSharedMutex> shared(mutex);
+        std::lock_guard<RecursiveSharedMutex> nested(mutex);
+        ASSERT_TRUE(mutex.owns_lock());
+    }
+
+    ASSERT_TRUE(mutex.owns_lock());
+    ASSERT_FALSE(std::async(std::launch::async, [&mutex]() { return mutex.try_lock_shared(); }).get());
+}
+
+TEST(RecursiveSharedMutex, readersShareAndExcludeWriters)
+{
+    RecursiveSharedMutex mutex;
+
+    std::shared_lock<RecursiveSharedMutex> shared(mutex);
+    ASSERT_TRUE(mutex.owns_shared_lock());
+    ASSERT_FALSE(mutex.owns_lock());
+
+    auto otherReader = std::async(std::launch::async,
+                                  [&mutex]()
+                                  {
+                                      bool locked = mutex.try_lock_shared();
+                                      if (locked)
+                                          mutex.unlock_shared();
+                                      return locked;
+                                  });
+    ASSERT_TRUE(otherReader.get());
+
+    auto writer = std::async(std::launch::async,
+                             [&mutex]()
+                             {
+                                 bool locked = mutex.try_lock();
+                                 if (locked)
+                                     mutex.unlock();
+                                 return locked;
+                             });
+    ASSERT_FALSE(writer.get());
+}
+
+TEST(RecursiveSharedMutex, nestedSharedLockDoesNotWaitForQueuedWriter)
+{
+    RecursiveSharedMutex mutex;
+
+    std::shared_lock<RecursiveSharedMutex> shared(mutex);
+
+    std::atomic<bool> writerDone{false};
+    auto writer = std::async(std::launch::async,
+                             [&]()
+                             {
+                                 std::lock_guard<RecursiveSharedMutex> exclusive(mutex);
+                                 writerDone = true;
+                             });
+
+    // Give the writer time to queue up.
+    std::this_thread::sleep_for(50ms);
+
+    // A new reader must wait for the queued writer...
+    auto otherReader = std::async(std::launch::async, [&mutex]() { return mutex.try_lock_shared(); });
+    ASSERT_FALSE(otherReader.get());
+
+    // ...but a thread that already reads must not, or it would deadlock.
+    {
+        std::shared_lock<RecursiveSharedMutex> nested(mutex);
+        ASSERT_FALSE(writerDone);
+    }
+
+    shared.unlock();
+    writer.get();
+    ASSERT_TRUE(writerDone);
+}
+
+class NodeManagerConcurrency: public testing::Test
+{
+protected:
+    mega::MegaApp mApp;
+    mt::SqliteNodeClient mNodes{mApp};
+
+    std::vector<std::shared_ptr<mega::Node>> mFolders;
+    std::vector<mega::NodeHandle> mFiles;
+
+    std::shared_ptr<mega::Node> addNode(mega::nodetype_t nodeType,
+                                        const std::shared_ptr<mega::Node>& parent,
+                                        bool isFetching)
+    {
+        return mNodes.addNode(nodeType, parent, isFetching);
+    }
+
+    void buildTree(size_t numFolders, size_t filesPerFolder)
+    {
+        for (size_t i = 0; i < numFolders; ++i)
+        {
+            mFolders.push_back(addNode(mega::nodetype_t::FOLDERNODE, mNodes.rootNode, true));
+
+            for (size_t j = 0; j < filesPerFolder; ++j)
+            {
+                mFiles.push_back(
+                    addNode(mega::nodetype_t::FILENODE, mFolders.back(), true)->nodeHandle());
+            }
+        }
+    }
+
+    // Adds new files under random folders, as action packets would do.
+    size_t applyActionPackets(size_t count)
+    {
+        std::mt19937 generator(1);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto& folder = mFolders[generator() % mFolders.size()];
+            addNode(mega::nodetype_t::FILENODE, folder, false);
+        }
+
+        return count;
+    }
+
+    // Looks up random known nodes and enumerates random folders until stopped.
+    // Returns the number of operations done, or 0 if any result was inconsistent.
+    size_t hammer(const std::atomic<bool>& stop, size_t filesPerFolder, unsigned seed)
+    {
+        std::mt19937 generator(seed);
+        size_t operations = 0;
+
+        while (!stop)
+        {
+            const auto& handle = mFiles[generator() % mFiles.size()];
+            auto node = mNodes.client->mNodeManager.getNodeByHandle(handle);
+            if (!node || node->nodeHandle() != handle)
+            {
+                return 0;
+            }
+
+            const auto& folder = mFolders[generator() % mFolders.size()];
+            if (mNodes.client->mNodeManager.getChildren(folder.get()).size() < filesPerFolder)
+            {
+                return 0;
+            }
+
+            operations += 2;
+        }
+
+        return operations;
+    }
+};
+
+TEST_F(NodeManagerConcurrency, readersSeeConsistentNodesWhileWriting)
+{
+    constexpr size_t numFolders = 20;
+    constexpr size_t filesPerFolder = 50;
+    constexpr size_t numReaders = 4;
+    constexpr size_t numActionPackets = 1000;
+
+    buildTree(numFolders, filesPerFolder);
+
+    std::atomic<bool> stop{false};
+    std::vector<std::future<size_t>> readers;
+
+    for (unsigned i = 0; i < numReaders; ++i)
+    {
+        readers.emplace_back(std::async(std::launch::async,
+                                        [this, &stop, i]()
+                                        {
+                                            return hammer(stop, filesPerFolder, i);
+                                        }));
+    }
+
+    applyActionPackets(numActionPackets);
+    stop = true;
+
+    for (auto& reader: readers)
+    {
+        ASSERT_GT(reader.get(), 0u) << "A reader got an inconsistent result";
+    }
+
+    size_t numChildren = 0;
+    for (const auto& folder: mFolders)
+    {
+        numChildren += mNodes.client->mNodeManager.getChildren(folder.get()).size();
+    }
+
+    ASSERT_EQ(numChildren, numFolders * filesPerFolder + numActionPackets);
+}
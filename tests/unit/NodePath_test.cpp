@@ -0,0 +1,205 @@
+/**
+ * @file NodePath_test.cpp
+ * @brief Unitary tests for the ancestor paths stored with the nodes in the DB
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "utils.h"
+
+#include <gtest/gtest.h>
+#include <mega/megaapp.h>
+#include <mega/megaclient.h>
+
+#include <set>
+#include <vector>
+
+class NodePath: public testing::Test
+{
+protected:
+    mega::MegaApp mApp;
+    mt::SqliteNodeClient mNodes{mApp};
+
+    std::shared_ptr<mega::Node> makeNode(mega::nodetype_t nodeType,
+                                         const std::shared_ptr<mega::Node>& parent)
+    {
+        return mNodes.makeNode(nodeType, parent);
+    }
+
+    std::shared_ptr<mega::Node> addNode(mega::nodetype_t nodeType,
+                                        const std::shared_ptr<mega::Node>& parent)
+    {
+        return mNodes.addNode(nodeType, parent);
+    }
+
+    void move(const std::shared_ptr<mega::Node>& node, const std::shared_ptr<mega::Node>& parent)
+    {
+        node->setparent(parent);
+        mNodes.client->mNodeManager.saveNodeInDb(node.get());
+    }
+
+    std::set<mega::NodeHandle> searchBelow(const std::shared_ptr<mega::Node>& ancestor,
+                                           bool includeVersions = false)
+    {
+        mega::NodeSearchFilter filter;
+        filter.byAncestors({ancestor->nodehandle, mega::UNDEF, mega::UNDEF});
+        filter.includeVersions(includeVersions);
+
+        std::set<mega::NodeHandle> handles;
+        for (const auto& node: mNodes.client->mNodeManager.searchNodes(filter,
+                                                                       0 /*order None*/,
+                                                                       mega::CancelToken(),
+                                                                       mega::NodeSearchPage{0, 0}))
+        {
+            handles.insert(node->nodeHandle());
+        }
+        return handles;
+    }
+
+    bool isAncestor(const std::shared_ptr<mega::Node>& node,
+                    const std::shared_ptr<mega::Node>& ancestor)
+    {
+        return mNodes.table().isAncestor(node->nodeHandle(),
+                                         ancestor->nodeHandle(),
+                                         mega::CancelToken());
+    }
+};
+
+TEST_F(NodePath, searchFollowsMoves)
+{
+    auto photos = addNode(mega::nodetype_t::FOLDERNODE, mNodes.rootNode);
+    auto trips = addNode(mega::nodetype_t::FOLDERNODE, photos);
+    auto beach = addNode(mega::nodetype_t::FILENODE, trips);
+    auto mountain = addNode(mega::nodetype_t::FILENODE, trips);
+    auto backup = addNode(mega::nodetype_t::FOLDERNODE, mNodes.rootNode);
+
+    using Handles = std::set<mega::NodeHandle>;
+    const Handles movedNodes{trips->nodeHandle(), beach->nodeHandle(), mountain->nodeHandle()};
+
+    ASSERT_EQ(searchBelow(photos), movedNodes);
+    ASSERT_TRUE(searchBelow(backup).empty());
+    ASSERT_TRUE(isAncestor(beach, photos));
+
+    // The whole subtree follows its top node
+    move(trips, backup);
+
+    ASSERT_TRUE(searchBelow(photos).empty());
+    ASSERT_EQ(searchBelow(backup), movedNodes);
+    ASSERT_FALSE(isAncestor(beach, photos));
+    ASSERT_TRUE(isAncestor(beach, backup));
+    ASSERT_TRUE(isAncestor(beach, mNodes.rootNode));
+
+    // Moves deeper in the tree, below a former sibling
+    move(backup, photos);
+
+    ASSERT_EQ(searchBelow(photos).size(), movedNodes.size() + 1);
+    ASSERT_TRUE(isAncestor(mountain, photos));
+    ASSERT_FALSE(isAncestor(photos, mountain));
+    ASSERT_FALSE(isAncestor(photos, photos));
+}
+
+TEST_F(NodePath, childrenStoredBeforeTheirParent)
+{
+    // As during fetchnodes, where children may come before their parent
+    auto folder = makeNode(mega::nodetype_t::FOLDERNODE, mNodes.rootNode);
+    auto subfolder = makeNode(mega::nodetype_t::FOLDERNODE, folder);
+    auto file = makeNode(mega::nodetype_t::FILENODE, subfolder);
+
+    mNodes.client->mNodeManager.saveNodeInDb(file.get());
+    mNodes.client->mNodeManager.saveNodeInDb(folder.get());
+
+    // 'subfolder' isn't stored yet, so the path of 'file' starts at 'file' itself
+    ASSERT_TRUE(isAncestor(file, subfolder));
+    ASSERT_FALSE(isAncestor(file, folder));
+
+    mNodes.client->mNodeManager.saveNodeInDb(subfolder.get());
+
+    ASSERT_TRUE(isAncestor(file, folder));
+    ASSERT_TRUE(isAncestor(file, mNodes.rootNode));
+
+    const std::set<mega::NodeHandle> expected{folder->nodeHandle(),
+                                              subfolder->nodeHandle(),
+                                              file->nodeHandle()};
+    ASSERT_EQ(searchBelow(mNodes.rootNode), expected);
+}
+
+TEST_F(NodePath, versionsAreNotFound)
+{
+    auto folder = addNode(mega::nodetype_t::FOLDERNODE, mNodes.rootNode);
+    auto file = addNode(mega::nodetype_t::FILENODE, folder);
+    auto version = addNode(mega::nodetype_t::FILENODE, file);
+    auto olderVersion = addNode(mega::nodetype_t::FILENODE, version);
+
+    using Handles = std::set<mega::NodeHandle>;
+
+    ASSERT_EQ(searchBelow(folder, true), Handles{file->nodeHandle()});
+    ASSERT_TRUE(isAncestor(olderVersion, folder));
+
+    // Only the latest version is found when searching below the file itself
+    ASSERT_EQ(searchBelow(file, true), Handles{version->nodeHandle()});
+    ASSERT_TRUE(searchBelow(file).empty());
+}
+
+TEST_F(NodePath, countersFromDepthFirstVisit)
+{
+    auto addFile = [this](const std::shared_ptr<mega::Node>& parent, m_off_t size)
+    {
+        auto file = makeNode(mega::nodetype_t::FILENODE, parent);
+        file->size = size;
+        mNodes.client->mNodeManager.saveNodeInDb(file.get());
+        return file;
+    };
+
+    // As during fetchnodes, nodes below the first level aren't kept in memory
+    auto folder = addNode(mega::nodetype_t::FOLDERNODE, mNodes.rootNode);
+    auto subfolder = addNode(mega::nodetype_t::FOLDERNODE, folder);
+    addFile(folder, 10);
+    auto file = addFile(subfolder, 20);
+    auto version = addFile(file, 5);
+
+    auto rubbish = mNodes.client->nodeByHandle(mNodes.client->mNodeManager.getRootNodeRubbish());
+    ASSERT_TRUE(rubbish);
+    auto deleted = addFile(rubbish, 7);
+
+    mNodes.client->mNodeManager.initCompleted();
+
+    mega::NodeCounter counter = mNodes.rootNode->getCounter();
+    ASSERT_EQ(counter.files, 2u);
+    ASSERT_EQ(counter.folders, 2u);
+    ASSERT_EQ(counter.versions, 1u);
+    ASSERT_EQ(counter.storage, 30);
+    ASSERT_EQ(counter.versionStorage, 5);
+
+    ASSERT_EQ(rubbish->getCounter().files, 1u);
+    ASSERT_EQ(rubbish->getCounter().storage, 7);
+
+    auto dbFlags = [this](const std::shared_ptr<mega::Node>& node)
+    {
+        m_off_t size = 0;
+        mega::nodetype_t type = mega::TYPE_UNKNOWN;
+        uint64_t flags = 0;
+        EXPECT_TRUE(mNodes.table().getNodeSizeTypeAndFlags(node->nodeHandle(), size, type, flags));
+        return mega::Node::Flags(flags);
+    };
+
+    ASSERT_TRUE(dbFlags(version).test(mega::Node::FLAGS_IS_VERSION));
+    ASSERT_FALSE(dbFlags(file).test(mega::Node::FLAGS_IS_VERSION));
+    ASSERT_TRUE(dbFlags(deleted).test(mega::Node::FLAGS_IS_IN_RUBBISH));
+    ASSERT_FALSE(dbFlags(rubbish).test(mega::Node::FLAGS_IS_IN_RUBBISH));
+    ASSERT_FALSE(dbFlags(file).test(mega::Node::FLAGS_IS_IN_RUBBISH));
+}
@@ -0,0 +1,223 @@
+/**
+ * @file NodeSearchIndex_test.cpp
+ * @brief Unitary tests for the full-text index used by searchNodes()
+ *
+ * (c) 2013-2025 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "utils.h"
+
+#include <gtest/gtest.h>
+#include <mega/megaapp.h>
+#include <mega/megaclient.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+class NodeSearchIndex: public testing::Test
+{
+protected:
+    mega::MegaApp mApp;
+    mt::SqliteNodeClient mNodes{mApp};
+
+    // The index is a search index: it's created and dropped along with the search DB indexes
+    void enableIndex(bool enable)
+    {
+        // dropSearchDBIndexes() uses its own transaction
+        mNodes.client->sctable->commit();
+
+        if (enable)
+        {
+            mNodes.table().createIndexes(true);
+        }
+        else
+        {
+            mNodes.table().dropSearchDBIndexes();
+        }
+
+        mNodes.client->sctable->begin();
+    }
+
+    std::shared_ptr<mega::Node> addNode(mega::nodetype_t nodeType,
+                                        const std::shared_ptr<mega::Node>& parent,
+                                        const std::string& name,
+                                        const std::string& description = "",
+                                        const std::string& tags = "")
+    {
+        auto node = mNodes.makeNode(nodeType, parent);
+
+        setAttr(*node, "n", name);
+        setAttr(*node, mega::MegaClient::NODE_ATTRIBUTE_DESCRIPTION, description);
+        setAttr(*node, mega::MegaClient::NODE_ATTRIBUTE_TAGS, tags);
+
+        mNodes.client->mNodeManager.saveNodeInDb(node.get());
+        return node;
+    }
+
+    static void setAttr(mega::Node& node, const char* attr, const std::string& value)
+    {
+        if (!value.empty())
+        {
+            node.attrs.map[mega::AttrMap::string2nameid(attr)] = value;
+        }
+    }
+
+    std::set<mega::NodeHandle> search(const mega::NodeSearchFilter& filter)
+    {
+        std::set<mega::NodeHandle> handles;
+        for (const auto& node: mNodes.client->mNodeManager.searchNodes(filter,
+                                                                       0 /*order None*/,
+                                                                       mega::CancelToken(),
+                                                                       mega::NodeSearchPage{0, 0}))
+        {
+            handles.insert(node->nodeHandle());
+        }
+        return handles;
+    }
+
+    bool hasIndex()
+    {
+        return dynamic_cast<mega::SqliteAccountState&>(mNodes.table()).hasNodeSearchIndex();
+    }
+
+    // Whether searchNodes() looks up the filter in the index, when there's one
+    static bool usesIndex(const mega::NodeSearchFilter& filter)
+    {
+        return !mega::getNodeSearchIndexQuery(filter).empty();
+    }
+
+    mega::NodeSearchFilter filterBelowRoot() const
+    {
+        mega::NodeSearchFilter filter;
+        filter.byAncestors({mNodes.rootNode->nodehandle, mega::UNDEF, mega::UNDEF});
+        return filter;
+    }
+};
+
+TEST_F(NodeSearchIndex, sameResultsWithAndWithoutIndex)
+{
+    auto documents = addNode(mega::nodetype_t::FOLDERNODE, mNodes.rootNode, "Documents");
+    addNode(mega::nodetype_t::FILENODE,
+            documents,
+            "Résumé 2024.pdf",
+            "Curriculum vitae",
+            "work,cv");
+    addNode(mega::nodetype_t::FILENODE, documents, "resume.txt");
+    addNode(mega::nodetype_t::FILENODE, documents, "Presumed.doc", "first draft");
+    addNode(mega::nodetype_t::FILENODE, documents, "holiday.jpg", "", "beach,summer");
+    auto archive = addNode(mega::nodetype_t::FOLDERNODE, documents, "Archive 2019");
+
+    // Existing nodes are indexed when the index is created...
+    enableIndex(true);
+    ASSERT_TRUE(hasIndex()) << "SQLite must be built with FTS5";
+
+    // ...and new ones when they are stored
+    addNode(mega::nodetype_t::FILENODE, archive, "old RESUME.txt", "Draft of CV", "cv");
+    addNode(mega::nodetype_t::FILENODE, archive, "100% done?.txt");
+
+    struct TextFilter
+    {
+        std::string name;
+        std::string description;
+        std::string tag;
+        bool useAnd = true;
+    };
+
+    const std::vector<TextFilter> textFilters{
+        {"resume", "", ""},
+        {"RÉSUMÉ", "", ""},
+        {"res?me", "", ""},
+        {"re", "", ""},
+        {"*.txt", "", ""},
+        {"2024.pdf", "", ""},
+        {"\\*", "", ""},
+        {"done\\?", "", ""},
+        {"archive", "", ""},
+        {"", "draft", ""},
+        {"", "cv*", ""},
+        {"", "", "summer"},
+        {"", "", "cv"},
+        {"", "", "work,cv"},
+        {"resume", "draft", "", false},
+        {"resume", "", "cv", true},
+        {"re", "", "work", true},
+        {"re", "", "work", false},
+    };
+
+    auto makeFilter = [this](const TextFilter& textFilter)
+    {
+        auto filter = filterBelowRoot();
+        filter.byName(textFilter.name);
+        filter.byDescription(textFilter.description);
+        filter.byTag(textFilter.tag);
+        filter.useAndForTextQuery(textFilter.useAnd);
+        return filter;
+    };
+
+    std::vector<std::set<mega::NodeHandle>> withIndex;
+    for (const auto& textFilter: textFilters)
+    {
+        withIndex.push_back(search(makeFilter(textFilter)));
+    }
+
+    ASSERT_TRUE(usesIndex(makeFilter(textFilters[0]))) << "Searches must use the full-text index";
+
+    ASSERT_EQ(withIndex[0].size(), 4u) << "Case and accents must be ignored";
+    ASSERT_EQ(withIndex[15].size(), 2u);
+
+    enableIndex(false);
+    ASSERT_FALSE(hasIndex());
+
+    for (size_t i = 0; i < textFilters.size(); ++i)
+    {
+        ASSERT_EQ(withIndex[i], search(makeFilter(textFilters[i])))
+            << "Different results for filter " << i;
+    }
+}
+
+TEST_F(NodeSearchIndex, indexFollowsUpdatesAndRemovals)
+{
+    enableIndex(true);
+
+    auto folder = addNode(mega::nodetype_t::FOLDERNODE, mNodes.rootNode, "Reports");
+    auto file = addNode(mega::nodetype_t::FILENODE, folder, "Quarterly report.xlsx");
+
+    ASSERT_TRUE(hasIndex()) << "SQLite must be built with FTS5";
+
+    auto filter = filterBelowRoot();
+    filter.byName("quarterly");
+
+    ASSERT_TRUE(usesIndex(filter)) << "The search must use the full-text index";
+    ASSERT_EQ(search(filter).size(), 1u);
+
+    // Rename
+    setAttr(*file, "n", "Yearly summary.xlsx");
+    mNodes.client->mNodeManager.saveNodeInDb(file.get());
+
+    ASSERT_TRUE(search(filter).empty());
+    filter.byName("summary");
+    ASSERT_EQ(search(filter).size(), 1u);
+
+    ASSERT_TRUE(mNodes.table().remove(file->nodeHandle()));
+    ASSERT_TRUE(search(filter).empty());
+
+    ASSERT_TRUE(mNodes.table().removeNodes());
+    filter.byName("reports");
+    ASSERT_TRUE(search(filter).empty());
+}
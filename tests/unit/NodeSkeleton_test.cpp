@@ -0,0 +1,177 @@
+/* @brief Unit tests for the node skeleton snapshot
+ *
+ * This test suite validates writing, mapping and querying NodeSkeleton snapshots
+ */
+
+#include <gtest/gtest.h>
+#include <mega.h>
+#include <mega/node_skeleton.h>
+#include <stdfs.h>
+
+#include <filesystem>
+#include <fstream>
+
+using namespace mega;
+
+namespace
+{
+
+class NodeSkeletonTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::filesystem::create_directory(mFolder);
+        mPath = LocalPath::fromAbsolutePath(path_u8string(mFolder / "snapshot.skeleton"));
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(mFolder);
+    }
+
+    static NodeSkeleton::Entry entry(handle node, handle parent, nodetype_t type)
+    {
+        return {node, parent, type, 0};
+    }
+
+    // root(1) -> folder(2) -> {file(3), folder(4) -> file(5)}, root(1) -> file(6)
+    std::vector<NodeSkeleton::Entry> tree() const
+    {
+        return {entry(5, 4, FILENODE),
+                entry(1, UNDEF, ROOTNODE),
+                entry(3, 2, FILENODE),
+                entry(6, 1, FILENODE),
+                entry(2, 1, FOLDERNODE),
+                entry(4, 2, FOLDERNODE)};
+    }
+
+    static NodeHandle h(handle node)
+    {
+        return NodeHandle().set6byte(node);
+    }
+
+    const std::filesystem::path mFolder{std::filesystem::current_path() / "node_skeleton"};
+    std::unique_ptr<FileSystemAccess> mFsAccess{new FSACCESS_CLASS};
+    LocalPath mPath;
+    const handle mScsn = 0x123456789;
+};
+
+} // namespace
+
+/**
+ * @brief A written snapshot maps back and answers structural queries
+ */
+TEST_F(NodeSkeletonTest, WriteAndQuery)
+{
+    ASSERT_TRUE(NodeSkeleton::write(*mFsAccess, mPath, mScsn, tree()));
+
+    auto skeleton = NodeSkeleton::map(mPath, mScsn);
+    ASSERT_TRUE(skeleton);
+
+    EXPECT_EQ(skeleton->size(), 6u);
+    EXPECT_EQ(skeleton->scsn(), mScsn);
+
+    EXPECT_TRUE(skeleton->contains(h(4)));
+    EXPECT_FALSE(skeleton->contains(h(7)));
+
+    EXPECT_EQ(skeleton->numChildren(h(1)), 2u);
+    EXPECT_EQ(skeleton->numChildren(h(2)), 2u);
+    EXPECT_EQ(skeleton->numChildren(h(3)), 0u);
+    EXPECT_EQ(skeleton->numChildrenByType(h(2), FILENODE), 1u);
+    EXPECT_EQ(skeleton->numChildrenByType(h(2), FOLDERNODE), 1u);
+    EXPECT_EQ(skeleton->numChildrenByType(h(1), FOLDERNODE), 1u);
+
+    EXPECT_EQ(skeleton->parent(h(5)), h(4));
+    EXPECT_EQ(skeleton->parent(h(7)), std::nullopt);
+
+    CancelToken cancelToken;
+    EXPECT_EQ(skeleton->isAncestor(h(5), h(1), cancelToken), true);
+    EXPECT_EQ(skeleton->isAncestor(h(5), h(2), cancelToken), true);
+    EXPECT_EQ(skeleton->isAncestor(h(6), h(2), cancelToken), false);
+    EXPECT_EQ(skeleton->isAncestor(h(2), h(5), cancelToken), false);
+    EXPECT_EQ(skeleton->isAncestor(h(7), h(1), cancelToken), std::nullopt);
+}
+
+/**
+ * @brief A snapshot taken at another scsn is rejected
+ */
+TEST_F(NodeSkeletonTest, RejectsStaleSnapshot)
+{
+    ASSERT_TRUE(NodeSkeleton::write(*mFsAccess, mPath, mScsn, tree()));
+
+    EXPECT_FALSE(NodeSkeleton::map(mPath, mScsn + 1));
+    EXPECT_TRUE(NodeSkeleton::map(mPath, mScsn));
+}
+
+/**
+ * @brief Missing, truncated and corrupt snapshots are rejected
+ */
+TEST_F(NodeSkeletonTest, RejectsMalformedSnapshot)
+{
+    EXPECT_FALSE(NodeSkeleton::map(mPath, mScsn));
+
+    ASSERT_TRUE(NodeSkeleton::write(*mFsAccess, mPath, mScsn, tree()));
+
+    auto path = mPath.toPath(false);
+    auto size = std::filesystem::file_size(path);
+
+    std::filesystem::resize_file(path, size - 1);
+    EXPECT_FALSE(NodeSkeleton::map(mPath, mScsn));
+
+    ASSERT_TRUE(NodeSkeleton::write(*mFsAccess, mPath, mScsn, tree()));
+
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(0);
+        file.put('X');
+    }
+
+    EXPECT_FALSE(NodeSkeleton::map(mPath, mScsn));
+}
+
+/**
+ * @brief Snapshots whose index or ordering is corrupt are rejected
+ */
+TEST_F(NodeSkeletonTest, RejectsCorruptIndex)
+{
+    auto entries = tree();
+    ASSERT_TRUE(NodeSkeleton::write(*mFsAccess, mPath, mScsn, entries));
+
+    auto path = mPath.toPath(false);
+    auto indexOffset = std::filesystem::file_size(path) - entries.size() * sizeof(uint32_t);
+
+    auto overwrite = [&path](std::streamoff offset, const void* data, std::streamsize size)
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offset);
+        file.write(static_cast<const char*>(data), size);
+    };
+
+    // A position past the last entry.
+    const uint32_t position = static_cast<uint32_t>(entries.size());
+
+    overwrite(static_cast<std::streamoff>(indexOffset), &position, sizeof(position));
+    EXPECT_FALSE(NodeSkeleton::map(mPath, mScsn));
+
+    // Positions out of (parent, handle) order.
+    ASSERT_TRUE(NodeSkeleton::write(*mFsAccess, mPath, mScsn, entries));
+
+    const uint32_t swapped[] = {1, 0};
+
+    overwrite(static_cast<std::streamoff>(indexOffset), swapped, sizeof(swapped));
+    EXPECT_FALSE(NodeSkeleton::map(mPath, mScsn));
+
+    // Entries out of handle order.
+    ASSERT_TRUE(NodeSkeleton::write(*mFsAccess, mPath, mScsn, entries));
+
+    const uint64_t handle = 0xFFFF;
+    auto entriesOffset = indexOffset - entries.size() * sizeof(NodeSkeleton::Entry);
+
+    overwrite(static_cast<std::streamoff>(entriesOffset), &handle, sizeof(handle));
+    EXPECT_FALSE(NodeSkeleton::map(mPath, mScsn));
+
+    // A fresh snapshot maps again.
+    ASSERT_TRUE(NodeSkeleton::write(*mFsAccess, mPath, mScsn, entries));
+    EXPECT_TRUE(NodeSkeleton::map(mPath, mScsn));
+}
@@ -0,0 +1,204 @@
+/**
+ * @brief Unitary tests for RaidKernels, the routines that combine the parts of cloudraid files
+ */
+
+#include <gtest/gtest.h>
+#include <mega/raid_kernels.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace mega;
+
+namespace
+{
+
+std::vector<byte> randomBytes(size_t count, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::vector<byte> bytes(count);
+    std::generate(bytes.begin(),
+                  bytes.end(),
+                  [&generator]()
+                  {
+                      return static_cast<byte>(generator());
+                  });
+    return bytes;
+}
+
+// Splits a file in its parity and data parts, as stored by the servers
+std::vector<std::vector<byte>> splitInParts(const std::vector<byte>& file)
+{
+    const size_t numLines = (file.size() + RAIDLINE - 1) / RAIDLINE;
+    std::vector<std::vector<byte>> parts(RAIDPARTS, std::vector<byte>(numLines * RAIDSECTOR));
+
+    for (size_t i = 0; i < file.size(); ++i)
+    {
+        const size_t line = i / RAIDLINE;
+        const size_t part = 1 + (i % RAIDLINE) / RAIDSECTOR;
+        const size_t offset = line * RAIDSECTOR + i % RAIDSECTOR;
+
+        parts[part][offset] = file[i];
+        parts[0][offset] = static_cast<byte>(parts[0][offset] ^ file[i]);
+    }
+
+    return parts;
+}
+
+class TestRaidBufferManager: public RaidBufferManager
+{
+public:
+    // Downloads 'parts' in requests of 'requestSize' bytes, without connection 'unusedPart'
+    std::vector<byte> download(const std::vector<std::vector<byte>>& parts,
+                               m_off_t fileSize,
+                               unsigned unusedPart,
+                               size_t requestSize)
+    {
+        setIsRaid(std::vector<std::string>(RAIDPARTS, "http://localhost/"),
+                  0,
+                  fileSize,
+                  fileSize,
+                  static_cast<m_off_t>(requestSize) * RAIDPARTS,
+                  false);
+        setUnusedRaidConnection(unusedPart);
+
+        std::vector<byte> file(static_cast<size_t>(fileSize));
+        const size_t partSize = parts[0].size();
+
+        for (size_t pos = 0; pos < partSize; pos += requestSize)
+        {
+            const size_t len = std::min(requestSize, partSize - pos);
+
+            for (unsigned part = 0; part < RAIDPARTS; ++part)
+            {
+                FilePiece* piece = nullptr;
+                if (part == unusedPart)
+                {
+                    piece = new FilePiece(static_cast<m_off_t>(pos),
+                                          new HttpReq::http_buf_t(nullptr, 0, len));
+                }
+                else
+                {
+                    piece = new FilePiece(static_cast<m_off_t>(pos), len);
+                    memcpy(piece->buf.datastart(), parts[part].data() + pos, len);
+                }
+                submitBuffer(part, piece);
+            }
+
+            while (auto output = getAsyncOutputBufferPointer(0))
+            {
+                memcpy(file.data() + output->pos, output->buf.datastart(), output->buf.datalen());
+                bufferWriteCompleted(0, true);
+            }
+        }
+
+        return file;
+    }
+
+private:
+    void finalize(FilePiece&) override {}
+
+    m_off_t calcOutputChunkPos(m_off_t acquiredpos) override
+    {
+        return acquiredpos;
+    }
+};
+
+} // namespace
+
+TEST(RaidKernels, implementationsMatchPortable)
+{
+    const auto& implementations = RaidKernels::supported();
+    ASSERT_FALSE(implementations.empty());
+    ASSERT_EQ(&RaidKernels::get(), implementations.front());
+
+    const RaidKernels& portable = *implementations.back();
+    ASSERT_STREQ(portable.name, "portable");
+
+    // XOR of any number of unaligned buffers of any length
+    constexpr size_t maxLen = 1000;
+    std::vector<std::vector<byte>> buffers;
+    const byte* sources[RAIDPARTS];
+    for (unsigned i = 0; i < RAIDPARTS; ++i)
+    {
+        buffers.push_back(randomBytes(maxLen + 1, i));
+        sources[i] = buffers.back().data() + 1;
+    }
+
+    const std::vector<size_t> lengths{0, 1, 15, 16, 17, 31, 32, 33, 63, 80, 81, 999};
+    for (size_t len: lengths)
+    {
+        for (unsigned numSources = 1; numSources <= RAIDPARTS; ++numSources)
+        {
+            std::vector<byte> expected(len);
+            for (size_t i = 0; i < len; ++i)
+            {
+                for (unsigned j = 0; j < numSources; ++j)
+                {
+                    expected[i] = static_cast<byte>(expected[i] ^ sources[j][i]);
+                }
+            }
+
+            for (const auto* kernels: implementations)
+            {
+                std::vector<byte> dest(len + 1);
+                kernels->xorParts(dest.data() + 1, sources, numSources, len);
+                ASSERT_TRUE(std::equal(expected.begin(), expected.end(), dest.begin() + 1))
+                    << kernels->name << " len " << len << " sources " << numSources;
+            }
+        }
+    }
+
+    // Interleaving, scattering and recovery of RAID lines
+    constexpr size_t numLines = 100;
+    const auto file = randomBytes(numLines * RAIDLINE, 10);
+    const auto parts = splitInParts(file);
+    const byte* dataParts[EFFECTIVE_RAIDPARTS];
+    for (unsigned n = 0; n < EFFECTIVE_RAIDPARTS; ++n)
+    {
+        dataParts[n] = parts[n + 1].data();
+    }
+
+    for (const auto* kernels: implementations)
+    {
+        std::vector<byte> lines(file.size());
+        kernels->interleaveLines(lines.data(), dataParts, numLines);
+        ASSERT_EQ(lines, file) << kernels->name;
+
+        std::fill(lines.begin(), lines.end(), byte(0));
+        for (unsigned n = 0; n < EFFECTIVE_RAIDPARTS; ++n)
+        {
+            kernels->scatterPart(lines.data() + n * RAIDSECTOR, dataParts[n], numLines);
+        }
+        ASSERT_EQ(lines, file) << kernels->name;
+
+        for (unsigned missing = 0; missing < EFFECTIVE_RAIDPARTS; ++missing)
+        {
+            for (size_t l = 0; l < numLines; ++l)
+            {
+                memset(lines.data() + l * RAIDLINE + missing * RAIDSECTOR, 0xAB, RAIDSECTOR);
+            }
+            kernels->recoverLines(lines.data(), parts[0].data(), missing, numLines);
+            ASSERT_EQ(lines, file) << kernels->name << " missing " << missing;
+        }
+    }
+}
+
+TEST(RaidKernels, bufferManagerRebuildsAnyMissingPart)
+{
+    // Not a multiple of RAIDLINE, so the last line is padded
+    const auto file = randomBytes(1000 * RAIDLINE + 37, 20);
+    const auto parts = splitInParts(file);
+
+    for (unsigned unusedPart = 0; unusedPart < RAIDPARTS; ++unusedPart)
+    {
+        TestRaidBufferManager manager;
+        auto downloaded = manager.download(parts,
+                                           static_cast<m_off_t>(file.size()),
+                                           unusedPart,
+                                           100 * RAIDSECTOR);
+        ASSERT_EQ(downloaded, file) << "Unused part " << unusedPart;
+    }
+}
@@ -0,0 +1,155 @@
+/**
+ * @brief Unitary tests for ScanService, which scans directories and fingerprints their files
+ */
+
+#include <gtest/gtest.h>
+#include <mega.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <thread>
+
+using namespace mega;
+
+namespace
+{
+
+namespace fs = std::filesystem;
+
+class ScanServiceTest: public ::testing::Test
+{
+protected:
+    fs::path mDirectory = fs::temp_directory_path() / "ScanService_test";
+
+    void SetUp() override
+    {
+        fs::remove_all(mDirectory);
+        fs::create_directories(mDirectory / "subfolder");
+    }
+
+    void TearDown() override
+    {
+        ScanService::setNumThreads(1);
+        fs::remove_all(mDirectory);
+    }
+
+    void createFiles(size_t numFiles, size_t maxSize)
+    {
+        for (size_t i = 0; i < numFiles; ++i)
+        {
+            std::ofstream file(mDirectory / ("file" + std::to_string(i)), std::ios::binary);
+            file << std::string((i * 7919) % maxSize, static_cast<char>('a' + i % 26));
+        }
+    }
+
+    // Scans mDirectory with the given number of threads, results by name
+    std::map<LocalPath, FSNode> scan(size_t numThreads, ScanService::ScanRequest::Stats& stats)
+    {
+        ScanService::setNumThreads(numThreads);
+        EXPECT_EQ(ScanService::numThreads(), numThreads);
+
+        FSACCESS_CLASS fsAccess;
+        auto path = LocalPath::fromAbsolutePath(mDirectory.string());
+        auto fsid = fsAccess.fsidOf(path, false, false, FSLogging::logOnError);
+
+        ScanService service;
+        auto request =
+            service.queueScan(path, fsid, false, {}, std::make_shared<WAIT_CLASS>());
+        while (!request->completed())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(request->completionResult(), SCAN_SUCCESS);
+
+        stats = request->stats();
+        std::map<LocalPath, FSNode> results;
+        for (auto& node: request->resultNodes())
+        {
+            results.emplace(node.localname, std::move(node));
+        }
+        return results;
+    }
+};
+
+} // namespace
+
+TEST_F(ScanServiceTest, parallelFingerprintsMatchSequentialOnes)
+{
+    constexpr size_t numFiles = 200;
+    createFiles(numFiles, 100000);
+
+    ScanService::ScanRequest::Stats sequentialStats;
+    auto sequential = scan(1, sequentialStats);
+
+    ScanService::ScanRequest::Stats parallelStats;
+    auto parallel = scan(4, parallelStats);
+
+    ASSERT_EQ(sequential.size(), numFiles + 1);
+    ASSERT_EQ(parallel.size(), sequential.size());
+    for (const auto& [name, node]: sequential)
+    {
+        auto it = parallel.find(name);
+        ASSERT_NE(it, parallel.end()) << name;
+        ASSERT_EQ(it->second.type, node.type) << name;
+
+        if (node.type == FILENODE)
+        {
+            ASSERT_TRUE(node.fingerprint.isvalid) << name;
+            ASSERT_EQ(it->second.fingerprint, node.fingerprint) << name;
+        }
+    }
+
+    for (const auto* stats: {&sequentialStats, &parallelStats})
+    {
+        ASSERT_EQ(stats->numEntries, numFiles + 1);
+        ASSERT_EQ(stats->numFingerprinted, numFiles);
+        ASSERT_GT(stats->bytesFingerprinted, 0);
+    }
+    ASSERT_EQ(parallelStats.bytesFingerprinted, sequentialStats.bytesFingerprinted);
+}
+
+TEST_F(ScanServiceTest, resizeWhileRunning)
+{
+    createFiles(20, 1000);
+
+    ScanService::ScanRequest::Stats stats;
+    for (size_t numThreads: {3u, 1u, 8u, 2u})
+    {
+        ASSERT_EQ(scan(numThreads, stats).size(), 21u);
+        ASSERT_EQ(stats.numFingerprinted, 20u);
+    }
+}
+
+TEST(ScanServiceStatsTest, overlappingScansCountWallClockTime)
+{
+    using std::chrono::seconds;
+
+    auto scan = [start = std::chrono::steady_clock::time_point{}](int from, int to)
+    {
+        ScanService::ScanRequest::Stats stats;
+        stats.numEntries = 10;
+        stats.finished = start + seconds(to);
+        stats.elapsed = seconds(to - from);
+        return stats;
+    };
+
+    // Two threads scanning [0, 10) and [5, 20), completing in either order, then an idle gap
+    // and a last scan over [30, 40).
+    ScanService::ScanRequest::Stats total;
+    total += scan(5, 20);
+    total += scan(0, 10);
+    total += scan(30, 40);
+
+    ASSERT_EQ(total.numEntries, 30u);
+    ASSERT_EQ(total.elapsed, seconds(30));
+    ASSERT_EQ(total.entriesPerSecond(), 1.0);
+
+    ScanService::ScanRequest::Stats inOrder;
+    inOrder += scan(0, 10);
+    inOrder += scan(5, 20);
+    inOrder += scan(30, 40);
+
+    ASSERT_EQ(inOrder.elapsed, seconds(30));
+}
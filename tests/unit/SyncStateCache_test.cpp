@@ -0,0 +1,279 @@
+/* @brief Unit tests for loading a sync's state cache
+ *
+ * This test suite validates decoding state cache rows in the worker threads, and attaching them
+ * with attachStateCacheChildren(), as Sync::addstatecachechildren does, which resolves duplicates
+ * and leaves orphans over.
+ */
+
+#include <gtest/gtest.h>
+#include <mega.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef ENABLE_SYNC
+
+using namespace mega;
+
+namespace
+{
+
+class SyncStateCacheTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        byte keyBytes[SymmCipher::KEYLENGTH];
+        mRng.genblock(keyBytes, sizeof(keyBytes));
+        mKey.setkey(keyBytes);
+    }
+
+    using EncryptedRows = std::vector<std::pair<uint32_t, std::string>>;
+
+    // The encrypted row of a node called name, as Sync::statecacheadd writes it.
+    EncryptedRows::value_type
+        row(uint32_t id, uint32_t parentID, const std::string& name, nodetype_t type)
+    {
+        SyncStateCacheRow::Core core;
+        core.type = type;
+        core.localname = LocalPath::fromRelativePath(name);
+        core.fsid_lastSynced = id;
+        core.syncedCloudNodeHandle.set6byte(id);
+
+        std::string data;
+        core.write(data, parentID);
+        PaddedCBC::encrypt(mRng, &data, &mKey);
+
+        return {id, std::move(data)};
+    }
+
+    // Rows as Sync::readstatecache reads them from the database.
+    static std::vector<SyncStateCacheRow> rows(const EncryptedRows& encrypted)
+    {
+        std::vector<SyncStateCacheRow> result(encrypted.size());
+
+        for (size_t i = 0; i < encrypted.size(); ++i)
+        {
+            result[i].id = encrypted[i].first;
+            result[i].data = encrypted[i].second;
+        }
+
+        return result;
+    }
+
+    // A LocalNode, as far as attachStateCacheChildren() is concerned.
+    struct FakeNode
+    {
+        uint32_t id = 0;
+        std::string name;
+        FakeNode* parent = nullptr;
+        std::map<std::string, FakeNode*> children;
+    };
+
+    // Attaches FakeNodes as Sync::addstatecachechildren attaches LocalNodes.
+    struct FakeTree
+    {
+        std::set<uint32_t> removed;
+
+        FakeNode* duplicate(FakeNode* parent, FakeNode& node)
+        {
+            auto i = parent->children.find(node.name);
+            return i != parent->children.end() ? i->second : nullptr;
+        }
+
+        void remove(FakeNode& duplicate)
+        {
+            duplicate.parent->children.erase(duplicate.name);
+            removed.emplace(duplicate.id);
+        }
+
+        FakeNode* attach(FakeNode* parent, FakeNode& node)
+        {
+            // Doesn't replace anything: duplicates must have been removed already.
+            EXPECT_TRUE(parent->children.emplace(node.name, &node).second) << node.name;
+            node.parent = parent;
+            return &node;
+        }
+
+        uint32_t id(const FakeNode& node) const
+        {
+            return node.id;
+        }
+    };
+
+    // Ids of the nodes attached below the sync root, by path, as Sync::readstatecache loads the
+    // first count rows. Nodes that are left over are orphans.
+    static std::map<std::string, uint32_t> tree(std::vector<SyncStateCacheRow>& rows,
+                                                size_t count,
+                                                std::set<uint32_t>& orphans,
+                                                std::set<uint32_t>* removed = nullptr)
+    {
+        std::vector<std::unique_ptr<FakeNode>> storage;
+        std::vector<std::pair<uint32_t, FakeNode*>> nodes;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!rows[i].unserialized)
+                continue;
+
+            auto node = std::make_unique<FakeNode>();
+            node->id = rows[i].id;
+            node->name = rows[i].core.localname.toPath(false);
+
+            nodes.emplace_back(rows[i].parentID, node.get());
+            storage.emplace_back(std::move(node));
+        }
+
+        sortStateCacheNodes(nodes);
+
+        FakeNode root;
+        FakeTree fakeTree;
+
+        attachStateCacheChildren(nodes, 0, &root, 100, fakeTree);
+
+        for (auto& [parentID, node]: nodes)
+        {
+            if (node)
+                orphans.emplace(node->id);
+        }
+
+        if (removed)
+            *removed = fakeTree.removed;
+
+        std::map<std::string, uint32_t> paths;
+        std::function<void(const FakeNode&, const std::string&)> collect =
+            [&](const FakeNode& parent, const std::string& path)
+        {
+            for (auto& [name, child]: parent.children)
+            {
+                paths[path + "/" + name] = child->id;
+                collect(*child, path + "/" + name);
+            }
+        };
+
+        collect(root, "");
+
+        return paths;
+    }
+
+    PrnGen mRng;
+    SymmCipher mKey;
+    WAIT_CLASS mWaiter;
+};
+
+TEST_F(SyncStateCacheTest, ForEachRangeVisitsEveryIndexOnce)
+{
+    for (unsigned threads: {0u, 4u})
+    {
+        MegaClientAsyncQueue queue(mWaiter, threads);
+
+        for (size_t count: {0u, 1u, 63u, 64u, 1000u})
+        {
+            std::vector<std::atomic<int>> visits(count);
+
+            queue.forEachRange(count,
+                               64,
+                               [&](size_t first, size_t last, SymmCipher&)
+                               {
+                                   EXPECT_LE(last - first, 64u);
+
+                                   for (auto i = first; i < last; ++i)
+                                       ++visits[i];
+                               });
+
+            // Every range has finished by the time forEachRange returns.
+            for (auto& visit: visits)
+                EXPECT_EQ(visit.load(), 1);
+        }
+    }
+}
+
+TEST_F(SyncStateCacheTest, ParallelDecodeMatchesSequential)
+{
+    EncryptedRows encrypted;
+
+    for (uint32_t id = 1; id <= 2000; ++id)
+        encrypted.emplace_back(row(id, (id - 1) / 16, "node " + std::to_string(id), FILENODE));
+
+    // One row that decrypts but doesn't unserialize, and one that can't be decrypted.
+    encrypted[500].second = "short";
+    PaddedCBC::encrypt(mRng, &encrypted[500].second, &mKey);
+    encrypted[1500].second = "garbage";
+
+    auto sequential = rows(encrypted);
+    auto parallel = rows(encrypted);
+
+    MegaClientAsyncQueue noThreads(mWaiter, 0);
+    MegaClientAsyncQueue threads(mWaiter, 4);
+
+    // Loading stops at the row that can't be decrypted.
+    EXPECT_EQ(decodeSyncStateCacheRows(noThreads, mKey, sequential), 1500u);
+    EXPECT_EQ(decodeSyncStateCacheRows(threads, mKey, parallel), 1500u);
+
+    ASSERT_EQ(sequential.size(), parallel.size());
+
+    for (size_t i = 0; i < sequential.size(); ++i)
+    {
+        EXPECT_EQ(sequential[i].id, parallel[i].id);
+        EXPECT_EQ(sequential[i].decrypted, parallel[i].decrypted);
+        EXPECT_EQ(sequential[i].unserialized, parallel[i].unserialized);
+        EXPECT_EQ(sequential[i].parentID, parallel[i].parentID);
+        EXPECT_EQ(sequential[i].core.localname, parallel[i].core.localname);
+        EXPECT_EQ(sequential[i].core.fsid_lastSynced, parallel[i].core.fsid_lastSynced);
+    }
+
+    EXPECT_TRUE(parallel[499].unserialized);
+    EXPECT_TRUE(parallel[500].decrypted);
+    EXPECT_FALSE(parallel[500].unserialized);
+    EXPECT_FALSE(parallel[1500].decrypted);
+
+    // Of the rows loaded, all but the one that didn't unserialize make it into the tree.
+    std::set<uint32_t> orphans;
+    auto paths = tree(parallel, 1500, orphans);
+
+    EXPECT_EQ(paths.size() + orphans.size(), 1499u);
+
+    for (auto& [path, id]: paths)
+        EXPECT_LT(id, 1501u) << path;
+}
+
+TEST_F(SyncStateCacheTest, LaterDuplicateWinsAndOrphansAreLeftOver)
+{
+    // Rows come out of the database in dbid order, children before some of their parents.
+    auto decoded = rows({
+        row(1, 3, "file", FILENODE),
+        row(2, 0, "duplicate", FILENODE),
+        row(3, 0, "folder", FOLDERNODE),
+        row(4, 0, "duplicate", FILENODE),
+        row(5, 42, "orphan", FOLDERNODE),
+        row(6, 5, "orphan child", FILENODE),
+        row(7, 3, "file", FILENODE),
+    });
+
+    MegaClientAsyncQueue queue(mWaiter, 2);
+    ASSERT_EQ(decodeSyncStateCacheRows(queue, mKey, decoded), decoded.size());
+
+    std::set<uint32_t> orphans;
+    std::set<uint32_t> removed;
+    auto paths = tree(decoded, decoded.size(), orphans, &removed);
+
+    std::map<std::string, uint32_t> expected = {
+        {"/duplicate",   4},
+        {"/folder",      3},
+        {"/folder/file", 7},
+    };
+
+    EXPECT_EQ(paths, expected);
+    EXPECT_EQ(removed, (std::set<uint32_t>{1, 2}));
+    EXPECT_EQ(orphans, (std::set<uint32_t>{5, 6}));
+}
+
+} // namespace
+
+#endif // ENABLE_SYNC
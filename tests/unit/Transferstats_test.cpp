@@ -16,6 +16,8 @@
  * program.
  */
 
+#include "mega/code_counter.h"
+#include "mega/transferslot.h"
 #include "mega/transferstats.h"
 
 #include <gtest/gtest.h>
@@ -247,4 +249,44 @@ TEST(TransferStatsTest, TestCalculateWeightedAverageRoundingDown)
     const std::vector<m_off_t> values = {1, 2};
     const std::vector<m_off_t> weights = {2, 1};
     ASSERT_EQ(calculateWeightedAverage(values, weights), 1);
-}
\ No newline at end of file
+}
+/************************\
+*  TEST UPLOAD PIPELINE  *
+\************************/
+
+/**
+ * @brief Tests that the time uploaded chunks spend in each stage of the pipeline is averaged
+ * per transfer and published to the CodeCounter registry.
+ */
+TEST(TransferStatsTest, TestUploadedChunkStagesArePublished)
+{
+    auto& registry = mega::CodeCounter::Registry::instance();
+    auto before = registry.snapshot();
+
+    TransferSlotStats stats;
+    stats.addUploadedChunk(2, 4, 6, 100);
+    stats.addUploadedChunk(4, 0, 8, 300);
+
+    ASSERT_EQ(stats.mNumUploadedChunks, 2);
+    ASSERT_EQ(stats.averageUploadStageTime(stats.mTotalReadTime), 3);
+    ASSERT_EQ(stats.averageUploadStageTime(stats.mTotalEncryptQueueTime), 2);
+    ASSERT_EQ(stats.averageUploadStageTime(stats.mTotalEncryptTime), 7);
+    ASSERT_EQ(stats.averageUploadStageTime(stats.mTotalSendTime), 200);
+
+    auto after = registry.snapshot();
+
+    auto published = [&](const std::string& name)
+    {
+        auto& scope = after[name];
+        auto& previous = before[name];
+        return std::make_pair(scope.count - previous.count,
+                              (scope.timeSpentNs - previous.timeSpentNs) / 1000000);
+    };
+
+    ASSERT_EQ(published("TransferSlot_uploadRead"), std::make_pair(uint64_t{2}, uint64_t{6}));
+    ASSERT_EQ(published("TransferSlot_uploadEncryptQueue"),
+              std::make_pair(uint64_t{2}, uint64_t{4}));
+    ASSERT_EQ(published("TransferSlot_uploadEncrypt"), std::make_pair(uint64_t{2}, uint64_t{14}));
+    ASSERT_EQ(published("TransferSlot_uploadSend"), std::make_pair(uint64_t{2}, uint64_t{400}));
+    ASSERT_EQ(after["TransferSlot_uploadSend"].active(), 0u);
+}
@@ -6,6 +6,9 @@
 #include <gtest/gtest.h>
 
 #include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
 
 using namespace mega;
 using namespace sdk_test;
@@ -74,4 +77,114 @@ TEST_F(MegaClientTest, isValidLocalSyncRoot_NotAFolder)
     EXPECT_EQ(sWarn, NO_SYNC_WARNING);
 }
 
-} // namespace
\ No newline at end of file
+class StateCacheRecordTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        byte keyBytes[SymmCipher::KEYLENGTH];
+        mRng.genblock(keyBytes, sizeof(keyBytes));
+        mKey.setkey(keyBytes);
+    }
+
+    // The statecache record of a Cacheable, encrypted as DbTable::put() writes it.
+    void add(uint32_t index, uint32_t type, const Cacheable& cacheable)
+    {
+        std::string data;
+        cacheable.serialize(&data);
+        PaddedCBC::encrypt(mRng, &data, &mKey);
+
+        mEncrypted.emplace_back(index * DbTable::IDSPACING + type, std::move(data));
+    }
+
+    // Records as MegaClient::fetchsc() reads them from the database.
+    std::vector<StateCacheRecord> records() const
+    {
+        std::vector<StateCacheRecord> result(mEncrypted.size());
+
+        for (size_t i = 0; i < mEncrypted.size(); ++i)
+        {
+            result[i].id = mEncrypted[i].first;
+            result[i].data = mEncrypted[i].second;
+        }
+
+        return result;
+    }
+
+    PrnGen mRng;
+    SymmCipher mKey;
+    WAIT_CLASS mWaiter;
+    std::vector<std::pair<uint32_t, std::string>> mEncrypted;
+};
+
+TEST_F(StateCacheRecordTest, ParallelDecodeMatchesSequential)
+{
+    for (uint32_t i = 1; i <= 1000; ++i)
+    {
+        if (i % 2)
+        {
+            PendingContactRequest pcr(i, "from@mega.nz", "to@mega.nz", i, i, "hello", true);
+            add(i, MegaClient::CACHEDPCR, pcr);
+        }
+        else
+        {
+            Set set(i, std::string(SymmCipher::KEYLENGTH, 'k'), i, {});
+            add(i, MegaClient::CACHEDSET, set);
+        }
+    }
+
+    // Loading the session stops at the record that can't be decrypted.
+    mEncrypted[600].second = "garbage";
+
+    auto sequential = records();
+    auto parallel = records();
+
+    MegaClientAsyncQueue noThreads(mWaiter, 0);
+    MegaClientAsyncQueue threads(mWaiter, 4);
+
+    EXPECT_EQ(StateCacheRecord::decode(noThreads, mKey, sequential), 600u);
+    EXPECT_EQ(StateCacheRecord::decode(threads, mKey, parallel), 600u);
+
+    ASSERT_EQ(sequential.size(), parallel.size());
+
+    for (size_t i = 0; i < sequential.size(); ++i)
+    {
+        EXPECT_EQ(sequential[i].decrypted, parallel[i].decrypted) << i;
+        ASSERT_EQ(!!sequential[i].pcr, !!parallel[i].pcr) << i;
+        ASSERT_EQ(!!sequential[i].set, !!parallel[i].set) << i;
+
+        if (parallel[i].pcr)
+        {
+            EXPECT_EQ(sequential[i].pcr->id, parallel[i].pcr->id);
+            EXPECT_EQ(sequential[i].pcr->targetemail, parallel[i].pcr->targetemail);
+            EXPECT_EQ(sequential[i].pcr->ts, parallel[i].pcr->ts);
+        }
+
+        if (parallel[i].set)
+        {
+            EXPECT_EQ(sequential[i].set->id(), parallel[i].set->id());
+            EXPECT_EQ(sequential[i].set->user(), parallel[i].set->user());
+            EXPECT_EQ(sequential[i].set->key(), parallel[i].set->key());
+        }
+    }
+
+    EXPECT_TRUE(parallel[599].set);
+    EXPECT_FALSE(parallel[600].decrypted);
+    EXPECT_TRUE(parallel[601].decrypted);
+}
+
+TEST_F(StateCacheRecordTest, AllRecordsAreUsableWhenAllDecrypt)
+{
+    for (uint32_t i = 1; i <= 100; ++i)
+        add(i, MegaClient::CACHEDPCR, PendingContactRequest(i));
+
+    auto decoded = records();
+    MegaClientAsyncQueue threads(mWaiter, 4);
+
+    EXPECT_EQ(StateCacheRecord::decode(threads, mKey, decoded), decoded.size());
+
+    for (auto& record: decoded)
+        EXPECT_TRUE(record.pcr);
+}
+
+} // namespace
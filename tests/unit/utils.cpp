@@ -44,7 +44,9 @@ mega::handle nextFsId()
     return fsId++;
 }
 
-std::shared_ptr<mega::MegaClient> makeClient(mega::MegaApp& app, mega::DbAccess* dbAccess)
+std::shared_ptr<mega::MegaClient> makeClient(mega::MegaApp& app,
+                                             mega::DbAccess* dbAccess,
+                                             unsigned workerThreadCount)
 {
     struct HttpIo : mega::HttpIO
     {
@@ -68,7 +70,13 @@ std::shared_ptr<mega::MegaClient> makeClient(mega::MegaApp& app, mega::DbAccess*
     auto waiter = std::make_shared<WAIT_CLASS>();
 
     std::shared_ptr<mega::MegaClient> client{
-        new mega::MegaClient{&app, waiter, httpio, dbAccess, nullptr, "unit_test", 0},
+        new mega::MegaClient{&app,
+                             waiter,
+                             httpio,
+                             dbAccess,
+                             nullptr,
+                             "unit_test",
+                             workerThreadCount},
         deleter};
 
     return client;
@@ -87,6 +95,45 @@ mega::Node& makeNode(mega::MegaClient& client, const mega::nodetype_t type, mega
     return *n;
 }
 
+SqliteNodeClient::SqliteNodeClient(mega::MegaApp& app)
+{
+    auto dbAccess = new mega::SqliteDbAccess(mega::LocalPath::fromAbsolutePath("."));
+    client = makeClient(app, dbAccess);
+    client->sid =
+        "AWA5YAbtb4JO-y2zWxmKZpSe5-6XM7CTEkA-3Nv7J4byQUpOazdfSC1ZUFlS-kah76gPKUEkTF9g7MeE";
+    client->opensctable();
+
+    rootNode = addNode(mega::ROOTNODE, nullptr);
+    addNode(mega::VAULTNODE, nullptr);
+    addNode(mega::RUBBISHNODE, nullptr);
+}
+
+mega::DBTableNodes& SqliteNodeClient::table() const
+{
+    auto table = dynamic_cast<mega::DBTableNodes*>(client->sctable.get());
+    assert(table);
+    return *table;
+}
+
+std::shared_ptr<mega::Node> SqliteNodeClient::makeNode(const mega::nodetype_t type,
+                                                       const std::shared_ptr<mega::Node>& parent,
+                                                       const bool isFetching)
+{
+    std::shared_ptr<mega::Node> node(
+        &mt::makeNode(*client, type, mega::NodeHandle().set6byte(mIndex++), parent.get()));
+    client->mNodeManager.addNode(node, false, isFetching, mMissingParentNodes);
+    return node;
+}
+
+std::shared_ptr<mega::Node> SqliteNodeClient::addNode(const mega::nodetype_t type,
+                                                      const std::shared_ptr<mega::Node>& parent,
+                                                      const bool isFetching)
+{
+    auto node = makeNode(type, parent, isFetching);
+    client->mNodeManager.saveNodeInDb(node.get());
+    return node;
+}
+
 std::uint16_t nextRandomInt()
 {
     std::uniform_int_distribution<std::uint16_t> dist{0, std::numeric_limits<std::uint16_t>::max()};
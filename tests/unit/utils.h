@@ -31,10 +31,40 @@ class FsNode;
 
 mega::handle nextFsId();
 
-std::shared_ptr<mega::MegaClient> makeClient(mega::MegaApp& app, mega::DbAccess* dbAccess  = nullptr);
+std::shared_ptr<mega::MegaClient> makeClient(mega::MegaApp& app,
+                                             mega::DbAccess* dbAccess = nullptr,
+                                             unsigned workerThreadCount = 0);
 
 mega::Node& makeNode(mega::MegaClient& client, mega::nodetype_t type, mega::NodeHandle handle, mega::Node* parent = nullptr);
 
+// Client whose nodes are stored by its NodeManager in an SQLite DB in the working directory.
+// The root, vault and rubbish bin nodes are added on construction.
+class SqliteNodeClient
+{
+public:
+    explicit SqliteNodeClient(mega::MegaApp& app);
+
+    mega::DBTableNodes& table() const;
+
+    // Adds the node to the NodeManager as fetchnodes would, or as action packets would if
+    // !isFetching, but doesn't store it in the DB
+    std::shared_ptr<mega::Node> makeNode(mega::nodetype_t type,
+                                         const std::shared_ptr<mega::Node>& parent,
+                                         bool isFetching = true);
+
+    // As makeNode(), and stores the node in the DB
+    std::shared_ptr<mega::Node> addNode(mega::nodetype_t type,
+                                        const std::shared_ptr<mega::Node>& parent,
+                                        bool isFetching = true);
+
+    std::shared_ptr<mega::MegaClient> client;
+    std::shared_ptr<mega::Node> rootNode;
+
+private:
+    mega::NodeManager::MissingParentNodes mMissingParentNodes;
+    uint64_t mIndex = 1;
+};
+
 void collectAllFsNodes(std::map<mega::LocalPath, const mt::FsNode*>& nodes, const mt::FsNode& node);
 
 std::uint16_t nextRandomInt();